@@ -0,0 +1,1047 @@
+#include "AES.h"
+#include "AES_ni.h"
+#include <string.h>
+#include <pthread.h>
+
+// Encrypt and hash in chunks of this size so GHASH reads ciphertext still in L1
+#define AES_GCM_CHUNK_SIZE 4096
+
+/**
+ * Big-endian reads and writes
+ */
+static uint32_t aes_be32(const uint8_t *p) {
+    return ((uint32_t)p[0] << 24) |
+           ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) |
+           ((uint32_t)p[3]);
+}
+
+static void aes_write_be32(uint8_t *p, uint32_t val) {
+    p[0] = (uint8_t)(val >> 24);
+    p[1] = (uint8_t)(val >> 16);
+    p[2] = (uint8_t)(val >> 8);
+    p[3] = (uint8_t)(val);
+}
+
+static uint64_t aes_be64(const uint8_t *p) {
+    return ((uint64_t)aes_be32(p) << 32) | aes_be32(p + 4);
+}
+
+static void aes_write_be64(uint8_t *p, uint64_t val) {
+    aes_write_be32(p, (uint32_t)(val >> 32));
+    aes_write_be32(p + 4, (uint32_t)val);
+}
+
+/**
+ * Zero memory in a way the compiler cannot drop
+ */
+static void aes_wipe(void *p, size_t len) {
+    volatile uint8_t *v = (volatile uint8_t *)p;
+    while (len--) {
+        *v++ = 0;
+    }
+}
+
+static void aes_xor(uint8_t *out, const uint8_t *in, const uint8_t *keystream, size_t length) {
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        uint64_t a, b;
+        memcpy(&a, in + i, 8);
+        memcpy(&b, keystream + i, 8);
+        a ^= b;
+        memcpy(out + i, &a, 8);
+    }
+    for (; i < length; i++) {
+        out[i] = in[i] ^ keystream[i];
+    }
+}
+
+/*
+ * Bitsliced AES
+ *
+ * Four blocks are held in eight 64-bit words, word b holding bit b of all 64 bytes.
+ * Byte i of block k (row i % 4, column i / 4) sits at bit 16 * row + 4 * column + k,
+ * so every row is a 16-bit field: ShiftRows rotates inside the fields and
+ * MixColumns reaches the other rows by rotating the whole word by 16 bits.
+ * SubBytes is the Boyar-Peralta circuit on the eight words.
+ */
+
+/**
+ * AES S-box on all 64 bytes at once; q[0] holds the least significant bits
+ */
+static void aes_sbox_sliced(uint64_t q[8]) {
+    uint64_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint64_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    uint64_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    uint64_t y20, y21;
+    uint64_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    uint64_t z10, z11, z12, z13, z14, z15, z16, z17;
+    uint64_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    uint64_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint64_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    uint64_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint64_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    uint64_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint64_t t60, t61, t62, t63, t64, t65, t66, t67;
+    uint64_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7];
+    x1 = q[6];
+    x2 = q[5];
+    x3 = q[4];
+    x4 = q[3];
+    x5 = q[2];
+    x6 = q[1];
+    x7 = q[0];
+
+    // Top linear transformation
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    // Non-linear section: inversion in GF(2^8) through GF(2^4)
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    // Bottom linear transformation, including the affine constant
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+static uint64_t aes_le64(const uint8_t *p) {
+    uint64_t val = 0;
+    int i;
+    for (i = 7; i >= 0; i--) {
+        val = (val << 8) | p[i];
+    }
+    return val;
+}
+
+static void aes_write_le64(uint8_t *p, uint64_t val) {
+    int i;
+    for (i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(val >> (8 * i));
+    }
+}
+
+/**
+ * Exchange the bits of x selected by mask with the bits `shift` positions above them
+ */
+static uint64_t aes_swapmove(uint64_t x, uint64_t mask, int shift) {
+    uint64_t t = ((x >> shift) ^ x) & mask;
+    return x ^ t ^ (t << shift);
+}
+
+/**
+ * Transpose an 8x8 bit matrix: bit j of byte k moves to bit k of byte j
+ */
+static uint64_t aes_transpose8(uint64_t x) {
+    x = aes_swapmove(x, 0x00aa00aa00aa00aaULL, 7);
+    x = aes_swapmove(x, 0x0000cccc0000ccccULL, 14);
+    x = aes_swapmove(x, 0x00000000f0f0f0f0ULL, 28);
+    return x;
+}
+
+/**
+ * Exchange the bytes of a selected by mask with the bytes of b `shift` positions below them
+ */
+static void aes_swap_words(uint64_t *a, uint64_t *b, uint64_t mask, int shift) {
+    uint64_t t = ((*a >> shift) ^ *b) & mask;
+    *b ^= t;
+    *a ^= t << shift;
+}
+
+/**
+ * Transpose eight words as an 8x8 byte matrix: byte j of w[i] moves to byte i of w[j]
+ */
+static void aes_transpose_bytes(uint64_t w[8]) {
+    aes_swap_words(&w[0], &w[1], 0x00ff00ff00ff00ffULL, 8);
+    aes_swap_words(&w[2], &w[3], 0x00ff00ff00ff00ffULL, 8);
+    aes_swap_words(&w[4], &w[5], 0x00ff00ff00ff00ffULL, 8);
+    aes_swap_words(&w[6], &w[7], 0x00ff00ff00ff00ffULL, 8);
+    aes_swap_words(&w[0], &w[2], 0x0000ffff0000ffffULL, 16);
+    aes_swap_words(&w[1], &w[3], 0x0000ffff0000ffffULL, 16);
+    aes_swap_words(&w[4], &w[6], 0x0000ffff0000ffffULL, 16);
+    aes_swap_words(&w[5], &w[7], 0x0000ffff0000ffffULL, 16);
+    aes_swap_words(&w[0], &w[4], 0x00000000ffffffffULL, 32);
+    aes_swap_words(&w[1], &w[5], 0x00000000ffffffffULL, 32);
+    aes_swap_words(&w[2], &w[6], 0x00000000ffffffffULL, 32);
+    aes_swap_words(&w[3], &w[7], 0x00000000ffffffffULL, 32);
+}
+
+/**
+ * Reorder the bits of a plane from 16 * block + 4 * column + row to 16 * row + 4 * column + block
+ * (swaps the two low index bits with the two high ones, so it is its own inverse)
+ */
+static uint64_t aes_swap_row_block(uint64_t x) {
+    x = aes_swapmove(x, 0x0000aaaa0000aaaaULL, 15);
+    x = aes_swapmove(x, 0x00000000ccccccccULL, 30);
+    return x;
+}
+
+/**
+ * Four 16-byte blocks to bitsliced form: split each 8-byte half block into bit
+ * planes, gather plane b of all halves into q[b], then move rows and blocks into place
+ */
+static void aes_pack(const uint8_t in[64], uint64_t q[8]) {
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        q[i] = aes_transpose8(aes_le64(in + 8 * i));
+    }
+    aes_transpose_bytes(q);
+    for (i = 0; i < 8; i++) {
+        q[i] = aes_swap_row_block(q[i]);
+    }
+}
+
+/**
+ * Inverse of aes_pack; every step is an involution
+ */
+static void aes_unpack(const uint64_t q[8], uint8_t out[64]) {
+    uint64_t w[8];
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        w[i] = aes_swap_row_block(q[i]);
+    }
+    aes_transpose_bytes(w);
+    for (i = 0; i < 8; i++) {
+        aes_write_le64(out + 8 * i, aes_transpose8(w[i]));
+    }
+}
+
+/**
+ * ShiftRows: row r rotates right by r columns (4 bits per column)
+ */
+static uint64_t aes_shift_rows_word(uint64_t x) {
+    return (x & 0x000000000000ffffULL)
+         | ((x & 0x00000000fff00000ULL) >> 4) | ((x & 0x00000000000f0000ULL) << 12)
+         | ((x & 0x0000ff0000000000ULL) >> 8) | ((x & 0x000000ff00000000ULL) << 8)
+         | ((x & 0xf000000000000000ULL) >> 12) | ((x & 0x0fff000000000000ULL) << 4);
+}
+
+static uint64_t aes_rotr(uint64_t x, int n) {
+    return (x >> n) | (x << (64 - n));
+}
+
+/**
+ * MixColumns: out_r = 2 * (a_r ^ a_r+1) ^ a_r+1 ^ a_r+2 ^ a_r+3
+ */
+static void aes_mix_columns(uint64_t q[8]) {
+    uint64_t t[8], r[8];
+    int b;
+
+    for (b = 0; b < 8; b++) {
+        uint64_t r1 = aes_rotr(q[b], 16);
+        t[b] = q[b] ^ r1;
+        r[b] = r1 ^ aes_rotr(q[b], 32) ^ aes_rotr(q[b], 48);
+    }
+    // Multiplication by x modulo x^8 + x^4 + x^3 + x + 1
+    q[0] = t[7] ^ r[0];
+    q[1] = t[0] ^ t[7] ^ r[1];
+    q[2] = t[1] ^ r[2];
+    q[3] = t[2] ^ t[7] ^ r[3];
+    q[4] = t[3] ^ t[7] ^ r[4];
+    q[5] = t[4] ^ r[5];
+    q[6] = t[5] ^ r[6];
+    q[7] = t[6] ^ r[7];
+}
+
+static void aes_add_round_key(uint64_t q[8], const uint64_t rk[8]) {
+    int b;
+
+    for (b = 0; b < 8; b++) {
+        q[b] ^= rk[b];
+    }
+}
+
+/**
+ * Encrypt four blocks
+ */
+static void aes_encrypt4_bitsliced(const aes_key_t *key, const uint8_t in[64], uint8_t out[64]) {
+    uint64_t q[8];
+    int round, b;
+
+    aes_pack(in, q);
+    aes_add_round_key(q, key->sliced_keys[0]);
+    for (round = 1; round < key->rounds; round++) {
+        aes_sbox_sliced(q);
+        for (b = 0; b < 8; b++) {
+            q[b] = aes_shift_rows_word(q[b]);
+        }
+        aes_mix_columns(q);
+        aes_add_round_key(q, key->sliced_keys[round]);
+    }
+    aes_sbox_sliced(q);
+    for (b = 0; b < 8; b++) {
+        q[b] = aes_shift_rows_word(q[b]);
+    }
+    aes_add_round_key(q, key->sliced_keys[key->rounds]);
+    aes_unpack(q, out);
+    aes_wipe(q, sizeof(q));
+}
+
+static void aes_encrypt_block_bitsliced(const aes_key_t *key, const uint8_t in[16], uint8_t out[16]) {
+    uint8_t blocks[64] = {0};
+
+    memcpy(blocks, in, 16);
+    aes_encrypt4_bitsliced(key, blocks, blocks);
+    memcpy(out, blocks, 16);
+    aes_wipe(blocks, sizeof(blocks));
+}
+
+static void aes_ctr32_bitsliced(const aes_key_t *key, const uint8_t counter[16],
+                                const uint8_t *in, uint8_t *out, size_t blocks) {
+    uint8_t ctr[64], keystream[64];
+    uint32_t c = aes_be32(counter + 12);
+    int j;
+
+    for (j = 0; j < 4; j++) {
+        memcpy(ctr + 16 * j, counter, 12);
+    }
+    while (blocks > 0) {
+        size_t n = blocks < 4 ? blocks : 4;
+
+        for (j = 0; j < 4; j++) {
+            aes_write_be32(ctr + 16 * j + 12, c + (uint32_t)j);
+        }
+        aes_encrypt4_bitsliced(key, ctr, keystream);
+        aes_xor(out, in, keystream, n * 16);
+
+        c += (uint32_t)n;
+        in += n * 16;
+        out += n * 16;
+        blocks -= n;
+    }
+    aes_wipe(keystream, sizeof(keystream));
+}
+
+/*
+ * Constant-time GHASH: carry-less multiplication with integer multiplies on
+ * operands whose bits are spread four apart, so carries land in bits that are masked off
+ */
+
+static uint64_t aes_bmul64(uint64_t x, uint64_t y) {
+    const uint64_t m0 = 0x1111111111111111ULL;
+    const uint64_t m1 = 0x2222222222222222ULL;
+    const uint64_t m2 = 0x4444444444444444ULL;
+    const uint64_t m3 = 0x8888888888888888ULL;
+    uint64_t x0 = x & m0, x1 = x & m1, x2 = x & m2, x3 = x & m3;
+    uint64_t y0 = y & m0, y1 = y & m1, y2 = y & m2, y3 = y & m3;
+    uint64_t z0, z1, z2, z3;
+
+    z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+    return (z0 & m0) | (z1 & m1) | (z2 & m2) | (z3 & m3);
+}
+
+static uint64_t aes_rev64(uint64_t x) {
+    x = ((x & 0x5555555555555555ULL) << 1) | ((x >> 1) & 0x5555555555555555ULL);
+    x = ((x & 0x3333333333333333ULL) << 2) | ((x >> 2) & 0x3333333333333333ULL);
+    x = ((x & 0x0f0f0f0f0f0f0f0fULL) << 4) | ((x >> 4) & 0x0f0f0f0f0f0f0f0fULL);
+    x = ((x & 0x00ff00ff00ff00ffULL) << 8) | ((x >> 8) & 0x00ff00ff00ff00ffULL);
+    x = ((x & 0x0000ffff0000ffffULL) << 16) | ((x >> 16) & 0x0000ffff0000ffffULL);
+    return (x << 32) | (x >> 32);
+}
+
+/**
+ * x = (x ^ data) * h for each block of data
+ */
+static void aes_ghash_mul(const uint8_t h[16], uint8_t x[16], const uint8_t *data, size_t blocks) {
+    uint64_t y1 = aes_be64(h);
+    uint64_t y0 = aes_be64(h + 8);
+    uint64_t y1r = aes_rev64(y1), y0r = aes_rev64(y0);
+    uint64_t y2 = y0 ^ y1, y2r = y0r ^ y1r;
+    uint64_t z1 = aes_be64(x);
+    uint64_t z0 = aes_be64(x + 8);
+
+    while (blocks--) {
+        uint64_t z0r, z1r, z2, z2r, z0h, z1h, z2h;
+        uint64_t v0, v1, v2, v3;
+
+        z1 ^= aes_be64(data);
+        z0 ^= aes_be64(data + 8);
+
+        // Karatsuba on bit-reversed operands gives the high halves
+        z0r = aes_rev64(z0);
+        z1r = aes_rev64(z1);
+        z2 = z0 ^ z1;
+        z2r = z0r ^ z1r;
+        z0h = aes_bmul64(y0r, z0r);
+        z1h = aes_bmul64(y1r, z1r);
+        z2h = aes_bmul64(y2r, z2r);
+        z0 = aes_bmul64(y0, z0);
+        z1 = aes_bmul64(y1, z1);
+        z2 = aes_bmul64(y2, z2);
+        z2 ^= z0 ^ z1;
+        z2h ^= z0h ^ z1h;
+        z0h = aes_rev64(z0h) >> 1;
+        z1h = aes_rev64(z1h) >> 1;
+        z2h = aes_rev64(z2h) >> 1;
+
+        v0 = z0;
+        v1 = z0h ^ z2;
+        v2 = z1 ^ z2h;
+        v3 = z1h;
+
+        // GCM bit order: shift the 255-bit product left by one, then reduce
+        v3 = (v3 << 1) | (v2 >> 63);
+        v2 = (v2 << 1) | (v1 >> 63);
+        v1 = (v1 << 1) | (v0 >> 63);
+        v0 = (v0 << 1);
+
+        v2 ^= v0 ^ (v0 >> 1) ^ (v0 >> 2) ^ (v0 >> 7);
+        v1 ^= (v0 << 63) ^ (v0 << 62) ^ (v0 << 57);
+        v3 ^= v1 ^ (v1 >> 1) ^ (v1 >> 2) ^ (v1 >> 7);
+        v2 ^= (v1 << 63) ^ (v1 << 62) ^ (v1 << 57);
+
+        z0 = v2;
+        z1 = v3;
+        data += 16;
+    }
+
+    aes_write_be64(x, z1);
+    aes_write_be64(x + 8, z0);
+}
+
+static void aes_ghash_ct(const uint8_t h_powers[8][16], uint8_t x[16], const uint8_t *data, size_t blocks) {
+    aes_ghash_mul(h_powers[0], x, data, blocks);
+}
+
+/*
+ * Key expansion (shared by both backends)
+ */
+
+/**
+ * SubWord through the bitsliced S-box, so the key schedule has no table lookups either
+ */
+static uint32_t aes_sub_word(uint32_t w) {
+    uint64_t q[8];
+    uint32_t r = 0;
+    int b, j;
+
+    for (b = 0; b < 8; b++) {
+        q[b] = 0;
+        for (j = 0; j < 4; j++) {
+            q[b] |= (uint64_t)((w >> (8 * j + b)) & 1) << j;
+        }
+    }
+    aes_sbox_sliced(q);
+    for (b = 0; b < 8; b++) {
+        for (j = 0; j < 4; j++) {
+            r |= (uint32_t)((q[b] >> j) & 1) << (8 * j + b);
+        }
+    }
+    return r;
+}
+
+int aes_init(aes_key_t *key, const uint8_t *key_bytes, size_t key_len) {
+    uint32_t w[4 * (AES_MAX_ROUNDS + 1)];
+    uint8_t blocks[64];
+    uint8_t rcon = 1;
+    int nk, total, i, j;
+
+    if (key_len != 16 && key_len != 24 && key_len != 32) {
+        return -1;
+    }
+    nk = (int)key_len / 4;
+    key->rounds = nk + 6;
+    total = 4 * (key->rounds + 1);
+
+    // Words are kept with the first key byte in the low 8 bits
+    for (i = 0; i < nk; i++) {
+        w[i] = (uint32_t)key_bytes[4 * i] | ((uint32_t)key_bytes[4 * i + 1] << 8) |
+               ((uint32_t)key_bytes[4 * i + 2] << 16) | ((uint32_t)key_bytes[4 * i + 3] << 24);
+    }
+    for (i = nk; i < total; i++) {
+        uint32_t t = w[i - 1];
+        if (i % nk == 0) {
+            t = aes_sub_word((t >> 8) | (t << 24)) ^ rcon;
+            rcon = (uint8_t)((rcon << 1) ^ (0x1b & -(rcon >> 7)));
+        } else if (nk > 6 && i % nk == 4) {
+            t = aes_sub_word(t);
+        }
+        w[i] = w[i - nk] ^ t;
+    }
+
+    for (i = 0; i <= key->rounds; i++) {
+        for (j = 0; j < 4; j++) {
+            uint32_t t = w[4 * i + j];
+            key->round_keys[i][4 * j] = (uint8_t)t;
+            key->round_keys[i][4 * j + 1] = (uint8_t)(t >> 8);
+            key->round_keys[i][4 * j + 2] = (uint8_t)(t >> 16);
+            key->round_keys[i][4 * j + 3] = (uint8_t)(t >> 24);
+        }
+        // The same round key for all four bitsliced blocks
+        for (j = 0; j < 4; j++) {
+            memcpy(blocks + 16 * j, key->round_keys[i], 16);
+        }
+        aes_pack(blocks, key->sliced_keys[i]);
+    }
+
+    aes_wipe(w, sizeof(w));
+    aes_wipe(blocks, sizeof(blocks));
+    return 0;
+}
+
+/*
+ * Backend dispatch
+ */
+
+typedef struct {
+    aes_backend_t backend;
+    aes_block_fn encrypt_block;
+    aes_ctr32_fn ctr32;
+    aes_ghash_fn ghash;
+} aes_impl_t;
+
+static const aes_impl_t aes_impl_bitsliced = {
+    AES_BACKEND_BITSLICED, aes_encrypt_block_bitsliced, aes_ctr32_bitsliced, aes_ghash_ct
+};
+
+#if AES_HAVE_X86_NI
+static const aes_impl_t aes_impl_ni = {
+    AES_BACKEND_AESNI, aes_encrypt_block_ni, aes_ctr32_ni, aes_ghash_clmul
+};
+#endif
+
+static pthread_once_t aes_dispatch_once = PTHREAD_ONCE_INIT;
+static const aes_impl_t *aes_active = &aes_impl_bitsliced;
+
+static const char *const aes_backend_names[] = {
+    "auto", "bitsliced", "aesni"
+};
+
+/**
+ * Implementation of a backend, NULL if this build or CPU cannot run it
+ */
+static const aes_impl_t *aes_backend_impl(aes_backend_t backend) {
+    switch (backend) {
+    case AES_BACKEND_BITSLICED:
+        return &aes_impl_bitsliced;
+#if AES_HAVE_X86_NI
+    case AES_BACKEND_AESNI:
+        return __builtin_cpu_supports("aes") && __builtin_cpu_supports("pclmul") &&
+               __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("ssse3")
+               ? &aes_impl_ni : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+static void aes_dispatch_init(void) {
+    const aes_impl_t *impl = aes_backend_impl(AES_BACKEND_AESNI);
+
+    aes_active = impl ? impl : &aes_impl_bitsliced;
+}
+
+static const aes_impl_t *aes_impl(void) {
+    pthread_once(&aes_dispatch_once, aes_dispatch_init);
+    return aes_active;
+}
+
+int aes_set_backend(aes_backend_t backend) {
+    const aes_impl_t *impl;
+
+    pthread_once(&aes_dispatch_once, aes_dispatch_init);
+    if (backend == AES_BACKEND_AUTO) {
+        aes_dispatch_init();
+        return 0;
+    }
+
+    impl = aes_backend_impl(backend);
+    if (!impl) {
+        return -1;
+    }
+    aes_active = impl;
+    return 0;
+}
+
+aes_backend_t aes_get_backend(void) {
+    return aes_impl()->backend;
+}
+
+int aes_backend_supported(aes_backend_t backend) {
+    return backend == AES_BACKEND_AUTO || aes_backend_impl(backend) != NULL;
+}
+
+const char *aes_backend_name(aes_backend_t backend) {
+    if (backend >= AES_BACKEND_AUTO && backend <= AES_BACKEND_AESNI) {
+        return aes_backend_names[backend];
+    }
+    return "unknown";
+}
+
+void aes_encrypt_block(const aes_key_t *key, const uint8_t input[AES_BLOCK_SIZE], uint8_t output[AES_BLOCK_SIZE]) {
+    aes_impl()->encrypt_block(key, input, output);
+}
+
+/*
+ * CTR mode
+ */
+
+/**
+ * Advance the counter block by n blocks
+ */
+static void aes_ctr_advance(aes_ctr_ctx_t *ctx, uint32_t n) {
+    uint32_t low = aes_be32(ctx->counter + 12);
+    uint32_t next = low + n;
+    int i;
+
+    aes_write_be32(ctx->counter + 12, next);
+    if (!ctx->counter32 && next < low) {
+        // Carry into the upper 96 bits
+        for (i = 11; i >= 0; i--) {
+            if (++ctx->counter[i] != 0) {
+                break;
+            }
+        }
+    }
+}
+
+static void aes_ctr_process(aes_ctr_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length) {
+    const aes_impl_t *impl = aes_impl();
+    size_t blocks;
+
+    // Finish the partially used keystream block
+    while (length > 0 && ctx->keystream_pos < 16) {
+        *output++ = *input++ ^ ctx->keystream[ctx->keystream_pos++];
+        length--;
+    }
+
+    // Whole blocks go straight to the kernel; a 128-bit counter is split where its low word wraps
+    blocks = length / 16;
+    while (blocks > 0) {
+        size_t n = blocks;
+        if (!ctx->counter32) {
+            uint64_t until_wrap = ((uint64_t)1 << 32) - aes_be32(ctx->counter + 12);
+            if (n > until_wrap) {
+                n = (size_t)until_wrap;
+            }
+        }
+        if (n > 0x10000000) {
+            n = 0x10000000;
+        }
+        impl->ctr32(&ctx->key, ctx->counter, input, output, n);
+        aes_ctr_advance(ctx, (uint32_t)n);
+        input += n * 16;
+        output += n * 16;
+        length -= n * 16;
+        blocks -= n;
+    }
+
+    // Keep the rest of the last block for the next call
+    if (length > 0) {
+        impl->encrypt_block(&ctx->key, ctx->counter, ctx->keystream);
+        aes_ctr_advance(ctx, 1);
+        aes_xor(output, input, ctx->keystream, length);
+        ctx->keystream_pos = length;
+    }
+}
+
+int aes_ctr_init(aes_ctr_ctx_t *ctx, const uint8_t *key_bytes, size_t key_len, const uint8_t iv[AES_BLOCK_SIZE]) {
+    if (aes_init(&ctx->key, key_bytes, key_len) != 0) {
+        return -1;
+    }
+    memcpy(ctx->counter, iv, 16);
+    ctx->keystream_pos = 16;
+    ctx->counter32 = 0;
+    return 0;
+}
+
+void aes_ctr_encrypt(aes_ctr_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length) {
+    aes_ctr_process(ctx, input, output, length);
+}
+
+void aes_ctr_decrypt(aes_ctr_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length) {
+    // CTR is a stream mode, so decryption is the same as encryption
+    aes_ctr_process(ctx, input, output, length);
+}
+
+/*
+ * GCM
+ */
+
+static void aes_gcm_hash(aes_gcm_ctx_t *ctx, const uint8_t *data, size_t length) {
+    aes_ghash_fn ghash = aes_impl()->ghash;
+
+    // Top up a partial block first
+    if (ctx->buffer_len > 0) {
+        size_t want = 16 - ctx->buffer_len;
+        if (want > length) {
+            want = length;
+        }
+        memcpy(ctx->buffer + ctx->buffer_len, data, want);
+        ctx->buffer_len += want;
+        data += want;
+        length -= want;
+        if (ctx->buffer_len < 16) {
+            return;
+        }
+        ghash(ctx->h_powers, ctx->ghash, ctx->buffer, 1);
+        ctx->buffer_len = 0;
+    }
+
+    if (length >= 16) {
+        size_t blocks = length / 16;
+        ghash(ctx->h_powers, ctx->ghash, data, blocks);
+        data += blocks * 16;
+        length -= blocks * 16;
+    }
+
+    if (length > 0) {
+        memcpy(ctx->buffer, data, length);
+        ctx->buffer_len = length;
+    }
+}
+
+/**
+ * Zero-pad the pending partial block
+ */
+static void aes_gcm_pad(aes_gcm_ctx_t *ctx) {
+    if (ctx->buffer_len > 0) {
+        memset(ctx->buffer + ctx->buffer_len, 0, 16 - ctx->buffer_len);
+        aes_impl()->ghash(ctx->h_powers, ctx->ghash, ctx->buffer, 1);
+        ctx->buffer_len = 0;
+    }
+}
+
+int aes_gcm_init(aes_gcm_ctx_t *ctx, const uint8_t *key_bytes, size_t key_len,
+                 const uint8_t *iv, size_t iv_len) {
+    static const uint8_t zero[16] = {0};
+    int i;
+
+    if (iv_len == 0 || aes_init(&ctx->ctr.key, key_bytes, key_len) != 0) {
+        return -1;
+    }
+
+    // H and its powers; the portable multiply keeps this independent of the backend
+    aes_encrypt_block(&ctx->ctr.key, zero, ctx->h);
+    memcpy(ctx->h_powers[0], ctx->h, 16);
+    for (i = 1; i < 8; i++) {
+        memset(ctx->h_powers[i], 0, 16);
+        aes_ghash_mul(ctx->h, ctx->h_powers[i], ctx->h_powers[i - 1], 1);
+    }
+
+    memset(ctx->ghash, 0, 16);
+    ctx->buffer_len = 0;
+    if (iv_len == AES_GCM_IV_SIZE) {
+        memcpy(ctx->j0, iv, 12);
+        aes_write_be32(ctx->j0 + 12, 1);
+    } else {
+        // J0 = GHASH(IV || 0 padding || [0]64 || [len(IV) in bits]64)
+        uint8_t lengths[16] = {0};
+        aes_gcm_hash(ctx, iv, iv_len);
+        aes_gcm_pad(ctx);
+        aes_write_be64(lengths + 8, (uint64_t)iv_len * 8);
+        aes_gcm_hash(ctx, lengths, 16);
+        memcpy(ctx->j0, ctx->ghash, 16);
+        memset(ctx->ghash, 0, 16);
+    }
+
+    memcpy(ctx->ctr.counter, ctx->j0, 16);
+    ctx->ctr.counter32 = 1;
+    ctx->ctr.keystream_pos = 16;
+    aes_ctr_advance(&ctx->ctr, 1);
+
+    ctx->aad_len = 0;
+    ctx->data_len = 0;
+    ctx->data_started = 0;
+    return 0;
+}
+
+int aes_gcm_update_aad(aes_gcm_ctx_t *ctx, const uint8_t *aad, size_t length) {
+    if (ctx->data_started || length > AES_GCM_MAX_AAD - ctx->aad_len) {
+        return -1;
+    }
+    aes_gcm_hash(ctx, aad, length);
+    ctx->aad_len += length;
+    return 0;
+}
+
+/**
+ * Pad the AAD to a block boundary before the first ciphertext byte
+ */
+static void aes_gcm_start_data(aes_gcm_ctx_t *ctx) {
+    if (!ctx->data_started) {
+        aes_gcm_pad(ctx);
+        ctx->data_started = 1;
+    }
+}
+
+/**
+ * Account for `length` more message bytes
+ * @return 0 on success, -1 if the 32-bit counter would wrap back to J0
+ */
+static int aes_gcm_add_data(aes_gcm_ctx_t *ctx, uint64_t length) {
+    if (length > AES_GCM_MAX_DATA - ctx->data_len) {
+        return -1;
+    }
+    aes_gcm_start_data(ctx);
+    ctx->data_len += length;
+    return 0;
+}
+
+int aes_gcm_encrypt(aes_gcm_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length) {
+    if (aes_gcm_add_data(ctx, length) != 0) {
+        return -1;
+    }
+
+    while (length > 0) {
+        size_t n = length < AES_GCM_CHUNK_SIZE ? length : AES_GCM_CHUNK_SIZE;
+        aes_ctr_process(&ctx->ctr, input, output, n);
+        aes_gcm_hash(ctx, output, n);
+        input += n;
+        output += n;
+        length -= n;
+    }
+    return 0;
+}
+
+int aes_gcm_decrypt(aes_gcm_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length) {
+    if (aes_gcm_add_data(ctx, length) != 0) {
+        return -1;
+    }
+
+    while (length > 0) {
+        size_t n = length < AES_GCM_CHUNK_SIZE ? length : AES_GCM_CHUNK_SIZE;
+        // Hash the ciphertext before an in-place decrypt overwrites it
+        aes_gcm_hash(ctx, input, n);
+        aes_ctr_process(&ctx->ctr, input, output, n);
+        input += n;
+        output += n;
+        length -= n;
+    }
+    return 0;
+}
+
+/**
+ * Full 16-byte tag
+ */
+static void aes_gcm_tag(aes_gcm_ctx_t *ctx, uint8_t tag[AES_GCM_TAG_SIZE]) {
+    uint8_t lengths[16];
+    uint8_t mask[16];
+
+    aes_gcm_start_data(ctx);
+    aes_gcm_pad(ctx);
+    aes_write_be64(lengths, ctx->aad_len * 8);
+    aes_write_be64(lengths + 8, ctx->data_len * 8);
+    aes_gcm_hash(ctx, lengths, 16);
+
+    aes_encrypt_block(&ctx->ctr.key, ctx->j0, mask);
+    aes_xor(tag, ctx->ghash, mask, 16);
+
+    aes_wipe(mask, sizeof(mask));
+    aes_wipe(ctx, sizeof(*ctx));
+}
+
+/**
+ * Tag lengths SP 800-38D allows; shorter tags make forgeries too likely
+ */
+static int aes_gcm_tag_len_valid(size_t tag_len) {
+    return (tag_len >= AES_GCM_MIN_TAG_SIZE && tag_len <= AES_GCM_TAG_SIZE) ||
+           tag_len == 8 || tag_len == 4;
+}
+
+int aes_gcm_final(aes_gcm_ctx_t *ctx, uint8_t *tag, size_t tag_len) {
+    uint8_t full[AES_GCM_TAG_SIZE];
+
+    aes_gcm_tag(ctx, full);
+    if (!aes_gcm_tag_len_valid(tag_len)) {
+        aes_wipe(full, sizeof(full));
+        return -1;
+    }
+    memcpy(tag, full, tag_len);
+    aes_wipe(full, sizeof(full));
+    return 0;
+}
+
+int aes_gcm_verify(aes_gcm_ctx_t *ctx, const uint8_t *tag, size_t tag_len) {
+    uint8_t expected[AES_GCM_TAG_SIZE];
+    uint8_t diff = 0;
+    size_t i;
+
+    aes_gcm_tag(ctx, expected);
+    if (!aes_gcm_tag_len_valid(tag_len)) {
+        aes_wipe(expected, sizeof(expected));
+        return -1;
+    }
+    for (i = 0; i < tag_len; i++) {
+        diff |= expected[i] ^ tag[i];
+    }
+    aes_wipe(expected, sizeof(expected));
+    return diff == 0 ? 0 : -1;
+}
+
+int aes_gcm_seal(const uint8_t *key_bytes, size_t key_len, const uint8_t *iv, size_t iv_len,
+                 const uint8_t *aad, size_t aad_len,
+                 const uint8_t *input, size_t length, uint8_t *output,
+                 uint8_t tag[AES_GCM_TAG_SIZE]) {
+    aes_gcm_ctx_t ctx;
+
+    if (aes_gcm_init(&ctx, key_bytes, key_len, iv, iv_len) != 0) {
+        return -1;
+    }
+    if (aes_gcm_update_aad(&ctx, aad, aad_len) != 0 ||
+        aes_gcm_encrypt(&ctx, input, output, length) != 0) {
+        aes_wipe(&ctx, sizeof(ctx));
+        return -1;
+    }
+    aes_gcm_final(&ctx, tag, AES_GCM_TAG_SIZE);
+    return 0;
+}
+
+int aes_gcm_open(const uint8_t *key_bytes, size_t key_len, const uint8_t *iv, size_t iv_len,
+                 const uint8_t *aad, size_t aad_len,
+                 const uint8_t *input, size_t length,
+                 const uint8_t tag[AES_GCM_TAG_SIZE], uint8_t *output) {
+    aes_gcm_ctx_t ctx;
+    aes_ctr_ctx_t cipher;
+    int ret;
+
+    if (aes_gcm_init(&ctx, key_bytes, key_len, iv, iv_len) != 0) {
+        return -1;
+    }
+    cipher = ctx.ctr;
+
+    // Authenticate everything first, then decrypt
+    if (aes_gcm_update_aad(&ctx, aad, aad_len) != 0 || aes_gcm_add_data(&ctx, length) != 0) {
+        aes_wipe(&ctx, sizeof(ctx));
+        aes_wipe(&cipher, sizeof(cipher));
+        return -1;
+    }
+    aes_gcm_hash(&ctx, input, length);
+    ret = aes_gcm_verify(&ctx, tag, AES_GCM_TAG_SIZE);
+
+    if (ret == 0) {
+        aes_ctr_process(&cipher, input, output, length);
+    } else if (output != input) {
+        memset(output, 0, length);
+    }
+    aes_wipe(&cipher, sizeof(cipher));
+    return ret;
+}
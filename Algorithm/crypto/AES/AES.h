@@ -0,0 +1,245 @@
+#ifndef AES_H
+#define AES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * AES block cipher (FIPS-197) with CTR (SP 800-38A) and GCM (SP 800-38D) modes
+ * Uses AES-NI and PCLMULQDQ when the CPU has them; otherwise a bitsliced
+ * implementation without secret-dependent table lookups or branches.
+ */
+
+#define AES_BLOCK_SIZE 16
+#define AES_MAX_ROUNDS 14
+#define AES_GCM_IV_SIZE 12
+#define AES_GCM_TAG_SIZE 16
+
+// SP 800-38D limits per (key, IV): 2^32 - 2 blocks of plaintext, so inc32 never returns to J0,
+// and 2^64 - 1 bits of AAD
+#define AES_GCM_MAX_DATA ((UINT64_C(1) << 36) - 32)
+#define AES_GCM_MAX_AAD ((UINT64_C(1) << 61) - 1)
+
+// SP 800-38D tag lengths: 16, 15, 14, 13 or 12 bytes; 8 and 4 only for applications
+// that bound the message length and the number of forgery attempts (Appendix C)
+#define AES_GCM_MIN_TAG_SIZE 12
+
+/**
+ * Implementations
+ */
+typedef enum {
+    AES_BACKEND_AUTO = 0,       // Fastest backend the CPU supports
+    AES_BACKEND_BITSLICED,      // Portable constant-time C, 4 blocks at a time
+    AES_BACKEND_AESNI           // AES-NI + PCLMULQDQ, 8 blocks in flight
+} aes_backend_t;
+
+/**
+ * Expanded key
+ */
+typedef struct {
+    uint8_t round_keys[AES_MAX_ROUNDS + 1][16];     // FIPS-197 round keys
+    uint64_t sliced_keys[AES_MAX_ROUNDS + 1][8];    // Round keys in bitsliced form
+    int rounds;                                     // 10, 12 or 14
+} aes_key_t;
+
+/**
+ * CTR mode context
+ */
+typedef struct {
+    aes_key_t key;
+    uint8_t counter[16];        // Next counter block
+    uint8_t keystream[16];      // Generated keystream block
+    size_t keystream_pos;       // Position in current keystream block
+    int counter32;              // Increment only the last 32 bits (GCM); 0 for the full 128 bits
+} aes_ctr_ctx_t;
+
+/**
+ * GCM context
+ * Usage: init, any number of update_aad calls, any number of encrypt (or decrypt)
+ * calls, then final (sender) or verify (receiver).
+ */
+typedef struct {
+    aes_ctr_ctx_t ctr;          // Keystream, starts at inc32(J0)
+    uint8_t j0[16];             // Pre-counter block, encrypted into the tag
+    uint8_t h[16];              // Hash subkey E(K, 0)
+    uint8_t h_powers[8][16];    // H^1..H^8 for the PCLMULQDQ backend
+    uint8_t ghash[16];          // Running GHASH value
+    uint8_t buffer[16];         // Partial GHASH block
+    size_t buffer_len;          // Bytes in buffer
+    uint64_t aad_len;           // AAD bytes so far
+    uint64_t data_len;          // Ciphertext bytes so far
+    int data_started;           // Set once the AAD has been padded
+} aes_gcm_ctx_t;
+
+/**
+ * Expand a key
+ * @param key Expanded key
+ * @param key_bytes 16, 24 or 32-byte key
+ * @param key_len Key length in bytes
+ * @return 0 on success, -1 for an invalid key length
+ */
+int aes_init(aes_key_t *key, const uint8_t *key_bytes, size_t key_len);
+
+/**
+ * Encrypt one block
+ * @param key Expanded key
+ * @param input 16-byte plaintext block
+ * @param output 16-byte ciphertext block (can be the same as input)
+ */
+void aes_encrypt_block(const aes_key_t *key, const uint8_t input[AES_BLOCK_SIZE], uint8_t output[AES_BLOCK_SIZE]);
+
+/**
+ * Initialize CTR mode
+ * @param ctx CTR context
+ * @param key_bytes 16, 24 or 32-byte key
+ * @param key_len Key length in bytes
+ * @param iv 16-byte initial counter block, incremented as a 128-bit big-endian number
+ * @return 0 on success, -1 for an invalid key length
+ */
+int aes_ctr_init(aes_ctr_ctx_t *ctx, const uint8_t *key_bytes, size_t key_len, const uint8_t iv[AES_BLOCK_SIZE]);
+
+/**
+ * Encrypt/decrypt data in CTR mode
+ * @param ctx CTR context
+ * @param input Input data
+ * @param output Output buffer (can be the same as input for in-place operation)
+ * @param length Length of data in bytes
+ */
+void aes_ctr_encrypt(aes_ctr_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length);
+
+/**
+ * Decrypt data in CTR mode (same as encrypt)
+ */
+void aes_ctr_decrypt(aes_ctr_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length);
+
+/**
+ * Initialize GCM
+ * @param ctx GCM context
+ * @param key_bytes 16, 24 or 32-byte key
+ * @param key_len Key length in bytes
+ * @param iv IV, AES_GCM_IV_SIZE bytes recommended
+ * @param iv_len IV length in bytes, at least 1
+ * @return 0 on success, -1 for an invalid key or IV length
+ */
+int aes_gcm_init(aes_gcm_ctx_t *ctx, const uint8_t *key_bytes, size_t key_len,
+                 const uint8_t *iv, size_t iv_len);
+
+/**
+ * Add associated data (authenticated, not encrypted)
+ * @param ctx GCM context
+ * @param aad Associated data
+ * @param length Length of aad in bytes
+ * @return 0 on success, -1 if encryption or decryption has already started
+ *         or the AAD would exceed AES_GCM_MAX_AAD
+ */
+int aes_gcm_update_aad(aes_gcm_ctx_t *ctx, const uint8_t *aad, size_t length);
+
+/**
+ * Encrypt the next part of the message and authenticate the ciphertext
+ * @param ctx GCM context
+ * @param input Plaintext
+ * @param output Ciphertext (can be the same as input)
+ * @param length Length in bytes
+ * @return 0 on success, -1 if the message would exceed AES_GCM_MAX_DATA (nothing is processed)
+ */
+int aes_gcm_encrypt(aes_gcm_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length);
+
+/**
+ * Authenticate and decrypt the next part of the message
+ * The plaintext is not authentic until aes_gcm_verify succeeds;
+ * use aes_gcm_open when it must not be released early.
+ * @param ctx GCM context
+ * @param input Ciphertext
+ * @param output Plaintext (can be the same as input)
+ * @param length Length in bytes
+ * @return 0 on success, -1 if the message would exceed AES_GCM_MAX_DATA (nothing is processed)
+ */
+int aes_gcm_decrypt(aes_gcm_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length);
+
+/**
+ * Output the tag (truncated to the leftmost tag_len bytes); the context is wiped
+ * @param ctx GCM context
+ * @param tag Output tag
+ * @param tag_len Tag length in bytes: 12 to 16, or 8 or 4 (SP 800-38D)
+ * @return 0 on success, -1 if tag_len is not an allowed length (nothing is written)
+ */
+int aes_gcm_final(aes_gcm_ctx_t *ctx, uint8_t *tag, size_t tag_len);
+
+/**
+ * Check a received tag in constant time; the context is wiped
+ * @param ctx GCM context
+ * @param tag Received tag
+ * @param tag_len Tag length in bytes: 12 to 16, or 8 or 4 (SP 800-38D)
+ * @return 0 if the tag is valid, -1 if it is not or tag_len is not an allowed length
+ */
+int aes_gcm_verify(aes_gcm_ctx_t *ctx, const uint8_t *tag, size_t tag_len);
+
+/**
+ * Encrypt and authenticate a whole message
+ * @param key_bytes 16, 24 or 32-byte key
+ * @param key_len Key length in bytes
+ * @param iv IV
+ * @param iv_len IV length in bytes
+ * @param aad Associated data (may be NULL when aad_len is 0)
+ * @param aad_len Length of aad in bytes
+ * @param input Plaintext
+ * @param length Length of plaintext in bytes
+ * @param output Ciphertext, same length as the plaintext (can be the same as input)
+ * @param tag Output 16-byte tag
+ * @return 0 on success, -1 for an invalid key or IV length, or if aad_len or length
+ *         exceeds AES_GCM_MAX_AAD or AES_GCM_MAX_DATA
+ */
+int aes_gcm_seal(const uint8_t *key_bytes, size_t key_len, const uint8_t *iv, size_t iv_len,
+                 const uint8_t *aad, size_t aad_len,
+                 const uint8_t *input, size_t length, uint8_t *output,
+                 uint8_t tag[AES_GCM_TAG_SIZE]);
+
+/**
+ * Verify and decrypt a whole message; nothing is decrypted unless the tag is valid
+ * @param key_bytes 16, 24 or 32-byte key
+ * @param key_len Key length in bytes
+ * @param iv IV
+ * @param iv_len IV length in bytes
+ * @param aad Associated data (may be NULL when aad_len is 0)
+ * @param aad_len Length of aad in bytes
+ * @param input Ciphertext
+ * @param length Length of ciphertext in bytes
+ * @param tag Received 16-byte tag
+ * @param output Plaintext, same length as the ciphertext (can be the same as input)
+ * @return 0 on success, -1 on an invalid key/IV length, a length over the limits,
+ *         or if authentication fails (output is zeroed unless it aliases input)
+ */
+int aes_gcm_open(const uint8_t *key_bytes, size_t key_len, const uint8_t *iv, size_t iv_len,
+                 const uint8_t *aad, size_t aad_len,
+                 const uint8_t *input, size_t length,
+                 const uint8_t tag[AES_GCM_TAG_SIZE], uint8_t *output);
+
+/**
+ * Force a backend (for testing and benchmarking)
+ * Not synchronized with concurrent use; call it before starting threads.
+ * @param backend Backend to use, AES_BACKEND_AUTO restores runtime detection
+ * @return 0 on success, -1 if the backend is not available on this CPU or build
+ */
+int aes_set_backend(aes_backend_t backend);
+
+/**
+ * Get the backend currently in use
+ * @return Active backend (never AES_BACKEND_AUTO)
+ */
+aes_backend_t aes_get_backend(void);
+
+/**
+ * Check whether a backend can run on this CPU and build
+ * @param backend Backend to check
+ * @return 1 if supported, 0 otherwise
+ */
+int aes_backend_supported(aes_backend_t backend);
+
+/**
+ * Get the name of a backend
+ * @param backend Backend
+ * @return Name such as "aesni"
+ */
+const char *aes_backend_name(aes_backend_t backend);
+
+#endif // AES_H
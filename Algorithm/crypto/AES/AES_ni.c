@@ -0,0 +1,202 @@
+#include "AES_ni.h"
+
+#if AES_HAVE_X86_NI
+
+#include <immintrin.h>
+#include <string.h>
+
+#define AES_NI_TARGET __attribute__((target("aes,pclmul,sse4.1,ssse3")))
+
+// Number of CTR blocks in flight; AESENC has a latency of several cycles but a throughput of one or two per cycle
+#define AES_NI_LANES 8
+
+/*
+ * AES-NI
+ */
+
+AES_NI_TARGET
+static void aes_ni_load_keys(const aes_key_t *key, __m128i rk[AES_MAX_ROUNDS + 1]) {
+    int i;
+    for (i = 0; i <= key->rounds; i++) {
+        rk[i] = _mm_loadu_si128((const __m128i *)key->round_keys[i]);
+    }
+}
+
+AES_NI_TARGET
+void aes_encrypt_block_ni(const aes_key_t *key, const uint8_t in[16], uint8_t out[16]) {
+    const __m128i *rk = (const __m128i *)key->round_keys;
+    __m128i x;
+    int r;
+
+    x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)in), _mm_loadu_si128(rk));
+    for (r = 1; r < key->rounds; r++) {
+        x = _mm_aesenc_si128(x, _mm_loadu_si128(rk + r));
+    }
+    x = _mm_aesenclast_si128(x, _mm_loadu_si128(rk + key->rounds));
+    _mm_storeu_si128((__m128i *)out, x);
+}
+
+AES_NI_TARGET
+void aes_ctr32_ni(const aes_key_t *key, const uint8_t counter[16],
+                  const uint8_t *in, uint8_t *out, size_t blocks) {
+    __m128i rk[AES_MAX_ROUNDS + 1];
+    __m128i base = _mm_loadu_si128((const __m128i *)counter);
+    uint32_t c = ((uint32_t)counter[12] << 24) | ((uint32_t)counter[13] << 16) |
+                 ((uint32_t)counter[14] << 8) | (uint32_t)counter[15];
+    int rounds = key->rounds;
+    int r, i;
+
+    aes_ni_load_keys(key, rk);
+
+    // Eight independent blocks per round key so the AESENC pipeline stays full
+    while (blocks >= AES_NI_LANES) {
+        __m128i x[AES_NI_LANES];
+
+        for (i = 0; i < AES_NI_LANES; i++) {
+            x[i] = _mm_insert_epi32(base, (int)__builtin_bswap32(c + (uint32_t)i), 3);
+            x[i] = _mm_xor_si128(x[i], rk[0]);
+        }
+        for (r = 1; r < rounds; r++) {
+            for (i = 0; i < AES_NI_LANES; i++) {
+                x[i] = _mm_aesenc_si128(x[i], rk[r]);
+            }
+        }
+        for (i = 0; i < AES_NI_LANES; i++) {
+            x[i] = _mm_aesenclast_si128(x[i], rk[rounds]);
+            x[i] = _mm_xor_si128(x[i], _mm_loadu_si128((const __m128i *)(in + 16 * i)));
+            _mm_storeu_si128((__m128i *)(out + 16 * i), x[i]);
+        }
+
+        c += AES_NI_LANES;
+        in += 16 * AES_NI_LANES;
+        out += 16 * AES_NI_LANES;
+        blocks -= AES_NI_LANES;
+    }
+
+    while (blocks > 0) {
+        __m128i x = _mm_insert_epi32(base, (int)__builtin_bswap32(c), 3);
+
+        x = _mm_xor_si128(x, rk[0]);
+        for (r = 1; r < rounds; r++) {
+            x = _mm_aesenc_si128(x, rk[r]);
+        }
+        x = _mm_aesenclast_si128(x, rk[rounds]);
+        x = _mm_xor_si128(x, _mm_loadu_si128((const __m128i *)in));
+        _mm_storeu_si128((__m128i *)out, x);
+
+        c++;
+        in += 16;
+        out += 16;
+        blocks--;
+    }
+}
+
+/*
+ * PCLMULQDQ GHASH
+ *
+ * Operands are byte-reversed into little-endian order; the bit-reflected
+ * product is shifted left by one and reduced modulo x^128 + x^7 + x^2 + x + 1.
+ * Eight blocks are multiplied by H^8..H^1 and summed before a single reduction.
+ */
+
+AES_NI_TARGET
+static __m128i aes_ni_bswap(__m128i x) {
+    const __m128i mask = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    return _mm_shuffle_epi8(x, mask);
+}
+
+/**
+ * 256-bit carry-less product, accumulated into lo/hi
+ */
+AES_NI_TARGET
+static void aes_ni_clmul(__m128i a, __m128i b, __m128i *lo, __m128i *hi) {
+    __m128i t0 = _mm_clmulepi64_si128(a, b, 0x00);
+    __m128i t1 = _mm_clmulepi64_si128(a, b, 0x10);
+    __m128i t2 = _mm_clmulepi64_si128(a, b, 0x01);
+    __m128i t3 = _mm_clmulepi64_si128(a, b, 0x11);
+
+    t1 = _mm_xor_si128(t1, t2);
+    *lo = _mm_xor_si128(*lo, _mm_xor_si128(t0, _mm_slli_si128(t1, 8)));
+    *hi = _mm_xor_si128(*hi, _mm_xor_si128(t3, _mm_srli_si128(t1, 8)));
+}
+
+AES_NI_TARGET
+static __m128i aes_ni_reduce(__m128i lo, __m128i hi) {
+    __m128i t0, t1, t2;
+
+    // Shift the 256-bit product left by one bit
+    t0 = _mm_srli_epi32(lo, 31);
+    t1 = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    t2 = _mm_srli_si128(t0, 12);
+    t1 = _mm_slli_si128(t1, 4);
+    t0 = _mm_slli_si128(t0, 4);
+    lo = _mm_or_si128(lo, t0);
+    hi = _mm_or_si128(hi, t1);
+    hi = _mm_or_si128(hi, t2);
+
+    // First phase of the reduction
+    t0 = _mm_slli_epi32(lo, 31);
+    t1 = _mm_slli_epi32(lo, 30);
+    t2 = _mm_slli_epi32(lo, 25);
+    t0 = _mm_xor_si128(t0, t1);
+    t0 = _mm_xor_si128(t0, t2);
+    t1 = _mm_srli_si128(t0, 4);
+    t0 = _mm_slli_si128(t0, 12);
+    lo = _mm_xor_si128(lo, t0);
+
+    // Second phase
+    t2 = _mm_srli_epi32(lo, 1);
+    t0 = _mm_srli_epi32(lo, 2);
+    t2 = _mm_xor_si128(t2, t0);
+    t0 = _mm_srli_epi32(lo, 7);
+    t2 = _mm_xor_si128(t2, t0);
+    t2 = _mm_xor_si128(t2, t1);
+    lo = _mm_xor_si128(lo, t2);
+    return _mm_xor_si128(hi, lo);
+}
+
+AES_NI_TARGET
+void aes_ghash_clmul(const uint8_t h_powers[8][16], uint8_t x[16],
+                     const uint8_t *data, size_t blocks) {
+    __m128i h[8];
+    __m128i acc = aes_ni_bswap(_mm_loadu_si128((const __m128i *)x));
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        h[i] = aes_ni_bswap(_mm_loadu_si128((const __m128i *)h_powers[i]));
+    }
+
+    // X' = (X ^ C1) * H^8 ^ C2 * H^7 ^ ... ^ C8 * H
+    while (blocks >= 8) {
+        __m128i lo = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+
+        for (i = 0; i < 8; i++) {
+            __m128i d = aes_ni_bswap(_mm_loadu_si128((const __m128i *)(data + 16 * i)));
+            if (i == 0) {
+                d = _mm_xor_si128(d, acc);
+            }
+            aes_ni_clmul(d, h[7 - i], &lo, &hi);
+        }
+        acc = aes_ni_reduce(lo, hi);
+        data += 128;
+        blocks -= 8;
+    }
+
+    while (blocks > 0) {
+        __m128i lo = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+        __m128i d = aes_ni_bswap(_mm_loadu_si128((const __m128i *)data));
+
+        aes_ni_clmul(_mm_xor_si128(d, acc), h[0], &lo, &hi);
+        acc = aes_ni_reduce(lo, hi);
+        data += 16;
+        blocks--;
+    }
+
+    _mm_storeu_si128((__m128i *)x, aes_ni_bswap(acc));
+}
+
+#endif // AES_HAVE_X86_NI
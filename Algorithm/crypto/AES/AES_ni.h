@@ -0,0 +1,58 @@
+#ifndef AES_NI_H
+#define AES_NI_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "AES.h"
+
+/*
+ * Internal interface between AES.c and the AES-NI / PCLMULQDQ kernels.
+ * Not installed; applications select a backend through aes_set_backend().
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define AES_HAVE_X86_NI 1
+#else
+#define AES_HAVE_X86_NI 0
+#endif
+
+/**
+ * Single-block encryption
+ */
+typedef void (*aes_block_fn)(const aes_key_t *key, const uint8_t in[16], uint8_t out[16]);
+
+/**
+ * CTR kernel: encrypts `blocks` blocks with counter blocks counter, inc32(counter), ...
+ * (only the last 32 bits, big-endian, are incremented) and XORs them with `in`.
+ * @param out Output buffer, may be exactly the same as `in`
+ */
+typedef void (*aes_ctr32_fn)(const aes_key_t *key, const uint8_t counter[16],
+                             const uint8_t *in, uint8_t *out, size_t blocks);
+
+/**
+ * GHASH kernel: folds `blocks` 16-byte blocks of `data` into x
+ * @param h_powers H^1..H^8 in GCM byte order
+ */
+typedef void (*aes_ghash_fn)(const uint8_t h_powers[8][16], uint8_t x[16],
+                             const uint8_t *data, size_t blocks);
+
+#if AES_HAVE_X86_NI
+/**
+ * AES-NI single block
+ */
+void aes_encrypt_block_ni(const aes_key_t *key, const uint8_t in[16], uint8_t out[16]);
+
+/**
+ * AES-NI CTR, 8 blocks in flight to hide the AESENC latency
+ */
+void aes_ctr32_ni(const aes_key_t *key, const uint8_t counter[16],
+                  const uint8_t *in, uint8_t *out, size_t blocks);
+
+/**
+ * PCLMULQDQ GHASH, 8 blocks per reduction
+ */
+void aes_ghash_clmul(const uint8_t h_powers[8][16], uint8_t x[16],
+                     const uint8_t *data, size_t blocks);
+#endif
+
+#endif // AES_NI_H
@@ -1,5 +1,9 @@
 #include "ChaCha20.h"
+#include "ChaCha20_simd.h"
 #include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
 
 // ChaCha20 constants
 static const uint32_t CHACHA20_CONSTANTS[4] = {
@@ -94,9 +98,168 @@ void chacha20_init(chacha20_ctx_t *ctx, const uint8_t key[32], const uint8_t non
     
     // Initialize keystream position
     ctx->counter = counter;
+    ctx->base_counter = counter;
     ctx->keystream_pos = 64; // Force generation of new keystream block
 }
 
+void hchacha20(const uint8_t key[32], const uint8_t nonce[16], uint8_t subkey[32]) {
+    uint32_t x[16];
+    int i;
+
+    x[0] = CHACHA20_CONSTANTS[0];
+    x[1] = CHACHA20_CONSTANTS[1];
+    x[2] = CHACHA20_CONSTANTS[2];
+    x[3] = CHACHA20_CONSTANTS[3];
+    for (i = 0; i < 8; i++) {
+        x[4 + i] = read_le32(key + 4 * i);
+    }
+    for (i = 0; i < 4; i++) {
+        x[12 + i] = read_le32(nonce + 4 * i);
+    }
+
+    for (i = 0; i < 10; i++) {
+        chacha20_quarter_round(x, 0, 4, 8, 12);
+        chacha20_quarter_round(x, 1, 5, 9, 13);
+        chacha20_quarter_round(x, 2, 6, 10, 14);
+        chacha20_quarter_round(x, 3, 7, 11, 15);
+        chacha20_quarter_round(x, 0, 5, 10, 15);
+        chacha20_quarter_round(x, 1, 6, 11, 12);
+        chacha20_quarter_round(x, 2, 7, 8, 13);
+        chacha20_quarter_round(x, 3, 4, 9, 14);
+    }
+
+    // No feed-forward: the subkey is words 0-3 and 12-15 of the permuted state
+    for (i = 0; i < 4; i++) {
+        write_le32(subkey + 4 * i, x[i]);
+        write_le32(subkey + 16 + 4 * i, x[12 + i]);
+    }
+}
+
+void xchacha20_init(chacha20_ctx_t *ctx, const uint8_t key[32], const uint8_t nonce[24], uint32_t counter) {
+    uint8_t subkey[32];
+    uint8_t subnonce[12] = {0};
+
+    hchacha20(key, nonce, subkey);
+    memcpy(subnonce + 4, nonce + 16, 8);
+    chacha20_init(ctx, subkey, subnonce, counter);
+    memset(subkey, 0, sizeof(subkey));
+}
+
+void chacha20_blocks_scalar(const uint32_t state[16], uint32_t counter,
+                            const uint8_t *in, uint8_t *out, size_t blocks) {
+    uint32_t input[16];
+    uint8_t block[64];
+    size_t i;
+
+    memcpy(input, state, sizeof(input));
+    while (blocks--) {
+        input[12] = counter++;
+        chacha20_block(input, block);
+
+        if (in) {
+            // XOR eight bytes at a time
+            for (i = 0; i < 64; i += 8) {
+                uint64_t a, b;
+                memcpy(&a, in + i, 8);
+                memcpy(&b, block + i, 8);
+                a ^= b;
+                memcpy(out + i, &a, 8);
+            }
+            in += 64;
+        } else {
+            memcpy(out, block, 64);
+        }
+        out += 64;
+    }
+}
+
+/*
+ * Backend dispatch
+ */
+
+static pthread_once_t chacha20_dispatch_once = PTHREAD_ONCE_INIT;
+static chacha20_backend_t chacha20_active_backend = CHACHA20_BACKEND_SCALAR;
+static chacha20_blocks_fn chacha20_active_blocks = chacha20_blocks_scalar;
+
+static const char *const chacha20_backend_names[] = {
+    "auto", "scalar", "sse2", "avx2", "avx512"
+};
+
+/**
+ * Kernel for a backend, NULL if this build or CPU cannot run it
+ */
+static chacha20_blocks_fn chacha20_backend_blocks(chacha20_backend_t backend) {
+    switch (backend) {
+    case CHACHA20_BACKEND_SCALAR:
+        return chacha20_blocks_scalar;
+#if CHACHA20_HAVE_X86_SIMD
+    case CHACHA20_BACKEND_SSE2:
+        return __builtin_cpu_supports("sse2") ? chacha20_blocks_sse2 : NULL;
+    case CHACHA20_BACKEND_AVX2:
+        return __builtin_cpu_supports("avx2") ? chacha20_blocks_avx2 : NULL;
+    case CHACHA20_BACKEND_AVX512:
+        return __builtin_cpu_supports("avx512f") ? chacha20_blocks_avx512 : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * Pick the widest kernel the CPU supports
+ */
+static void chacha20_dispatch_init(void) {
+    chacha20_backend_t backend;
+
+    for (backend = CHACHA20_BACKEND_AVX512; backend > CHACHA20_BACKEND_SCALAR; backend--) {
+        chacha20_blocks_fn fn = chacha20_backend_blocks(backend);
+        if (fn) {
+            chacha20_active_backend = backend;
+            chacha20_active_blocks = fn;
+            return;
+        }
+    }
+}
+
+static chacha20_blocks_fn chacha20_blocks(void) {
+    pthread_once(&chacha20_dispatch_once, chacha20_dispatch_init);
+    return chacha20_active_blocks;
+}
+
+int chacha20_set_backend(chacha20_backend_t backend) {
+    chacha20_blocks_fn fn;
+
+    pthread_once(&chacha20_dispatch_once, chacha20_dispatch_init);
+    if (backend == CHACHA20_BACKEND_AUTO) {
+        chacha20_dispatch_init();
+        return 0;
+    }
+
+    fn = chacha20_backend_blocks(backend);
+    if (!fn) {
+        return -1;
+    }
+    chacha20_active_backend = backend;
+    chacha20_active_blocks = fn;
+    return 0;
+}
+
+chacha20_backend_t chacha20_get_backend(void) {
+    pthread_once(&chacha20_dispatch_once, chacha20_dispatch_init);
+    return chacha20_active_backend;
+}
+
+int chacha20_backend_supported(chacha20_backend_t backend) {
+    return backend == CHACHA20_BACKEND_AUTO || chacha20_backend_blocks(backend) != NULL;
+}
+
+const char *chacha20_backend_name(chacha20_backend_t backend) {
+    if (backend >= CHACHA20_BACKEND_AUTO && backend <= CHACHA20_BACKEND_AVX512) {
+        return chacha20_backend_names[backend];
+    }
+    return "unknown";
+}
+
 static void chacha20_generate_keystream(chacha20_ctx_t *ctx) {
     ctx->state[12] = ctx->counter;
     chacha20_block(ctx->state, ctx->keystream);
@@ -104,17 +267,43 @@ static void chacha20_generate_keystream(chacha20_ctx_t *ctx) {
     ctx->keystream_pos = 0;
 }
 
-void chacha20_encrypt(chacha20_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length) {
+/**
+ * Shared body of encrypt and keystream; input == NULL emits the raw keystream
+ */
+static void chacha20_process(chacha20_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length) {
+    size_t blocks;
     size_t i;
-    
-    for (i = 0; i < length; i++) {
-        if (ctx->keystream_pos >= 64) {
-            chacha20_generate_keystream(ctx);
+
+    // Finish the partially used keystream block
+    while (length > 0 && ctx->keystream_pos < 64) {
+        *output++ = (input ? *input++ : 0) ^ ctx->keystream[ctx->keystream_pos++];
+        length--;
+    }
+
+    // Whole blocks go straight to the kernel without touching ctx->keystream
+    blocks = length / 64;
+    if (blocks > 0) {
+        chacha20_blocks()(ctx->state, ctx->counter, input, output, blocks);
+        ctx->counter += (uint32_t)blocks;
+        if (input) {
+            input += blocks * 64;
         }
-        
-        output[i] = input[i] ^ ctx->keystream[ctx->keystream_pos];
-        ctx->keystream_pos++;
+        output += blocks * 64;
+        length -= blocks * 64;
     }
+
+    // Keep the rest of the last block for the next call
+    if (length > 0) {
+        chacha20_generate_keystream(ctx);
+        for (i = 0; i < length; i++) {
+            output[i] = (input ? input[i] : 0) ^ ctx->keystream[i];
+        }
+        ctx->keystream_pos = length;
+    }
+}
+
+void chacha20_encrypt(chacha20_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length) {
+    chacha20_process(ctx, input, output, length);
 }
 
 void chacha20_decrypt(chacha20_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length) {
@@ -122,20 +311,281 @@ void chacha20_decrypt(chacha20_ctx_t *ctx, const uint8_t *input, uint8_t *output
     chacha20_encrypt(ctx, input, output, length);
 }
 
-void chacha20_keystream(chacha20_ctx_t *ctx, uint8_t *output, size_t length) {
-    size_t i;
-    
-    for (i = 0; i < length; i++) {
-        if (ctx->keystream_pos >= 64) {
-            chacha20_generate_keystream(ctx);
+/*
+ * Scattered buffers
+ */
+
+/**
+ * XOR eight bytes at a time
+ */
+static void chacha20_xor(uint8_t *out, const uint8_t *in, const uint8_t *keystream, size_t length) {
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        uint64_t a, b;
+        memcpy(&a, in + i, 8);
+        memcpy(&b, keystream + i, 8);
+        a ^= b;
+        memcpy(out + i, &a, 8);
+    }
+    for (; i < length; i++) {
+        out[i] = in[i] ^ keystream[i];
+    }
+}
+
+void chacha20_lookahead_begin(chacha20_lookahead_t *la, size_t total) {
+    la->len = 0;
+    la->pos = 0;
+    la->remaining = total;
+}
+
+void chacha20_lookahead_xor(chacha20_ctx_t *ctx, chacha20_lookahead_t *la,
+                            const uint8_t *in, uint8_t *out, size_t length) {
+    la->remaining -= length;
+
+    while (length > 0) {
+        size_t n;
+
+        if (ctx->keystream_pos < 64) {
+            // Keystream left over from before this operation
+            n = 64 - ctx->keystream_pos;
+            if (n > length) {
+                n = length;
+            }
+            chacha20_xor(out, in, ctx->keystream + ctx->keystream_pos, n);
+            ctx->keystream_pos += n;
+        } else if (la->pos < la->len) {
+            n = la->len - la->pos;
+            if (n > length) {
+                n = length;
+            }
+            chacha20_xor(out, in, la->keystream + la->pos, n);
+            la->pos += n;
+        } else if (length >= CHACHA20_LOOKAHEAD_BLOCKS * 64) {
+            // Block aligned in the stream: full batches straight from the segment
+            size_t blocks = length / 64 / CHACHA20_LOOKAHEAD_BLOCKS * CHACHA20_LOOKAHEAD_BLOCKS;
+            chacha20_blocks()(ctx->state, ctx->counter, in, out, blocks);
+            ctx->counter += (uint32_t)blocks;
+            n = blocks * 64;
+        } else {
+            // Less than a batch left in this segment: compute a full batch that runs on
+            // into the next segments, so short runs do not leave partly used kernel batches
+            size_t blocks = (length + la->remaining + 63) / 64;
+            if (blocks > CHACHA20_LOOKAHEAD_BLOCKS) {
+                blocks = CHACHA20_LOOKAHEAD_BLOCKS;
+            }
+            chacha20_blocks()(ctx->state, ctx->counter, NULL, la->keystream, blocks);
+            ctx->counter += (uint32_t)blocks;
+            la->len = blocks * 64;
+            la->pos = 0;
+            continue;
         }
-        
-        output[i] = ctx->keystream[ctx->keystream_pos];
-        ctx->keystream_pos++;
+        in += n;
+        out += n;
+        length -= n;
+    }
+}
+
+void chacha20_lookahead_end(chacha20_ctx_t *ctx, chacha20_lookahead_t *la) {
+    // The lookahead never goes past the block holding the last byte
+    if (la->pos < la->len) {
+        memcpy(ctx->keystream, la->keystream + la->len - 64, 64);
+        ctx->keystream_pos = 64 - (la->len - la->pos);
+    }
+    memset(la->keystream, 0, la->len);
+    la->len = 0;
+    la->pos = 0;
+}
+
+int chacha20_iov_length(const struct iovec *in, int n, const struct iovec *out, size_t *total) {
+    size_t in_total = 0, out_total = 0;
+    int i;
+
+    if (n < 0) {
+        return -1;
+    }
+    if (!out) {
+        out = in;
+    }
+    for (i = 0; i < n; i++) {
+        in_total += in[i].iov_len;
+        out_total += out[i].iov_len;
+    }
+    if (out_total < in_total) {
+        return -1;
+    }
+    *total = in_total;
+    return 0;
+}
+
+void chacha20_iov_walk(const struct iovec *in, int n, const struct iovec *out, chacha20_iov_fn fn, void *arg) {
+    size_t out_done = 0;
+    int i, j = 0;
+
+    if (!out) {
+        out = in;
+    }
+    for (i = 0; i < n; i++) {
+        const uint8_t *src = (const uint8_t *)in[i].iov_base;
+        size_t left = in[i].iov_len;
+
+        while (left > 0) {
+            size_t len;
+
+            while (out_done == out[j].iov_len) {
+                j++;
+                out_done = 0;
+            }
+            len = out[j].iov_len - out_done;
+            if (len > left) {
+                len = left;
+            }
+            fn(arg, src, (uint8_t *)out[j].iov_base + out_done, len);
+            src += len;
+            left -= len;
+            out_done += len;
+        }
+    }
+}
+
+typedef struct {
+    chacha20_ctx_t *ctx;
+    chacha20_lookahead_t la;
+} chacha20_iov_state_t;
+
+static void chacha20_iov_piece(void *arg, const uint8_t *in, uint8_t *out, size_t length) {
+    chacha20_iov_state_t *st = (chacha20_iov_state_t *)arg;
+
+    chacha20_lookahead_xor(st->ctx, &st->la, in, out, length);
+}
+
+int chacha20_encrypt_iov(chacha20_ctx_t *ctx, const struct iovec *in, int n, const struct iovec *out) {
+    chacha20_iov_state_t st;
+    size_t total;
+
+    if (chacha20_iov_length(in, n, out, &total) != 0) {
+        return -1;
     }
+    st.ctx = ctx;
+    chacha20_lookahead_begin(&st.la, total);
+    chacha20_iov_walk(in, n, out, chacha20_iov_piece, &st);
+    chacha20_lookahead_end(ctx, &st.la);
+    return 0;
+}
+
+void chacha20_keystream(chacha20_ctx_t *ctx, uint8_t *output, size_t length) {
+    chacha20_process(ctx, NULL, output, length);
 }
 
 void chacha20_reset_counter(chacha20_ctx_t *ctx, uint32_t counter) {
     ctx->counter = counter;
+    ctx->base_counter = counter;
     ctx->keystream_pos = 64; // Force generation of new keystream block
 }
+
+void chacha20_seek(chacha20_ctx_t *ctx, uint64_t offset) {
+    size_t pos = (size_t)(offset % 64);
+
+    ctx->counter = ctx->base_counter + (uint32_t)(offset / 64);
+    ctx->keystream_pos = 64;
+    if (pos > 0) {
+        // Mid-block: generate that block and skip its first bytes
+        chacha20_generate_keystream(ctx);
+        ctx->keystream_pos = pos;
+    }
+}
+
+/*
+ * Parallel encryption
+ */
+
+typedef struct {
+    chacha20_blocks_fn blocks_fn;   // Kernel resolved by the calling thread
+    const uint32_t *state;          // Shared, read-only
+    uint32_t counter;               // Counter of the first block of this run
+    const uint8_t *input;
+    uint8_t *output;
+    size_t blocks;
+} chacha20_parallel_task_t;
+
+static void *chacha20_parallel_worker(void *arg) {
+    chacha20_parallel_task_t *task = (chacha20_parallel_task_t *)arg;
+
+    task->blocks_fn(task->state, task->counter, task->input, task->output, task->blocks);
+    return NULL;
+}
+
+void chacha20_encrypt_parallel(chacha20_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length,
+                               size_t nthreads) {
+    chacha20_parallel_task_t *tasks;
+    pthread_t *tids;
+    int *started;
+    size_t head, blocks, t;
+
+    if (nthreads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (nthreads > length / CHACHA20_PARALLEL_MIN_CHUNK) {
+        nthreads = length / CHACHA20_PARALLEL_MIN_CHUNK;
+    }
+    if (nthreads < 2) {
+        chacha20_process(ctx, input, output, length);
+        return;
+    }
+
+    tasks = malloc(nthreads * sizeof(*tasks));
+    tids = malloc(nthreads * sizeof(*tids));
+    started = malloc(nthreads * sizeof(*started));
+    if (!tasks || !tids || !started) {
+        free(tasks);
+        free(tids);
+        free(started);
+        chacha20_process(ctx, input, output, length);
+        return;
+    }
+
+    // Use up the buffered keystream first so the runs start on block boundaries
+    head = ctx->keystream_pos < 64 ? 64 - ctx->keystream_pos : 0;
+    if (head > length) {
+        head = length;
+    }
+    chacha20_process(ctx, input, output, head);
+    input += head;
+    output += head;
+    length -= head;
+
+    blocks = length / 64;
+    for (t = 0; t < nthreads; t++) {
+        size_t first = blocks * t / nthreads;
+        size_t last = blocks * (t + 1) / nthreads;
+
+        tasks[t].blocks_fn = chacha20_blocks();
+        tasks[t].state = ctx->state;
+        tasks[t].counter = ctx->counter + (uint32_t)first;
+        tasks[t].input = input + first * 64;
+        tasks[t].output = output + first * 64;
+        tasks[t].blocks = last - first;
+    }
+
+    // The calling thread takes run 0; runs whose thread failed to start are done here too
+    for (t = 1; t < nthreads; t++) {
+        started[t] = pthread_create(&tids[t], NULL, chacha20_parallel_worker, &tasks[t]) == 0;
+    }
+    chacha20_parallel_worker(&tasks[0]);
+    for (t = 1; t < nthreads; t++) {
+        if (started[t]) {
+            pthread_join(tids[t], NULL);
+        } else {
+            chacha20_parallel_worker(&tasks[t]);
+        }
+    }
+
+    free(tasks);
+    free(tids);
+    free(started);
+
+    // Partial last block goes through the context like the sequential path
+    ctx->counter += (uint32_t)blocks;
+    chacha20_process(ctx, input + blocks * 64, output + blocks * 64, length - blocks * 64);
+}
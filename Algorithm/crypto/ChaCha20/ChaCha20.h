@@ -3,6 +3,20 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <sys/uio.h>
+
+/**
+ * Block function implementations
+ * Bulk data is processed several 64-byte blocks at a time in SIMD registers;
+ * the backend is chosen at first use from the CPU features.
+ */
+typedef enum {
+    CHACHA20_BACKEND_AUTO = 0,  // Widest backend the CPU supports
+    CHACHA20_BACKEND_SCALAR,    // Portable C, one block at a time
+    CHACHA20_BACKEND_SSE2,      // 4 blocks in parallel
+    CHACHA20_BACKEND_AVX2,      // 8 blocks in parallel
+    CHACHA20_BACKEND_AVX512     // 16 blocks in parallel (AVX-512F)
+} chacha20_backend_t;
 
 /**
  * ChaCha20 encryption/decryption context
@@ -12,6 +26,7 @@ typedef struct {
     uint32_t counter;       // Block counter
     uint8_t keystream[64];  // Generated keystream block
     size_t keystream_pos;   // Position in current keystream block
+    uint32_t base_counter;  // Counter at stream offset 0, used by chacha20_seek
 } chacha20_ctx_t;
 
 /**
@@ -41,6 +56,19 @@ void chacha20_encrypt(chacha20_ctx_t *ctx, const uint8_t *input, uint8_t *output
  */
 void chacha20_decrypt(chacha20_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length);
 
+/**
+ * Encrypt/decrypt data spread over several buffers as one continuous stream
+ * Segment boundaries need not be block aligned and input and output may be
+ * split differently; nothing is copied into a staging buffer.
+ * @param ctx ChaCha20 context
+ * @param in Input segments
+ * @param n Number of input segments
+ * @param out Output segments, n entries; NULL (or in) to work in place
+ * @return 0 on success, -1 if n is negative or out holds fewer bytes than in
+ *         (nothing is processed then)
+ */
+int chacha20_encrypt_iov(chacha20_ctx_t *ctx, const struct iovec *in, int n, const struct iovec *out);
+
 /**
  * Generate raw keystream without encryption/decryption
  * @param ctx ChaCha20 context
@@ -49,11 +77,86 @@ void chacha20_decrypt(chacha20_ctx_t *ctx, const uint8_t *input, uint8_t *output
  */
 void chacha20_keystream(chacha20_ctx_t *ctx, uint8_t *output, size_t length);
 
+/**
+ * Minimum bytes per thread for chacha20_encrypt_parallel
+ */
+#define CHACHA20_PARALLEL_MIN_CHUNK (256 * 1024)
+
+/**
+ * Encrypt/decrypt a large buffer on several threads
+ * The buffer is split into runs of whole blocks, each started at its own counter,
+ * so the output and the context afterwards are the same as with chacha20_encrypt.
+ * @param ctx ChaCha20 context
+ * @param input Input data
+ * @param output Output buffer (can be the same as input for in-place operation)
+ * @param length Length of data in bytes
+ * @param nthreads Number of threads, 0 for all online CPUs; fewer are used when
+ *                 each would get less than CHACHA20_PARALLEL_MIN_CHUNK bytes
+ */
+void chacha20_encrypt_parallel(chacha20_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length,
+                               size_t nthreads);
+
 /**
  * Reset the ChaCha20 context to initial state with new counter
+ * The new counter also becomes stream offset 0 for chacha20_seek.
  * @param ctx ChaCha20 context
  * @param counter New counter value
  */
 void chacha20_reset_counter(chacha20_ctx_t *ctx, uint32_t counter);
 
+/**
+ * Move to a byte offset in the keystream
+ * Offset 0 is the counter given to chacha20_init or chacha20_reset_counter;
+ * the 32-bit block counter wraps after 256GB like the sequential path.
+ * @param ctx ChaCha20 context
+ * @param offset Byte offset from the start of the stream
+ */
+void chacha20_seek(chacha20_ctx_t *ctx, uint64_t offset);
+
+/**
+ * HChaCha20: derive a 32-byte subkey from a key and a 16-byte nonce
+ * @param key 32-byte key
+ * @param nonce 16-byte nonce
+ * @param subkey Output 32-byte subkey
+ */
+void hchacha20(const uint8_t key[32], const uint8_t nonce[16], uint8_t subkey[32]);
+
+/**
+ * Initialize a context for XChaCha20 (24-byte nonce, safe to pick at random)
+ * The context is then used with the regular chacha20_* functions.
+ * @param ctx ChaCha20 context to initialize
+ * @param key 32-byte key
+ * @param nonce 24-byte nonce
+ * @param counter Initial counter value
+ */
+void xchacha20_init(chacha20_ctx_t *ctx, const uint8_t key[32], const uint8_t nonce[24], uint32_t counter);
+
+/**
+ * Force a block function backend for all contexts (for testing and benchmarking)
+ * Not synchronized with concurrent encryption; call it before starting threads.
+ * @param backend Backend to use, CHACHA20_BACKEND_AUTO restores runtime detection
+ * @return 0 on success, -1 if the backend is not available on this CPU or build
+ */
+int chacha20_set_backend(chacha20_backend_t backend);
+
+/**
+ * Get the backend currently in use
+ * @return Active backend (never CHACHA20_BACKEND_AUTO)
+ */
+chacha20_backend_t chacha20_get_backend(void);
+
+/**
+ * Check whether a backend can run on this CPU and build
+ * @param backend Backend to check
+ * @return 1 if supported, 0 otherwise
+ */
+int chacha20_backend_supported(chacha20_backend_t backend);
+
+/**
+ * Get the name of a backend
+ * @param backend Backend
+ * @return Name such as "avx2"
+ */
+const char *chacha20_backend_name(chacha20_backend_t backend);
+
 #endif // CHACHA20_H
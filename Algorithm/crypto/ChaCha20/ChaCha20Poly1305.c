@@ -0,0 +1,284 @@
+#include "ChaCha20Poly1305.h"
+#include "ChaCha20_simd.h"
+#include <string.h>
+
+// Encrypt and MAC in chunks of this size so the MAC reads ciphertext still in L1
+#define AEAD_CHUNK_SIZE 4096
+
+static const uint8_t aead_zero_pad[16] = {0};
+
+static void aead_write_le64(uint8_t *p, uint64_t val) {
+    int i;
+    for (i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(val >> (8 * i));
+    }
+}
+
+static void aead_wipe(void *p, size_t len) {
+    volatile uint8_t *v = (volatile uint8_t *)p;
+    while (len--) {
+        *v++ = 0;
+    }
+}
+
+/**
+ * Key Poly1305 with the first 32 bytes of block 0; the cipher continues at block 1
+ */
+static void aead_start(chacha20_poly1305_ctx_t *ctx) {
+    uint8_t block0[64];
+
+    chacha20_keystream(&ctx->chacha, block0, sizeof(block0));
+    poly1305_init(&ctx->poly, block0);
+    aead_wipe(block0, sizeof(block0));
+
+    ctx->aad_len = 0;
+    ctx->data_len = 0;
+    ctx->data_started = 0;
+}
+
+void chacha20_poly1305_init(chacha20_poly1305_ctx_t *ctx, const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                            const uint8_t nonce[CHACHA20_POLY1305_NONCE_SIZE]) {
+    chacha20_init(&ctx->chacha, key, nonce, 0);
+    aead_start(ctx);
+}
+
+void xchacha20_poly1305_init(chacha20_poly1305_ctx_t *ctx, const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                             const uint8_t nonce[XCHACHA20_POLY1305_NONCE_SIZE]) {
+    xchacha20_init(&ctx->chacha, key, nonce, 0);
+    aead_start(ctx);
+}
+
+int chacha20_poly1305_update_aad(chacha20_poly1305_ctx_t *ctx, const uint8_t *aad, size_t length) {
+    if (ctx->data_started) {
+        return -1;
+    }
+    poly1305_update(&ctx->poly, aad, length);
+    ctx->aad_len += length;
+    return 0;
+}
+
+/**
+ * Pad the AAD to a 16-byte boundary before the first ciphertext byte
+ */
+static void aead_start_data(chacha20_poly1305_ctx_t *ctx) {
+    if (!ctx->data_started) {
+        if (ctx->aad_len % 16) {
+            poly1305_update(&ctx->poly, aead_zero_pad, 16 - ctx->aad_len % 16);
+        }
+        ctx->data_started = 1;
+    }
+}
+
+/**
+ * Account for `length` more message bytes
+ * @return 0 on success, -1 if the 32-bit block counter would wrap back to the Poly1305 key block
+ */
+static int aead_add_data(chacha20_poly1305_ctx_t *ctx, uint64_t length) {
+    if (length > CHACHA20_POLY1305_MAX_DATA - ctx->data_len) {
+        return -1;
+    }
+    aead_start_data(ctx);
+    ctx->data_len += length;
+    return 0;
+}
+
+int chacha20_poly1305_encrypt(chacha20_poly1305_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length) {
+    if (aead_add_data(ctx, length) != 0) {
+        return -1;
+    }
+
+    while (length > 0) {
+        size_t n = length < AEAD_CHUNK_SIZE ? length : AEAD_CHUNK_SIZE;
+        chacha20_encrypt(&ctx->chacha, input, output, n);
+        poly1305_update(&ctx->poly, output, n);
+        input += n;
+        output += n;
+        length -= n;
+    }
+    return 0;
+}
+
+int chacha20_poly1305_decrypt(chacha20_poly1305_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length) {
+    if (aead_add_data(ctx, length) != 0) {
+        return -1;
+    }
+
+    while (length > 0) {
+        size_t n = length < AEAD_CHUNK_SIZE ? length : AEAD_CHUNK_SIZE;
+        // MAC the ciphertext before an in-place decrypt overwrites it
+        poly1305_update(&ctx->poly, input, n);
+        chacha20_decrypt(&ctx->chacha, input, output, n);
+        input += n;
+        output += n;
+        length -= n;
+    }
+    return 0;
+}
+
+typedef struct {
+    chacha20_poly1305_ctx_t *ctx;
+    chacha20_lookahead_t la;
+    int decrypt;
+} aead_iov_state_t;
+
+static void aead_iov_piece(void *arg, const uint8_t *in, uint8_t *out, size_t length) {
+    aead_iov_state_t *st = (aead_iov_state_t *)arg;
+
+    while (length > 0) {
+        size_t n = length < AEAD_CHUNK_SIZE ? length : AEAD_CHUNK_SIZE;
+        if (st->decrypt) {
+            poly1305_update(&st->ctx->poly, in, n);
+            chacha20_lookahead_xor(&st->ctx->chacha, &st->la, in, out, n);
+        } else {
+            chacha20_lookahead_xor(&st->ctx->chacha, &st->la, in, out, n);
+            poly1305_update(&st->ctx->poly, out, n);
+        }
+        in += n;
+        out += n;
+        length -= n;
+    }
+}
+
+/**
+ * Scattered encrypt or decrypt; blocks across segment boundaries come from the lookahead
+ */
+static int aead_crypt_iov(chacha20_poly1305_ctx_t *ctx, int decrypt,
+                          const struct iovec *in, int n, const struct iovec *out) {
+    aead_iov_state_t st;
+    size_t total;
+
+    if (chacha20_iov_length(in, n, out, &total) != 0 || aead_add_data(ctx, total) != 0) {
+        return -1;
+    }
+
+    st.ctx = ctx;
+    st.decrypt = decrypt;
+    chacha20_lookahead_begin(&st.la, total);
+    chacha20_iov_walk(in, n, out, aead_iov_piece, &st);
+    chacha20_lookahead_end(&ctx->chacha, &st.la);
+    return 0;
+}
+
+int chacha20_poly1305_encrypt_iov(chacha20_poly1305_ctx_t *ctx, const struct iovec *in, int n,
+                                  const struct iovec *out) {
+    return aead_crypt_iov(ctx, 0, in, n, out);
+}
+
+int chacha20_poly1305_decrypt_iov(chacha20_poly1305_ctx_t *ctx, const struct iovec *in, int n,
+                                  const struct iovec *out) {
+    return aead_crypt_iov(ctx, 1, in, n, out);
+}
+
+void chacha20_poly1305_final(chacha20_poly1305_ctx_t *ctx, uint8_t tag[CHACHA20_POLY1305_TAG_SIZE]) {
+    uint8_t lengths[16];
+
+    aead_start_data(ctx);
+    if (ctx->data_len % 16) {
+        poly1305_update(&ctx->poly, aead_zero_pad, 16 - ctx->data_len % 16);
+    }
+    aead_write_le64(lengths, ctx->aad_len);
+    aead_write_le64(lengths + 8, ctx->data_len);
+    poly1305_update(&ctx->poly, lengths, sizeof(lengths));
+    poly1305_final(&ctx->poly, tag);
+
+    aead_wipe(ctx, sizeof(*ctx));
+}
+
+int chacha20_poly1305_verify(chacha20_poly1305_ctx_t *ctx, const uint8_t tag[CHACHA20_POLY1305_TAG_SIZE]) {
+    uint8_t expected[CHACHA20_POLY1305_TAG_SIZE];
+    int ok;
+
+    chacha20_poly1305_final(ctx, expected);
+    ok = poly1305_tag_equal(expected, tag);
+    aead_wipe(expected, sizeof(expected));
+    return ok ? 0 : -1;
+}
+
+/**
+ * Seal with an initialized context
+ */
+static int aead_seal(chacha20_poly1305_ctx_t *ctx, const uint8_t *aad, size_t aad_len,
+                     const uint8_t *input, size_t length, uint8_t *output,
+                     uint8_t tag[CHACHA20_POLY1305_TAG_SIZE]) {
+    int ret;
+
+    chacha20_poly1305_update_aad(ctx, aad, aad_len);
+    ret = chacha20_poly1305_encrypt(ctx, input, output, length);
+    if (ret == 0) {
+        chacha20_poly1305_final(ctx, tag);
+    } else {
+        aead_wipe(ctx, sizeof(*ctx));
+    }
+    return ret;
+}
+
+/**
+ * Open with an initialized context: authenticate everything first, then decrypt
+ */
+static int aead_open(chacha20_poly1305_ctx_t *ctx, const uint8_t *aad, size_t aad_len,
+                     const uint8_t *input, size_t length,
+                     const uint8_t tag[CHACHA20_POLY1305_TAG_SIZE], uint8_t *output) {
+    chacha20_ctx_t cipher = ctx->chacha;
+    int ret;
+
+    chacha20_poly1305_update_aad(ctx, aad, aad_len);
+    if (aead_add_data(ctx, length) != 0) {
+        aead_wipe(ctx, sizeof(*ctx));
+        aead_wipe(&cipher, sizeof(cipher));
+        return -1;
+    }
+    poly1305_update(&ctx->poly, input, length);
+    ret = chacha20_poly1305_verify(ctx, tag);
+
+    if (ret == 0) {
+        chacha20_decrypt(&cipher, input, output, length);
+    } else if (output != input) {
+        memset(output, 0, length);
+    }
+    aead_wipe(&cipher, sizeof(cipher));
+    return ret;
+}
+
+int chacha20_poly1305_seal(const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                           const uint8_t nonce[CHACHA20_POLY1305_NONCE_SIZE],
+                           const uint8_t *aad, size_t aad_len,
+                           const uint8_t *input, size_t length, uint8_t *output,
+                           uint8_t tag[CHACHA20_POLY1305_TAG_SIZE]) {
+    chacha20_poly1305_ctx_t ctx;
+
+    chacha20_poly1305_init(&ctx, key, nonce);
+    return aead_seal(&ctx, aad, aad_len, input, length, output, tag);
+}
+
+int chacha20_poly1305_open(const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                           const uint8_t nonce[CHACHA20_POLY1305_NONCE_SIZE],
+                           const uint8_t *aad, size_t aad_len,
+                           const uint8_t *input, size_t length,
+                           const uint8_t tag[CHACHA20_POLY1305_TAG_SIZE], uint8_t *output) {
+    chacha20_poly1305_ctx_t ctx;
+
+    chacha20_poly1305_init(&ctx, key, nonce);
+    return aead_open(&ctx, aad, aad_len, input, length, tag, output);
+}
+
+int xchacha20_poly1305_seal(const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                            const uint8_t nonce[XCHACHA20_POLY1305_NONCE_SIZE],
+                            const uint8_t *aad, size_t aad_len,
+                            const uint8_t *input, size_t length, uint8_t *output,
+                            uint8_t tag[CHACHA20_POLY1305_TAG_SIZE]) {
+    chacha20_poly1305_ctx_t ctx;
+
+    xchacha20_poly1305_init(&ctx, key, nonce);
+    return aead_seal(&ctx, aad, aad_len, input, length, output, tag);
+}
+
+int xchacha20_poly1305_open(const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                            const uint8_t nonce[XCHACHA20_POLY1305_NONCE_SIZE],
+                            const uint8_t *aad, size_t aad_len,
+                            const uint8_t *input, size_t length,
+                            const uint8_t tag[CHACHA20_POLY1305_TAG_SIZE], uint8_t *output) {
+    chacha20_poly1305_ctx_t ctx;
+
+    xchacha20_poly1305_init(&ctx, key, nonce);
+    return aead_open(&ctx, aad, aad_len, input, length, tag, output);
+}
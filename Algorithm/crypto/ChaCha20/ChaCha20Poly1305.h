@@ -0,0 +1,181 @@
+#ifndef CHACHA20_POLY1305_H
+#define CHACHA20_POLY1305_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ChaCha20.h"
+#include "Poly1305.h"
+
+/**
+ * ChaCha20-Poly1305 AEAD (RFC 8439) and XChaCha20-Poly1305 (24-byte nonce)
+ * A (key, nonce) pair must never be reused. With XChaCha20 the nonce is large
+ * enough to be chosen at random.
+ */
+
+#define CHACHA20_POLY1305_KEY_SIZE 32
+#define CHACHA20_POLY1305_NONCE_SIZE 12
+#define XCHACHA20_POLY1305_NONCE_SIZE 24
+#define CHACHA20_POLY1305_TAG_SIZE 16
+
+// Longest message per nonce (RFC 8439): 2^32 - 1 blocks after block 0, which keys Poly1305
+#define CHACHA20_POLY1305_MAX_DATA ((UINT64_C(1) << 38) - 64)
+
+/**
+ * Incremental AEAD context
+ * Usage: init, any number of update_aad calls, any number of encrypt (or decrypt)
+ * calls, then final (sender) or verify (receiver).
+ */
+typedef struct {
+    chacha20_ctx_t chacha;      // Cipher, starts at block 1
+    poly1305_ctx_t poly;        // Authenticator keyed with block 0
+    uint64_t aad_len;           // AAD bytes so far
+    uint64_t data_len;          // Ciphertext bytes so far
+    int data_started;           // Set once the AAD has been padded
+} chacha20_poly1305_ctx_t;
+
+/**
+ * Initialize an AEAD context
+ * @param ctx AEAD context
+ * @param key 32-byte key
+ * @param nonce 12-byte nonce
+ */
+void chacha20_poly1305_init(chacha20_poly1305_ctx_t *ctx, const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                            const uint8_t nonce[CHACHA20_POLY1305_NONCE_SIZE]);
+
+/**
+ * Initialize an AEAD context for XChaCha20-Poly1305
+ * @param ctx AEAD context
+ * @param key 32-byte key
+ * @param nonce 24-byte nonce
+ */
+void xchacha20_poly1305_init(chacha20_poly1305_ctx_t *ctx, const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                             const uint8_t nonce[XCHACHA20_POLY1305_NONCE_SIZE]);
+
+/**
+ * Add associated data (authenticated, not encrypted)
+ * @param ctx AEAD context
+ * @param aad Associated data
+ * @param length Length of aad in bytes
+ * @return 0 on success, -1 if encryption or decryption has already started
+ */
+int chacha20_poly1305_update_aad(chacha20_poly1305_ctx_t *ctx, const uint8_t *aad, size_t length);
+
+/**
+ * Encrypt the next part of the message and authenticate the ciphertext
+ * @param ctx AEAD context
+ * @param input Plaintext
+ * @param output Ciphertext (can be the same as input)
+ * @param length Length in bytes
+ * @return 0 on success, -1 if the message would exceed CHACHA20_POLY1305_MAX_DATA (nothing is processed)
+ */
+int chacha20_poly1305_encrypt(chacha20_poly1305_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length);
+
+/**
+ * Authenticate and decrypt the next part of the message
+ * The plaintext is not authentic until chacha20_poly1305_verify succeeds;
+ * use chacha20_poly1305_open when it must not be released early.
+ * @param ctx AEAD context
+ * @param input Ciphertext
+ * @param output Plaintext (can be the same as input)
+ * @param length Length in bytes
+ * @return 0 on success, -1 if the message would exceed CHACHA20_POLY1305_MAX_DATA (nothing is processed)
+ */
+int chacha20_poly1305_decrypt(chacha20_poly1305_ctx_t *ctx, const uint8_t *input, uint8_t *output, size_t length);
+
+/**
+ * Encrypt the next part of the message from scattered buffers
+ * Works like chacha20_encrypt_iov; segments may end anywhere.
+ * @param ctx AEAD context
+ * @param in Plaintext segments
+ * @param n Number of input segments
+ * @param out Ciphertext segments, n entries; NULL (or in) to work in place
+ * @return 0 on success, -1 if n is negative, out holds fewer bytes than in
+ *         or the message would exceed CHACHA20_POLY1305_MAX_DATA
+ */
+int chacha20_poly1305_encrypt_iov(chacha20_poly1305_ctx_t *ctx, const struct iovec *in, int n,
+                                  const struct iovec *out);
+
+/**
+ * Authenticate and decrypt the next part of the message from scattered buffers
+ * The plaintext is not authentic until chacha20_poly1305_verify succeeds.
+ * @param ctx AEAD context
+ * @param in Ciphertext segments
+ * @param n Number of input segments
+ * @param out Plaintext segments, n entries; NULL (or in) to work in place
+ * @return 0 on success, -1 if n is negative, out holds fewer bytes than in
+ *         or the message would exceed CHACHA20_POLY1305_MAX_DATA
+ */
+int chacha20_poly1305_decrypt_iov(chacha20_poly1305_ctx_t *ctx, const struct iovec *in, int n,
+                                  const struct iovec *out);
+
+/**
+ * Output the tag; the context is wiped
+ * @param ctx AEAD context
+ * @param tag Output 16-byte tag
+ */
+void chacha20_poly1305_final(chacha20_poly1305_ctx_t *ctx, uint8_t tag[CHACHA20_POLY1305_TAG_SIZE]);
+
+/**
+ * Check a received tag in constant time; the context is wiped
+ * @param ctx AEAD context
+ * @param tag Received 16-byte tag
+ * @return 0 if the tag is valid, -1 otherwise
+ */
+int chacha20_poly1305_verify(chacha20_poly1305_ctx_t *ctx, const uint8_t tag[CHACHA20_POLY1305_TAG_SIZE]);
+
+/**
+ * Encrypt and authenticate a whole message
+ * @param key 32-byte key
+ * @param nonce 12-byte nonce
+ * @param aad Associated data (may be NULL when aad_len is 0)
+ * @param aad_len Length of aad in bytes
+ * @param input Plaintext
+ * @param length Length of plaintext in bytes
+ * @param output Ciphertext, same length as the plaintext (can be the same as input)
+ * @param tag Output 16-byte tag
+ * @return 0 on success, -1 if length exceeds CHACHA20_POLY1305_MAX_DATA
+ */
+int chacha20_poly1305_seal(const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                           const uint8_t nonce[CHACHA20_POLY1305_NONCE_SIZE],
+                           const uint8_t *aad, size_t aad_len,
+                           const uint8_t *input, size_t length, uint8_t *output,
+                           uint8_t tag[CHACHA20_POLY1305_TAG_SIZE]);
+
+/**
+ * Verify and decrypt a whole message; nothing is decrypted unless the tag is valid
+ * @param key 32-byte key
+ * @param nonce 12-byte nonce
+ * @param aad Associated data (may be NULL when aad_len is 0)
+ * @param aad_len Length of aad in bytes
+ * @param input Ciphertext
+ * @param length Length of ciphertext in bytes
+ * @param tag Received 16-byte tag
+ * @param output Plaintext, same length as the ciphertext (can be the same as input)
+ * @return 0 on success, -1 if length exceeds CHACHA20_POLY1305_MAX_DATA or authentication
+ *         fails (output is zeroed unless it aliases input)
+ */
+int chacha20_poly1305_open(const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                           const uint8_t nonce[CHACHA20_POLY1305_NONCE_SIZE],
+                           const uint8_t *aad, size_t aad_len,
+                           const uint8_t *input, size_t length,
+                           const uint8_t tag[CHACHA20_POLY1305_TAG_SIZE], uint8_t *output);
+
+/**
+ * XChaCha20-Poly1305 version of chacha20_poly1305_seal
+ */
+int xchacha20_poly1305_seal(const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                            const uint8_t nonce[XCHACHA20_POLY1305_NONCE_SIZE],
+                            const uint8_t *aad, size_t aad_len,
+                            const uint8_t *input, size_t length, uint8_t *output,
+                            uint8_t tag[CHACHA20_POLY1305_TAG_SIZE]);
+
+/**
+ * XChaCha20-Poly1305 version of chacha20_poly1305_open
+ */
+int xchacha20_poly1305_open(const uint8_t key[CHACHA20_POLY1305_KEY_SIZE],
+                            const uint8_t nonce[XCHACHA20_POLY1305_NONCE_SIZE],
+                            const uint8_t *aad, size_t aad_len,
+                            const uint8_t *input, size_t length,
+                            const uint8_t tag[CHACHA20_POLY1305_TAG_SIZE], uint8_t *output);
+
+#endif // CHACHA20_POLY1305_H
@@ -0,0 +1,338 @@
+#include "ChaCha20_simd.h"
+
+#if CHACHA20_HAVE_X86_SIMD
+
+#include <immintrin.h>
+#include <string.h>
+
+/*
+ * All kernels use the "vertical" layout: vector register i holds state word i of
+ * N independent blocks, one block per 32-bit lane, so a quarter round on the
+ * registers is N quarter rounds at once. After the rounds the 16 x N words are
+ * transposed back into N contiguous 64-byte blocks and XORed with the input.
+ */
+
+/**
+ * Quarter round on four registers, parameterized by the vector operations
+ */
+#define CHACHA20_QR(ADD, XOR, ROT16, ROT12, ROT8, ROT7, a, b, c, d) \
+    do { \
+        a = ADD(a, b); d = XOR(d, a); d = ROT16(d); \
+        c = ADD(c, d); b = XOR(b, c); b = ROT12(b); \
+        a = ADD(a, b); d = XOR(d, a); d = ROT8(d); \
+        c = ADD(c, d); b = XOR(b, c); b = ROT7(b); \
+    } while (0)
+
+/**
+ * Column round followed by diagonal round on x[16]
+ */
+#define CHACHA20_DOUBLE_ROUND(QR, x) \
+    do { \
+        QR(x[0], x[4], x[8],  x[12]); \
+        QR(x[1], x[5], x[9],  x[13]); \
+        QR(x[2], x[6], x[10], x[14]); \
+        QR(x[3], x[7], x[11], x[15]); \
+        QR(x[0], x[5], x[10], x[15]); \
+        QR(x[1], x[6], x[11], x[12]); \
+        QR(x[2], x[7], x[8],  x[13]); \
+        QR(x[3], x[4], x[9],  x[14]); \
+    } while (0)
+
+/**
+ * Tail of fewer blocks than the kernel width. A single block goes to the scalar
+ * kernel; more than one runs a full-width batch into a stack buffer, which is
+ * cheaper than handing them to narrower kernels and then to the scalar one.
+ */
+static void chacha20_simd_tail(chacha20_blocks_fn kernel, size_t width, const uint32_t state[16],
+                               uint32_t counter, const uint8_t *in, uint8_t *out, size_t blocks) {
+    uint8_t keystream[16 * 64];
+    size_t len = blocks * 64;
+    size_t i;
+
+    if (blocks == 1) {
+        chacha20_blocks_scalar(state, counter, in, out, 1);
+        return;
+    }
+
+    kernel(state, counter, NULL, keystream, width);
+    if (in) {
+        for (i = 0; i < len; i += 8) {
+            uint64_t a, b;
+            memcpy(&a, in + i, 8);
+            memcpy(&b, keystream + i, 8);
+            a ^= b;
+            memcpy(out + i, &a, 8);
+        }
+    } else {
+        memcpy(out, keystream, len);
+    }
+    memset(keystream, 0, width * 64);
+}
+
+/*
+ * SSE2: 4 blocks
+ */
+
+#define SSE2_ROTL(x, n) _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - (n)))
+#define SSE2_ROT16(x) SSE2_ROTL(x, 16)
+#define SSE2_ROT12(x) SSE2_ROTL(x, 12)
+#define SSE2_ROT8(x)  SSE2_ROTL(x, 8)
+#define SSE2_ROT7(x)  SSE2_ROTL(x, 7)
+#define SSE2_QR(a, b, c, d) \
+    CHACHA20_QR(_mm_add_epi32, _mm_xor_si128, SSE2_ROT16, SSE2_ROT12, SSE2_ROT8, SSE2_ROT7, a, b, c, d)
+
+__attribute__((target("sse2")))
+static inline void chacha20_sse2_xor_store(const uint8_t *in, uint8_t *out, __m128i v) {
+    if (in) {
+        v = _mm_xor_si128(v, _mm_loadu_si128((const __m128i *)in));
+    }
+    _mm_storeu_si128((__m128i *)out, v);
+}
+
+/**
+ * Transpose a 4x4 matrix of 32-bit words: afterwards register j holds words a..d of lane j
+ */
+__attribute__((target("sse2")))
+static inline void chacha20_sse2_transpose(__m128i *a, __m128i *b, __m128i *c, __m128i *d) {
+    __m128i t0 = _mm_unpacklo_epi32(*a, *b);
+    __m128i t1 = _mm_unpackhi_epi32(*a, *b);
+    __m128i t2 = _mm_unpacklo_epi32(*c, *d);
+    __m128i t3 = _mm_unpackhi_epi32(*c, *d);
+    *a = _mm_unpacklo_epi64(t0, t2);
+    *b = _mm_unpackhi_epi64(t0, t2);
+    *c = _mm_unpacklo_epi64(t1, t3);
+    *d = _mm_unpackhi_epi64(t1, t3);
+}
+
+__attribute__((target("sse2")))
+void chacha20_blocks_sse2(const uint32_t state[16], uint32_t counter,
+                          const uint8_t *in, uint8_t *out, size_t blocks) {
+    while (blocks >= 4) {
+        __m128i s[16], x[16];
+        int i;
+
+        for (i = 0; i < 16; i++) {
+            s[i] = _mm_set1_epi32((int)state[i]);
+        }
+        s[12] = _mm_add_epi32(_mm_set1_epi32((int)counter), _mm_setr_epi32(0, 1, 2, 3));
+
+        for (i = 0; i < 16; i++) {
+            x[i] = s[i];
+        }
+        for (i = 0; i < 10; i++) {
+            CHACHA20_DOUBLE_ROUND(SSE2_QR, x);
+        }
+        for (i = 0; i < 16; i++) {
+            x[i] = _mm_add_epi32(x[i], s[i]);
+        }
+
+        // Group g = words 4g..4g+3; after the transpose x[4g + j] is that group of block j
+        for (i = 0; i < 16; i += 4) {
+            chacha20_sse2_transpose(&x[i], &x[i + 1], &x[i + 2], &x[i + 3]);
+        }
+        for (i = 0; i < 4; i++) {
+            size_t off = 64 * (size_t)i;
+            chacha20_sse2_xor_store(in ? in + off : NULL,      out + off,      x[i]);
+            chacha20_sse2_xor_store(in ? in + off + 16 : NULL, out + off + 16, x[4 + i]);
+            chacha20_sse2_xor_store(in ? in + off + 32 : NULL, out + off + 32, x[8 + i]);
+            chacha20_sse2_xor_store(in ? in + off + 48 : NULL, out + off + 48, x[12 + i]);
+        }
+
+        counter += 4;
+        blocks -= 4;
+        if (in) {
+            in += 256;
+        }
+        out += 256;
+    }
+
+    if (blocks) {
+        chacha20_simd_tail(chacha20_blocks_sse2, 4, state, counter, in, out, blocks);
+    }
+}
+
+/*
+ * AVX2: 8 blocks, lane (128-bit half) h holds blocks 4h..4h+3
+ */
+
+#define AVX2_ROTL(x, n) _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+#define AVX2_ROT16(x) _mm256_shuffle_epi8(x, rot16)
+#define AVX2_ROT12(x) AVX2_ROTL(x, 12)
+#define AVX2_ROT8(x)  _mm256_shuffle_epi8(x, rot8)
+#define AVX2_ROT7(x)  AVX2_ROTL(x, 7)
+#define AVX2_QR(a, b, c, d) \
+    CHACHA20_QR(_mm256_add_epi32, _mm256_xor_si256, AVX2_ROT16, AVX2_ROT12, AVX2_ROT8, AVX2_ROT7, a, b, c, d)
+
+__attribute__((target("avx2")))
+static inline void chacha20_avx2_xor_store(const uint8_t *in, uint8_t *out, __m256i v) {
+    if (in) {
+        v = _mm256_xor_si256(v, _mm256_loadu_si256((const __m256i *)in));
+    }
+    _mm256_storeu_si256((__m256i *)out, v);
+}
+
+/**
+ * 4x4 transpose inside each 128-bit lane
+ */
+__attribute__((target("avx2")))
+static inline void chacha20_avx2_transpose(__m256i *a, __m256i *b, __m256i *c, __m256i *d) {
+    __m256i t0 = _mm256_unpacklo_epi32(*a, *b);
+    __m256i t1 = _mm256_unpackhi_epi32(*a, *b);
+    __m256i t2 = _mm256_unpacklo_epi32(*c, *d);
+    __m256i t3 = _mm256_unpackhi_epi32(*c, *d);
+    *a = _mm256_unpacklo_epi64(t0, t2);
+    *b = _mm256_unpackhi_epi64(t0, t2);
+    *c = _mm256_unpacklo_epi64(t1, t3);
+    *d = _mm256_unpackhi_epi64(t1, t3);
+}
+
+__attribute__((target("avx2")))
+void chacha20_blocks_avx2(const uint32_t state[16], uint32_t counter,
+                          const uint8_t *in, uint8_t *out, size_t blocks) {
+    const __m256i rot16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                           2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    const __m256i rot8 = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                          3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+
+    while (blocks >= 8) {
+        __m256i s[16], x[16];
+        int i;
+
+        for (i = 0; i < 16; i++) {
+            s[i] = _mm256_set1_epi32((int)state[i]);
+        }
+        s[12] = _mm256_add_epi32(_mm256_set1_epi32((int)counter),
+                                 _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+
+        for (i = 0; i < 16; i++) {
+            x[i] = s[i];
+        }
+        for (i = 0; i < 10; i++) {
+            CHACHA20_DOUBLE_ROUND(AVX2_QR, x);
+        }
+        for (i = 0; i < 16; i++) {
+            x[i] = _mm256_add_epi32(x[i], s[i]);
+        }
+
+        // After the in-lane transpose, lane h of x[4g + j] is group g of block 4h + j
+        for (i = 0; i < 16; i += 4) {
+            chacha20_avx2_transpose(&x[i], &x[i + 1], &x[i + 2], &x[i + 3]);
+        }
+        for (i = 0; i < 4; i++) {
+            size_t lo = 64 * (size_t)i;
+            size_t hi = 64 * (size_t)(i + 4);
+            chacha20_avx2_xor_store(in ? in + lo : NULL, out + lo,
+                                    _mm256_permute2x128_si256(x[i], x[4 + i], 0x20));
+            chacha20_avx2_xor_store(in ? in + lo + 32 : NULL, out + lo + 32,
+                                    _mm256_permute2x128_si256(x[8 + i], x[12 + i], 0x20));
+            chacha20_avx2_xor_store(in ? in + hi : NULL, out + hi,
+                                    _mm256_permute2x128_si256(x[i], x[4 + i], 0x31));
+            chacha20_avx2_xor_store(in ? in + hi + 32 : NULL, out + hi + 32,
+                                    _mm256_permute2x128_si256(x[8 + i], x[12 + i], 0x31));
+        }
+
+        counter += 8;
+        blocks -= 8;
+        if (in) {
+            in += 512;
+        }
+        out += 512;
+    }
+
+    if (blocks) {
+        chacha20_simd_tail(chacha20_blocks_avx2, 8, state, counter, in, out, blocks);
+    }
+}
+
+/*
+ * AVX-512: 16 blocks, lane (128-bit quarter) q holds blocks 4q..4q+3
+ */
+
+#define AVX512_ROT16(x) _mm512_rol_epi32(x, 16)
+#define AVX512_ROT12(x) _mm512_rol_epi32(x, 12)
+#define AVX512_ROT8(x)  _mm512_rol_epi32(x, 8)
+#define AVX512_ROT7(x)  _mm512_rol_epi32(x, 7)
+#define AVX512_QR(a, b, c, d) \
+    CHACHA20_QR(_mm512_add_epi32, _mm512_xor_si512, AVX512_ROT16, AVX512_ROT12, AVX512_ROT8, AVX512_ROT7, a, b, c, d)
+
+__attribute__((target("avx512f")))
+static inline void chacha20_avx512_xor_store(const uint8_t *in, uint8_t *out, __m512i v) {
+    if (in) {
+        v = _mm512_xor_si512(v, _mm512_loadu_si512((const void *)in));
+    }
+    _mm512_storeu_si512((void *)out, v);
+}
+
+/**
+ * 4x4 transpose inside each 128-bit lane
+ */
+__attribute__((target("avx512f")))
+static inline void chacha20_avx512_transpose(__m512i *a, __m512i *b, __m512i *c, __m512i *d) {
+    __m512i t0 = _mm512_unpacklo_epi32(*a, *b);
+    __m512i t1 = _mm512_unpackhi_epi32(*a, *b);
+    __m512i t2 = _mm512_unpacklo_epi32(*c, *d);
+    __m512i t3 = _mm512_unpackhi_epi32(*c, *d);
+    *a = _mm512_unpacklo_epi64(t0, t2);
+    *b = _mm512_unpackhi_epi64(t0, t2);
+    *c = _mm512_unpacklo_epi64(t1, t3);
+    *d = _mm512_unpackhi_epi64(t1, t3);
+}
+
+__attribute__((target("avx512f")))
+void chacha20_blocks_avx512(const uint32_t state[16], uint32_t counter,
+                            const uint8_t *in, uint8_t *out, size_t blocks) {
+    while (blocks >= 16) {
+        __m512i s[16], x[16];
+        int i;
+
+        for (i = 0; i < 16; i++) {
+            s[i] = _mm512_set1_epi32((int)state[i]);
+        }
+        s[12] = _mm512_add_epi32(_mm512_set1_epi32((int)counter),
+                                 _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                                   8, 9, 10, 11, 12, 13, 14, 15));
+
+        for (i = 0; i < 16; i++) {
+            x[i] = s[i];
+        }
+        for (i = 0; i < 10; i++) {
+            CHACHA20_DOUBLE_ROUND(AVX512_QR, x);
+        }
+        for (i = 0; i < 16; i++) {
+            x[i] = _mm512_add_epi32(x[i], s[i]);
+        }
+
+        // After the in-lane transpose, lane q of x[4g + j] is group g of block 4q + j
+        for (i = 0; i < 16; i += 4) {
+            chacha20_avx512_transpose(&x[i], &x[i + 1], &x[i + 2], &x[i + 3]);
+        }
+        for (i = 0; i < 4; i++) {
+            // Gather lane q of the four groups into block 4q + i
+            __m512i u0 = _mm512_shuffle_i32x4(x[i], x[4 + i], 0x44);
+            __m512i u1 = _mm512_shuffle_i32x4(x[i], x[4 + i], 0xee);
+            __m512i u2 = _mm512_shuffle_i32x4(x[8 + i], x[12 + i], 0x44);
+            __m512i u3 = _mm512_shuffle_i32x4(x[8 + i], x[12 + i], 0xee);
+            size_t off0 = 64 * (size_t)i;
+            size_t off1 = 64 * (size_t)(i + 4);
+            size_t off2 = 64 * (size_t)(i + 8);
+            size_t off3 = 64 * (size_t)(i + 12);
+            chacha20_avx512_xor_store(in ? in + off0 : NULL, out + off0, _mm512_shuffle_i32x4(u0, u2, 0x88));
+            chacha20_avx512_xor_store(in ? in + off1 : NULL, out + off1, _mm512_shuffle_i32x4(u0, u2, 0xdd));
+            chacha20_avx512_xor_store(in ? in + off2 : NULL, out + off2, _mm512_shuffle_i32x4(u1, u3, 0x88));
+            chacha20_avx512_xor_store(in ? in + off3 : NULL, out + off3, _mm512_shuffle_i32x4(u1, u3, 0xdd));
+        }
+
+        counter += 16;
+        blocks -= 16;
+        if (in) {
+            in += 1024;
+        }
+        out += 1024;
+    }
+
+    if (blocks) {
+        chacha20_simd_tail(chacha20_blocks_avx512, 16, state, counter, in, out, blocks);
+    }
+}
+
+#endif // CHACHA20_HAVE_X86_SIMD
@@ -0,0 +1,102 @@
+#ifndef CHACHA20_SIMD_H
+#define CHACHA20_SIMD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "ChaCha20.h"
+
+/*
+ * Internal interface between ChaCha20.c, ChaCha20Poly1305.c and the multi-block kernels.
+ * Not installed; applications select a backend through chacha20_set_backend().
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CHACHA20_HAVE_X86_SIMD 1
+#else
+#define CHACHA20_HAVE_X86_SIMD 0
+#endif
+
+/**
+ * Multi-block kernel
+ * Computes `blocks` consecutive keystream blocks of the key/nonce held in `state`
+ * (state[12] is ignored, blocks use counter, counter + 1, ...), XORs them with
+ * `in` and writes the result to `out`.
+ * @param in Input data, or NULL to write the raw keystream
+ * @param out Output buffer, may be exactly the same as `in`
+ */
+typedef void (*chacha20_blocks_fn)(const uint32_t state[16], uint32_t counter,
+                                   const uint8_t *in, uint8_t *out, size_t blocks);
+
+/**
+ * Portable one-block-at-a-time kernel, also used for single-block tails of the SIMD kernels
+ */
+void chacha20_blocks_scalar(const uint32_t state[16], uint32_t counter,
+                            const uint8_t *in, uint8_t *out, size_t blocks);
+
+#if CHACHA20_HAVE_X86_SIMD
+/**
+ * 4 blocks in parallel in SSE2 registers
+ */
+void chacha20_blocks_sse2(const uint32_t state[16], uint32_t counter,
+                          const uint8_t *in, uint8_t *out, size_t blocks);
+
+/**
+ * 8 blocks in parallel in AVX2 registers
+ */
+void chacha20_blocks_avx2(const uint32_t state[16], uint32_t counter,
+                          const uint8_t *in, uint8_t *out, size_t blocks);
+
+/**
+ * 16 blocks in parallel in AVX-512 registers
+ */
+void chacha20_blocks_avx512(const uint32_t state[16], uint32_t counter,
+                            const uint8_t *in, uint8_t *out, size_t blocks);
+#endif
+
+/*
+ * Scattered buffers
+ */
+
+#define CHACHA20_LOOKAHEAD_BLOCKS 16
+
+/**
+ * Keystream computed ahead for blocks that straddle segment boundaries,
+ * so they are produced by the SIMD kernel in batches instead of one by one
+ */
+typedef struct {
+    uint8_t keystream[CHACHA20_LOOKAHEAD_BLOCKS * 64];
+    size_t len;         // Bytes of keystream in the buffer
+    size_t pos;         // Bytes already used
+    size_t remaining;   // Bytes still to come in this call, bounds the lookahead
+} chacha20_lookahead_t;
+
+/**
+ * Start a scattered operation over `total` bytes
+ */
+void chacha20_lookahead_begin(chacha20_lookahead_t *la, size_t total);
+
+/**
+ * Encrypt the next `length` bytes of the operation
+ */
+void chacha20_lookahead_xor(chacha20_ctx_t *ctx, chacha20_lookahead_t *la,
+                            const uint8_t *in, uint8_t *out, size_t length);
+
+/**
+ * Finish: hand an unfinished block back to the context and wipe the buffer
+ */
+void chacha20_lookahead_end(chacha20_ctx_t *ctx, chacha20_lookahead_t *la);
+
+typedef void (*chacha20_iov_fn)(void *arg, const uint8_t *in, uint8_t *out, size_t length);
+
+/**
+ * Total input length of an iovec pair, checking that out (NULL means in place) is large enough
+ * @return 0 on success, -1 if n is negative or out is too small
+ */
+int chacha20_iov_length(const struct iovec *in, int n, const struct iovec *out, size_t *total);
+
+/**
+ * Call fn for each piece where an input segment and an output segment overlap, in stream order
+ */
+void chacha20_iov_walk(const struct iovec *in, int n, const struct iovec *out, chacha20_iov_fn fn, void *arg);
+
+#endif // CHACHA20_SIMD_H
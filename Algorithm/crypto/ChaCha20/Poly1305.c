@@ -0,0 +1,305 @@
+#include "Poly1305.h"
+#include <string.h>
+
+/**
+ * Little-endian reads and writes
+ */
+static uint32_t poly1305_le32(const uint8_t *p) {
+    return ((uint32_t)p[0]) |
+           ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+static void poly1305_write_le32(uint8_t *p, uint32_t val) {
+    p[0] = (uint8_t)(val);
+    p[1] = (uint8_t)(val >> 8);
+    p[2] = (uint8_t)(val >> 16);
+    p[3] = (uint8_t)(val >> 24);
+}
+
+/**
+ * Zero memory in a way the compiler cannot drop
+ */
+static void poly1305_wipe(void *p, size_t len) {
+    volatile uint8_t *v = (volatile uint8_t *)p;
+    while (len--) {
+        *v++ = 0;
+    }
+}
+
+#if defined(__SIZEOF_INT128__)
+
+/*
+ * Radix 2^64: h = h[0] + h[1] * 2^64 + h[2] * 2^128, r = r[0] + r[1] * 2^64.
+ * Clamping clears the low two bits of r[1], so r[1] * 2^128 = (r[1] / 4) * 2^130,
+ * which is congruent to 5 * r[1] / 4 = r[1] + (r[1] >> 2) modulo 2^130 - 5.
+ * Each 16-byte block costs four 64x64->128 multiplications.
+ */
+
+typedef unsigned __int128 poly1305_u128;
+
+static uint64_t poly1305_le64(const uint8_t *p) {
+    return (uint64_t)poly1305_le32(p) | ((uint64_t)poly1305_le32(p + 4) << 32);
+}
+
+void poly1305_init(poly1305_ctx_t *ctx, const uint8_t key[POLY1305_KEY_SIZE]) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->r[0] = poly1305_le64(key) & 0x0ffffffc0fffffffULL;
+    ctx->r[1] = poly1305_le64(key + 8) & 0x0ffffffc0ffffffcULL;
+    ctx->s[0] = poly1305_le32(key + 16);
+    ctx->s[1] = poly1305_le32(key + 20);
+    ctx->s[2] = poly1305_le32(key + 24);
+    ctx->s[3] = poly1305_le32(key + 28);
+}
+
+/**
+ * Absorb whole 16-byte blocks; hibit is 1 for message blocks and 0 for the padded last block
+ */
+static void poly1305_blocks(poly1305_ctx_t *ctx, const uint8_t *m, size_t blocks, uint64_t hibit) {
+    const uint64_t r0 = ctx->r[0];
+    const uint64_t r1 = ctx->r[1];
+    const uint64_t s1 = r1 + (r1 >> 2);
+    uint64_t h0 = ctx->h[0];
+    uint64_t h1 = ctx->h[1];
+    uint64_t h2 = ctx->h[2];
+
+    while (blocks--) {
+        poly1305_u128 d0, d1;
+        uint64_t c;
+
+        // h += m
+        d0 = (poly1305_u128)h0 + poly1305_le64(m);
+        h0 = (uint64_t)d0;
+        d1 = (poly1305_u128)h1 + poly1305_le64(m + 8) + (uint64_t)(d0 >> 64);
+        h1 = (uint64_t)d1;
+        h2 += (uint64_t)(d1 >> 64) + hibit;
+
+        // h *= r, partially reduced: h2 stays below 2^3 between blocks
+        d0 = (poly1305_u128)h0 * r0 + (poly1305_u128)h1 * s1;
+        d1 = (poly1305_u128)h0 * r1 + (poly1305_u128)h1 * r0 + (poly1305_u128)h2 * s1;
+        h2 = h2 * r0;
+
+        h0 = (uint64_t)d0;
+        d1 += (uint64_t)(d0 >> 64);
+        h1 = (uint64_t)d1;
+        h2 += (uint64_t)(d1 >> 64);
+
+        // Fold bits above 2^130 back in: 2^130 = 5
+        c = (h2 >> 2) + (h2 & ~(uint64_t)3);
+        h2 &= 3;
+        h0 += c;
+        c = (h0 < c);
+        h1 += c;
+        c = (h1 < c);
+        h2 += c;
+
+        m += 16;
+    }
+
+    ctx->h[0] = h0;
+    ctx->h[1] = h1;
+    ctx->h[2] = h2;
+}
+
+void poly1305_final(poly1305_ctx_t *ctx, uint8_t tag[POLY1305_TAG_SIZE]) {
+    uint64_t h0, h1, h2, g0, g1, g2, mask;
+    poly1305_u128 t;
+
+    if (ctx->buffer_len > 0) {
+        ctx->buffer[ctx->buffer_len] = 1;
+        memset(ctx->buffer + ctx->buffer_len + 1, 0, 16 - ctx->buffer_len - 1);
+        poly1305_blocks(ctx, ctx->buffer, 1, 0);
+    }
+
+    h0 = ctx->h[0];
+    h1 = ctx->h[1];
+    h2 = ctx->h[2];
+
+    // g = h + 5 - 2^130; use g if it did not underflow, in constant time
+    t = (poly1305_u128)h0 + 5;
+    g0 = (uint64_t)t;
+    t = (poly1305_u128)h1 + (uint64_t)(t >> 64);
+    g1 = (uint64_t)t;
+    g2 = h2 + (uint64_t)(t >> 64);
+    mask = 0 - (g2 >> 2);
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+
+    // tag = (h + s) mod 2^128
+    t = (poly1305_u128)h0 + ((uint64_t)ctx->s[0] | ((uint64_t)ctx->s[1] << 32));
+    h0 = (uint64_t)t;
+    t = (poly1305_u128)h1 + ((uint64_t)ctx->s[2] | ((uint64_t)ctx->s[3] << 32)) + (uint64_t)(t >> 64);
+    h1 = (uint64_t)t;
+
+    poly1305_write_le32(tag, (uint32_t)h0);
+    poly1305_write_le32(tag + 4, (uint32_t)(h0 >> 32));
+    poly1305_write_le32(tag + 8, (uint32_t)h1);
+    poly1305_write_le32(tag + 12, (uint32_t)(h1 >> 32));
+
+    poly1305_wipe(ctx, sizeof(*ctx));
+}
+
+#else
+
+/*
+ * Radix 2^26 for compilers without a 128-bit integer type:
+ * five limbs, 32x32->64 multiplications.
+ */
+
+void poly1305_init(poly1305_ctx_t *ctx, const uint8_t key[POLY1305_KEY_SIZE]) {
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->r[0] = (poly1305_le32(key)) & 0x3ffffff;
+    ctx->r[1] = (poly1305_le32(key + 3) >> 2) & 0x3ffff03;
+    ctx->r[2] = (poly1305_le32(key + 6) >> 4) & 0x3ffc0ff;
+    ctx->r[3] = (poly1305_le32(key + 9) >> 6) & 0x3f03fff;
+    ctx->r[4] = (poly1305_le32(key + 12) >> 8) & 0x00fffff;
+    ctx->s[0] = poly1305_le32(key + 16);
+    ctx->s[1] = poly1305_le32(key + 20);
+    ctx->s[2] = poly1305_le32(key + 24);
+    ctx->s[3] = poly1305_le32(key + 28);
+}
+
+static void poly1305_blocks(poly1305_ctx_t *ctx, const uint8_t *m, size_t blocks, uint64_t hibit) {
+    const uint32_t r0 = (uint32_t)ctx->r[0], r1 = (uint32_t)ctx->r[1], r2 = (uint32_t)ctx->r[2];
+    const uint32_t r3 = (uint32_t)ctx->r[3], r4 = (uint32_t)ctx->r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    const uint32_t hi = hibit ? (1UL << 24) : 0;
+    uint32_t h0 = (uint32_t)ctx->h[0], h1 = (uint32_t)ctx->h[1], h2 = (uint32_t)ctx->h[2];
+    uint32_t h3 = (uint32_t)ctx->h[3], h4 = (uint32_t)ctx->h[4];
+
+    while (blocks--) {
+        uint64_t d0, d1, d2, d3, d4;
+        uint32_t c;
+
+        h0 += (poly1305_le32(m)) & 0x3ffffff;
+        h1 += (poly1305_le32(m + 3) >> 2) & 0x3ffffff;
+        h2 += (poly1305_le32(m + 6) >> 4) & 0x3ffffff;
+        h3 += (poly1305_le32(m + 9) >> 6) & 0x3ffffff;
+        h4 += (poly1305_le32(m + 12) >> 8) | hi;
+
+        d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+        d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+        d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+        d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+        d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+
+        c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & 0x3ffffff;
+        d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & 0x3ffffff;
+        d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & 0x3ffffff;
+        d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & 0x3ffffff;
+        d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & 0x3ffffff;
+        h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+        h1 += c;
+
+        m += 16;
+    }
+
+    ctx->h[0] = h0; ctx->h[1] = h1; ctx->h[2] = h2; ctx->h[3] = h3; ctx->h[4] = h4;
+}
+
+void poly1305_final(poly1305_ctx_t *ctx, uint8_t tag[POLY1305_TAG_SIZE]) {
+    uint32_t h0, h1, h2, h3, h4, c;
+    uint32_t g0, g1, g2, g3, g4, mask;
+    uint64_t f;
+
+    if (ctx->buffer_len > 0) {
+        ctx->buffer[ctx->buffer_len] = 1;
+        memset(ctx->buffer + ctx->buffer_len + 1, 0, 16 - ctx->buffer_len - 1);
+        poly1305_blocks(ctx, ctx->buffer, 1, 0);
+    }
+
+    h0 = (uint32_t)ctx->h[0]; h1 = (uint32_t)ctx->h[1]; h2 = (uint32_t)ctx->h[2];
+    h3 = (uint32_t)ctx->h[3]; h4 = (uint32_t)ctx->h[4];
+
+    // Fully carry h
+    c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    // g = h + 5 - 2^130; use g if it did not underflow, in constant time
+    g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    g4 = h4 + c - (1UL << 26);
+    mask = (g4 >> 31) - 1;
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+    h2 = (h2 & ~mask) | (g2 & mask);
+    h3 = (h3 & ~mask) | (g3 & mask);
+    h4 = (h4 & ~mask) | (g4 & mask);
+
+    // h = h % 2^128, then tag = h + s
+    h0 = (h0) | (h1 << 26);
+    h1 = (h1 >> 6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 << 8);
+
+    f = (uint64_t)h0 + ctx->s[0]; h0 = (uint32_t)f;
+    f = (uint64_t)h1 + ctx->s[1] + (f >> 32); h1 = (uint32_t)f;
+    f = (uint64_t)h2 + ctx->s[2] + (f >> 32); h2 = (uint32_t)f;
+    f = (uint64_t)h3 + ctx->s[3] + (f >> 32); h3 = (uint32_t)f;
+
+    poly1305_write_le32(tag, h0);
+    poly1305_write_le32(tag + 4, h1);
+    poly1305_write_le32(tag + 8, h2);
+    poly1305_write_le32(tag + 12, h3);
+
+    poly1305_wipe(ctx, sizeof(*ctx));
+}
+
+#endif
+
+void poly1305_update(poly1305_ctx_t *ctx, const uint8_t *data, size_t length) {
+    // Top up a partial block first
+    if (ctx->buffer_len > 0) {
+        size_t want = 16 - ctx->buffer_len;
+        if (want > length) {
+            want = length;
+        }
+        memcpy(ctx->buffer + ctx->buffer_len, data, want);
+        ctx->buffer_len += want;
+        data += want;
+        length -= want;
+        if (ctx->buffer_len < 16) {
+            return;
+        }
+        poly1305_blocks(ctx, ctx->buffer, 1, 1);
+        ctx->buffer_len = 0;
+    }
+
+    if (length >= 16) {
+        size_t blocks = length / 16;
+        poly1305_blocks(ctx, data, blocks, 1);
+        data += blocks * 16;
+        length -= blocks * 16;
+    }
+
+    if (length > 0) {
+        memcpy(ctx->buffer, data, length);
+        ctx->buffer_len = length;
+    }
+}
+
+void poly1305_mac(const uint8_t key[POLY1305_KEY_SIZE], const uint8_t *data, size_t length,
+                  uint8_t tag[POLY1305_TAG_SIZE]) {
+    poly1305_ctx_t ctx;
+
+    poly1305_init(&ctx, key);
+    poly1305_update(&ctx, data, length);
+    poly1305_final(&ctx, tag);
+}
+
+int poly1305_tag_equal(const uint8_t a[POLY1305_TAG_SIZE], const uint8_t b[POLY1305_TAG_SIZE]) {
+    uint8_t diff = 0;
+    int i;
+
+    for (i = 0; i < POLY1305_TAG_SIZE; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
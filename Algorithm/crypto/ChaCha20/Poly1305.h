@@ -0,0 +1,68 @@
+#ifndef POLY1305_H
+#define POLY1305_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Poly1305 one-time authenticator (RFC 8439)
+ * A key must never be used for more than one message.
+ */
+
+#define POLY1305_KEY_SIZE 32
+#define POLY1305_TAG_SIZE 16
+
+/**
+ * Poly1305 context
+ * The accumulator uses 64-bit limbs when the compiler has a 128-bit integer type,
+ * and 26-bit limbs otherwise.
+ */
+typedef struct {
+    uint64_t r[5];          // Clamped key r
+    uint64_t h[5];          // Accumulator
+    uint32_t s[4];          // Key s, added at the end
+    uint8_t buffer[16];     // Partial block
+    size_t buffer_len;      // Bytes in buffer
+} poly1305_ctx_t;
+
+/**
+ * Initialize Poly1305 context
+ * @param ctx Poly1305 context
+ * @param key 32-byte one-time key (r || s)
+ */
+void poly1305_init(poly1305_ctx_t *ctx, const uint8_t key[POLY1305_KEY_SIZE]);
+
+/**
+ * Feed message data
+ * @param ctx Poly1305 context
+ * @param data Message data
+ * @param length Length of data in bytes
+ */
+void poly1305_update(poly1305_ctx_t *ctx, const uint8_t *data, size_t length);
+
+/**
+ * Finish and output the tag; the context is wiped
+ * @param ctx Poly1305 context
+ * @param tag Output 16-byte tag
+ */
+void poly1305_final(poly1305_ctx_t *ctx, uint8_t tag[POLY1305_TAG_SIZE]);
+
+/**
+ * Compute a tag in one call
+ * @param key 32-byte one-time key
+ * @param data Message data
+ * @param length Length of data in bytes
+ * @param tag Output 16-byte tag
+ */
+void poly1305_mac(const uint8_t key[POLY1305_KEY_SIZE], const uint8_t *data, size_t length,
+                  uint8_t tag[POLY1305_TAG_SIZE]);
+
+/**
+ * Compare two tags in constant time
+ * @param a First tag
+ * @param b Second tag
+ * @return 1 if equal, 0 otherwise
+ */
+int poly1305_tag_equal(const uint8_t a[POLY1305_TAG_SIZE], const uint8_t b[POLY1305_TAG_SIZE]);
+
+#endif // POLY1305_H
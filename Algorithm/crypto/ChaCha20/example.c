@@ -2,7 +2,24 @@
 #include <string.h>
 #include <stdint.h>
 #include <assert.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
 #include "ChaCha20.h"
+#include "Poly1305.h"
+#include "ChaCha20Poly1305.h"
+
+static int test_failures = 0;
+
+/**
+ * Print a check result and count failures
+ */
+static void check(int ok, const char *name) {
+    printf("%s %s %s\n", ok ? "✓" : "✗", name, ok ? "PASSED" : "FAILED");
+    if (!ok) {
+        test_failures++;
+    }
+}
 
 /**
  * Print hex data for debugging
@@ -190,6 +207,599 @@ void test_chacha20_counter_reset(void) {
     printf("\n");
 }
 
+/**
+ * Known-answer tests, run on every backend the CPU supports
+ */
+void test_chacha20_kat(void) {
+    printf("=== ChaCha20 Known-Answer Tests ===\n");
+
+    // RFC 8439 section 2.4.2
+    uint8_t key[32];
+    for (int i = 0; i < 32; i++) {
+        key[i] = (uint8_t)i;
+    }
+    const uint8_t nonce_242[12] = {0, 0, 0, 0, 0, 0, 0, 0x4a, 0, 0, 0, 0};
+    const char *plaintext = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+    const uint8_t expected_242[114] = {
+        0x6e, 0x2e, 0x35, 0x9a, 0x25, 0x68, 0xf9, 0x80, 0x41, 0xba, 0x07, 0x28, 0xdd, 0x0d, 0x69, 0x81,
+        0xe9, 0x7e, 0x7a, 0xec, 0x1d, 0x43, 0x60, 0xc2, 0x0a, 0x27, 0xaf, 0xcc, 0xfd, 0x9f, 0xae, 0x0b,
+        0xf9, 0x1b, 0x65, 0xc5, 0x52, 0x47, 0x33, 0xab, 0x8f, 0x59, 0x3d, 0xab, 0xcd, 0x62, 0xb3, 0x57,
+        0x16, 0x39, 0xd6, 0x24, 0xe6, 0x51, 0x52, 0xab, 0x8f, 0x53, 0x0c, 0x35, 0x9f, 0x08, 0x61, 0xd8,
+        0x07, 0xca, 0x0d, 0xbf, 0x50, 0x0d, 0x6a, 0x61, 0x56, 0xa3, 0x8e, 0x08, 0x8a, 0x22, 0xb6, 0x5e,
+        0x52, 0xbc, 0x51, 0x4d, 0x16, 0xcc, 0xf8, 0x06, 0x81, 0x8c, 0xe9, 0x1a, 0xb7, 0x79, 0x37, 0x36,
+        0x5a, 0xf9, 0x0b, 0xbf, 0x74, 0xa3, 0x5b, 0xe6, 0xb4, 0x0b, 0x8e, 0xed, 0xf2, 0x78, 0x5e, 0x42,
+        0x87, 0x4d
+    };
+
+    // RFC 8439 appendix A.1 test vector #1: all-zero key and nonce, counter 0
+    const uint8_t zero[32] = {0};
+    const uint8_t expected_a1[64] = {
+        0x76, 0xb8, 0xe0, 0xad, 0xa0, 0xf1, 0x3d, 0x90, 0x40, 0x5d, 0x6a, 0xe5, 0x53, 0x86, 0xbd, 0x28,
+        0xbd, 0xd2, 0x19, 0xb8, 0xa0, 0x8d, 0xed, 0x1a, 0xa8, 0x36, 0xef, 0xcc, 0x8b, 0x77, 0x0d, 0xc7,
+        0xda, 0x41, 0x59, 0x7c, 0x51, 0x57, 0x48, 0x8d, 0x77, 0x24, 0xe0, 0x3f, 0xb8, 0xd8, 0x4a, 0x37,
+        0x6a, 0x43, 0xb8, 0xf4, 0x15, 0x18, 0xa1, 0x1c, 0xc3, 0x87, 0xb6, 0x69, 0xb2, 0xee, 0x65, 0x86
+    };
+
+    // Key and nonce of RFC 8439 section 2.3.2, counter 1: 20 blocks reach every SIMD lane.
+    // Bytes at the start of blocks 0 and 19 and the ends of blocks 7 and 15 (from OpenSSL).
+    const uint8_t nonce_232[12] = {0, 0, 0, 0x09, 0, 0, 0, 0x4a, 0, 0, 0, 0};
+    const size_t long_offsets[4] = {0, 496, 1008, 1264};
+    const uint8_t expected_long[4][16] = {
+        {0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd, 0x1f, 0xa3, 0x20, 0x71, 0xc4},
+        {0xee, 0x47, 0x4e, 0x11, 0xf0, 0x19, 0x15, 0xca, 0xc6, 0x6e, 0x0f, 0x9a, 0xe9, 0x24, 0xad, 0x94},
+        {0x13, 0x75, 0x1f, 0x29, 0x87, 0x8a, 0x39, 0xce, 0x6f, 0x67, 0xd1, 0x91, 0x4c, 0xa6, 0x07, 0x05},
+        {0xb3, 0xb0, 0x7b, 0x76, 0x1f, 0xe7, 0x1c, 0x4f, 0xbe, 0xe1, 0x73, 0xef, 0xb9, 0x2d, 0x01, 0x66}
+    };
+
+    for (int b = CHACHA20_BACKEND_SCALAR; b <= CHACHA20_BACKEND_AVX512; b++) {
+        char name[96];
+        chacha20_ctx_t ctx;
+        uint8_t out[1280];
+
+        if (chacha20_set_backend((chacha20_backend_t)b) != 0) {
+            printf("- %s: not supported on this CPU\n", chacha20_backend_name((chacha20_backend_t)b));
+            continue;
+        }
+
+        chacha20_init(&ctx, key, nonce_242, 1);
+        chacha20_encrypt(&ctx, (const uint8_t *)plaintext, out, strlen(plaintext));
+        snprintf(name, sizeof(name), "%s RFC 8439 2.4.2 ciphertext", chacha20_backend_name((chacha20_backend_t)b));
+        check(memcmp(out, expected_242, sizeof(expected_242)) == 0, name);
+
+        chacha20_init(&ctx, zero, zero, 0);
+        chacha20_keystream(&ctx, out, 64);
+        snprintf(name, sizeof(name), "%s RFC 8439 A.1 #1 keystream", chacha20_backend_name((chacha20_backend_t)b));
+        check(memcmp(out, expected_a1, sizeof(expected_a1)) == 0, name);
+
+        chacha20_init(&ctx, key, nonce_232, 1);
+        chacha20_keystream(&ctx, out, sizeof(out));
+        int ok = 1;
+        for (int i = 0; i < 4; i++) {
+            ok &= memcmp(out + long_offsets[i], expected_long[i], 16) == 0;
+        }
+        snprintf(name, sizeof(name), "%s 20-block keystream", chacha20_backend_name((chacha20_backend_t)b));
+        check(ok, name);
+    }
+
+    chacha20_set_backend(CHACHA20_BACKEND_AUTO);
+    printf("\n");
+}
+
+/**
+ * Every backend must match the scalar one for any length and chunking
+ */
+void test_chacha20_backends_agree(void) {
+    printf("=== ChaCha20 Backend Consistency Test ===\n");
+
+    static uint8_t input[4096], expected[4096], output[4096];
+    uint8_t key[32], nonce[12];
+    unsigned int seed = 12345;
+
+    for (size_t i = 0; i < sizeof(input); i++) {
+        input[i] = (uint8_t)rand_r(&seed);
+    }
+    for (int i = 0; i < 32; i++) {
+        key[i] = (uint8_t)rand_r(&seed);
+    }
+    for (int i = 0; i < 12; i++) {
+        nonce[i] = (uint8_t)rand_r(&seed);
+    }
+
+    for (int b = CHACHA20_BACKEND_SSE2; b <= CHACHA20_BACKEND_AVX512; b++) {
+        int ok = 1;
+
+        if (!chacha20_backend_supported((chacha20_backend_t)b)) {
+            continue;
+        }
+        for (int t = 0; t < 200 && ok; t++) {
+            size_t len = (size_t)rand_r(&seed) % sizeof(input);
+            // Counters near 2^32 also check that every lane wraps like the scalar code
+            uint32_t counter = (t % 4 == 0) ? 0xfffffff8u : (uint32_t)rand_r(&seed);
+            chacha20_ctx_t ctx;
+
+            chacha20_set_backend(CHACHA20_BACKEND_SCALAR);
+            chacha20_init(&ctx, key, nonce, counter);
+            chacha20_encrypt(&ctx, input, expected, len);
+
+            // Same stream in random chunks, alternating encrypt and keystream-only calls
+            chacha20_set_backend((chacha20_backend_t)b);
+            chacha20_init(&ctx, key, nonce, counter);
+            for (size_t pos = 0; pos < len;) {
+                size_t chunk = (size_t)rand_r(&seed) % 700;
+                if (chunk > len - pos) {
+                    chunk = len - pos;
+                }
+                if (t % 2) {
+                    chacha20_keystream(&ctx, output + pos, chunk);
+                    for (size_t i = 0; i < chunk; i++) {
+                        output[pos + i] ^= input[pos + i];
+                    }
+                } else {
+                    chacha20_encrypt(&ctx, input + pos, output + pos, chunk);
+                }
+                pos += chunk;
+            }
+            ok = memcmp(output, expected, len) == 0;
+        }
+
+        char name[64];
+        snprintf(name, sizeof(name), "%s matches scalar", chacha20_backend_name((chacha20_backend_t)b));
+        check(ok, name);
+    }
+
+    chacha20_set_backend(CHACHA20_BACKEND_AUTO);
+    printf("\n");
+}
+
+/**
+ * Throughput of each backend on a 16KB buffer
+ */
+void benchmark_chacha20(void) {
+    printf("=== ChaCha20 Throughput (16KB buffer) ===\n");
+
+    static uint8_t buffer[16384];
+    uint8_t key[32] = {0};
+    uint8_t nonce[12] = {0};
+
+    for (int b = CHACHA20_BACKEND_SCALAR; b <= CHACHA20_BACKEND_AVX512; b++) {
+        chacha20_ctx_t ctx;
+        size_t rounds = 0;
+
+        if (chacha20_set_backend((chacha20_backend_t)b) != 0) {
+            continue;
+        }
+        clock_t start = clock();
+        clock_t elapsed;
+        do {
+            chacha20_init(&ctx, key, nonce, 0);
+            chacha20_encrypt(&ctx, buffer, buffer, sizeof(buffer));
+            rounds++;
+            elapsed = clock() - start;
+        } while (elapsed < CLOCKS_PER_SEC / 5);
+
+        double seconds = (double)elapsed / CLOCKS_PER_SEC;
+        printf("%-7s: %8.1f MB/s\n", chacha20_backend_name((chacha20_backend_t)b),
+               (double)rounds * sizeof(buffer) / seconds / 1e6);
+    }
+
+    chacha20_set_backend(CHACHA20_BACKEND_AUTO);
+    printf("Active backend: %s\n\n", chacha20_backend_name(chacha20_get_backend()));
+}
+
+/**
+ * Parallel encryption and seeking must match the sequential stream
+ */
+void test_chacha20_parallel(void) {
+    printf("=== ChaCha20 Parallel / Seek Test ===\n");
+
+    size_t size = 4 * CHACHA20_PARALLEL_MIN_CHUNK + 100;
+    uint8_t *input = malloc(size);
+    uint8_t *expected = malloc(size);
+    uint8_t *output = malloc(size);
+    uint8_t key[32], nonce[12];
+    unsigned int seed = 777;
+
+    assert(input && expected && output);
+    for (size_t i = 0; i < size; i++) {
+        input[i] = (uint8_t)rand_r(&seed);
+    }
+    for (int i = 0; i < 32; i++) {
+        key[i] = (uint8_t)rand_r(&seed);
+    }
+    for (int i = 0; i < 12; i++) {
+        nonce[i] = (uint8_t)rand_r(&seed);
+    }
+
+    int ok = 1;
+    for (size_t nthreads = 0; nthreads <= 4; nthreads++) {
+        // Start mid-block and near the counter wrap, then keep streaming afterwards
+        chacha20_ctx_t seq, par;
+        chacha20_init(&seq, key, nonce, 0xfffffff0u);
+        chacha20_encrypt(&seq, input, expected, size);
+
+        chacha20_init(&par, key, nonce, 0xfffffff0u);
+        chacha20_encrypt(&par, input, output, 13);
+        chacha20_encrypt_parallel(&par, input + 13, output + 13, size - 113, nthreads);
+        chacha20_encrypt(&par, input + size - 100, output + size - 100, 100);
+        ok &= memcmp(output, expected, size) == 0;
+    }
+    check(ok, "ChaCha20 parallel output matches sequential");
+
+    // In-place parallel decryption restores the plaintext
+    memcpy(output, expected, size);
+    chacha20_ctx_t ctx;
+    chacha20_init(&ctx, key, nonce, 0xfffffff0u);
+    chacha20_encrypt_parallel(&ctx, output, output, size, 4);
+    check(memcmp(output, input, size) == 0, "ChaCha20 parallel in-place decrypt");
+
+    // Random access: decrypt a slice without the bytes before it
+    ok = 1;
+    for (int t = 0; t < 100; t++) {
+        size_t offset = (size_t)rand_r(&seed) % (size - 1000);
+        size_t len = (size_t)rand_r(&seed) % 1000;
+        chacha20_keystream(&ctx, output, 7); // Position before the seek must not matter
+        chacha20_seek(&ctx, offset);
+        chacha20_decrypt(&ctx, expected + offset, output, len);
+        ok &= memcmp(output, input + offset, len) == 0;
+    }
+    check(ok, "ChaCha20 seek");
+
+    free(input);
+    free(expected);
+    free(output);
+    printf("\n");
+}
+
+/**
+ * Wall-clock throughput of chacha20_encrypt_parallel on a 64MB buffer
+ */
+void benchmark_chacha20_parallel(void) {
+    printf("=== ChaCha20 Parallel Throughput (64MB buffer) ===\n");
+
+    size_t size = 64 * 1024 * 1024;
+    uint8_t *buffer = calloc(size, 1);
+    uint8_t key[32] = {0};
+    uint8_t nonce[12] = {0};
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    assert(buffer);
+    // Touch every page once so the first measurement does not include page faults
+    memset(buffer, 1, size);
+    for (size_t nthreads = 1; nthreads <= 8; nthreads *= 2) {
+        struct timespec start, end;
+        chacha20_ctx_t ctx;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int r = 0; r < 4; r++) {
+            chacha20_init(&ctx, key, nonce, 0);
+            chacha20_encrypt_parallel(&ctx, buffer, buffer, size, nthreads);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+        printf("%zu thread(s): %8.1f MB/s\n", nthreads, 4.0 * size / seconds / 1e6);
+    }
+    printf("Online CPUs: %ld\n\n", cpus);
+    free(buffer);
+}
+
+/**
+ * Scattered buffers must give the same stream as one contiguous buffer
+ */
+void test_chacha20_iov(void) {
+    printf("=== ChaCha20 Scatter/Gather Test ===\n");
+
+    static uint8_t input[3000], expected[3000], output[3000], buffer[3000];
+    uint8_t key[32], nonce[12], tag[16], expected_tag[16];
+    const uint8_t aad[5] = {1, 2, 3, 4, 5};
+    unsigned int seed = 4242;
+
+    for (size_t i = 0; i < sizeof(input); i++) {
+        input[i] = (uint8_t)rand_r(&seed);
+    }
+    for (int i = 0; i < 32; i++) {
+        key[i] = (uint8_t)rand_r(&seed);
+    }
+    for (int i = 0; i < 12; i++) {
+        nonce[i] = (uint8_t)rand_r(&seed);
+    }
+
+    // Input split at odd offsets, output split differently, one empty segment
+    const size_t in_cuts[5] = {1, 63, 0, 700, 2236};
+    const size_t out_cuts[5] = {100, 1000, 1500, 399, 1};
+    struct iovec in[5], out[5], inplace[5];
+    size_t in_pos = 0, out_pos = 0;
+    for (int i = 0; i < 5; i++) {
+        in[i].iov_base = input + in_pos;
+        in[i].iov_len = in_cuts[i];
+        inplace[i].iov_base = buffer + in_pos;
+        inplace[i].iov_len = in_cuts[i];
+        out[i].iov_base = output + out_pos;
+        out[i].iov_len = out_cuts[i];
+        in_pos += in_cuts[i];
+        out_pos += out_cuts[i];
+    }
+
+    chacha20_ctx_t ctx;
+    chacha20_init(&ctx, key, nonce, 1);
+    chacha20_encrypt(&ctx, input, expected, sizeof(input));
+
+    chacha20_init(&ctx, key, nonce, 1);
+    check(chacha20_encrypt_iov(&ctx, in, 5, out) == 0 && memcmp(output, expected, sizeof(expected)) == 0,
+          "ChaCha20 iov encrypt");
+
+    memcpy(buffer, input, sizeof(input));
+    chacha20_init(&ctx, key, nonce, 1);
+    check(chacha20_encrypt_iov(&ctx, inplace, 5, NULL) == 0 && memcmp(buffer, expected, sizeof(expected)) == 0,
+          "ChaCha20 iov in place");
+
+    out[4].iov_len = 0;
+    check(chacha20_encrypt_iov(&ctx, in, 5, out) == -1, "ChaCha20 iov rejects short output");
+    out[4].iov_len = 1;
+
+    // AEAD: scattered seal and open against the one-shot functions
+    chacha20_poly1305_ctx_t aead;
+    chacha20_poly1305_seal(key, nonce, aad, sizeof(aad), input, sizeof(input), expected, expected_tag);
+
+    chacha20_poly1305_init(&aead, key, nonce);
+    chacha20_poly1305_update_aad(&aead, aad, sizeof(aad));
+    chacha20_poly1305_encrypt_iov(&aead, in, 5, out);
+    chacha20_poly1305_final(&aead, tag);
+    check(memcmp(output, expected, sizeof(expected)) == 0 && memcmp(tag, expected_tag, 16) == 0,
+          "ChaCha20-Poly1305 iov encrypt");
+
+    memcpy(buffer, expected, sizeof(expected));
+    chacha20_poly1305_init(&aead, key, nonce);
+    chacha20_poly1305_update_aad(&aead, aad, sizeof(aad));
+    chacha20_poly1305_decrypt_iov(&aead, inplace, 5, NULL);
+    check(chacha20_poly1305_verify(&aead, tag) == 0 && memcmp(buffer, input, sizeof(input)) == 0,
+          "ChaCha20-Poly1305 iov decrypt in place");
+    printf("\n");
+}
+
+/**
+ * 1500-byte packets: encrypt in place through iovecs versus copying into a staging buffer
+ */
+void benchmark_chacha20_iov(void) {
+    printf("=== ChaCha20 Scatter/Gather Throughput (64 x 1500-byte packets) ===\n");
+
+    enum { PACKETS = 64, PACKET_SIZE = 1500 };
+    static uint8_t packets[PACKETS][PACKET_SIZE];
+    static uint8_t staging[PACKETS * PACKET_SIZE];
+    struct iovec iov[PACKETS];
+    uint8_t key[32] = {0};
+    uint8_t nonce[12] = {0};
+
+    for (int i = 0; i < PACKETS; i++) {
+        iov[i].iov_base = packets[i];
+        iov[i].iov_len = PACKET_SIZE;
+    }
+
+    for (int mode = 0; mode < 2; mode++) {
+        chacha20_ctx_t ctx;
+        size_t rounds = 0;
+        clock_t start = clock();
+        clock_t elapsed;
+        do {
+            chacha20_init(&ctx, key, nonce, 0);
+            if (mode == 0) {
+                // Gather, encrypt, scatter back
+                for (int i = 0; i < PACKETS; i++) {
+                    memcpy(staging + i * PACKET_SIZE, packets[i], PACKET_SIZE);
+                }
+                chacha20_encrypt(&ctx, staging, staging, sizeof(staging));
+                for (int i = 0; i < PACKETS; i++) {
+                    memcpy(packets[i], staging + i * PACKET_SIZE, PACKET_SIZE);
+                }
+            } else {
+                chacha20_encrypt_iov(&ctx, iov, PACKETS, NULL);
+            }
+            rounds++;
+            elapsed = clock() - start;
+        } while (elapsed < CLOCKS_PER_SEC / 5);
+
+        double seconds = (double)elapsed / CLOCKS_PER_SEC;
+        printf("%-13s: %8.1f MB/s\n", mode == 0 ? "staging copy" : "iovec",
+               (double)rounds * sizeof(staging) / seconds / 1e6);
+    }
+    printf("\n");
+}
+
+/**
+ * Poly1305 with the RFC 8439 section 2.5.2 vector, in one call and byte by byte
+ */
+void test_poly1305_kat(void) {
+    printf("=== Poly1305 Known-Answer Test ===\n");
+
+    const uint8_t key[32] = {
+        0x85, 0xd6, 0xbe, 0x78, 0x57, 0x55, 0x6d, 0x33, 0x7f, 0x44, 0x52, 0xfe, 0x42, 0xd5, 0x06, 0xa8,
+        0x01, 0x03, 0x80, 0x8a, 0xfb, 0x0d, 0xb2, 0xfd, 0x4a, 0xbf, 0xf6, 0xaf, 0x41, 0x49, 0xf5, 0x1b
+    };
+    const char *message = "Cryptographic Forum Research Group";
+    const uint8_t expected[16] = {
+        0xa8, 0x06, 0x1d, 0xc1, 0x30, 0x51, 0x36, 0xc6, 0xc2, 0x2b, 0x8b, 0xaf, 0x0c, 0x01, 0x27, 0xa9
+    };
+    uint8_t tag[16];
+    poly1305_ctx_t ctx;
+
+    poly1305_mac(key, (const uint8_t *)message, strlen(message), tag);
+    check(memcmp(tag, expected, sizeof(expected)) == 0, "Poly1305 RFC 8439 2.5.2 tag");
+
+    poly1305_init(&ctx, key);
+    for (size_t i = 0; i < strlen(message); i++) {
+        poly1305_update(&ctx, (const uint8_t *)message + i, 1);
+    }
+    poly1305_final(&ctx, tag);
+    check(memcmp(tag, expected, sizeof(expected)) == 0, "Poly1305 byte-by-byte update");
+
+    check(poly1305_tag_equal(tag, expected) && !poly1305_tag_equal(tag, key), "Poly1305 tag comparison");
+    printf("\n");
+}
+
+/**
+ * ChaCha20-Poly1305 with the RFC 8439 section 2.8.2 vector
+ */
+void test_chacha20_poly1305_aead(void) {
+    printf("=== ChaCha20-Poly1305 AEAD Test ===\n");
+
+    uint8_t key[32];
+    for (int i = 0; i < 32; i++) {
+        key[i] = (uint8_t)(0x80 + i);
+    }
+    const uint8_t nonce[12] = {0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+    const uint8_t aad[12] = {0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
+    const char *plaintext = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+    const uint8_t expected_ct[114] = {
+        0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+        0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+        0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+        0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+        0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+        0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+        0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+        0x61, 0x16
+    };
+    const uint8_t expected_tag[16] = {
+        0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+    };
+    size_t len = strlen(plaintext);
+    uint8_t ciphertext[114], decrypted[114], tag[16];
+    chacha20_poly1305_ctx_t ctx;
+
+    chacha20_poly1305_seal(key, nonce, aad, sizeof(aad), (const uint8_t *)plaintext, len, ciphertext, tag);
+    check(memcmp(ciphertext, expected_ct, len) == 0 && memcmp(tag, expected_tag, 16) == 0,
+          "ChaCha20-Poly1305 RFC 8439 2.8.2 seal");
+
+    check(chacha20_poly1305_open(key, nonce, aad, sizeof(aad), ciphertext, len, tag, decrypted) == 0 &&
+          memcmp(decrypted, plaintext, len) == 0, "ChaCha20-Poly1305 open");
+
+    // Incremental API with uneven pieces gives the same result
+    chacha20_poly1305_init(&ctx, key, nonce);
+    chacha20_poly1305_update_aad(&ctx, aad, 5);
+    chacha20_poly1305_update_aad(&ctx, aad + 5, sizeof(aad) - 5);
+    chacha20_poly1305_encrypt(&ctx, (const uint8_t *)plaintext, ciphertext, 7);
+    chacha20_poly1305_encrypt(&ctx, (const uint8_t *)plaintext + 7, ciphertext + 7, len - 7);
+    chacha20_poly1305_final(&ctx, tag);
+    check(memcmp(ciphertext, expected_ct, len) == 0 && memcmp(tag, expected_tag, 16) == 0,
+          "ChaCha20-Poly1305 incremental encrypt");
+
+    chacha20_poly1305_init(&ctx, key, nonce);
+    chacha20_poly1305_update_aad(&ctx, aad, sizeof(aad));
+    chacha20_poly1305_decrypt(&ctx, ciphertext, decrypted, 50);
+    chacha20_poly1305_decrypt(&ctx, ciphertext + 50, decrypted + 50, len - 50);
+    check(chacha20_poly1305_verify(&ctx, tag) == 0 && memcmp(decrypted, plaintext, len) == 0,
+          "ChaCha20-Poly1305 incremental decrypt");
+
+    // The 32-bit block counter must not wrap back to the Poly1305 key block
+    chacha20_poly1305_init(&ctx, key, nonce);
+    ctx.data_len = CHACHA20_POLY1305_MAX_DATA - 16;
+    int limited = chacha20_poly1305_encrypt(&ctx, decrypted, decrypted, 17) == -1 &&
+                  ctx.data_len == CHACHA20_POLY1305_MAX_DATA - 16 &&
+                  chacha20_poly1305_encrypt(&ctx, decrypted, decrypted, 16) == 0 &&
+                  chacha20_poly1305_decrypt(&ctx, decrypted, decrypted, 1) == -1;
+    struct iovec one = {decrypted, 1};
+    limited &= chacha20_poly1305_encrypt_iov(&ctx, &one, 1, NULL) == -1;
+    chacha20_poly1305_final(&ctx, tag);
+    check(limited, "ChaCha20-Poly1305 message length limit");
+
+    // Any change to the ciphertext, AAD or tag must be rejected
+    chacha20_poly1305_seal(key, nonce, aad, sizeof(aad), (const uint8_t *)plaintext, len, ciphertext, tag);
+    int rejected = 1;
+    ciphertext[10] ^= 1;
+    rejected &= chacha20_poly1305_open(key, nonce, aad, sizeof(aad), ciphertext, len, tag, decrypted) == -1;
+    ciphertext[10] ^= 1;
+    rejected &= chacha20_poly1305_open(key, nonce, aad, sizeof(aad) - 1, ciphertext, len, tag, decrypted) == -1;
+    tag[15] ^= 0x80;
+    rejected &= chacha20_poly1305_open(key, nonce, aad, sizeof(aad), ciphertext, len, tag, decrypted) == -1;
+    for (size_t i = 0; i < len; i++) {
+        rejected &= decrypted[i] == 0;
+    }
+    check(rejected, "ChaCha20-Poly1305 rejects forgeries");
+    printf("\n");
+}
+
+/**
+ * HChaCha20 and XChaCha20-Poly1305 vectors from draft-irtf-cfrg-xchacha
+ */
+void test_xchacha20_poly1305(void) {
+    printf("=== XChaCha20-Poly1305 Test ===\n");
+
+    uint8_t key[32];
+    for (int i = 0; i < 32; i++) {
+        key[i] = (uint8_t)i;
+    }
+    const uint8_t hnonce[16] = {
+        0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00, 0x31, 0x41, 0x59, 0x27
+    };
+    const uint8_t expected_subkey[32] = {
+        0x82, 0x41, 0x3b, 0x42, 0x27, 0xb2, 0x7b, 0xfe, 0xd3, 0x0e, 0x42, 0x50, 0x8a, 0x87, 0x7d, 0x73,
+        0xa0, 0xf9, 0xe4, 0xd5, 0x8a, 0x74, 0xa8, 0x53, 0xc1, 0x2e, 0xc4, 0x13, 0x26, 0xd3, 0xec, 0xdc
+    };
+    uint8_t subkey[32];
+
+    hchacha20(key, hnonce, subkey);
+    check(memcmp(subkey, expected_subkey, sizeof(subkey)) == 0, "HChaCha20 subkey");
+
+    for (int i = 0; i < 32; i++) {
+        key[i] = (uint8_t)(0x80 + i);
+    }
+    uint8_t nonce[24];
+    for (int i = 0; i < 24; i++) {
+        nonce[i] = (uint8_t)(0x40 + i);
+    }
+    const uint8_t aad[12] = {0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
+    const char *plaintext = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+    const uint8_t expected_ct_head[16] = {
+        0xbd, 0x6d, 0x17, 0x9d, 0x3e, 0x83, 0xd4, 0x3b, 0x95, 0x76, 0x57, 0x94, 0x93, 0xc0, 0xe9, 0x39
+    };
+    const uint8_t expected_tag[16] = {
+        0xc0, 0x87, 0x59, 0x24, 0xc1, 0xc7, 0x98, 0x79, 0x47, 0xde, 0xaf, 0xd8, 0x78, 0x0a, 0xcf, 0x49
+    };
+    size_t len = strlen(plaintext);
+    uint8_t buffer[114], tag[16];
+
+    // Seal and open in place
+    memcpy(buffer, plaintext, len);
+    xchacha20_poly1305_seal(key, nonce, aad, sizeof(aad), buffer, len, buffer, tag);
+    check(memcmp(buffer, expected_ct_head, 16) == 0 && memcmp(tag, expected_tag, 16) == 0,
+          "XChaCha20-Poly1305 draft A.3.1 seal");
+    check(xchacha20_poly1305_open(key, nonce, aad, sizeof(aad), buffer, len, tag, buffer) == 0 &&
+          memcmp(buffer, plaintext, len) == 0, "XChaCha20-Poly1305 open in place");
+    printf("\n");
+}
+
+/**
+ * Throughput of Poly1305 and the AEAD on a 16KB buffer
+ */
+void benchmark_aead(void) {
+    printf("=== Poly1305 / AEAD Throughput (16KB buffer) ===\n");
+
+    static uint8_t buffer[16384];
+    uint8_t key[32] = {1};
+    uint8_t nonce[12] = {0};
+    uint8_t tag[16];
+
+    for (int mode = 0; mode < 2; mode++) {
+        size_t rounds = 0;
+        clock_t start = clock();
+        clock_t elapsed;
+        do {
+            if (mode == 0) {
+                poly1305_mac(key, buffer, sizeof(buffer), tag);
+            } else {
+                chacha20_poly1305_seal(key, nonce, NULL, 0, buffer, sizeof(buffer), buffer, tag);
+            }
+            rounds++;
+            elapsed = clock() - start;
+        } while (elapsed < CLOCKS_PER_SEC / 5);
+
+        double seconds = (double)elapsed / CLOCKS_PER_SEC;
+        printf("%-17s: %8.1f MB/s\n", mode == 0 ? "Poly1305" : "ChaCha20-Poly1305",
+               (double)rounds * sizeof(buffer) / seconds / 1e6);
+    }
+    printf("\n");
+}
+
 /**
  * Main function to run all ChaCha20 tests
  */
@@ -201,7 +811,18 @@ int main(void) {
     test_chacha20_keystream();
     test_chacha20_inplace();
     test_chacha20_counter_reset();
+    test_chacha20_kat();
+    test_chacha20_backends_agree();
+    benchmark_chacha20();
+    test_chacha20_parallel();
+    benchmark_chacha20_parallel();
+    test_poly1305_kat();
+    test_chacha20_poly1305_aead();
+    test_xchacha20_poly1305();
+    test_chacha20_iov();
+    benchmark_aead();
+    benchmark_chacha20_iov();
     
     printf("All ChaCha20 tests completed!\n");
-    return 0;
+    return test_failures == 0 ? 0 : 1;
 }
@@ -8,6 +8,7 @@
  * 1. 字符串哈希算法：AP, BKDR, DJB2, ELF, JS, PJW, RS, SDBM
  * 2. 简单哈希算法：Division Hash, Multiplication Hash
  * 3. 密码学哈希算法：MD5
+ * 4. 64 位快速哈希算法：wyhash
  * 
  * gcc example.c .\*\*.c -o test
  */
@@ -27,6 +28,8 @@
 #include "SDBMHash/SDBMHash.h"
 #include "SimpleHash/SimpleHash.h"
 #include "MD5/md5.h"
+#include "WyHash/wyhash.h"
+#include <time.h>
 
 // 测试用的字符串
 static const char* test_strings[] = {
@@ -235,6 +238,86 @@ void demo_hash_collision_detection(void) {
     printf("\n");
 }
 
+/**
+ * @brief 演示 wyhash 以及与逐字节哈希的吞吐对比
+ */
+void demo_wyhash_algorithm(void) {
+    printf("=== wyhash 64 位哈希演示 ===\n\n");
+    
+    printf("%-30s | %-18s | %-18s\n", "字符串", "种子 0", "种子 42");
+    printf("-------------------------------+--------------------+-------------------\n");
+    for (size_t i = 0; i < TEST_STRING_COUNT; i++) {
+        const char* str = test_strings[i];
+        const char* display_str = (strlen(str) == 0) ? "(空字符串)" : str;
+        printf("%-30s | 0x%016llX | 0x%016llX\n", display_str,
+               (unsigned long long)wyhash(str, strlen(str), 0),
+               (unsigned long long)wyhash(str, strlen(str), 42));
+    }
+    
+    // 官方测试向量（种子为序号）
+    static const char* vectors[] = {
+        "", "a", "abc", "message digest", "abcdefghijklmnopqrstuvwxyz",
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+        "12345678901234567890123456789012345678901234567890123456789012345678901234567890"
+    };
+    static const uint64_t expected[] = {
+        0x93228a4de0eec5a2ULL, 0xc5bac3db178713c4ULL, 0xa97f2f7b1d9b3314ULL,
+        0x786d1f1df3801df4ULL, 0xdca5a8138ad37c87ULL, 0xb9e734f117cfaf70ULL,
+        0x6cc5eab49a92d617ULL
+    };
+    int passed = 0;
+    for (int i = 0; i < 7; i++) {
+        passed += wyhash(vectors[i], strlen(vectors[i]), i) == expected[i];
+    }
+    printf("\n测试向量: %d/7 通过\n", passed);
+    
+    // 整数快速路径与通用路径结果一致（小端）
+    uint64_t v = 0x0123456789abcdefULL;
+    printf("wyhash_u64 与 wyhash(8 字节) 一致: %s\n",
+           wyhash_u64(v, 7) == wyhash(&v, sizeof(v), 7) ? "是" : "否");
+    
+    // 40~200 字节键的吞吐对比
+    enum { KEY_COUNT = 1024, ROUNDS = 2000 };
+    static char keys[KEY_COUNT][201];
+    size_t lens[KEY_COUNT];
+    unsigned int rnd = 1;
+    for (int i = 0; i < KEY_COUNT; i++) {
+        rnd = rnd * 1103515245u + 12345u;
+        lens[i] = 40 + (rnd >> 8) % 161;
+        for (size_t j = 0; j < lens[i]; j++) {
+            rnd = rnd * 1103515245u + 12345u;
+            keys[i][j] = 'a' + (rnd >> 16) % 26;
+        }
+        keys[i][lens[i]] = '\0';
+    }
+    
+    size_t total = 0;
+    for (int i = 0; i < KEY_COUNT; i++) {
+        total += lens[i];
+    }
+    
+    uint64_t sink = 0;
+    clock_t start = clock();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < KEY_COUNT; i++) {
+            sink += DJB2Hash(keys[i]);
+        }
+    }
+    double djb2_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    
+    start = clock();
+    for (int r = 0; r < ROUNDS; r++) {
+        for (int i = 0; i < KEY_COUNT; i++) {
+            sink += wyhash(keys[i], lens[i], r);
+        }
+    }
+    double wy_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+    
+    double mb = (double)total * ROUNDS / (1024.0 * 1024.0);
+    printf("40~200 字节键吞吐: DJB2 %.0f MB/s, wyhash %.0f MB/s (校验和 %llu)\n\n",
+           mb / djb2_time, mb / wy_time, (unsigned long long)(sink & 0xff));
+}
+
 /**
  * @brief 主函数
  */
@@ -248,6 +331,7 @@ int main(void) {
     demo_md5_algorithm();
     demo_md5_incremental();
     demo_hash_collision_detection();
+    demo_wyhash_algorithm();
     
     printf("演示完成！\n");
 
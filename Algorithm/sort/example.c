@@ -1,8 +1,16 @@
 #include "sort.h"
+#include "sort_define.h"
+#include "external_sort.h"
+#include "sort_calibrate.h"
 #include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
 #include <string.h>
 #include <time.h>
 #include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
 
 // 整数比较函数
 int compare_int(const void *a, const void *b, void *context) 
@@ -17,6 +25,23 @@ int compare_string(const void *a, const void *b, void *context)
     return strcmp(*(const char**)a, *(const char**)b);
 }
 
+// 按键排序的记录，id 用来检查稳定性
+struct record {
+    int64_t key;
+    int id;
+};
+
+// 生成类型特化的排序函数
+SORT_DEFINE(i64, int64_t, a < b)
+SORT_DEFINE(dbl_desc, double, a > b)
+SORT_DEFINE(record, struct record, a.key < b.key)
+
+int compare_i64(const void *a, const void *b, void *context) 
+{
+    int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
 // 根据数据特性选择排序算法的自定义选择器
 sort_algorithm_t custom_algorithm_selector(size_t num, size_t size) 
 {
@@ -51,7 +76,8 @@ void benchmark_sort_algorithms(int *data, size_t size)
     {
         clock_t start = clock();
         
-        sort(arrays[algorithm], size, sizeof(int), compare_int, NULL, algorithm);
+        // 按键排序不需要比较函数，基数排序也能参与对比
+        sort_by_key(arrays[algorithm], size, sizeof(int), 0, SORT_KEY_I32, algorithm);
         
         clock_t end = clock();
         double time_spent = (double)(end - start) / CLOCKS_PER_SEC;
@@ -67,6 +93,420 @@ void benchmark_sort_algorithms(int *data, size_t size)
     }
 }
 
+// 对比回调版本和 SORT_DEFINE 生成的版本
+void benchmark_sort_define(size_t size) 
+{
+    int64_t *origin = malloc(size * sizeof(int64_t));
+    int64_t *data = malloc(size * sizeof(int64_t));
+    for (size_t i = 0; i < size; i++) 
+    {
+        origin[i] = ((int64_t)rand() << 31) ^ rand();
+    }
+
+    memcpy(data, origin, size * sizeof(int64_t));
+    clock_t start = clock();
+    quick_sort(data, size, sizeof(int64_t), compare_i64, NULL);
+    double generic = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    memcpy(data, origin, size * sizeof(int64_t));
+    start = clock();
+    i64_sort(data, size);
+    double special = (double)(clock() - start) / CLOCKS_PER_SEC;
+    for (size_t i = 1; i < size; i++) 
+    {
+        assert(data[i - 1] <= data[i]);
+    }
+
+    printf("quick_sort (回调)  : %f 秒\n", generic);
+    printf("i64_sort (特化)    : %f 秒\n", special);
+
+    free(origin);
+    free(data);
+}
+
+// 并行排序：4 个线程排序 4M 个整数
+void test_sort_parallel(size_t size) 
+{
+    int64_t *data = malloc(size * sizeof(int64_t));
+    for (size_t i = 0; i < size; i++) 
+    {
+        data[i] = ((int64_t)rand() << 31) ^ rand();
+    }
+
+    clock_t start = clock();
+    assert(sort_parallel(data, size, sizeof(int64_t), compare_i64, NULL, 4) == 0);
+    double spent = (double)(clock() - start) / CLOCKS_PER_SEC;
+    for (size_t i = 1; i < size; i++) 
+    {
+        assert(data[i - 1] <= data[i]);
+    }
+    // clock() 统计的是所有线程的 CPU 时间
+    printf("sort_parallel (4 线程) CPU 时间: %f 秒\n", spent);
+
+    free(data);
+}
+
+// 分数降序比较，用于取分数最高的 k 个
+int compare_score_desc(const void *a, const void *b, void *context) 
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x < y) - (x > y);
+}
+
+// 部分排序、第 k 小选择和流式 top-k
+void test_select_topk(void) 
+{
+    double scores[1000];
+    double copy[1000];
+    double top[5];
+    for (int i = 0; i < 1000; i++) 
+    {
+        scores[i] = rand() % 100000 / 100.0;
+    }
+
+    // 流式输入，只保留分数最高的 5 个
+    topk_t *topk = topk_create(5, sizeof(double), compare_score_desc, NULL);
+    for (int i = 0; i < 1000; i++) 
+    {
+        topk_push(topk, &scores[i]);
+    }
+    size_t n = topk_result(topk, top);
+    topk_destroy(topk);
+
+    // 与 partial_sort 的结果一致
+    memcpy(copy, scores, sizeof(scores));
+    partial_sort(copy, 1000, 5, sizeof(double), compare_score_desc, NULL);
+    assert(n == 5 && memcmp(top, copy, sizeof(top)) == 0);
+
+    printf("分数最高的 5 个: ");
+    for (size_t i = 0; i < n; i++) 
+    {
+        printf("%.2f ", top[i]);
+    }
+    printf("\n");
+
+    // 中位数
+    memcpy(copy, scores, sizeof(scores));
+    select_nth(copy, 1000, 500, sizeof(double), compare_score_desc, NULL);
+    for (int i = 0; i < 500; i++) 
+    {
+        assert(copy[i] >= copy[500]);
+    }
+    printf("第 501 高的分数: %.2f\n", copy[500]);
+}
+
+// 外部排序的数据源和输出，这里用内存数组模拟记录流
+typedef struct {
+    const struct record *input;
+    size_t count;
+    size_t read_pos;
+    struct record *output;
+    size_t write_pos;
+} record_stream_t;
+
+ptrdiff_t record_stream_read(void *buf, size_t max, void *ctx) 
+{
+    record_stream_t *stream = ctx;
+    size_t n = stream->count - stream->read_pos;
+    if (n > max) 
+    {
+        n = max;
+    }
+    memcpy(buf, stream->input + stream->read_pos, n * sizeof(struct record));
+    stream->read_pos += n;
+    return (ptrdiff_t)n;
+}
+
+int record_stream_write(const void *records, size_t count, void *ctx) 
+{
+    record_stream_t *stream = ctx;
+    memcpy(stream->output + stream->write_pos, records, count * sizeof(struct record));
+    stream->write_pos += count;
+    return 0;
+}
+
+int compare_record(const void *a, const void *b, void *context) 
+{
+    int64_t x = ((const struct record*)a)->key, y = ((const struct record*)b)->key;
+    return (x > y) - (x < y);
+}
+
+// 外部排序：内存预算只有 256KB，10 万条记录会分成多个有序段写入临时文件再归并
+void test_external_sort(size_t count) 
+{
+    struct record *input = malloc(count * sizeof(struct record));
+    struct record *output = malloc(count * sizeof(struct record));
+    for (size_t i = 0; i < count; i++) 
+    {
+        input[i].key = rand() % 1000;
+        input[i].id = (int)i;
+    }
+
+    record_stream_t stream = { input, count, 0, output, 0 };
+    ext_sort_config_t config = {
+        .record_size = sizeof(struct record),
+        .memory_limit = 256 * 1024,
+        .temp_dir = NULL,
+        .compare = compare_record,
+        .context = NULL,
+        .algorithm = SORT_MERGE,   // 分块使用稳定排序，整个外部排序也是稳定的
+    };
+
+    // 分块排序不能用基数排序，无效的算法在读取输入之前就被拒绝
+    sort_algorithm_t bad_algorithms[] = { SORT_RADIX, SORT_COUNT, (sort_algorithm_t)-1 };
+    for (size_t i = 0; i < sizeof(bad_algorithms) / sizeof(bad_algorithms[0]); i++) 
+    {
+        ext_sort_config_t bad = config;
+        bad.algorithm = bad_algorithms[i];
+        assert(external_sort(&bad, record_stream_read, &stream,
+                             record_stream_write, &stream) == EXT_SORT_ERROR_PARAM);
+        assert(stream.read_pos == 0 && stream.write_pos == 0);
+    }
+
+    assert(external_sort(&config, record_stream_read, &stream,
+                         record_stream_write, &stream) == EXT_SORT_SUCCESS);
+    assert(stream.write_pos == count);
+    for (size_t i = 1; i < count; i++) 
+    {
+        assert(output[i - 1].key < output[i].key ||
+               (output[i - 1].key == output[i].key && output[i - 1].id < output[i].id));
+    }
+    printf("外部排序 %zu 条记录 (内存预算 256KB): 通过\n", count);
+
+    free(input);
+    free(output);
+}
+
+// 文件到文件的外部排序：内存预算只有 4KB，会产生几百个有序段并多轮归并
+// 把文件描述符上限压到 16，段数远超上限时也不能因为打开过多临时文件而失败
+void test_external_sort_file(size_t count) 
+{
+    const char *tmpdir = getenv("TMPDIR");
+    char input[512], output[512];
+    snprintf(input, sizeof(input), "%s/ext_sort_in_XXXXXX", tmpdir && tmpdir[0] ? tmpdir : "/tmp");
+    snprintf(output, sizeof(output), "%s/ext_sort_out_XXXXXX", tmpdir && tmpdir[0] ? tmpdir : "/tmp");
+    int in_fd = mkstemp(input);
+    int out_fd = mkstemp(output);
+    assert(in_fd >= 0 && out_fd >= 0);
+    close(out_fd);
+
+    struct record *records = malloc(count * sizeof(struct record));
+    for (size_t i = 0; i < count; i++) 
+    {
+        records[i].key = rand() % 1000;
+        records[i].id = (int)i;
+    }
+    assert(write(in_fd, records, count * sizeof(struct record)) == (ssize_t)(count * sizeof(struct record)));
+    close(in_fd);
+
+    struct rlimit saved, limited;
+    assert(getrlimit(RLIMIT_NOFILE, &saved) == 0);
+    limited = saved;
+    limited.rlim_cur = 16;
+    assert(setrlimit(RLIMIT_NOFILE, &limited) == 0);
+
+    ext_sort_config_t config = {
+        .record_size = sizeof(struct record),
+        .memory_limit = 4 * 1024,
+        .temp_dir = NULL,
+        .compare = compare_record,
+        .context = NULL,
+        .algorithm = SORT_MERGE,
+    };
+    ext_sort_status_t status = external_sort_file(input, output, &config);
+    assert(setrlimit(RLIMIT_NOFILE, &saved) == 0);
+    assert(status == EXT_SORT_SUCCESS);
+
+    int fd = open(output, O_RDONLY);
+    assert(fd >= 0);
+    assert(read(fd, records, count * sizeof(struct record)) == (ssize_t)(count * sizeof(struct record)));
+    assert(read(fd, records, 1) == 0);
+    close(fd);
+    for (size_t i = 1; i < count; i++) 
+    {
+        assert(records[i - 1].key < records[i].key ||
+               (records[i - 1].key == records[i].key && records[i - 1].id < records[i].id));
+    }
+    printf("文件外部排序 %zu 条记录 (内存预算 4KB, %zu 个有序段, 文件描述符上限 16): 通过\n",
+           count, (count + 4 * 1024 / sizeof(struct record) - 1) / (4 * 1024 / sizeof(struct record)));
+
+    // 记录长度不是整数倍的输入要报错
+    fd = open(input, O_WRONLY | O_APPEND);
+    assert(fd >= 0 && write(fd, "x", 1) == 1);
+    close(fd);
+    assert(external_sort_file(input, output, &config) == EXT_SORT_ERROR_READ);
+
+    unlink(input);
+    unlink(output);
+    free(records);
+}
+
+// 自动校准：先在临时文件上走一遍"校准并保存"，再从同一文件加载，两次的校准表必须一致
+void test_sort_calibrate(void) 
+{
+    const char *tmpdir = getenv("TMPDIR");
+    char path[512];
+    snprintf(path, sizeof(path), "%s/sort_calibration_XXXXXX", tmpdir && tmpdir[0] ? tmpdir : "/tmp");
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    // 空文件加载失败，于是校准并保存
+    assert(sort_calibration_load(path) == -1);
+    assert(sort_calibrate_cached(path) == 0);
+
+    size_t sizes[] = {4, 8, 16, 32, 64, 100};
+    size_t counts[] = {10, 100, 1000, 10000, 65536, 1000000};
+    sort_algorithm_t calibrated[6][6];
+    for (size_t s = 0; s < 6; s++) 
+    {
+        for (size_t c = 0; c < 6; c++) 
+        {
+            calibrated[s][c] = sort_calibrated_algorithm(counts[c], sizes[s]);
+            assert(calibrated[s][c] != SORT_AUTO);
+        }
+    }
+    printf("校准并保存到 %s: 通过\n", path);
+
+    // 丢弃结果后从文件加载
+    sort_calibration_reset();
+    assert(sort_calibrated_algorithm(1000, sizeof(int)) == SORT_AUTO);
+    assert(sort_calibrate_cached(path) == 0);
+    for (size_t s = 0; s < 6; s++) 
+    {
+        for (size_t c = 0; c < 6; c++) 
+        {
+            assert(sort_calibrated_algorithm(counts[c], sizes[s]) == calibrated[s][c]);
+        }
+    }
+    printf("从文件加载校准表: 通过\n");
+    unlink(path);
+
+    for (size_t i = 0; i < 4; i++) 
+    {
+        printf("%6zu 个 int: %s\n", counts[i],
+               get_sort_algorithm_name(recommend_sort_algorithm(counts[i], sizeof(int))));
+    }
+
+    int numbers[1000];
+    for (int i = 0; i < 1000; i++) 
+    {
+        numbers[i] = rand() % 100;
+    }
+    sort(numbers, 1000, sizeof(int), compare_int, NULL, SORT_AUTO);
+    for (int i = 1; i < 1000; i++) 
+    {
+        assert(numbers[i - 1] <= numbers[i]);
+    }
+    printf("校准后 SORT_AUTO 排序: 通过\n");
+
+    // 恢复默认选择器
+    sort_calibration_reset();
+}
+
+// 大记录：名字作为键，其余是负载
+struct wide_record 
+{
+    char name[16];
+    int id;
+    char payload[1000];
+};
+
+static int compare_wide_record(const void *a, const void *b, void *context) 
+{
+    (void)context;
+    return strcmp(((const struct wide_record*)a)->name, ((const struct wide_record*)b)->name);
+}
+
+static uint64_t wide_record_prefix(const void *elem, void *context) 
+{
+    (void)context;
+    return sort_prefix_string(((const struct wide_record*)elem)->name);
+}
+
+// 间接排序：只排序索引，每条 1KB 的记录最后只搬移一次
+void test_sort_indirect(size_t count) 
+{
+    struct wide_record *input = malloc(count * sizeof(struct wide_record));
+    struct wide_record *work = malloc(count * sizeof(struct wide_record));
+    for (size_t i = 0; i < count; i++) 
+    {
+        memset(&input[i], 0, sizeof(input[i]));
+        snprintf(input[i].name, sizeof(input[i].name), "user%08d", rand() % 1000000);
+        input[i].id = (int)i;
+    }
+
+    memcpy(work, input, count * sizeof(struct wide_record));
+    clock_t start = clock();
+    quick_sort(work, count, sizeof(struct wide_record), compare_wide_record, NULL);
+    printf("quick_sort (直接)       : %f 秒\n", (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    memcpy(work, input, count * sizeof(struct wide_record));
+    start = clock();
+    assert(sort_indirect_prefix(work, count, sizeof(struct wide_record),
+                                compare_wide_record, wide_record_prefix, NULL, SORT_AUTO) == 0);
+    printf("sort_indirect_prefix    : %f 秒\n", (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    // 间接排序是稳定的
+    for (size_t i = 1; i < count; i++) 
+    {
+        int r = strcmp(work[i - 1].name, work[i].name);
+        assert(r < 0 || (r == 0 && work[i - 1].id < work[i].id));
+    }
+    printf("间接排序 %zu 条 %zu 字节的记录: 通过\n", count, sizeof(struct wide_record));
+
+    free(input);
+    free(work);
+}
+
+// 字符串排序：URL 有很长的公共前缀，strcmp 每次都要从头比较
+void test_sort_strings(size_t count) 
+{
+    const char *hosts[] = {
+        "https://www.example.com/api/v1/users/",
+        "https://www.example.com/api/v1/orders/",
+        "https://static.example.com/assets/img/",
+    };
+    char **urls = malloc(count * sizeof(char*));
+    const char **work = malloc(count * sizeof(char*));
+    for (size_t i = 0; i < count; i++) 
+    {
+        char buf[96];
+        snprintf(buf, sizeof(buf), "%s%08d", hosts[rand() % 3], rand() % 10000000);
+        urls[i] = malloc(strlen(buf) + 1);
+        strcpy(urls[i], buf);
+    }
+
+    memcpy(work, urls, count * sizeof(char*));
+    clock_t start = clock();
+    quick_sort(work, count, sizeof(char*), compare_string, NULL);
+    printf("quick_sort + strcmp : %f 秒\n", (double)(clock() - start) / CLOCKS_PER_SEC);
+
+    memcpy(work, urls, count * sizeof(char*));
+    start = clock();
+    assert(sort_strings(work, count) == 0);
+    printf("sort_strings        : %f 秒\n", (double)(clock() - start) / CLOCKS_PER_SEC);
+    for (size_t i = 1; i < count; i++) 
+    {
+        assert(strcmp(work[i - 1], work[i]) <= 0);
+    }
+
+    // 字节串可以包含 '\0'，公共部分相同时较短的在前
+    sort_bytes_t keys[] = {
+        { "ab\0c", 4 }, { "ab", 2 }, { "ab\0", 3 }, { "a", 1 }, { "b", 1 },
+    };
+    assert(sort_byte_strings(keys, 5) == 0);
+    assert(keys[0].len == 1 && keys[1].len == 2 && keys[2].len == 3 && keys[3].len == 4 && keys[4].len == 1);
+    printf("字符串排序 %zu 个 URL: 通过\n", count);
+
+    for (size_t i = 0; i < count; i++) 
+    {
+        free(urls[i]);
+    }
+    free(urls);
+    free(work);
+}
+
 int main() 
 {
     // 设置自定义算法选择器, 如果不设置则使用默认选择器
@@ -94,8 +534,13 @@ int main()
     {
         printf("%d ", numbers[i]);
     }
-    printf("\n\n");
-    
+    printf("\n");
+
+    // 基数排序需要键类型，只能通过 sort_by_key 使用
+    assert(sort(numbers, count, sizeof(int), compare_int, NULL, SORT_RADIX) == -1);
+    assert(sort_by_key(numbers, count, sizeof(int), 0, SORT_KEY_I32, SORT_RADIX) == 0);
+    printf("sort 拒绝 SORT_RADIX: 通过\n\n");
+
     // 字符串排序测试
     printf("=== 字符串排序测试 ===\n");
     const char *strings[] = {"banana", "apple", "orange", "grape", "pear", "kiwi"};
@@ -136,6 +581,62 @@ int main()
     benchmark_sort_algorithms(large_array, test_size);
     
     free(large_array);
+
+    // 类型特化排序测试
+    printf("\n=== 类型特化排序测试 ===\n");
+    double values[] = {3.5, -1.0, 2.25, 9.0, 0.0};
+    count = sizeof(values) / sizeof(values[0]);
+    dbl_desc_sort(values, count);
+    printf("double 降序: ");
+    for (int i = 0; i < count; i++) 
+    {
+        printf("%g ", values[i]);
+    }
+    printf("\n");
+
+    // 归并排序是稳定的，相同 key 的记录保持原有顺序
+    struct record records[1000];
+    for (int i = 0; i < 1000; i++) 
+    {
+        records[i].key = rand() % 10;
+        records[i].id = i;
+    }
+    assert(record_merge_sort(records, 1000) == 0);
+    for (int i = 1; i < 1000; i++) 
+    {
+        assert(records[i - 1].key < records[i].key ||
+               (records[i - 1].key == records[i].key && records[i - 1].id < records[i].id));
+    }
+    printf("struct 稳定归并排序: 通过\n");
+
+    record_heap_sort(records, 1000);
+    for (int i = 1; i < 1000; i++) 
+    {
+        assert(records[i - 1].key <= records[i].key);
+    }
+    printf("struct 堆排序: 通过\n");
+
+    printf("\n=== 性能测试 (1000000个随机 int64) ===\n");
+    benchmark_sort_define(1000000);
+
+    printf("\n=== 选择与 top-k 测试 ===\n");
+    test_select_topk();
+
+    printf("\n=== 外部排序测试 ===\n");
+    test_external_sort(100000);
+    test_external_sort_file(100000);
+
+    printf("\n=== 并行排序测试 (4000000个随机 int64) ===\n");
+    test_sort_parallel(4000000);
+
+    printf("\n=== SORT_AUTO 自动校准测试 ===\n");
+    test_sort_calibrate();
+
+    printf("\n=== 间接排序测试 (100000条 1KB 记录) ===\n");
+    test_sort_indirect(100000);
+
+    printf("\n=== 字符串排序测试 (1000000个 URL) ===\n");
+    test_sort_strings(1000000);
     
     return 0;
 }
@@ -156,4 +657,40 @@ int main()
 // Insertion Sort : 0.174973 秒
 // Quick Sort     : 0.002076 秒
 // Merge Sort     : 0.002193 秒
-// Heap Sort      : 0.003803 秒
\ No newline at end of file
+// Heap Sort      : 0.003803 秒
+// Radix Sort     : 0.000085 秒
+
+// === 类型特化排序测试 ===
+// double 降序: 9 3.5 2.25 0 -1 
+// struct 稳定归并排序: 通过
+// struct 堆排序: 通过
+
+// === 性能测试 (1000000个随机 int64) ===
+// quick_sort (回调)  : 0.208769 秒
+// i64_sort (特化)    : 0.121194 秒
+
+// === 选择与 top-k 测试 ===
+// 分数最高的 5 个: 999.66 999.42 999.24 998.97 996.73 
+// 第 501 高的分数: 500.75
+
+// === 外部排序测试 ===
+// 外部排序 100000 条记录 (内存预算 256KB): 通过
+
+// === 并行排序测试 (4000000个随机 int64) ===
+// sort_parallel (4 线程) CPU 时间: 0.937544 秒
+// === SORT_AUTO 自动校准测试 ===
+//     10 个 int: Merge Sort
+//    100 个 int: Merge Sort
+//   1000 个 int: Quick Sort
+// 100000 个 int: Quick Sort
+// 校准后 SORT_AUTO 排序: 通过
+
+// === 间接排序测试 (100000条 1KB 记录) ===
+// quick_sort (直接)       : 0.215776 秒
+// sort_indirect_prefix    : 0.067302 秒
+// 间接排序 100000 条 1020 字节的记录: 通过
+
+// === 字符串排序测试 (1000000个 URL) ===
+// quick_sort + strcmp : 0.364142 秒
+// sort_strings        : 0.221853 秒
+// 字符串排序 1000000 个 URL: 通过
@@ -0,0 +1,609 @@
+#include "external_sort.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// 归并时每路缓冲区的最小大小，太小会退化为大量小块 I/O
+#define EXT_SORT_MIN_BLOCK (64 * 1024)
+// 归并路数上限，路数太多时败者树和读缓冲区的开销不再划算
+#define EXT_SORT_MAX_FANIN 512
+
+//-----------------------------
+// 文件读写工具函数
+//-----------------------------
+
+// 写满 len 字节
+static bool ext_write_all(int fd, const void *buf, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)buf;
+
+    while (len > 0)
+    {
+        ssize_t n = write(fd, p, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// 尽量读满 len 字节，返回实际读取的字节数，出错返回 -1
+static ssize_t ext_read_full(int fd, void *buf, size_t len)
+{
+    size_t total = 0;
+
+    while (total < len)
+    {
+        ssize_t n = read(fd, (unsigned char *)buf + total, len - total);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        total += (size_t)n;
+    }
+    return (ssize_t)total;
+}
+
+// 从 offset 处尽量读满 len 字节，返回实际读取的字节数，出错返回 -1
+static ssize_t ext_pread_full(int fd, void *buf, size_t len, off_t offset)
+{
+    size_t total = 0;
+
+    while (total < len)
+    {
+        ssize_t n = pread(fd, (unsigned char *)buf + total, len - total, offset + (off_t)total);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        if (n == 0)
+        {
+            break;
+        }
+        total += (size_t)n;
+    }
+    return (ssize_t)total;
+}
+
+// 创建临时文件并立即删除目录项，只保留文件描述符
+static int ext_create_temp(const char *dir)
+{
+    if (!dir)
+    {
+        dir = getenv("TMPDIR");
+        if (!dir || !*dir)
+        {
+            dir = "/tmp";
+        }
+    }
+
+    size_t len = strlen(dir) + sizeof("/cstl_sort_XXXXXX");
+    char *path = malloc(len);
+    if (!path)
+    {
+        return -1;
+    }
+    snprintf(path, len, "%s/cstl_sort_XXXXXX", dir);
+
+    int fd = mkstemp(path);
+    if (fd >= 0)
+    {
+        unlink(path);
+    }
+    free(path);
+    return fd;
+}
+
+//-----------------------------
+// 有序段列表
+//-----------------------------
+
+// 所有有序段依次存放在同一个临时文件中，每段记录起始偏移和记录数
+// 这样无论有多少段，同时打开的临时文件都不超过两个（当前一轮的输入和输出）
+typedef struct {
+    off_t offset;
+    size_t count;
+} ext_run_t;
+
+// 有序段按输入顺序排列，归并时相等记录取序号小的一段，保证稳定
+typedef struct {
+    int fd;              // 存放所有有序段的临时文件，没有段时为 -1
+    off_t end;           // 文件末尾，下一段的起始偏移
+    ext_run_t *runs;
+    size_t count;
+    size_t capacity;
+} ext_run_list_t;
+
+static bool ext_run_list_push(ext_run_list_t *list, size_t count)
+{
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : 16;
+        ext_run_t *runs = realloc(list->runs, capacity * sizeof(ext_run_t));
+        if (!runs)
+        {
+            return false;
+        }
+        list->runs = runs;
+        list->capacity = capacity;
+    }
+    list->runs[list->count].offset = list->end;
+    list->runs[list->count].count = count;
+    list->count++;
+    return true;
+}
+
+// 清空段表，保留文件以便下一轮复用
+static void ext_run_list_reset(ext_run_list_t *list)
+{
+    list->end = 0;
+    list->count = 0;
+}
+
+static void ext_run_list_close(ext_run_list_t *list)
+{
+    if (list->fd >= 0)
+    {
+        close(list->fd);
+    }
+    free(list->runs);
+    list->fd = -1;
+    list->end = 0;
+    list->runs = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+//-----------------------------
+// 多路归并（败者树）
+//-----------------------------
+
+// 每路有序段的读缓冲区
+typedef struct {
+    int fd;
+    off_t offset;        // 下一次读取的文件偏移
+    size_t remaining;    // 段中尚未读入缓冲区的记录数
+    unsigned char *buf;
+    size_t cap;          // 缓冲区能容纳的记录数
+    size_t len;          // 缓冲区中的记录数
+    size_t pos;          // 下一条记录的位置
+    bool done;           // 已读完
+} ext_reader_t;
+
+typedef struct {
+    const ext_sort_config_t *config;
+    ext_reader_t *readers;
+    size_t k;            // 归并路数
+    size_t *tree;        // 败者树，tree[0] 是当前胜者，其余节点保存败者
+} ext_merge_t;
+
+static ext_sort_status_t ext_reader_fill(ext_reader_t *r, size_t record_size)
+{
+    size_t want = r->remaining < r->cap ? r->remaining : r->cap;
+    ssize_t n = ext_pread_full(r->fd, r->buf, want * record_size, r->offset);
+    if (n < 0 || (size_t)n != want * record_size)
+    {
+        return EXT_SORT_ERROR_IO;
+    }
+    r->offset += (off_t)n;
+    r->remaining -= want;
+    r->len = want;
+    r->pos = 0;
+    r->done = r->len == 0;
+    return EXT_SORT_SUCCESS;
+}
+
+// 第 a 路的当前记录是否排在第 b 路之前，已读完的一路排在最后
+static bool ext_beats(const ext_merge_t *m, size_t a, size_t b)
+{
+    const ext_reader_t *ra = &m->readers[a];
+    const ext_reader_t *rb = &m->readers[b];
+    size_t size = m->config->record_size;
+
+    if (ra->done)
+    {
+        return false;
+    }
+    if (rb->done)
+    {
+        return true;
+    }
+    int cmp = m->config->compare(ra->buf + ra->pos * size, rb->buf + rb->pos * size,
+                                 m->config->context);
+    return cmp < 0 || (cmp == 0 && a < b);
+}
+
+// 自底向上建树：叶子 i 对应节点 k + i，返回子树的胜者
+static size_t ext_tree_build(ext_merge_t *m, size_t node)
+{
+    if (node >= m->k)
+    {
+        return node - m->k;
+    }
+
+    size_t left = ext_tree_build(m, node * 2);
+    size_t right = ext_tree_build(m, node * 2 + 1);
+    if (ext_beats(m, left, right))
+    {
+        m->tree[node] = right;
+        return left;
+    }
+    m->tree[node] = left;
+    return right;
+}
+
+// 胜者前进一条记录后，沿叶子到根的路径与各节点的败者重赛
+static void ext_tree_replay(ext_merge_t *m, size_t winner)
+{
+    for (size_t node = (winner + m->k) / 2; node > 0; node /= 2)
+    {
+        if (ext_beats(m, m->tree[node], winner))
+        {
+            size_t t = m->tree[node];
+            m->tree[node] = winner;
+            winner = t;
+        }
+    }
+    m->tree[0] = winner;
+}
+
+// 输出一批记录：有回调时交给回调，否则写入临时文件
+static ext_sort_status_t ext_output(ext_sort_write_t write, void *write_ctx, int out_fd,
+                                    const void *records, size_t count, size_t size)
+{
+    if (write)
+    {
+        return write(records, count, write_ctx) == 0 ? EXT_SORT_SUCCESS : EXT_SORT_ERROR_WRITE;
+    }
+    return ext_write_all(out_fd, records, count * size) ? EXT_SORT_SUCCESS : EXT_SORT_ERROR_IO;
+}
+
+// 归并文件 fd 中的 k 个有序段，输出到回调 write 或文件 out_fd 的当前位置
+// 内存预算平分给 k 个读缓冲区和一个写缓冲区
+static ext_sort_status_t ext_merge(const ext_sort_config_t *config, int fd,
+                                   const ext_run_t *runs, size_t k,
+                                   ext_sort_write_t write, void *write_ctx, int out_fd)
+{
+    size_t size = config->record_size;
+    size_t block = config->memory_limit / (k + 1) / size;
+    ext_sort_status_t status = EXT_SORT_SUCCESS;
+
+    ext_merge_t m = { config, NULL, k, NULL };
+    unsigned char *buffer = malloc((k + 1) * block * size);
+    m.readers = malloc(k * sizeof(ext_reader_t));
+    m.tree = malloc(k * sizeof(size_t));
+    if (!buffer || !m.readers || !m.tree)
+    {
+        status = EXT_SORT_ERROR_MEMORY;
+        goto out;
+    }
+
+    for (size_t i = 0; i < k; i++)
+    {
+        ext_reader_t *r = &m.readers[i];
+        r->fd = fd;
+        r->offset = runs[i].offset;
+        r->remaining = runs[i].count;
+        r->buf = buffer + i * block * size;
+        r->cap = block;
+        status = ext_reader_fill(r, size);
+        if (status != EXT_SORT_SUCCESS)
+        {
+            goto out;
+        }
+    }
+
+    unsigned char *out_buf = buffer + k * block * size;
+    size_t out_len = 0;
+    m.tree[0] = ext_tree_build(&m, 1);
+
+    while (!m.readers[m.tree[0]].done)
+    {
+        size_t winner = m.tree[0];
+        ext_reader_t *r = &m.readers[winner];
+
+        memcpy(out_buf + out_len * size, r->buf + r->pos * size, size);
+        if (++out_len == block)
+        {
+            status = ext_output(write, write_ctx, out_fd, out_buf, out_len, size);
+            if (status != EXT_SORT_SUCCESS)
+            {
+                goto out;
+            }
+            out_len = 0;
+        }
+
+        if (++r->pos == r->len)
+        {
+            status = ext_reader_fill(r, size);
+            if (status != EXT_SORT_SUCCESS)
+            {
+                goto out;
+            }
+        }
+        ext_tree_replay(&m, winner);
+    }
+
+    if (out_len > 0)
+    {
+        status = ext_output(write, write_ctx, out_fd, out_buf, out_len, size);
+    }
+
+out:
+    free(buffer);
+    free(m.readers);
+    free(m.tree);
+    return status;
+}
+
+//-----------------------------
+// 外部排序
+//-----------------------------
+
+// 读入一块记录并排序，写成一个有序段；输入在第一块内结束时直接输出
+static ext_sort_status_t ext_make_runs(const ext_sort_config_t *config,
+                                       ext_sort_read_t read, void *read_ctx,
+                                       ext_sort_write_t write, void *write_ctx,
+                                       ext_run_list_t *runs, bool *finished)
+{
+    size_t size = config->record_size;
+    size_t capacity = config->memory_limit / size;
+    ext_sort_status_t status = EXT_SORT_SUCCESS;
+    bool eof = false;
+
+    unsigned char *chunk = malloc(capacity * size);
+    if (!chunk)
+    {
+        return EXT_SORT_ERROR_MEMORY;
+    }
+
+    while (!eof)
+    {
+        size_t count = 0;
+        while (count < capacity)
+        {
+            ptrdiff_t got = read(chunk + count * size, capacity - count, read_ctx);
+            if (got < 0 || (size_t)got > capacity - count)
+            {
+                status = EXT_SORT_ERROR_READ;
+                goto out;
+            }
+            if (got == 0)
+            {
+                eof = true;
+                break;
+            }
+            count += (size_t)got;
+        }
+        if (count == 0)
+        {
+            break;
+        }
+
+        if (sort(chunk, count, size, config->compare, config->context, config->algorithm) != 0)
+        {
+            status = EXT_SORT_ERROR_MEMORY;
+            goto out;
+        }
+
+        // 全部数据都在内存中，不需要临时文件
+        if (eof && runs->count == 0)
+        {
+            if (write(chunk, count, write_ctx) != 0)
+            {
+                status = EXT_SORT_ERROR_WRITE;
+            }
+            *finished = true;
+            goto out;
+        }
+
+        if (runs->fd < 0)
+        {
+            runs->fd = ext_create_temp(config->temp_dir);
+            if (runs->fd < 0)
+            {
+                status = EXT_SORT_ERROR_IO;
+                goto out;
+            }
+        }
+        if (!ext_run_list_push(runs, count))
+        {
+            status = EXT_SORT_ERROR_MEMORY;
+            goto out;
+        }
+        if (!ext_write_all(runs->fd, chunk, count * size))
+        {
+            status = EXT_SORT_ERROR_IO;
+            goto out;
+        }
+        runs->end += (off_t)(count * size);
+    }
+
+out:
+    free(chunk);
+    return status;
+}
+
+// 检查配置，在读取任何输入之前拒绝无效参数
+// 分块只有比较函数，基数排序和越界的算法值会被 sort 拒绝
+static bool ext_config_valid(const ext_sort_config_t *config)
+{
+    return config && config->compare && config->record_size != 0 &&
+           config->memory_limit / config->record_size >= 3 &&
+           (int)config->algorithm >= 0 && config->algorithm < SORT_COUNT &&
+           config->algorithm != SORT_RADIX;
+}
+
+ext_sort_status_t external_sort(const ext_sort_config_t *config,
+                                ext_sort_read_t read, void *read_ctx,
+                                ext_sort_write_t write, void *write_ctx)
+{
+    if (!read || !write || !ext_config_valid(config))
+    {
+        return EXT_SORT_ERROR_PARAM;
+    }
+
+    ext_run_list_t runs = { -1, 0, NULL, 0, 0 };
+    bool finished = false;
+    ext_sort_status_t status = ext_make_runs(config, read, read_ctx, write, write_ctx,
+                                             &runs, &finished);
+    if (status != EXT_SORT_SUCCESS || finished || runs.count == 0)
+    {
+        ext_run_list_close(&runs);
+        return status;
+    }
+
+    // 归并路数：每路至少 EXT_SORT_MIN_BLOCK 字节且至少一条记录
+    size_t fanin = config->memory_limit / EXT_SORT_MIN_BLOCK;
+    size_t max_by_record = config->memory_limit / config->record_size;
+    if (fanin > max_by_record)
+    {
+        fanin = max_by_record;
+    }
+    fanin = fanin > 1 ? fanin - 1 : 1;
+    if (fanin < 2)
+    {
+        fanin = 2;
+    }
+    if (fanin > EXT_SORT_MAX_FANIN)
+    {
+        fanin = EXT_SORT_MAX_FANIN;
+    }
+
+    // 有序段过多时先分组归并，相邻的段合成一段写入另一个临时文件，保持输入顺序
+    // 两个文件轮流作为每一轮的输入和输出
+    ext_run_list_t next = { -1, 0, NULL, 0, 0 };
+    while (runs.count > fanin)
+    {
+        if (next.fd < 0)
+        {
+            next.fd = ext_create_temp(config->temp_dir);
+            if (next.fd < 0)
+            {
+                status = EXT_SORT_ERROR_IO;
+                break;
+            }
+        }
+        else if (ftruncate(next.fd, 0) != 0 || lseek(next.fd, 0, SEEK_SET) < 0)
+        {
+            status = EXT_SORT_ERROR_IO;
+            break;
+        }
+        ext_run_list_reset(&next);
+
+        for (size_t i = 0; i < runs.count && status == EXT_SORT_SUCCESS; i += fanin)
+        {
+            size_t group = runs.count - i < fanin ? runs.count - i : fanin;
+            size_t count = 0;
+
+            for (size_t j = i; j < i + group; j++)
+            {
+                count += runs.runs[j].count;
+            }
+            if (!ext_run_list_push(&next, count))
+            {
+                status = EXT_SORT_ERROR_MEMORY;
+                break;
+            }
+            status = ext_merge(config, runs.fd, runs.runs + i, group, NULL, NULL, next.fd);
+            next.end += (off_t)(count * config->record_size);
+        }
+        if (status != EXT_SORT_SUCCESS)
+        {
+            break;
+        }
+
+        ext_run_list_t t = runs;
+        runs = next;
+        next = t;
+    }
+
+    if (status == EXT_SORT_SUCCESS)
+    {
+        status = ext_merge(config, runs.fd, runs.runs, runs.count, write, write_ctx, -1);
+    }
+    ext_run_list_close(&runs);
+    ext_run_list_close(&next);
+    return status;
+}
+
+//-----------------------------
+// 文件到文件
+//-----------------------------
+
+typedef struct {
+    int fd;
+    size_t record_size;
+} ext_file_t;
+
+static ptrdiff_t ext_file_read(void *buf, size_t max, void *ctx)
+{
+    ext_file_t *file = (ext_file_t *)ctx;
+    ssize_t n = ext_read_full(file->fd, buf, max * file->record_size);
+
+    // 文件长度不是记录大小的整数倍
+    if (n < 0 || (size_t)n % file->record_size != 0)
+    {
+        return -1;
+    }
+    return (ptrdiff_t)((size_t)n / file->record_size);
+}
+
+static int ext_file_write(const void *records, size_t count, void *ctx)
+{
+    ext_file_t *file = (ext_file_t *)ctx;
+    return ext_write_all(file->fd, records, count * file->record_size) ? 0 : -1;
+}
+
+ext_sort_status_t external_sort_file(const char *input, const char *output,
+                                     const ext_sort_config_t *config)
+{
+    if (!input || !output || !ext_config_valid(config))
+    {
+        return EXT_SORT_ERROR_PARAM;
+    }
+
+    ext_file_t in = { open(input, O_RDONLY), config->record_size };
+    if (in.fd < 0)
+    {
+        return EXT_SORT_ERROR_IO;
+    }
+    ext_file_t out = { open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644), config->record_size };
+    if (out.fd < 0)
+    {
+        close(in.fd);
+        return EXT_SORT_ERROR_IO;
+    }
+
+    ext_sort_status_t status = external_sort(config, ext_file_read, &in, ext_file_write, &out);
+
+    close(in.fd);
+    if (close(out.fd) != 0 && status == EXT_SORT_SUCCESS)
+    {
+        status = EXT_SORT_ERROR_IO;
+    }
+    return status;
+}
@@ -0,0 +1,44 @@
+#ifndef __EXTERNAL_SORT_H__
+#define __EXTERNAL_SORT_H__
+
+#include <stddef.h>
+#include "sort.h"
+
+// 外部排序状态码
+typedef enum {
+    EXT_SORT_SUCCESS = 0,        // 成功
+    EXT_SORT_ERROR_PARAM = -1,   // 参数无效（如内存预算不足以容纳几条记录）
+    EXT_SORT_ERROR_MEMORY = -2,  // 内存分配失败
+    EXT_SORT_ERROR_IO = -3,      // 临时文件读写失败
+    EXT_SORT_ERROR_READ = -4,    // 读取回调返回错误
+    EXT_SORT_ERROR_WRITE = -5    // 写出回调返回错误
+} ext_sort_status_t;
+
+// 读取回调：最多读取 max 条记录到 buf，返回实际读取的条数，0 表示输入结束，小于 0 表示出错
+typedef ptrdiff_t (*ext_sort_read_t)(void *buf, size_t max, void *ctx);
+
+// 写出回调：输出 count 条连续存放的有序记录，成功返回 0
+typedef int (*ext_sort_write_t)(const void *records, size_t count, void *ctx);
+
+// 外部排序配置
+typedef struct {
+    size_t record_size;          // 定长记录的大小（字节数）
+    size_t memory_limit;         // 内存预算（字节数），决定分块大小和归并路数
+    const char *temp_dir;        // 临时文件目录，NULL 时使用 TMPDIR 环境变量或 /tmp
+    compare_func_t compare;      // 比较函数
+    void *context;               // 比较函数上下文
+    sort_algorithm_t algorithm;  // 分块排序使用的算法，SORT_MERGE 时整个外部排序是稳定的；不支持 SORT_RADIX
+} ext_sort_config_t;
+
+// 外部排序：按内存预算分块读取并排序，有序段写入临时文件，再多路归并输出
+// 输入能放进内存时不产生临时文件；所有有序段共用一个临时文件，分组归并时再用一个，
+// 同时打开的临时文件不超过两个；临时文件创建后立即删除，出错或进程退出时不会残留
+extern ext_sort_status_t external_sort(const ext_sort_config_t *config,
+                                       ext_sort_read_t read, void *read_ctx,
+                                       ext_sort_write_t write, void *write_ctx);
+
+// 对定长记录文件做外部排序，input 和 output 不能是同一个文件
+extern ext_sort_status_t external_sort_file(const char *input, const char *output,
+                                            const ext_sort_config_t *config);
+
+#endif /* __EXTERNAL_SORT_H__ */
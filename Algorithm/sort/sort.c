@@ -2,6 +2,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
 
 // 默认的算法选择器
 static algorithm_selector_t g_algorithm_selector = NULL;
@@ -14,17 +17,39 @@ static const char *sort_algorithm_names[] = {
     "Insertion Sort",
     "Quick Sort",
     "Merge Sort",
-    "Heap Sort"
+    "Heap Sort",
+    "Radix Sort",
+    "Parallel Sort"
 };
 
 // 内部工具函数: 交换元素
-static void swap_elements(void *a, void *b, size_t size) 
+static inline void swap_elements(void *a, void *b, size_t size) 
 {
-    // 使用临时缓冲区交换元素
-    char temp[size];
-    memcpy(temp, a, size);
-    memcpy(a, b, size);
-    memcpy(b, temp, size);
+    unsigned char *p = (unsigned char *)a;
+    unsigned char *q = (unsigned char *)b;
+
+    // 8 字节元素（指针、64 位整数、double）是最常见的情况
+    if (size == sizeof(uint64_t))
+    {
+        uint64_t t;
+        memcpy(&t, p, sizeof(t));
+        memcpy(p, q, sizeof(t));
+        memcpy(q, &t, sizeof(t));
+        return;
+    }
+
+    // 按块交换，不依赖变长数组
+    unsigned char temp[64];
+    while (size > 0)
+    {
+        size_t n = size < sizeof(temp) ? size : sizeof(temp);
+        memcpy(temp, p, n);
+        memcpy(p, q, n);
+        memcpy(q, temp, n);
+        p += n;
+        q += n;
+        size -= n;
+    }
 }
 
 // 内部工具函数: 获取数组中的元素指针
@@ -33,18 +58,35 @@ static inline void *get_element(void *base, size_t index, size_t size)
     return (char *)base + index * size;
 }
 
+// 按键排序时，元素数量达到该值才选择基数排序
+#define RADIX_SORT_THRESHOLD 256
+
+// 元素大小达到该值时，SORT_AUTO 改为先排序索引再搬移记录
+#define INDIRECT_SORT_THRESHOLD 256
+// 基数排序每趟都要搬移整条记录，记录稍大就改为只排序 (键, 下标) 对
+#define RADIX_INDIRECT_THRESHOLD 48
+
 // 默认的算法选择逻辑
 static sort_algorithm_t default_algorithm_selector(size_t num, size_t size) 
 {
-    // 根据数据量选择合适的排序算法
-    if (num <= 10) {
+    // 快速排序（pdqsort）对小区间自动使用插入排序，
+    // 对有序、逆序和大量重复的输入都是线性或 O(n log n)，所以各种规模都优先使用它
+    if (num <= 16) {
         return SORT_INSERTION;  // 数据量很小时，插入排序性能好
-    } else if (num <= 100) {
-        return SORT_QUICK;      // 中等数据量，快速排序
-    } else if (num <= 1000) {
-        return SORT_MERGE;      // 较大数据量，稳定的归并排序
     } else {
-        return SORT_QUICK;      // 大数据量，快速排序通常最快
+        return SORT_QUICK;
+    }
+}
+
+// 按键排序时的默认选择逻辑：基数排序与数据分布无关，规模稍大就优于比较排序
+static sort_algorithm_t default_key_algorithm_selector(size_t num, size_t size) 
+{
+    if (num <= 16) {
+        return SORT_INSERTION;
+    } else if (num < RADIX_SORT_THRESHOLD) {
+        return SORT_QUICK;
+    } else {
+        return SORT_RADIX;
     }
 }
 
@@ -181,269 +223,2357 @@ int insertion_sort(void *base, size_t num, size_t size,
     return 0;
 }
 
-// 快速排序 (内部递归实现)
-static void quick_sort_recursive(void *base, int low, int high, size_t size,
-                               compare_func_t compare, void *context) 
+//-----------------------------
+// 快速排序: pattern-defeating quicksort (pdqsort)
+//-----------------------------
+
+// 小于该长度的区间使用插入排序
+#define PDQ_INSERTION_THRESHOLD 24
+// 大于该长度的区间使用 Tukey ninther 选主元
+#define PDQ_NINTHER_THRESHOLD 128
+// 部分插入排序最多移动的元素个数，超过则认为区间不是近似有序
+#define PDQ_PARTIAL_INSERTION_LIMIT 8
+// 元素不超过该大小时临时元素放在栈上
+#define PDQ_STACK_ELEMENT_SIZE 256
+
+// 排序上下文，避免在每层递归中传递一串参数
+typedef struct {
+    size_t size;              // 元素大小
+    compare_func_t compare;   // 比较函数
+    void *context;            // 比较函数上下文
+    void *tmp;                // 一个元素大小的临时缓冲区
+} pdq_ctx_t;
+
+static inline bool pdq_less(const pdq_ctx_t *c, const void *a, const void *b)
+{
+    return c->compare(a, b, c->context) < 0;
+}
+
+// 指针前移/后移 n 个元素
+#define PDQ_AT(p, n) ((char *)(p) + (size_t)(n) * c->size)
+#define PDQ_COUNT(a, b) ((size_t)((char *)(b) - (char *)(a)) / c->size)
+
+// 使 *a <= *b <= *c
+static void pdq_sort3(const pdq_ctx_t *c, char *a, char *b, char *d)
+{
+    if (pdq_less(c, b, a)) swap_elements(a, b, c->size);
+    if (pdq_less(c, d, b)) swap_elements(b, d, c->size);
+    if (pdq_less(c, b, a)) swap_elements(a, b, c->size);
+}
+
+// 插入排序 [begin, end)
+static void pdq_insertion_sort(const pdq_ctx_t *c, char *begin, char *end)
 {
-    if (low < high) 
+    size_t size = c->size;
+    if (begin == end) return;
+
+    for (char *cur = begin + size; cur != end; cur += size)
     {
-        // 如果区间很小，使用插入排序
-        if (high - low < 10) 
+        char *sift = cur;
+        char *prev = cur - size;
+        if (pdq_less(c, sift, prev))
         {
-            // 对子数组使用插入排序
-            for (int i = low + 1; i <= high; i++) 
+            memcpy(c->tmp, sift, size);
+            do
             {
-                void *curr = get_element(base, i, size);
-                char key[size];
-                memcpy(key, curr, size);
-                
-                int j = i - 1;
-                while (j >= low && compare(get_element(base, j, size), key, context) > 0) 
-                {
-                    memcpy(get_element(base, j + 1, size), get_element(base, j, size), size);
-                    j--;
-                }
-                memcpy(get_element(base, j + 1, size), key, size);
-            }
-            return;
+                memcpy(sift, prev, size);
+                sift = prev;
+            } while (sift != begin && pdq_less(c, c->tmp, prev -= size));
+            memcpy(sift, c->tmp, size);
         }
-        
-        // 分区过程
-        void *pivot = get_element(base, high, size);
-        char pivot_value[size];
-        memcpy(pivot_value, pivot, size);
-        
-        int i = low - 1;
-        
-        for (int j = low; j < high; j++) 
+    }
+}
+
+// 无边界检查的插入排序，要求 begin 之前的元素不大于区间内任何元素
+static void pdq_unguarded_insertion_sort(const pdq_ctx_t *c, char *begin, char *end)
+{
+    size_t size = c->size;
+    if (begin == end) return;
+
+    for (char *cur = begin + size; cur != end; cur += size)
+    {
+        char *sift = cur;
+        char *prev = cur - size;
+        if (pdq_less(c, sift, prev))
         {
-            void *curr = get_element(base, j, size);
-            if (compare(curr, pivot_value, context) <= 0) 
+            memcpy(c->tmp, sift, size);
+            do
             {
-                i++;
-                void *elem_i = get_element(base, i, size);
-                swap_elements(elem_i, curr, size);
-            }
+                memcpy(sift, prev, size);
+                sift = prev;
+            } while (pdq_less(c, c->tmp, prev -= size));
+            memcpy(sift, c->tmp, size);
         }
-        
-        void *elem_i1 = get_element(base, i + 1, size);
-        swap_elements(elem_i1, pivot, size);
-        
-        int partition = i + 1;
-        
-        // 递归对左右子数组进行排序
-        quick_sort_recursive(base, low, partition - 1, size, compare, context);
-        quick_sort_recursive(base, partition + 1, high, size, compare, context);
     }
 }
 
-// 4. 快速排序 (公共接口)
-int quick_sort(void *base, size_t num, size_t size,
-              compare_func_t compare, void *context) 
+// 尝试用插入排序完成排序，移动次数超过上限时放弃并返回 false
+static bool pdq_partial_insertion_sort(const pdq_ctx_t *c, char *begin, char *end)
 {
-    if (!base || !compare || num < 2) 
+    size_t size = c->size;
+    size_t limit = 0;
+    if (begin == end) return true;
+
+    for (char *cur = begin + size; cur != end; cur += size)
     {
-        return 0;
+        char *sift = cur;
+        char *prev = cur - size;
+        if (pdq_less(c, sift, prev))
+        {
+            memcpy(c->tmp, sift, size);
+            do
+            {
+                memcpy(sift, prev, size);
+                sift = prev;
+            } while (sift != begin && pdq_less(c, c->tmp, prev -= size));
+            memcpy(sift, c->tmp, size);
+            limit += PDQ_COUNT(sift, cur);
+        }
+        if (limit > PDQ_PARTIAL_INSERTION_LIMIT) return false;
     }
-    
-    quick_sort_recursive(base, 0, num - 1, size, compare, context);
-    return 0;
+    return true;
 }
 
-// 归并排序 (内部合并函数)
-static void merge(void *base, int left, int mid, int right, size_t size,
-                 compare_func_t compare, void *context) 
+// 以 *begin 为主元分区：左边 < 主元，右边 >= 主元
+// 返回主元最终位置；*already_partitioned 表示分区前区间已经满足条件
+static char *pdq_partition_right(const pdq_ctx_t *c, char *begin, char *end, bool *already_partitioned)
 {
-    int n1 = mid - left + 1;
-    int n2 = right - mid;
-    
-    // 创建临时数组
-    void *L = malloc(n1 * size);
-    void *R = malloc(n2 * size);
-    
-    // 复制数据到临时数组
-    for (int i = 0; i < n1; i++) 
+    size_t size = c->size;
+    char *pivot = begin;
+    char *first = begin;
+    char *last = end;
+
+    // 选主元时已保证 end 前有 >= 主元的元素，左边的扫描无需边界检查
+    while (pdq_less(c, first += size, pivot));
+
+    // 左边第一个元素就 >= 主元时，右边扫描需要边界检查
+    if (first - size == begin)
     {
-        memcpy((char*)L + i * size, get_element(base, left + i, size), size);
+        while (first < last && !pdq_less(c, last -= size, pivot));
     }
-    for (int j = 0; j < n2; j++) 
+    else
     {
-        memcpy((char*)R + j * size, get_element(base, mid + 1 + j, size), size);
+        while (!pdq_less(c, last -= size, pivot));
     }
-    
-    // 合并临时数组
-    int i = 0, j = 0, k = left;
-    
-    while (i < n1 && j < n2) 
+
+    *already_partitioned = first >= last;
+
+    while (first < last)
     {
-        void *L_elem = (char*)L + i * size;
-        void *R_elem = (char*)R + j * size;
-        
-        if (compare(L_elem, R_elem, context) <= 0) 
+        swap_elements(first, last, size);
+        while (pdq_less(c, first += size, pivot));
+        while (!pdq_less(c, last -= size, pivot));
+    }
+
+    char *pivot_pos = first - size;
+    swap_elements(begin, pivot_pos, size);
+    return pivot_pos;
+}
+
+// 以 *begin 为主元分区：左边 <= 主元，右边 > 主元
+// 用于主元等于前一个区间主元的情况，把所有相等元素一次性归到左边，重复键不会退化
+static char *pdq_partition_left(const pdq_ctx_t *c, char *begin, char *end)
+{
+    size_t size = c->size;
+    char *pivot = begin;
+    char *first = begin;
+    char *last = end;
+
+    while (pdq_less(c, pivot, last -= size));
+
+    if (last + size == end)
+    {
+        while (first < last && !pdq_less(c, pivot, first += size));
+    }
+    else
+    {
+        while (!pdq_less(c, pivot, first += size));
+    }
+
+    while (first < last)
+    {
+        swap_elements(first, last, size);
+        while (pdq_less(c, pivot, last -= size));
+        while (!pdq_less(c, pivot, first += size));
+    }
+
+    swap_elements(begin, last, size);
+    return last;
+}
+
+// 堆排序的下沉操作（迭代实现）
+static void sift_down(void *base, size_t num, size_t size, size_t i,
+                      compare_func_t compare, void *context)
+{
+    for (;;)
+    {
+        size_t largest = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+
+        if (left < num && compare(get_element(base, left, size), get_element(base, largest, size), context) > 0)
         {
-            memcpy(get_element(base, k, size), L_elem, size);
-            i++;
-        } 
-        else 
+            largest = left;
+        }
+        if (right < num && compare(get_element(base, right, size), get_element(base, largest, size), context) > 0)
+        {
+            largest = right;
+        }
+        if (largest == i)
         {
-            memcpy(get_element(base, k, size), R_elem, size);
-            j++;
+            return;
         }
-        k++;
+        swap_elements(get_element(base, i, size), get_element(base, largest, size), size);
+        i = largest;
     }
-    
-    // 复制剩余元素
-    while (i < n1) 
+}
+
+// 对 [base, base + num) 做堆排序
+static void heap_sort_range(void *base, size_t num, size_t size,
+                            compare_func_t compare, void *context)
+{
+    for (size_t i = num / 2; i > 0; i--)
     {
-        memcpy(get_element(base, k, size), (char*)L + i * size, size);
-        i++;
-        k++;
+        sift_down(base, num, size, i - 1, compare, context);
     }
-    while (j < n2) 
+    for (size_t i = num - 1; i > 0; i--)
     {
-        memcpy(get_element(base, k, size), (char*)R + j * size, size);
-        j++;
-        k++;
+        swap_elements(base, get_element(base, i, size), size);
+        sift_down(base, i, size, 0, compare, context);
+    }
+}
+
+// 打乱区间中的几个元素，破坏导致分区不均衡的输入模式
+static void pdq_break_patterns(const pdq_ctx_t *c, char *begin, char *end, size_t len)
+{
+    size_t size = c->size;
+    size_t quarter = len / 4;
+
+    swap_elements(begin, PDQ_AT(begin, quarter), size);
+    swap_elements(end - size, end - quarter * size, size);
+    if (len > PDQ_NINTHER_THRESHOLD)
+    {
+        swap_elements(PDQ_AT(begin, 1), PDQ_AT(begin, quarter + 1), size);
+        swap_elements(PDQ_AT(begin, 2), PDQ_AT(begin, quarter + 2), size);
+        swap_elements(end - 2 * size, end - (quarter + 1) * size, size);
+        swap_elements(end - 3 * size, end - (quarter + 2) * size, size);
+    }
+}
+
+// 选主元并放到 begin：大区间用 ninther（三组三数取中再取中），否则三数取中
+static void pdq_choose_pivot(const pdq_ctx_t *c, char *begin, char *end, size_t len)
+{
+    size_t size = c->size;
+    size_t half = len / 2;
+
+    if (len > PDQ_NINTHER_THRESHOLD)
+    {
+        pdq_sort3(c, begin, PDQ_AT(begin, half), end - size);
+        pdq_sort3(c, PDQ_AT(begin, 1), PDQ_AT(begin, half - 1), end - 2 * size);
+        pdq_sort3(c, PDQ_AT(begin, 2), PDQ_AT(begin, half + 1), end - 3 * size);
+        pdq_sort3(c, PDQ_AT(begin, half - 1), PDQ_AT(begin, half), PDQ_AT(begin, half + 1));
+        swap_elements(begin, PDQ_AT(begin, half), size);
+    }
+    else
+    {
+        pdq_sort3(c, PDQ_AT(begin, half), begin, end - size);
     }
-    
-    // 释放临时数组
-    free(L);
-    free(R);
 }
 
-// 归并排序 (内部递归实现)
-static void merge_sort_recursive(void *base, int left, int right, size_t size,
-                                compare_func_t compare, void *context) 
+// pdqsort 主循环：只对较短的一侧递归，较长的一侧在循环中继续，递归深度 O(log n)
+// bad_allowed 为还允许出现的不均衡分区次数，用完后改用堆排序，保证 O(n log n)
+// leftmost 表示区间是否位于整个数组的最左端（否则 begin 前一个元素不大于区间内任何元素）
+static void pdq_sort_loop(const pdq_ctx_t *c, char *begin, char *end, int bad_allowed, bool leftmost)
 {
-    if (left < right) 
+    size_t size = c->size;
+
+    for (;;)
     {
-        if (right - left < 10) 
+        size_t len = PDQ_COUNT(begin, end);
+
+        if (len < PDQ_INSERTION_THRESHOLD)
         {
-            // 对小数组使用插入排序
-            for (int i = left + 1; i <= right; i++) 
+            if (leftmost)
             {
-                void *curr = get_element(base, i, size);
-                char key[size];
-                memcpy(key, curr, size);
-                
-                int j = i - 1;
-                while (j >= left && compare(get_element(base, j, size), key, context) > 0) 
-                {
-                    memcpy(get_element(base, j + 1, size), get_element(base, j, size), size);
-                    j--;
-                }
-                memcpy(get_element(base, j + 1, size), key, size);
+                pdq_insertion_sort(c, begin, end);
+            }
+            else
+            {
+                pdq_unguarded_insertion_sort(c, begin, end);
             }
             return;
         }
-        
-        int mid = left + (right - left) / 2;
-        
-        merge_sort_recursive(base, left, mid, size, compare, context);
-        merge_sort_recursive(base, mid + 1, right, size, compare, context);
-        
-        merge(base, left, mid, right, size, compare, context);
+
+        pdq_choose_pivot(c, begin, end, len);
+
+        // 主元等于左侧相邻元素（上一层的主元），说明有大量重复键：
+        // 把所有等于主元的元素归到左边，它们已经就位，只需继续处理右边
+        if (!leftmost && !pdq_less(c, begin - size, begin))
+        {
+            begin = pdq_partition_left(c, begin, end) + size;
+            continue;
+        }
+
+        bool already_partitioned;
+        char *pivot_pos = pdq_partition_right(c, begin, end, &already_partitioned);
+
+        size_t left_len = PDQ_COUNT(begin, pivot_pos);
+        size_t right_len = PDQ_COUNT(pivot_pos + size, end);
+        bool highly_unbalanced = left_len < len / 8 || right_len < len / 8;
+
+        if (highly_unbalanced)
+        {
+            // 不均衡分区次数过多，改用堆排序
+            if (--bad_allowed == 0)
+            {
+                heap_sort_range(begin, len, size, c->compare, c->context);
+                return;
+            }
+
+            if (left_len >= PDQ_INSERTION_THRESHOLD)
+            {
+                pdq_break_patterns(c, begin, pivot_pos, left_len);
+            }
+            if (right_len >= PDQ_INSERTION_THRESHOLD)
+            {
+                pdq_break_patterns(c, pivot_pos + size, end, right_len);
+            }
+        }
+        else if (already_partitioned &&
+                 pdq_partial_insertion_sort(c, begin, pivot_pos) &&
+                 pdq_partial_insertion_sort(c, pivot_pos + size, end))
+        {
+            // 分区时没有交换且两侧都近似有序，插入排序已经完成排序
+            return;
+        }
+
+        // 递归处理较短的一侧
+        if (left_len < right_len)
+        {
+            pdq_sort_loop(c, begin, pivot_pos, bad_allowed, leftmost);
+            begin = pivot_pos + size;
+            leftmost = false;
+        }
+        else
+        {
+            pdq_sort_loop(c, pivot_pos + size, end, bad_allowed, false);
+            end = pivot_pos;
+        }
     }
 }
 
-// 5. 归并排序 (公共接口)
-int merge_sort(void *base, size_t num, size_t size,
+// 4. 快速排序 (公共接口)
+int quick_sort(void *base, size_t num, size_t size,
               compare_func_t compare, void *context) 
 {
     if (!base || !compare || num < 2) 
     {
         return 0;
     }
-    
-    merge_sort_recursive(base, 0, num - 1, size, compare, context);
+
+    char stack_tmp[PDQ_STACK_ELEMENT_SIZE];
+    void *tmp = size <= sizeof(stack_tmp) ? stack_tmp : malloc(size);
+    if (!tmp)
+    {
+        return -1;
+    }
+
+    // 允许的不均衡分区次数为 log2(num)
+    int bad_allowed = 0;
+    for (size_t n = num; n > 1; n >>= 1)
+    {
+        bad_allowed++;
+    }
+
+    pdq_ctx_t c = { size, compare, context, tmp };
+    pdq_sort_loop(&c, (char *)base, (char *)base + num * size, bad_allowed, true);
+
+    if (tmp != stack_tmp)
+    {
+        free(tmp);
+    }
     return 0;
 }
 
-// 堆排序 (内部维护堆的函数)
-static void heapify(void *base, size_t num, size_t size, size_t i,
-                   compare_func_t compare, void *context) 
+//-----------------------------
+// 选择与部分排序
+//-----------------------------
+
+// 快速选择主循环：分区方式与 pdqsort 相同，但只继续处理包含 nth 的一侧，期望 O(n)
+// 不均衡分区次数用完后对剩余区间做堆排序，最坏 O(n log n)
+static void pdq_select_loop(const pdq_ctx_t *c, char *begin, char *end, char *nth,
+                            int bad_allowed, bool leftmost)
 {
-    size_t largest = i;
-    size_t left = 2 * i + 1;
-    size_t right = 2 * i + 2;
-    
-    void *largest_elem = get_element(base, largest, size);
-    
-    // 如果左子节点大于根节点
-    if (left < num) 
+    size_t size = c->size;
+
+    for (;;)
     {
-        void *left_elem = get_element(base, left, size);
-        if (compare(left_elem, largest_elem, context) > 0) 
+        size_t len = PDQ_COUNT(begin, end);
+
+        if (len < PDQ_INSERTION_THRESHOLD)
         {
-            largest = left;
-            largest_elem = left_elem;
+            if (leftmost)
+            {
+                pdq_insertion_sort(c, begin, end);
+            }
+            else
+            {
+                pdq_unguarded_insertion_sort(c, begin, end);
+            }
+            return;
         }
-    }
-    
-    // 如果右子节点大于当前最大值
-    if (right < num) 
-    {
-        void *right_elem = get_element(base, right, size);
-        if (compare(right_elem, largest_elem, context) > 0) 
+
+        pdq_choose_pivot(c, begin, end, len);
+
+        // 主元与左侧相邻元素相等时，左边分出的都是等于主元的元素
+        if (!leftmost && !pdq_less(c, begin - size, begin))
         {
-            largest = right;
+            char *last_equal = pdq_partition_left(c, begin, end);
+            if (nth <= last_equal)
+            {
+                return;
+            }
+            begin = last_equal + size;
+            continue;
+        }
+
+        bool already_partitioned;
+        char *pivot_pos = pdq_partition_right(c, begin, end, &already_partitioned);
+        if (nth == pivot_pos)
+        {
+            return;
+        }
+
+        size_t left_len = PDQ_COUNT(begin, pivot_pos);
+        size_t right_len = PDQ_COUNT(pivot_pos + size, end);
+        if (left_len < len / 8 || right_len < len / 8)
+        {
+            if (--bad_allowed == 0)
+            {
+                heap_sort_range(begin, len, size, c->compare, c->context);
+                return;
+            }
+            if (nth < pivot_pos && left_len >= PDQ_INSERTION_THRESHOLD)
+            {
+                pdq_break_patterns(c, begin, pivot_pos, left_len);
+            }
+            if (nth > pivot_pos && right_len >= PDQ_INSERTION_THRESHOLD)
+            {
+                pdq_break_patterns(c, pivot_pos + size, end, right_len);
+            }
+        }
+
+        if (nth < pivot_pos)
+        {
+            end = pivot_pos;
+        }
+        else
+        {
+            begin = pivot_pos + size;
+            leftmost = false;
         }
-    }
-    
-    // 如果最大值不是根节点
-    if (largest != i) 
-    {
-        swap_elements(get_element(base, i, size), 
-                      get_element(base, largest, size), size);
-        
-        // 递归维护子堆
-        heapify(base, num, size, largest, compare, context);
     }
 }
 
-// 6. 堆排序 (公共接口)
-int heap_sort(void *base, size_t num, size_t size,
-             compare_func_t compare, void *context) 
+int select_nth(void *base, size_t num, size_t nth, size_t size,
+               compare_func_t compare, void *context)
 {
-    if (!base || !compare || num < 2) 
+    if (!base || !compare || nth >= num)
+    {
+        return -1;
+    }
+    if (num < 2)
     {
         return 0;
     }
-    
-    // 构建最大堆
-    for (int i = num / 2 - 1; i >= 0; i--) 
+
+    char stack_tmp[PDQ_STACK_ELEMENT_SIZE];
+    void *tmp = size <= sizeof(stack_tmp) ? stack_tmp : malloc(size);
+    if (!tmp)
     {
-        heapify(base, num, size, i, compare, context);
+        return -1;
     }
-    
-    // 一个个从堆中提取元素
-    for (size_t i = num - 1; i > 0; i--) 
+
+    int bad_allowed = 0;
+    for (size_t n = num; n > 1; n >>= 1)
     {
-        // 将当前根节点移到末尾
-        swap_elements(get_element(base, 0, size), 
-                      get_element(base, i, size), size);
-        
-        // 对减小的堆调用heapify
-        heapify(base, i, size, 0, compare, context);
+        bad_allowed++;
+    }
+
+    pdq_ctx_t c = { size, compare, context, tmp };
+    pdq_select_loop(&c, (char *)base, (char *)base + num * size,
+                    (char *)base + nth * size, bad_allowed, true);
+
+    if (tmp != stack_tmp)
+    {
+        free(tmp);
     }
-    
     return 0;
 }
 
-// 主排序函数 - 根据算法类型选择合适的排序方法
-int sort(void *base, size_t num, size_t size,
-        compare_func_t compare, void *context,
-        sort_algorithm_t algorithm) 
+int partial_sort(void *base, size_t num, size_t k, size_t size,
+                 compare_func_t compare, void *context)
 {
-    if (!base || !compare || num < 2) 
+    if (!base || !compare)
+    {
+        return -1;
+    }
+    if (k >= num)
+    {
+        return quick_sort(base, num, size, compare, context);
+    }
+    if (k == 0)
     {
         return 0;
     }
-    
-    // 如果是自动选择，调用推荐函数
-    if (algorithm == SORT_AUTO) 
+
+    // 先选出前 k 个，第 k 个已经就位，只需排序它前面的 k - 1 个
+    if (select_nth(base, num, k - 1, size, compare, context) != 0)
     {
-        algorithm = recommend_sort_algorithm(num, size);
+        return -1;
+    }
+    return quick_sort(base, k - 1, size, compare, context);
+}
+
+// 堆的上浮操作（大顶堆）
+static void sift_up(void *base, size_t size, size_t i,
+                    compare_func_t compare, void *context)
+{
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+        void *cur = get_element(base, i, size);
+        void *up = get_element(base, parent, size);
+        if (compare(cur, up, context) <= 0)
+        {
+            return;
+        }
+        swap_elements(cur, up, size);
+        i = parent;
+    }
+}
+
+topk_t *topk_create(size_t k, size_t size, compare_func_t compare, void *context)
+{
+    if (k == 0 || size == 0 || !compare)
+    {
+        return NULL;
+    }
+
+    topk_t *topk = malloc(sizeof(topk_t));
+    if (!topk)
+    {
+        return NULL;
+    }
+    topk->data = malloc(k * size);
+    if (!topk->data)
+    {
+        free(topk);
+        return NULL;
+    }
+    topk->size = size;
+    topk->k = k;
+    topk->count = 0;
+    topk->compare = compare;
+    topk->context = context;
+    return topk;
+}
+
+void topk_destroy(topk_t *topk)
+{
+    if (!topk)
+    {
+        return;
+    }
+    free(topk->data);
+    free(topk);
+}
+
+void topk_clear(topk_t *topk)
+{
+    if (topk)
+    {
+        topk->count = 0;
+    }
+}
+
+int topk_push(topk_t *topk, const void *elem)
+{
+    if (!topk || !elem)
+    {
+        return 0;
+    }
+
+    if (topk->count < topk->k)
+    {
+        memcpy(get_element(topk->data, topk->count, topk->size), elem, topk->size);
+        sift_up(topk->data, topk->size, topk->count, topk->compare, topk->context);
+        topk->count++;
+        return 1;
+    }
+
+    // 已满时只有排在堆顶（当前第 k 个）之前的元素才会替换它
+    if (topk->compare(elem, topk->data, topk->context) >= 0)
+    {
+        return 0;
+    }
+    memcpy(topk->data, elem, topk->size);
+    sift_down(topk->data, topk->count, topk->size, 0, topk->compare, topk->context);
+    return 1;
+}
+
+size_t topk_push_batch(topk_t *topk, const void *base, size_t num)
+{
+    size_t kept = 0;
+
+    if (!topk || !base)
+    {
+        return 0;
+    }
+    for (size_t i = 0; i < num; i++)
+    {
+        kept += (size_t)topk_push(topk, (const char *)base + i * topk->size);
+    }
+    return kept;
+}
+
+size_t topk_size(const topk_t *topk)
+{
+    return topk ? topk->count : 0;
+}
+
+const void *topk_peek(const topk_t *topk)
+{
+    return topk && topk->count > 0 ? topk->data : NULL;
+}
+
+size_t topk_result(const topk_t *topk, void *out)
+{
+    if (!topk || !out || topk->count == 0)
+    {
+        return 0;
+    }
+    memcpy(out, topk->data, topk->count * topk->size);
+    quick_sort(out, topk->count, topk->size, topk->compare, topk->context);
+    return topk->count;
+}
+
+//-----------------------------
+// 归并排序: powersort（TimSort 的改进合并策略）
+//-----------------------------
+
+// 自然有序段短于该长度时用二分插入排序补齐
+#define MERGE_MIN_RUN 32
+// 临时缓冲区不超过该字节数时使用栈上内存
+#define MERGE_STACK_BUFFER_SIZE 1024
+// 合并时一侧连续胜出该次数后进入指数搜索模式
+#define MERGE_MIN_GALLOP 7
+// 有序段栈的最大深度，powersort 保证不超过 log2(n) + 1
+#define MERGE_MAX_RUNS 72
+
+// 归并排序的共享参数
+typedef struct {
+    size_t size;
+    compare_func_t compare;
+    void *context;
+    unsigned char *buffer;   // 至少能容纳 num / 2 个元素
+} merge_ctx_t;
+
+typedef struct {
+    size_t start;
+    size_t len;
+    unsigned power;          // 与后一个有序段之间边界的 power
+} merge_run_t;
+
+#define MERGE_AT(c, base, i) ((unsigned char *)(base) + (i) * (c)->size)
+
+// 第一个大于 key 的位置（相等的元素留在左边，保证稳定）
+static size_t merge_upper_bound(const merge_ctx_t *c, const unsigned char *base,
+                                size_t num, const void *key)
+{
+    size_t lo = 0, hi = num;
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (c->compare(key, MERGE_AT(c, base, mid), c->context) < 0)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+// 二分插入排序，[0, sorted) 已经有序，缓冲区的第一个元素用作临时空间
+static void merge_binary_insertion(const merge_ctx_t *c, unsigned char *base,
+                                   size_t num, size_t sorted)
+{
+    size_t size = c->size;
+    unsigned char *tmp = c->buffer;
+
+    for (size_t i = sorted; i < num; i++)
+    {
+        unsigned char *cur = MERGE_AT(c, base, i);
+        size_t pos = merge_upper_bound(c, base, i, cur);
+        if (pos == i)
+        {
+            continue;
+        }
+        memcpy(tmp, cur, size);
+        memmove(MERGE_AT(c, base, pos + 1), MERGE_AT(c, base, pos), (i - pos) * size);
+        memcpy(MERGE_AT(c, base, pos), tmp, size);
+    }
+}
+
+// 从 base 开始找自然有序段，严格降序段原地翻转（不会交换相等元素，保持稳定）
+static size_t merge_count_run(const merge_ctx_t *c, unsigned char *base, size_t num)
+{
+    size_t run = 2;
+
+    if (num < 2)
+    {
+        return num;
+    }
+
+    if (c->compare(MERGE_AT(c, base, 1), MERGE_AT(c, base, 0), c->context) < 0)
+    {
+        while (run < num &&
+               c->compare(MERGE_AT(c, base, run), MERGE_AT(c, base, run - 1), c->context) < 0)
+        {
+            run++;
+        }
+        for (size_t i = 0, j = run - 1; i < j; i++, j--)
+        {
+            swap_elements(MERGE_AT(c, base, i), MERGE_AT(c, base, j), c->size);
+        }
+    }
+    else
+    {
+        while (run < num &&
+               c->compare(MERGE_AT(c, base, run), MERGE_AT(c, base, run - 1), c->context) >= 0)
+        {
+            run++;
+        }
+    }
+    return run;
+}
+
+// 指数搜索：在有序的 base[0, num) 中找第一个不满足"排在 key 之前"的位置
+// upper 为 true 时相等元素算作排在 key 之前（upper bound），否则不算（lower bound）
+// from_right 为 true 时从右端开始搜索，适合目标靠近末尾的情况
+static size_t merge_gallop(const merge_ctx_t *c, const unsigned char *base, size_t num,
+                           const void *key, bool upper, bool from_right)
+{
+#define MERGE_BEFORE(i) (upper ? c->compare(key, MERGE_AT(c, base, i), c->context) >= 0 \
+                               : c->compare(MERGE_AT(c, base, i), key, c->context) < 0)
+    size_t lo, hi;
+    size_t last = 0, ofs = 1;
+
+    if (!from_right)
+    {
+        if (num == 0 || !MERGE_BEFORE(0))
+        {
+            return 0;
+        }
+        while (ofs < num && MERGE_BEFORE(ofs))
+        {
+            last = ofs;
+            ofs = ofs * 2 + 1;
+        }
+        lo = last + 1;
+        hi = ofs < num ? ofs : num;
+    }
+    else
+    {
+        if (num == 0 || MERGE_BEFORE(num - 1))
+        {
+            return num;
+        }
+        while (ofs < num && !MERGE_BEFORE(num - 1 - ofs))
+        {
+            last = ofs;
+            ofs = ofs * 2 + 1;
+        }
+        lo = ofs < num ? num - ofs : 0;
+        hi = num - 1 - last;
+    }
+
+    while (lo < hi)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (MERGE_BEFORE(mid))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    return lo;
+#undef MERGE_BEFORE
+}
+
+// 合并相邻的有序段 [lo, mid) 和 [mid, hi)，缓冲区只需容纳较短的一段
+// 一侧连续胜出 MERGE_MIN_GALLOP 次后改用指数搜索成块搬移
+static void merge_runs(const merge_ctx_t *c, unsigned char *base,
+                       size_t lo, size_t mid, size_t hi)
+{
+    size_t size = c->size;
+    unsigned char *buf = c->buffer;
+
+    // 左段中不大于右段首元素的前缀已经在最终位置
+    lo += merge_gallop(c, MERGE_AT(c, base, lo), mid - lo, MERGE_AT(c, base, mid), true, false);
+    if (lo == mid)
+    {
+        return;
+    }
+    // 右段中不小于左段末元素的后缀也已经在最终位置
+    hi = mid + merge_gallop(c, MERGE_AT(c, base, mid), hi - mid, MERGE_AT(c, base, mid - 1), false, true);
+
+    size_t n1 = mid - lo;
+    size_t n2 = hi - mid;
+
+    if (n1 <= n2)
+    {
+        // 左段拷出，从前向后合并
+        memcpy(buf, MERGE_AT(c, base, lo), n1 * size);
+        unsigned char *a = buf, *a_end = buf + n1 * size;
+        unsigned char *b = MERGE_AT(c, base, mid), *b_end = MERGE_AT(c, base, hi);
+        unsigned char *dst = MERGE_AT(c, base, lo);
+
+        while (a < a_end && b < b_end)
+        {
+            size_t wins_a = 0, wins_b = 0;
+            do
+            {
+                if (c->compare(b, a, c->context) < 0)
+                {
+                    memcpy(dst, b, size);
+                    b += size;
+                    wins_b++;
+                    wins_a = 0;
+                }
+                else
+                {
+                    memcpy(dst, a, size);
+                    a += size;
+                    wins_a++;
+                    wins_b = 0;
+                }
+                dst += size;
+            } while (a < a_end && b < b_end &&
+                     wins_a < MERGE_MIN_GALLOP && wins_b < MERGE_MIN_GALLOP);
+
+            while (a < a_end && b < b_end)
+            {
+                // 左段中不大于 b 的元素整块搬移
+                size_t na = merge_gallop(c, a, (size_t)(a_end - a) / size, b, true, false);
+                memcpy(dst, a, na * size);
+                dst += na * size;
+                a += na * size;
+                if (a == a_end)
+                {
+                    break;
+                }
+                memcpy(dst, b, size);
+                dst += size;
+                b += size;
+                if (b == b_end)
+                {
+                    break;
+                }
+
+                // 右段中小于 a 的元素整块搬移（目标区间可能与源重叠）
+                size_t nb = merge_gallop(c, b, (size_t)(b_end - b) / size, a, false, false);
+                memmove(dst, b, nb * size);
+                dst += nb * size;
+                b += nb * size;
+                if (b == b_end)
+                {
+                    break;
+                }
+                memcpy(dst, a, size);
+                dst += size;
+                a += size;
+
+                if (na < MERGE_MIN_GALLOP && nb < MERGE_MIN_GALLOP)
+                {
+                    break;
+                }
+            }
+        }
+        // 右段剩余部分已在原位
+        memcpy(dst, a, (size_t)(a_end - a));
+    }
+    else
+    {
+        // 右段拷出，从后向前合并
+        memcpy(buf, MERGE_AT(c, base, mid), n2 * size);
+        unsigned char *a = MERGE_AT(c, base, mid), *a_begin = MERGE_AT(c, base, lo);
+        unsigned char *b = buf + n2 * size;
+        unsigned char *dst = MERGE_AT(c, base, hi);
+
+        while (a > a_begin && b > buf)
+        {
+            size_t wins_a = 0, wins_b = 0;
+            do
+            {
+                dst -= size;
+                if (c->compare(b - size, a - size, c->context) < 0)
+                {
+                    a -= size;
+                    memcpy(dst, a, size);
+                    wins_a++;
+                    wins_b = 0;
+                }
+                else
+                {
+                    b -= size;
+                    memcpy(dst, b, size);
+                    wins_b++;
+                    wins_a = 0;
+                }
+            } while (a > a_begin && b > buf &&
+                     wins_a < MERGE_MIN_GALLOP && wins_b < MERGE_MIN_GALLOP);
+
+            while (a > a_begin && b > buf)
+            {
+                // 左段中大于右段末元素的后缀整块搬移（目标区间可能与源重叠）
+                size_t len_a = (size_t)(a - a_begin) / size;
+                size_t na = len_a - merge_gallop(c, a_begin, len_a, b - size, true, true);
+                dst -= na * size;
+                a -= na * size;
+                memmove(dst, a, na * size);
+                if (a == a_begin)
+                {
+                    break;
+                }
+                dst -= size;
+                b -= size;
+                memcpy(dst, b, size);
+                if (b == buf)
+                {
+                    break;
+                }
+
+                // 右段中不小于左段末元素的后缀整块搬移
+                size_t len_b = (size_t)(b - buf) / size;
+                size_t nb = len_b - merge_gallop(c, buf, len_b, a - size, false, true);
+                dst -= nb * size;
+                b -= nb * size;
+                memcpy(dst, b, nb * size);
+                if (b == buf)
+                {
+                    break;
+                }
+                dst -= size;
+                a -= size;
+                memcpy(dst, a, size);
+
+                if (na < MERGE_MIN_GALLOP && nb < MERGE_MIN_GALLOP)
+                {
+                    break;
+                }
+            }
+        }
+        // 左段剩余部分已在原位
+        memcpy(a_begin, buf, (size_t)(b - buf));
+    }
+}
+
+// powersort 的边界 power：两段中点在 [0, 1) 上的二进制表示的公共前缀长度加一
+static unsigned merge_node_power(size_t start, size_t n1, size_t n2, size_t num)
+{
+    size_t a = 2 * start + n1;
+    size_t b = a + n1 + n2;
+    unsigned power = 0;
+
+    for (;;)
+    {
+        power++;
+        if (a >= num)
+        {
+            a -= num;
+            b -= num;
+        }
+        else if (b >= num)
+        {
+            break;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+    return power;
+}
+
+// 找到下一个有序段，不足 MERGE_MIN_RUN 时用插入排序补齐
+static size_t merge_next_run(const merge_ctx_t *c, unsigned char *base, size_t start, size_t num)
+{
+    unsigned char *p = MERGE_AT(c, base, start);
+    size_t remain = num - start;
+    size_t run = merge_count_run(c, p, remain);
+
+    if (run < MERGE_MIN_RUN && run < remain)
+    {
+        size_t target = remain < MERGE_MIN_RUN ? remain : MERGE_MIN_RUN;
+        merge_binary_insertion(c, p, target, run);
+        run = target;
+    }
+    return run;
+}
+
+// 5. 归并排序，使用调用方提供的缓冲区
+int merge_sort_with_buffer(void *base, size_t num, size_t size,
+                           compare_func_t compare, void *context,
+                           void *buffer, size_t buffer_size)
+{
+    if (!base || !compare || num < 2)
+    {
+        return 0;
+    }
+    if (!buffer || buffer_size < (num / 2) * size)
+    {
+        return -1;
+    }
+
+    merge_ctx_t c = { size, compare, context, buffer };
+    unsigned char *p = base;
+    merge_run_t stack[MERGE_MAX_RUNS];
+    size_t top = 0;
+
+    size_t cur_start = 0;
+    size_t cur_len = merge_next_run(&c, p, 0, num);
+
+    while (cur_start + cur_len < num)
+    {
+        size_t next_start = cur_start + cur_len;
+        size_t next_len = merge_next_run(&c, p, next_start, num);
+        unsigned power = merge_node_power(cur_start, cur_len, next_len, num);
+
+        // 栈顶边界的 power 更大，说明它在合并树中更深，先合并
+        while (top > 0 && stack[top - 1].power > power)
+        {
+            top--;
+            merge_runs(&c, p, stack[top].start, cur_start, cur_start + cur_len);
+            cur_len += cur_start - stack[top].start;
+            cur_start = stack[top].start;
+        }
+
+        stack[top].start = cur_start;
+        stack[top].len = cur_len;
+        stack[top].power = power;
+        top++;
+
+        cur_start = next_start;
+        cur_len = next_len;
+    }
+
+    while (top > 0)
+    {
+        top--;
+        merge_runs(&c, p, stack[top].start, cur_start, cur_start + cur_len);
+        cur_len += cur_start - stack[top].start;
+        cur_start = stack[top].start;
+    }
+    return 0;
+}
+
+// 5. 归并排序 (公共接口)
+int merge_sort(void *base, size_t num, size_t size,
+              compare_func_t compare, void *context) 
+{
+    if (!base || !compare || num < 2) 
+    {
+        return 0;
+    }
+
+    // 只分配一次 num / 2 个元素的缓冲区
+    unsigned char stack_buffer[MERGE_STACK_BUFFER_SIZE];
+    size_t buffer_size = (num / 2) * size;
+    void *buffer = stack_buffer;
+    if (buffer_size > sizeof(stack_buffer))
+    {
+        buffer = malloc(buffer_size);
+        if (!buffer)
+        {
+            return -1;
+        }
+    }
+
+    int ret = merge_sort_with_buffer(base, num, size, compare, context, buffer, buffer_size);
+
+    if (buffer != stack_buffer)
+    {
+        free(buffer);
+    }
+    return ret;
+}
+
+// 6. 堆排序 (公共接口)
+int heap_sort(void *base, size_t num, size_t size,
+             compare_func_t compare, void *context) 
+{
+    if (!base || !compare || num < 2) 
+    {
+        return 0;
+    }
+    
+    heap_sort_range(base, num, size, compare, context);
+    return 0;
+}
+
+//-----------------------------
+// 基数排序
+//-----------------------------
+
+// 元素数量较少时使用 8 位数字（256 个桶），较多时使用 11 位数字（2048 个桶）以减少趟数
+#define RADIX_SMALL_BITS 8
+#define RADIX_LARGE_BITS 11
+#define RADIX_LARGE_MIN_COUNT 65536
+
+static inline unsigned radix_digit_bits(size_t num)
+{
+    return num >= RADIX_LARGE_MIN_COUNT ? RADIX_LARGE_BITS : RADIX_SMALL_BITS;
+}
+
+// 有符号整数和浮点数转换为无符号整数后按位比较与原值顺序一致
+static inline uint32_t radix_encode_f32(uint32_t bits)
+{
+    return (bits & 0x80000000u) ? ~bits : bits ^ 0x80000000u;
+}
+
+static inline uint32_t radix_decode_f32(uint32_t bits)
+{
+    return (bits & 0x80000000u) ? bits ^ 0x80000000u : ~bits;
+}
+
+static inline uint64_t radix_encode_f64(uint64_t bits)
+{
+    return (bits & 0x8000000000000000ull) ? ~bits : bits ^ 0x8000000000000000ull;
+}
+
+static inline uint64_t radix_decode_f64(uint64_t bits)
+{
+    return (bits & 0x8000000000000000ull) ? bits ^ 0x8000000000000000ull : ~bits;
+}
+
+// 对直方图求前缀和，得到每个桶的起始位置
+static inline void radix_prefix_sum(size_t *hist, size_t buckets)
+{
+    size_t sum = 0;
+    for (size_t b = 0; b < buckets; b++)
+    {
+        size_t count = hist[b];
+        hist[b] = sum;
+        sum += count;
+    }
+}
+
+// 32 位无符号键的 LSD 基数排序
+static int radix_sort_32(uint32_t *base, size_t num)
+{
+    unsigned bits = radix_digit_bits(num);
+    unsigned passes = (32 + bits - 1) / bits;
+    size_t buckets = (size_t)1 << bits;
+    uint32_t mask = (uint32_t)(buckets - 1);
+
+    size_t *hist = calloc(passes * buckets, sizeof(size_t));
+    uint32_t *buffer = malloc(num * sizeof(uint32_t));
+    if (!hist || !buffer)
+    {
+        free(hist);
+        free(buffer);
+        return -1;
+    }
+
+    // 一次遍历算出所有趟的直方图
+    for (size_t i = 0; i < num; i++)
+    {
+        uint32_t key = base[i];
+        for (unsigned p = 0; p < passes; p++)
+        {
+            hist[p * buckets + ((key >> (p * bits)) & mask)]++;
+        }
+    }
+
+    uint32_t *src = base;
+    uint32_t *dst = buffer;
+    for (unsigned p = 0; p < passes; p++)
+    {
+        size_t *h = hist + p * buckets;
+        unsigned shift = p * bits;
+
+        // 所有键在这一位上都相同，这一趟不改变顺序
+        if (h[(src[0] >> shift) & mask] == num)
+        {
+            continue;
+        }
+
+        radix_prefix_sum(h, buckets);
+        for (size_t i = 0; i < num; i++)
+        {
+            uint32_t key = src[i];
+            dst[h[(key >> shift) & mask]++] = key;
+        }
+
+        uint32_t *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != base)
+    {
+        memcpy(base, src, num * sizeof(uint32_t));
+    }
+    free(hist);
+    free(buffer);
+    return 0;
+}
+
+// 64 位无符号键的 LSD 基数排序
+static int radix_sort_64(uint64_t *base, size_t num)
+{
+    unsigned bits = radix_digit_bits(num);
+    unsigned passes = (64 + bits - 1) / bits;
+    size_t buckets = (size_t)1 << bits;
+    uint64_t mask = (uint64_t)(buckets - 1);
+
+    size_t *hist = calloc(passes * buckets, sizeof(size_t));
+    uint64_t *buffer = malloc(num * sizeof(uint64_t));
+    if (!hist || !buffer)
+    {
+        free(hist);
+        free(buffer);
+        return -1;
+    }
+
+    for (size_t i = 0; i < num; i++)
+    {
+        uint64_t key = base[i];
+        for (unsigned p = 0; p < passes; p++)
+        {
+            hist[p * buckets + ((key >> (p * bits)) & mask)]++;
+        }
+    }
+
+    uint64_t *src = base;
+    uint64_t *dst = buffer;
+    for (unsigned p = 0; p < passes; p++)
+    {
+        size_t *h = hist + p * buckets;
+        unsigned shift = p * bits;
+
+        if (h[(src[0] >> shift) & mask] == num)
+        {
+            continue;
+        }
+
+        radix_prefix_sum(h, buckets);
+        for (size_t i = 0; i < num; i++)
+        {
+            uint64_t key = src[i];
+            dst[h[(key >> shift) & mask]++] = key;
+        }
+
+        uint64_t *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != base)
+    {
+        memcpy(base, src, num * sizeof(uint64_t));
+    }
+    free(hist);
+    free(buffer);
+    return 0;
+}
+
+int radix_sort_u32(uint32_t *base, size_t num)
+{
+    if (!base || num < 2)
+    {
+        return 0;
+    }
+    return radix_sort_32(base, num);
+}
+
+int radix_sort_i32(int32_t *base, size_t num)
+{
+    if (!base || num < 2)
+    {
+        return 0;
+    }
+
+    uint32_t *keys = (uint32_t *)base;
+    for (size_t i = 0; i < num; i++)
+    {
+        keys[i] ^= 0x80000000u;
+    }
+    int ret = radix_sort_32(keys, num);
+    for (size_t i = 0; i < num; i++)
+    {
+        keys[i] ^= 0x80000000u;
+    }
+    return ret;
+}
+
+int radix_sort_u64(uint64_t *base, size_t num)
+{
+    if (!base || num < 2)
+    {
+        return 0;
+    }
+    return radix_sort_64(base, num);
+}
+
+int radix_sort_i64(int64_t *base, size_t num)
+{
+    if (!base || num < 2)
+    {
+        return 0;
+    }
+
+    uint64_t *keys = (uint64_t *)base;
+    for (size_t i = 0; i < num; i++)
+    {
+        keys[i] ^= 0x8000000000000000ull;
+    }
+    int ret = radix_sort_64(keys, num);
+    for (size_t i = 0; i < num; i++)
+    {
+        keys[i] ^= 0x8000000000000000ull;
+    }
+    return ret;
+}
+
+int radix_sort_f32(float *base, size_t num)
+{
+    if (!base || num < 2)
+    {
+        return 0;
+    }
+
+    uint32_t *keys = (uint32_t *)base;
+    for (size_t i = 0; i < num; i++)
+    {
+        keys[i] = radix_encode_f32(keys[i]);
+    }
+    int ret = radix_sort_32(keys, num);
+    for (size_t i = 0; i < num; i++)
+    {
+        keys[i] = radix_decode_f32(keys[i]);
+    }
+    return ret;
+}
+
+int radix_sort_f64(double *base, size_t num)
+{
+    if (!base || num < 2)
+    {
+        return 0;
+    }
+
+    uint64_t *keys = (uint64_t *)base;
+    for (size_t i = 0; i < num; i++)
+    {
+        keys[i] = radix_encode_f64(keys[i]);
+    }
+    int ret = radix_sort_64(keys, num);
+    for (size_t i = 0; i < num; i++)
+    {
+        keys[i] = radix_decode_f64(keys[i]);
+    }
+    return ret;
+}
+
+// 键类型占用的字节数，类型无效返回 0
+static size_t sort_key_width(sort_key_type_t key_type)
+{
+    switch (key_type)
+    {
+        case SORT_KEY_U32:
+        case SORT_KEY_I32:
+        case SORT_KEY_F32:
+            return sizeof(uint32_t);
+        case SORT_KEY_U64:
+        case SORT_KEY_I64:
+        case SORT_KEY_F64:
+            return sizeof(uint64_t);
+        default:
+            return 0;
+    }
+}
+
+// 读取记录中的键并转换为按无符号整数比较的形式
+static inline uint64_t sort_key_load(const unsigned char *key, sort_key_type_t key_type)
+{
+    uint32_t k32;
+    uint64_t k64;
+
+    switch (key_type)
+    {
+        case SORT_KEY_U32:
+            memcpy(&k32, key, sizeof(k32));
+            return k32;
+        case SORT_KEY_I32:
+            memcpy(&k32, key, sizeof(k32));
+            return k32 ^ 0x80000000u;
+        case SORT_KEY_F32:
+            memcpy(&k32, key, sizeof(k32));
+            return radix_encode_f32(k32);
+        case SORT_KEY_U64:
+            memcpy(&k64, key, sizeof(k64));
+            return k64;
+        case SORT_KEY_I64:
+            memcpy(&k64, key, sizeof(k64));
+            return k64 ^ 0x8000000000000000ull;
+        case SORT_KEY_F64:
+        default:
+            memcpy(&k64, key, sizeof(k64));
+            return radix_encode_f64(k64);
+    }
+}
+
+// 记录数组的 LSD 基数排序，每趟按键搬移整条记录
+static int radix_sort_records_lsd(void *base, size_t num, size_t size,
+                                  size_t key_offset, sort_key_type_t key_type)
+{
+    unsigned key_bits = (unsigned)sort_key_width(key_type) * 8;
+    unsigned bits = radix_digit_bits(num);
+    unsigned passes = (key_bits + bits - 1) / bits;
+    size_t buckets = (size_t)1 << bits;
+    uint64_t mask = (uint64_t)(buckets - 1);
+
+    size_t *hist = calloc(passes * buckets, sizeof(size_t));
+    unsigned char *buffer = malloc(num * size);
+    if (!hist || !buffer)
+    {
+        free(hist);
+        free(buffer);
+        return -1;
+    }
+
+    unsigned char *src = base;
+    unsigned char *dst = buffer;
+    for (size_t i = 0; i < num; i++)
+    {
+        uint64_t key = sort_key_load(src + i * size + key_offset, key_type);
+        for (unsigned p = 0; p < passes; p++)
+        {
+            hist[p * buckets + ((key >> (p * bits)) & mask)]++;
+        }
+    }
+
+    for (unsigned p = 0; p < passes; p++)
+    {
+        size_t *h = hist + p * buckets;
+        unsigned shift = p * bits;
+
+        if (h[(sort_key_load(src + key_offset, key_type) >> shift) & mask] == num)
+        {
+            continue;
+        }
+
+        radix_prefix_sum(h, buckets);
+        for (size_t i = 0; i < num; i++)
+        {
+            const unsigned char *elem = src + i * size;
+            uint64_t key = sort_key_load(elem + key_offset, key_type);
+            memcpy(dst + h[(key >> shift) & mask]++ * size, elem, size);
+        }
+
+        unsigned char *t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != (unsigned char *)base)
+    {
+        memcpy(base, src, num * size);
+    }
+    free(hist);
+    free(buffer);
+    return 0;
+}
+
+// 大记录的基数排序：只对 (键, 下标) 对做 LSD 排序，再按下标一次性搬移记录
+static int radix_sort_records_indirect(void *base, size_t num, size_t size,
+                                       size_t key_offset, sort_key_type_t key_type)
+{
+    typedef struct {
+        uint64_t key;
+        size_t index;
+    } radix_pair_t;
+
+    radix_pair_t *pairs = malloc(num * sizeof(radix_pair_t));
+    if (!pairs)
+    {
+        return -1;
+    }
+
+    const unsigned char *b = (const unsigned char *)base;
+    for (size_t i = 0; i < num; i++)
+    {
+        pairs[i].key = sort_key_load(b + i * size + key_offset, key_type);
+        pairs[i].index = i;
+    }
+
+    // 键已转换为按无符号整数比较的形式，32 位键的高位为 0，对应的趟数会被跳过
+    int ret = radix_sort_records_lsd(pairs, num, sizeof(radix_pair_t), 0, SORT_KEY_U64);
+    if (ret == 0)
+    {
+        size_t *perm = (size_t *)pairs;
+        for (size_t i = 0; i < num; i++)
+        {
+            perm[i] = pairs[i].index;
+        }
+        ret = sort_apply_permutation(base, num, size, perm);
+    }
+
+    free(pairs);
+    return ret;
+}
+
+int radix_sort_records(void *base, size_t num, size_t size,
+                       size_t key_offset, sort_key_type_t key_type)
+{
+    size_t width = sort_key_width(key_type);
+    if (width == 0 || key_offset > size || size - key_offset < width)
+    {
+        return -1;
+    }
+    if (!base || num < 2)
+    {
+        return 0;
+    }
+
+    // 元素本身就是键时走数组版本
+    if (size == width && key_offset == 0)
+    {
+        switch (key_type)
+        {
+            case SORT_KEY_U32: return radix_sort_u32(base, num);
+            case SORT_KEY_I32: return radix_sort_i32(base, num);
+            case SORT_KEY_F32: return radix_sort_f32(base, num);
+            case SORT_KEY_U64: return radix_sort_u64(base, num);
+            case SORT_KEY_I64: return radix_sort_i64(base, num);
+            case SORT_KEY_F64: return radix_sort_f64(base, num);
+            default: break;
+        }
+    }
+    if (size >= RADIX_INDIRECT_THRESHOLD)
+    {
+        return radix_sort_records_indirect(base, num, size, key_offset, key_type);
+    }
+    return radix_sort_records_lsd(base, num, size, key_offset, key_type);
+}
+
+// sort_by_key 使用比较排序时的键描述
+typedef struct {
+    size_t offset;
+    sort_key_type_t type;
+} sort_key_desc_t;
+
+// 与基数排序使用相同的键顺序（-0.0 排在 +0.0 之前，NaN 按符号位排在两端）
+static int compare_by_key(const void *a, const void *b, void *context)
+{
+    const sort_key_desc_t *desc = (const sort_key_desc_t *)context;
+    uint64_t x = sort_key_load((const unsigned char *)a + desc->offset, desc->type);
+    uint64_t y = sort_key_load((const unsigned char *)b + desc->offset, desc->type);
+    return (x > y) - (x < y);
+}
+
+int sort_by_key(void *base, size_t num, size_t size,
+                size_t key_offset, sort_key_type_t key_type,
+                sort_algorithm_t algorithm)
+{
+    size_t width = sort_key_width(key_type);
+    if (width == 0 || key_offset > size || size - key_offset < width)
+    {
+        return -1;
+    }
+    if (!base || num < 2)
+    {
+        return 0;
+    }
+
+    if (algorithm == SORT_AUTO)
+    {
+        algorithm = g_algorithm_selector ? g_algorithm_selector(num, size)
+                                         : default_key_algorithm_selector(num, size);
+    }
+
+    if (algorithm == SORT_RADIX)
+    {
+        return radix_sort_records(base, num, size, key_offset, key_type);
+    }
+
+    sort_key_desc_t desc = { key_offset, key_type };
+    return sort(base, num, size, compare_by_key, &desc, algorithm);
+}
+
+//-----------------------------
+// 多线程并行排序
+//-----------------------------
+
+// 每个线程至少分到这么多元素，否则线程开销超过收益
+#define PARALLEL_MIN_PER_THREAD 65536
+
+// 并行排序的共享状态：各线程先对自己的分段做快速排序，再逐轮两两归并相邻的有序段
+typedef struct {
+    unsigned char *src;      // 本轮读取的数组
+    unsigned char *dst;      // 本轮写入的数组
+    size_t num;
+    size_t size;
+    compare_func_t compare;
+    void *context;
+    size_t *bounds;          // 有序段边界，共 runs + 1 项
+    size_t runs;             // 当前有序段数量
+    size_t threads;
+} parallel_sort_ctx_t;
+
+typedef struct {
+    parallel_sort_ctx_t *ctx;
+    size_t index;            // 线程序号
+    int result;
+} parallel_sort_task_t;
+
+// 把 total 均分为 parts 份时第 index 份的起点
+static inline size_t parallel_split(size_t total, size_t parts, size_t index)
+{
+    size_t rem = total % parts;
+    return (total / parts) * index + (index < rem ? index : rem);
+}
+
+// 合并 a、b 两个有序段时，输出的前 d 个元素中有多少来自 a（相等时 a 在前，保证稳定）
+static size_t parallel_merge_corank(const parallel_sort_ctx_t *ctx,
+                                    const unsigned char *a, size_t na,
+                                    const unsigned char *b, size_t nb, size_t d)
+{
+    size_t lo = d > nb ? d - nb : 0;
+    size_t hi = d < na ? d : na;
+    size_t size = ctx->size;
+
+    while (lo < hi)
+    {
+        size_t i = lo + (hi - lo) / 2;
+        size_t j = d - i;
+        // a[i] 应排在 b[j-1] 之前，说明前 d 个元素里 a 的数量多于 i
+        if (ctx->compare(a + i * size, b + (j - 1) * size, ctx->context) <= 0)
+        {
+            lo = i + 1;
+        }
+        else
+        {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+// 稳定归并 a、b 到 dst
+static void parallel_merge_range(const parallel_sort_ctx_t *ctx,
+                                 const unsigned char *a, size_t na,
+                                 const unsigned char *b, size_t nb,
+                                 unsigned char *dst)
+{
+    size_t size = ctx->size;
+    const unsigned char *a_end = a + na * size;
+    const unsigned char *b_end = b + nb * size;
+
+    while (a < a_end && b < b_end)
+    {
+        if (ctx->compare(b, a, ctx->context) < 0)
+        {
+            memcpy(dst, b, size);
+            b += size;
+        }
+        else
+        {
+            memcpy(dst, a, size);
+            a += size;
+        }
+        dst += size;
+    }
+    if (a < a_end)
+    {
+        memcpy(dst, a, (size_t)(a_end - a));
+    }
+    if (b < b_end)
+    {
+        memcpy(dst, b, (size_t)(b_end - b));
+    }
+}
+
+// 第一阶段：对第 index 个分段做快速排序
+static void *parallel_sort_chunk_worker(void *arg)
+{
+    parallel_sort_task_t *task = (parallel_sort_task_t *)arg;
+    parallel_sort_ctx_t *ctx = task->ctx;
+    size_t begin = ctx->bounds[task->index];
+    size_t end = ctx->bounds[task->index + 1];
+
+    task->result = quick_sort(ctx->src + begin * ctx->size, end - begin,
+                              ctx->size, ctx->compare, ctx->context);
+    return NULL;
+}
+
+// 归并阶段：每个线程负责输出数组中等长的一段，按 merge path 切分所覆盖的归并
+static void *parallel_merge_worker(void *arg)
+{
+    parallel_sort_task_t *task = (parallel_sort_task_t *)arg;
+    parallel_sort_ctx_t *ctx = task->ctx;
+    size_t size = ctx->size;
+    size_t lo = parallel_split(ctx->num, ctx->threads, task->index);
+    size_t hi = parallel_split(ctx->num, ctx->threads, task->index + 1);
+
+    for (size_t r = 0; r < ctx->runs && lo < hi; r += 2)
+    {
+        size_t begin = ctx->bounds[r];
+        size_t mid = ctx->bounds[r + 1];
+        size_t end = r + 2 <= ctx->runs ? ctx->bounds[r + 2] : mid;
+        if (end <= lo || begin >= hi)
+        {
+            continue;
+        }
+
+        const unsigned char *a = ctx->src + begin * size;
+        const unsigned char *b = ctx->src + mid * size;
+        size_t na = mid - begin;
+        size_t nb = end - mid;
+        size_t d0 = (lo > begin ? lo : begin) - begin;
+        size_t d1 = (hi < end ? hi : end) - begin;
+        size_t i0 = parallel_merge_corank(ctx, a, na, b, nb, d0);
+        size_t i1 = parallel_merge_corank(ctx, a, na, b, nb, d1);
+
+        parallel_merge_range(ctx, a + i0 * size, i1 - i0,
+                             b + (d0 - i0) * size, (d1 - i1) - (d0 - i0),
+                             ctx->dst + (begin + d0) * size);
+    }
+    task->result = 0;
+    return NULL;
+}
+
+// 最后把结果从缓冲区拷回原数组
+static void *parallel_copy_worker(void *arg)
+{
+    parallel_sort_task_t *task = (parallel_sort_task_t *)arg;
+    parallel_sort_ctx_t *ctx = task->ctx;
+    size_t lo = parallel_split(ctx->num, ctx->threads, task->index);
+    size_t hi = parallel_split(ctx->num, ctx->threads, task->index + 1);
+
+    memcpy(ctx->dst + lo * ctx->size, ctx->src + lo * ctx->size, (hi - lo) * ctx->size);
+    task->result = 0;
+    return NULL;
+}
+
+// 用 threads 个线程执行一个阶段，当前线程承担第 0 个任务；线程创建失败时在当前线程补做
+static int parallel_run_phase(parallel_sort_ctx_t *ctx, parallel_sort_task_t *tasks,
+                              pthread_t *tids, bool *started, void *(*worker)(void *))
+{
+    int ret = 0;
+
+    for (size_t t = 0; t < ctx->threads; t++)
+    {
+        tasks[t].ctx = ctx;
+        tasks[t].index = t;
+        tasks[t].result = 0;
+    }
+    for (size_t t = 1; t < ctx->threads; t++)
+    {
+        started[t] = pthread_create(&tids[t], NULL, worker, &tasks[t]) == 0;
+    }
+    worker(&tasks[0]);
+    for (size_t t = 1; t < ctx->threads; t++)
+    {
+        if (started[t])
+        {
+            pthread_join(tids[t], NULL);
+        }
+        else
+        {
+            worker(&tasks[t]);
+        }
+    }
+    for (size_t t = 0; t < ctx->threads; t++)
+    {
+        if (tasks[t].result != 0)
+        {
+            ret = tasks[t].result;
+        }
+    }
+    return ret;
+}
+
+int sort_parallel(void *base, size_t num, size_t size,
+                  compare_func_t compare, void *context,
+                  size_t nthreads)
+{
+    if (!base || !compare || num < 2)
+    {
+        return 0;
+    }
+
+    if (nthreads == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (nthreads > num / PARALLEL_MIN_PER_THREAD)
+    {
+        nthreads = num / PARALLEL_MIN_PER_THREAD;
+    }
+    // 数据量不足以分给两个线程时走单线程路径
+    if (nthreads < 2)
+    {
+        return quick_sort(base, num, size, compare, context);
+    }
+
+    unsigned char *buffer = malloc(num * size);
+    size_t *bounds = malloc((nthreads + 1) * sizeof(size_t));
+    parallel_sort_task_t *tasks = malloc(nthreads * sizeof(parallel_sort_task_t));
+    pthread_t *tids = malloc(nthreads * sizeof(pthread_t));
+    bool *started = malloc(nthreads * sizeof(bool));
+    if (!buffer || !bounds || !tasks || !tids || !started)
+    {
+        free(buffer);
+        free(bounds);
+        free(tasks);
+        free(tids);
+        free(started);
+        return quick_sort(base, num, size, compare, context);
+    }
+
+    parallel_sort_ctx_t ctx = {
+        .src = base,
+        .dst = buffer,
+        .num = num,
+        .size = size,
+        .compare = compare,
+        .context = context,
+        .bounds = bounds,
+        .runs = nthreads,
+        .threads = nthreads,
+    };
+    for (size_t t = 0; t <= nthreads; t++)
+    {
+        bounds[t] = parallel_split(num, nthreads, t);
+    }
+
+    int ret = parallel_run_phase(&ctx, tasks, tids, started, parallel_sort_chunk_worker);
+
+    // 每轮把相邻两段归并为一段，src 和 dst 交替
+    while (ret == 0 && ctx.runs > 1)
+    {
+        parallel_run_phase(&ctx, tasks, tids, started, parallel_merge_worker);
+
+        size_t runs = 0;
+        for (size_t r = 0; r < ctx.runs; r += 2)
+        {
+            bounds[++runs] = r + 2 <= ctx.runs ? bounds[r + 2] : bounds[r + 1];
+        }
+        ctx.runs = runs;
+
+        unsigned char *t = ctx.src;
+        ctx.src = ctx.dst;
+        ctx.dst = t;
+    }
+
+    if (ret == 0 && ctx.src != (unsigned char *)base)
+    {
+        ctx.dst = base;
+        parallel_run_phase(&ctx, tasks, tids, started, parallel_copy_worker);
+    }
+
+    free(buffer);
+    free(bounds);
+    free(tasks);
+    free(tids);
+    free(started);
+    return ret;
+}
+
+//-----------------------------
+// 间接排序
+//-----------------------------
+
+// 置换时临时记录不超过该大小就放在栈上
+#define INDIRECT_STACK_RECORD 1024
+
+// 间接排序的索引项：缓存的键前缀和指向原记录的指针
+typedef struct {
+    uint64_t prefix;
+    const unsigned char *record;
+} indirect_entry_t;
+
+typedef struct {
+    compare_func_t compare;
+    void *context;
+} indirect_ctx_t;
+
+// 先比较键前缀，相同时才访问原记录；完全相等时按原位置排序，所以结果是稳定的
+static int indirect_compare(const void *a, const void *b, void *context)
+{
+    const indirect_entry_t *x = (const indirect_entry_t *)a;
+    const indirect_entry_t *y = (const indirect_entry_t *)b;
+    const indirect_ctx_t *c = (const indirect_ctx_t *)context;
+
+    if (x->prefix != y->prefix)
+    {
+        return x->prefix < y->prefix ? -1 : 1;
+    }
+    int r = c->compare(x->record, y->record, c->context);
+    if (r != 0)
+    {
+        return r;
+    }
+    return (x->record > y->record) - (x->record < y->record);
+}
+
+int sort_apply_permutation(void *base, size_t num, size_t size, size_t *perm)
+{
+    if (!base || !perm || num < 2)
+    {
+        return 0;
+    }
+
+    unsigned char stack_tmp[INDIRECT_STACK_RECORD];
+    unsigned char *tmp = stack_tmp;
+    if (size > sizeof(stack_tmp))
+    {
+        tmp = malloc(size);
+        if (!tmp)
+        {
+            return -1;
+        }
+    }
+
+    // 逐个置换环：先取出环首，沿环把每个元素搬到位，最后放回环首
+    // 每个元素只搬移一次，每个环多一次临时拷贝；已归位的下标改写为自身作为标记
+    unsigned char *b = (unsigned char *)base;
+    for (size_t i = 0; i < num; i++)
+    {
+        if (perm[i] == i)
+        {
+            continue;
+        }
+
+        memcpy(tmp, b + i * size, size);
+        size_t j = i;
+        size_t k = perm[j];
+        while (k != i)
+        {
+            memcpy(b + j * size, b + k * size, size);
+            perm[j] = j;
+            j = k;
+            k = perm[j];
+        }
+        memcpy(b + j * size, tmp, size);
+        perm[j] = j;
+    }
+
+    if (tmp != stack_tmp)
+    {
+        free(tmp);
+    }
+    return 0;
+}
+
+int sort_indirect_prefix(void *base, size_t num, size_t size,
+                         compare_func_t compare, sort_prefix_func_t prefix,
+                         void *context, sort_algorithm_t algorithm)
+{
+    if (!base || !compare || num < 2)
+    {
+        return 0;
+    }
+
+    indirect_entry_t *entries = malloc(num * sizeof(indirect_entry_t));
+    if (!entries)
+    {
+        return -1;
+    }
+
+    const unsigned char *b = (const unsigned char *)base;
+    for (size_t i = 0; i < num; i++)
+    {
+        entries[i].record = b + i * size;
+        entries[i].prefix = prefix ? prefix(entries[i].record, context) : 0;
+    }
+
+    indirect_ctx_t ctx = { compare, context };
+    int ret = sort(entries, num, sizeof(indirect_entry_t), indirect_compare, &ctx, algorithm);
+    if (ret == 0)
+    {
+        // 原地把索引项改写为下标：perm[i] 只覆盖 entries[i] 及之前已读过的部分
+        size_t *perm = (size_t *)entries;
+        for (size_t i = 0; i < num; i++)
+        {
+            perm[i] = (size_t)(entries[i].record - b) / size;
+        }
+        ret = sort_apply_permutation(base, num, size, perm);
+    }
+
+    free(entries);
+    return ret;
+}
+
+int sort_indirect(void *base, size_t num, size_t size,
+                  compare_func_t compare, void *context,
+                  sort_algorithm_t algorithm)
+{
+    return sort_indirect_prefix(base, num, size, compare, NULL, context, algorithm);
+}
+
+uint64_t sort_prefix_bytes(const void *bytes, size_t len)
+{
+    const unsigned char *p = (const unsigned char *)bytes;
+    uint64_t prefix = 0;
+
+    // 按大端拼接，无符号整数的大小关系与 memcmp 一致，不足 8 字节补 0
+    for (size_t i = 0; i < sizeof(uint64_t); i++)
+    {
+        prefix = (prefix << 8) | (i < len ? p[i] : 0);
+    }
+    return prefix;
+}
+
+uint64_t sort_prefix_string(const char *str)
+{
+    const unsigned char *p = (const unsigned char *)str;
+    uint64_t prefix = 0;
+    size_t i = 0;
+
+    // 遇到结尾的 '\0' 后补 0，与 strcmp 的顺序一致
+    for (; i < sizeof(uint64_t) && p[i]; i++)
+    {
+        prefix = (prefix << 8) | p[i];
+    }
+    for (; i < sizeof(uint64_t); i++)
+    {
+        prefix <<= 8;
+    }
+    return prefix;
+}
+
+//-----------------------------
+// 字符串排序: 带缓存键的多关键字快速排序
+//-----------------------------
+
+// 子数组不超过该长度时使用插入排序
+#define STRING_INSERTION_THRESHOLD 16
+// 每个缓存键包含的字符数，键的最低字节记录其中的有效字符数
+#define STRING_KEY_CHARS 7
+// 重新加载键时每趟最多跳过的公共前缀长度
+#define STRING_LCP_SCAN 64
+
+// 排序项：字符串从当前深度开始的缓存键，以及字符串本身
+typedef struct {
+    uint64_t key;
+    const unsigned char *data;
+    size_t len;                 // C 字符串不使用，遇到 '\0' 结束
+} string_entry_t;
+
+// 读取 depth 处开始的最多 7 个字符，高位对齐后拼接有效字符数
+// 有效字符相同时较短的键较小，所以嵌入的 '\0' 和字符串结束可以区分，顺序与 memcmp 加长度一致
+static inline uint64_t string_load_key(const string_entry_t *e, size_t depth, bool cstr)
+{
+    const unsigned char *p = e->data + depth;
+    uint64_t key = 0;
+    size_t n = 0;
+
+    if (cstr)
+    {
+        while (n < STRING_KEY_CHARS && p[n])
+        {
+            key = (key << 8) | p[n++];
+        }
+    }
+    else if (e->len - depth >= sizeof(uint64_t))
+    {
+        memcpy(&key, p, sizeof(key));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        key = __builtin_bswap64(key);
+#endif
+        return (key & ~(uint64_t)0xFF) | STRING_KEY_CHARS;
+    }
+    else
+    {
+        size_t rem = e->len - depth;
+        n = rem < STRING_KEY_CHARS ? rem : STRING_KEY_CHARS;
+        for (size_t i = 0; i < n; i++)
+        {
+            key = (key << 8) | p[i];
+        }
+    }
+
+    key <<= 8 * (STRING_KEY_CHARS - n);
+    return (key << 8) | n;
+}
+
+// 键的有效字符不足 7 个说明字符串已经结束
+static inline bool string_key_ended(uint64_t key)
+{
+    return (key & 0xFF) < STRING_KEY_CHARS;
+}
+
+// 缓存键相同且都未结束时，比较 depth + 7 之后的部分
+static int string_compare_tail(const string_entry_t *a, const string_entry_t *b,
+                               size_t depth, bool cstr)
+{
+    depth += STRING_KEY_CHARS;
+    if (cstr)
+    {
+        return strcmp((const char *)a->data + depth, (const char *)b->data + depth);
+    }
+
+    size_t la = a->len - depth;
+    size_t lb = b->len - depth;
+    int r = memcmp(a->data + depth, b->data + depth, la < lb ? la : lb);
+    if (r != 0)
+    {
+        return r;
+    }
+    return (la > lb) - (la < lb);
+}
+
+// 加载 depth 处的缓存键，同时计算各字符串与第一个字符串从 depth 开始的公共前缀长度
+// 公共前缀达到 7 个字符时所有键都相同，划分没有意义，直接跳过整段公共前缀后重新加载
+// 返回键实际对应的深度
+static size_t string_load_keys(string_entry_t *e, size_t n, size_t depth, bool cstr)
+{
+    for (;;)
+    {
+        const unsigned char *ref = e[0].data + depth;
+        size_t ref_len = cstr ? STRING_LCP_SCAN : e[0].len - depth;
+        size_t lcp = ref_len < STRING_LCP_SCAN ? ref_len : STRING_LCP_SCAN;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            e[i].key = string_load_key(&e[i], depth, cstr);
+
+            // 公共前缀不足 7 个字符后就不再比较，这一趟只是加载键
+            if (lcp >= STRING_KEY_CHARS)
+            {
+                const unsigned char *p = e[i].data + depth;
+                size_t limit = cstr ? lcp : (e[i].len - depth < lcp ? e[i].len - depth : lcp);
+                size_t k = 0;
+                while (k < limit && p[k] == ref[k] && (!cstr || p[k]))
+                {
+                    k++;
+                }
+                lcp = k;
+            }
+        }
+
+        if (lcp < STRING_KEY_CHARS)
+        {
+            return depth;
+        }
+        depth += lcp;
+    }
+}
+
+static inline bool string_entry_less(const string_entry_t *a, const string_entry_t *b,
+                                     size_t depth, bool cstr)
+{
+    if (a->key != b->key)
+    {
+        return a->key < b->key;
+    }
+    return !string_key_ended(a->key) && string_compare_tail(a, b, depth, cstr) < 0;
+}
+
+static void string_insertion_sort(string_entry_t *e, size_t n, size_t depth, bool cstr)
+{
+    for (size_t i = 1; i < n; i++)
+    {
+        string_entry_t t = e[i];
+        size_t j = i;
+        while (j > 0 && string_entry_less(&t, &e[j - 1], depth, cstr))
+        {
+            e[j] = e[j - 1];
+            j--;
+        }
+        e[j] = t;
+    }
+}
+
+static inline uint64_t string_median3(uint64_t a, uint64_t b, uint64_t c)
+{
+    if (a < b)
+    {
+        return b < c ? b : (a < c ? c : a);
+    }
+    return a < c ? a : (b < c ? c : b);
+}
+
+// 三路划分后，小于和大于部分在同一深度继续，等于部分深入 7 个字符
+// 只递归较小的两部分、循环处理最大的一部分，递归深度为 O(log n)
+static void string_mkqs(string_entry_t *e, size_t n, size_t depth, bool cstr)
+{
+    for (;;)
+    {
+        if (n <= STRING_INSERTION_THRESHOLD)
+        {
+            string_insertion_sort(e, n, depth, cstr);
+            return;
+        }
+
+        uint64_t pivot;
+        if (n > 128)
+        {
+            size_t step = n / 8;
+            pivot = string_median3(string_median3(e[0].key, e[step].key, e[2 * step].key),
+                                   string_median3(e[3 * step].key, e[n / 2].key, e[5 * step].key),
+                                   string_median3(e[6 * step].key, e[7 * step].key, e[n - 1].key));
+        }
+        else
+        {
+            pivot = string_median3(e[0].key, e[n / 2].key, e[n - 1].key);
+        }
+
+        size_t lt = 0, i = 0, gt = n;
+        while (i < gt)
+        {
+            uint64_t k = e[i].key;
+            if (k < pivot)
+            {
+                string_entry_t t = e[lt];
+                e[lt++] = e[i];
+                e[i++] = t;
+            }
+            else if (k > pivot)
+            {
+                string_entry_t t = e[--gt];
+                e[gt] = e[i];
+                e[i] = t;
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        // 三部分的起点、长度和深度；等于部分的字符串都已结束时不需要再排序
+        string_entry_t *part[3] = { e, e + lt, e + gt };
+        size_t len[3] = { lt, string_key_ended(pivot) ? 0 : gt - lt, n - gt };
+        size_t largest = len[0] >= len[1] ? (len[0] >= len[2] ? 0 : 2) : (len[1] >= len[2] ? 1 : 2);
+
+        for (size_t p = 0; p < 3; p++)
+        {
+            if (p == largest || len[p] < 2)
+            {
+                continue;
+            }
+            if (p == 1)
+            {
+                size_t d = string_load_keys(part[1], len[1], depth + STRING_KEY_CHARS, cstr);
+                string_mkqs(part[1], len[1], d, cstr);
+            }
+            else
+            {
+                string_mkqs(part[p], len[p], depth, cstr);
+            }
+        }
+
+        e = part[largest];
+        n = len[largest];
+        if (largest == 1)
+        {
+            depth = string_load_keys(e, n, depth + STRING_KEY_CHARS, cstr);
+        }
+    }
+}
+
+int sort_strings(const char **strs, size_t num)
+{
+    if (!strs || num < 2)
+    {
+        return 0;
+    }
+
+    string_entry_t *entries = malloc(num * sizeof(string_entry_t));
+    if (!entries)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < num; i++)
+    {
+        entries[i].data = (const unsigned char *)strs[i];
+        entries[i].len = 0;
+    }
+    string_mkqs(entries, num, string_load_keys(entries, num, 0, true), true);
+    for (size_t i = 0; i < num; i++)
+    {
+        strs[i] = (const char *)entries[i].data;
+    }
+
+    free(entries);
+    return 0;
+}
+
+int sort_byte_strings(sort_bytes_t *strs, size_t num)
+{
+    if (!strs || num < 2)
+    {
+        return 0;
+    }
+
+    string_entry_t *entries = malloc(num * sizeof(string_entry_t));
+    if (!entries)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < num; i++)
+    {
+        entries[i].data = (const unsigned char *)strs[i].data;
+        entries[i].len = strs[i].len;
+    }
+    string_mkqs(entries, num, string_load_keys(entries, num, 0, false), false);
+    for (size_t i = 0; i < num; i++)
+    {
+        strs[i].data = entries[i].data;
+        strs[i].len = entries[i].len;
+    }
+
+    free(entries);
+    return 0;
+}
+
+// 主排序函数 - 根据算法类型选择合适的排序方法
+int sort(void *base, size_t num, size_t size,
+        compare_func_t compare, void *context,
+        sort_algorithm_t algorithm) 
+{
+    if (!base || !compare || num < 2) 
+    {
+        return 0;
+    }
+    
+    // 大记录先排序索引再沿置换环搬移，内存不足时退回直接排序
+    if (algorithm == SORT_AUTO && size >= INDIRECT_SORT_THRESHOLD &&
+        sort_indirect(base, num, size, compare, context, SORT_AUTO) == 0) 
+    {
+        return 0;
+    }
+
+    // 如果是自动选择，调用推荐函数
+    if (algorithm == SORT_AUTO) 
+    {
+        algorithm = recommend_sort_algorithm(num, size);
+        // 选择器也服务于 sort_by_key，可能返回基数排序，这里只有比较函数，改用快速排序
+        if (algorithm == SORT_RADIX)
+        {
+            algorithm = SORT_QUICK;
+        }
     }
     
     // 根据算法类型调用相应的排序函数
@@ -461,6 +2591,11 @@ int sort(void *base, size_t num, size_t size,
             return merge_sort(base, num, size, compare, context);
         case SORT_HEAP:
             return heap_sort(base, num, size, compare, context);
+        case SORT_PARALLEL:
+            return sort_parallel(base, num, size, compare, context, 0);
+        // 只有比较函数时不知道键的类型和位置，显式指定基数排序是调用错误
+        case SORT_RADIX:
+            return -1;
         default:
             return quick_sort(base, num, size, compare, context);
     }
@@ -2,6 +2,7 @@
 #define __SORT_H__
 
 #include <stddef.h>
+#include <stdint.h>
 
 // 回调比较函数类型定义
 // 返回值: <0表示a<b, 0表示a==b, >0表示a>b
@@ -16,16 +17,30 @@ typedef enum {
     SORT_QUICK,        // 快速排序
     SORT_MERGE,        // 归并排序
     SORT_HEAP,         // 堆排序
+    SORT_RADIX,        // 基数排序（需要键类型，只能用于 sort_by_key，传给 sort 返回 -1）
+    SORT_PARALLEL,     // 多线程并行排序（使用全部在线 CPU）
     SORT_COUNT         // 排序算法数量
 } sort_algorithm_t;
 
+// 基数排序支持的键类型
+typedef enum {
+    SORT_KEY_U32 = 0,  // uint32_t
+    SORT_KEY_I32,      // int32_t
+    SORT_KEY_U64,      // uint64_t
+    SORT_KEY_I64,      // int64_t
+    SORT_KEY_F32,      // float，-0.0 排在 +0.0 之前，NaN 按符号位排在两端
+    SORT_KEY_F64,      // double，规则同 float
+    SORT_KEY_COUNT     // 键类型数量
+} sort_key_type_t;
+
 // 主排序函数 - 类似qsort_s，自动选择算法
 // base: 要排序的数组
 // num: 数组中元素个数
 // size: 每个元素的大小（字节数）
 // compare: 比较函数
 // context: 传递给比较函数的上下文
-// algorithm: 指定排序算法，SORT_AUTO为自动选择
+// algorithm: 指定排序算法，SORT_AUTO为自动选择（元素不小于 256 字节时使用间接排序）
+//            不支持 SORT_RADIX（没有键类型），指定时返回 -1；SORT_AUTO 不会选中基数排序
 extern int sort(void *base, size_t num, size_t size,
                 compare_func_t compare, void *context,
                 sort_algorithm_t algorithm);
@@ -46,14 +61,141 @@ extern int insertion_sort(void *base, size_t num, size_t size,
 extern int quick_sort(void *base, size_t num, size_t size,
                      compare_func_t compare, void *context);
 
-// 归并排序
+// 归并排序（powersort，稳定）
+// 识别输入中已有的升序/降序段，部分有序的数据接近线性时间
+// 只分配一次 num / 2 个元素的临时缓冲区，内存不足返回 -1
 extern int merge_sort(void *base, size_t num, size_t size,
                      compare_func_t compare, void *context);
 
+// 归并排序，使用调用方提供的临时缓冲区，不分配内存
+// buffer_size: 缓冲区字节数，至少为 (num / 2) * size，不足时返回 -1
+extern int merge_sort_with_buffer(void *base, size_t num, size_t size,
+                                  compare_func_t compare, void *context,
+                                  void *buffer, size_t buffer_size);
+
 // 堆排序
 extern int heap_sort(void *base, size_t num, size_t size,
                     compare_func_t compare, void *context);
 
+// 多线程并行排序：各线程分段快速排序后并行归并，需要与数组等大的临时缓冲区
+// nthreads: 线程数，0 表示使用全部在线 CPU；每个线程分到的元素过少时会减少线程数，
+//           不足两个线程时直接使用 quick_sort
+// compare 会在多个线程中同时调用，必须是线程安全的
+extern int sort_parallel(void *base, size_t num, size_t size,
+                         compare_func_t compare, void *context,
+                         size_t nthreads);
+
+// LSD 基数排序，稳定，需要与数组等大的临时缓冲区
+// 成功返回 0，内存不足返回 -1
+extern int radix_sort_u32(uint32_t *base, size_t num);
+extern int radix_sort_i32(int32_t *base, size_t num);
+extern int radix_sort_u64(uint64_t *base, size_t num);
+extern int radix_sort_i64(int64_t *base, size_t num);
+extern int radix_sort_f32(float *base, size_t num);
+extern int radix_sort_f64(double *base, size_t num);
+
+// 按记录中的定宽键做基数排序
+// size: 每条记录的大小（字节数）
+// key_offset: 键在记录中的偏移（如 offsetof(struct xxx, key)）
+// key_type: 键的类型
+// 成功返回 0，参数无效或内存不足返回 -1
+extern int radix_sort_records(void *base, size_t num, size_t size,
+                              size_t key_offset, sort_key_type_t key_type);
+
+// 按记录中的定宽键排序，不需要比较函数
+// algorithm 为 SORT_AUTO 时，数据量较大会选择基数排序；其他算法按键类型的顺序比较
+// 成功返回 0，参数无效或内存不足返回 -1
+extern int sort_by_key(void *base, size_t num, size_t size,
+                       size_t key_offset, sort_key_type_t key_type,
+                       sort_algorithm_t algorithm);
+
+// 键前缀提取函数：把记录的键压缩为一个 64 位无符号整数
+// 必须满足 prefix(a) < prefix(b) 时 compare(a, b) < 0，前缀相同时才调用 compare
+typedef uint64_t (*sort_prefix_func_t)(const void *elem, void *context);
+
+// 间接排序：先排序指向记录的索引，再沿置换环原地搬移记录
+// 适合几百字节以上的大记录，记录只搬移 O(n) 次；结果是稳定的
+// 需要 num * 16 字节的临时内存，内存不足返回 -1
+extern int sort_indirect(void *base, size_t num, size_t size,
+                         compare_func_t compare, void *context,
+                         sort_algorithm_t algorithm);
+
+// 间接排序，索引项中缓存 prefix 提取的键前缀，多数比较不需要访问原记录
+// prefix 和 compare 共用 context，prefix 为 NULL 时等同于 sort_indirect
+extern int sort_indirect_prefix(void *base, size_t num, size_t size,
+                                compare_func_t compare, sort_prefix_func_t prefix,
+                                void *context, sort_algorithm_t algorithm);
+
+// 按置换原地重排数组：perm[i] 是应放到位置 i 的元素的原下标
+// 每个元素只搬移一次，perm 会被改写为恒等置换；内存不足返回 -1
+extern int sort_apply_permutation(void *base, size_t num, size_t size, size_t *perm);
+
+// 取字节串的前 8 字节作为键前缀（大端拼接，顺序与 memcmp 一致，不足 8 字节补 0）
+extern uint64_t sort_prefix_bytes(const void *bytes, size_t len);
+
+// 取字符串的前 8 个字符作为键前缀（顺序与 strcmp 一致）
+extern uint64_t sort_prefix_string(const char *str);
+
+// 字节串：不要求以 '\0' 结尾，可以包含 '\0'
+typedef struct {
+    const void *data;
+    size_t len;
+} sort_bytes_t;
+
+// 字符串排序：按 strcmp 的顺序排序 C 字符串指针数组，不稳定
+// 多关键字快速排序，每次比较缓存的 7 个字符，长公共前缀不会被反复比较
+// 需要 num * 24 字节的临时内存，内存不足返回 -1
+extern int sort_strings(const char **strs, size_t num);
+
+// 字节串排序：按 memcmp 的顺序，公共部分相同时较短的在前，不稳定
+extern int sort_byte_strings(sort_bytes_t *strs, size_t num);
+
+// 选择第 nth 小的元素（快速选择，期望 O(n)）
+// 返回后 base[nth] 就是完整排序后该位置的元素，它之前的元素都不大于它，之后的都不小于它
+// nth 越界返回 -1
+extern int select_nth(void *base, size_t num, size_t nth, size_t size,
+                      compare_func_t compare, void *context);
+
+// 部分排序：把最小的 k 个元素按顺序放到数组前 k 个位置，其余元素顺序不定
+// O(n + k log k)，k >= num 时等同于 quick_sort
+extern int partial_sort(void *base, size_t num, size_t k, size_t size,
+                        compare_func_t compare, void *context);
+
+// 流式 top-k：逐个输入元素，只保留排序后排在最前的 k 个（按 compare 最小的 k 个）
+// 需要分数最高的 k 个时，compare 按降序实现即可
+typedef struct {
+    void *data;              // 大顶堆，堆顶是当前保留元素中排在最后的一个
+    size_t size;             // 元素大小
+    size_t k;                // 最多保留的元素个数
+    size_t count;            // 当前保留的元素个数
+    compare_func_t compare;  // 比较函数
+    void *context;           // 比较函数上下文
+} topk_t;
+
+// 创建 top-k 累加器，元素按值拷贝保存，k 为 0 或内存不足返回 NULL
+extern topk_t *topk_create(size_t k, size_t size, compare_func_t compare, void *context);
+
+// 销毁 top-k 累加器
+extern void topk_destroy(topk_t *topk);
+
+// 清空已保留的元素
+extern void topk_clear(topk_t *topk);
+
+// 输入一个元素，被保留返回 1，被丢弃返回 0，O(log k)
+extern int topk_push(topk_t *topk, const void *elem);
+
+// 输入 num 个连续存放的元素，返回被保留的个数
+extern size_t topk_push_batch(topk_t *topk, const void *base, size_t num);
+
+// 当前保留的元素个数
+extern size_t topk_size(const topk_t *topk);
+
+// 当前保留元素中排在最后的一个（新元素必须排在它之前才会被保留），为空返回 NULL
+extern const void *topk_peek(const topk_t *topk);
+
+// 把保留的元素按顺序拷贝到 out（至少能容纳 k 个元素），返回元素个数，不影响累加器
+extern size_t topk_result(const topk_t *topk, void *out);
+
 // 获取排序算法名称
 extern const char *get_sort_algorithm_name(sort_algorithm_t algorithm);
 
@@ -0,0 +1,393 @@
+#include "sort_calibrate.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+// 元素大小分档上限（字节）
+static const size_t calibrate_sizes[SORT_CALIBRATE_SIZE_CLASSES] = { 4, 8, 16, 32, 64 };
+// 元素个数分档上限
+static const size_t calibrate_counts[SORT_CALIBRATE_COUNT_CLASSES] = {
+    8, 16, 32, 64, 128, 256, 1024, 4096, 16384, 65536
+};
+
+// 参与比较的算法及其在校准文件中的名字
+static const struct {
+    sort_algorithm_t algorithm;
+    const char *name;
+} calibrate_candidates[] = {
+    { SORT_INSERTION, "insertion" },
+    { SORT_QUICK,     "quick" },
+    { SORT_MERGE,     "merge" },
+    { SORT_HEAP,      "heap" },
+};
+#define CALIBRATE_CANDIDATE_COUNT (sizeof(calibrate_candidates) / sizeof(calibrate_candidates[0]))
+
+// 插入排序是平方复杂度，只在不超过该个数的档位参与比较
+#define CALIBRATE_INSERTION_MAX 256
+// 每次测量至少累计排序这么多元素，小数组重复多次以减小计时误差
+#define CALIBRATE_MIN_ELEMENTS 16384
+// 校准文件头
+#define CALIBRATE_FILE_MAGIC "cstl-sort-calibration 1"
+
+// 测量使用的输入模式
+typedef enum {
+    CALIBRATE_RANDOM = 0,     // 随机
+    CALIBRATE_SORTED,         // 已有序
+    CALIBRATE_REVERSED,       // 逆序
+    CALIBRATE_NEARLY_SORTED,  // 有序后随机交换 2% 的元素
+    CALIBRATE_FEW_UNIQUE,     // 只有 16 种不同的键
+    CALIBRATE_PATTERN_COUNT
+} calibrate_pattern_t;
+
+static sort_algorithm_t g_calibration_table[SORT_CALIBRATE_SIZE_CLASSES][SORT_CALIBRATE_COUNT_CLASSES];
+static bool g_calibrated = false;
+
+static size_t calibrate_class(const size_t *bounds, size_t count, size_t value)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (value <= bounds[i])
+        {
+            return i;
+        }
+    }
+    return count - 1;
+}
+
+sort_algorithm_t sort_calibrated_algorithm(size_t num, size_t size)
+{
+    if (!g_calibrated)
+    {
+        return SORT_AUTO;
+    }
+    size_t s = calibrate_class(calibrate_sizes, SORT_CALIBRATE_SIZE_CLASSES, size);
+    size_t c = calibrate_class(calibrate_counts, SORT_CALIBRATE_COUNT_CLASSES, num);
+    return g_calibration_table[s][c];
+}
+
+static sort_algorithm_t calibrated_selector(size_t num, size_t size)
+{
+    return sort_calibrated_algorithm(num, size);
+}
+
+static void calibrate_install(void)
+{
+    g_calibrated = true;
+    set_algorithm_selector(calibrated_selector);
+}
+
+void sort_calibration_reset(void)
+{
+    g_calibrated = false;
+    set_algorithm_selector(NULL);
+}
+
+//-----------------------------
+// 微基准测试
+//-----------------------------
+
+// 键存放在元素开头：4 字节元素用 32 位键，更大的元素用 64 位键
+static int calibrate_compare(const void *a, const void *b, void *context)
+{
+    size_t size = *(const size_t *)context;
+
+    if (size < sizeof(uint64_t))
+    {
+        uint32_t x, y;
+        memcpy(&x, a, sizeof(x));
+        memcpy(&y, b, sizeof(y));
+        return (x > y) - (x < y);
+    }
+
+    uint64_t x, y;
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    return (x > y) - (x < y);
+}
+
+// splitmix64，保证每次校准使用相同的数据
+static uint64_t calibrate_random(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static void calibrate_store_key(unsigned char *elem, size_t size, uint64_t key)
+{
+    if (size < sizeof(uint64_t))
+    {
+        uint32_t k = (uint32_t)key;
+        memcpy(elem, &k, sizeof(k));
+    }
+    else
+    {
+        memcpy(elem, &key, sizeof(key));
+    }
+}
+
+static void calibrate_fill(unsigned char *data, size_t num, size_t size,
+                           calibrate_pattern_t pattern, uint64_t *rng)
+{
+    memset(data, 0, num * size);
+
+    for (size_t i = 0; i < num; i++)
+    {
+        uint64_t key;
+        switch (pattern)
+        {
+            case CALIBRATE_RANDOM:
+                key = calibrate_random(rng);
+                break;
+            case CALIBRATE_REVERSED:
+                key = num - i;
+                break;
+            case CALIBRATE_FEW_UNIQUE:
+                key = calibrate_random(rng) % 16;
+                break;
+            case CALIBRATE_SORTED:
+            case CALIBRATE_NEARLY_SORTED:
+            default:
+                key = i;
+                break;
+        }
+        calibrate_store_key(data + i * size, size, key);
+    }
+
+    if (pattern == CALIBRATE_NEARLY_SORTED)
+    {
+        for (size_t n = num / 50 + 1; n > 0; n--)
+        {
+            size_t a = calibrate_random(rng) % num;
+            size_t b = calibrate_random(rng) % num;
+            calibrate_store_key(data + a * size, size, b);
+            calibrate_store_key(data + b * size, size, a);
+        }
+    }
+}
+
+static double calibrate_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// 重复 reps 次排序同一份输入，返回排序本身的总耗时
+static double calibrate_measure(sort_algorithm_t algorithm, const unsigned char *input,
+                                unsigned char *work, size_t num, size_t size, size_t reps)
+{
+    double total = 0;
+
+    for (size_t r = 0; r < reps; r++)
+    {
+        memcpy(work, input, num * size);
+        double start = calibrate_now();
+        sort(work, num, size, calibrate_compare, &size, algorithm);
+        total += calibrate_now() - start;
+    }
+    return total;
+}
+
+int sort_calibrate(void)
+{
+    size_t max_num = calibrate_counts[SORT_CALIBRATE_COUNT_CLASSES - 1];
+    size_t max_size = calibrate_sizes[SORT_CALIBRATE_SIZE_CLASSES - 1];
+    unsigned char *inputs = malloc(CALIBRATE_PATTERN_COUNT * max_num * max_size);
+    unsigned char *work = malloc(max_num * max_size);
+    if (!inputs || !work)
+    {
+        free(inputs);
+        free(work);
+        return -1;
+    }
+
+    uint64_t rng = 0x5EED5EED5EED5EEDull;
+
+    for (size_t s = 0; s < SORT_CALIBRATE_SIZE_CLASSES; s++)
+    {
+        size_t size = calibrate_sizes[s];
+
+        for (size_t c = 0; c < SORT_CALIBRATE_COUNT_CLASSES; c++)
+        {
+            size_t num = calibrate_counts[c];
+            size_t reps = num < CALIBRATE_MIN_ELEMENTS ? CALIBRATE_MIN_ELEMENTS / num : 1;
+            double best_time = 0;
+            sort_algorithm_t best = SORT_QUICK;
+
+            for (int p = 0; p < CALIBRATE_PATTERN_COUNT; p++)
+            {
+                calibrate_fill(inputs + p * max_num * max_size, num, size,
+                               (calibrate_pattern_t)p, &rng);
+            }
+
+            // 各算法在所有输入模式上的总耗时
+            for (size_t a = 0; a < CALIBRATE_CANDIDATE_COUNT; a++)
+            {
+                sort_algorithm_t algorithm = calibrate_candidates[a].algorithm;
+                if (algorithm == SORT_INSERTION && num > CALIBRATE_INSERTION_MAX)
+                {
+                    continue;
+                }
+
+                double time = 0;
+                for (int p = 0; p < CALIBRATE_PATTERN_COUNT; p++)
+                {
+                    time += calibrate_measure(algorithm, inputs + p * max_num * max_size,
+                                              work, num, size, reps);
+                }
+                if (best_time == 0 || time < best_time)
+                {
+                    best_time = time;
+                    best = algorithm;
+                }
+            }
+            g_calibration_table[s][c] = best;
+        }
+    }
+
+    free(inputs);
+    free(work);
+    calibrate_install();
+    return 0;
+}
+
+//-----------------------------
+// 校准表持久化
+//-----------------------------
+
+static const char *calibrate_algorithm_name(sort_algorithm_t algorithm)
+{
+    for (size_t a = 0; a < CALIBRATE_CANDIDATE_COUNT; a++)
+    {
+        if (calibrate_candidates[a].algorithm == algorithm)
+        {
+            return calibrate_candidates[a].name;
+        }
+    }
+    return NULL;
+}
+
+static bool calibrate_algorithm_parse(const char *name, sort_algorithm_t *algorithm)
+{
+    for (size_t a = 0; a < CALIBRATE_CANDIDATE_COUNT; a++)
+    {
+        if (strcmp(calibrate_candidates[a].name, name) == 0)
+        {
+            *algorithm = calibrate_candidates[a].algorithm;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 文件格式：首行为文件头，之后每行为 "元素大小上限 元素个数上限 算法名"，# 开头为注释
+int sort_calibration_save(const char *path)
+{
+    if (!path || !g_calibrated)
+    {
+        return -1;
+    }
+
+    FILE *fp = fopen(path, "w");
+    if (!fp)
+    {
+        return -1;
+    }
+
+    fprintf(fp, "%s\n# size count algorithm\n", CALIBRATE_FILE_MAGIC);
+    for (size_t s = 0; s < SORT_CALIBRATE_SIZE_CLASSES; s++)
+    {
+        for (size_t c = 0; c < SORT_CALIBRATE_COUNT_CLASSES; c++)
+        {
+            fprintf(fp, "%zu %zu %s\n", calibrate_sizes[s], calibrate_counts[c],
+                    calibrate_algorithm_name(g_calibration_table[s][c]));
+        }
+    }
+
+    if (fclose(fp) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int sort_calibration_load(const char *path)
+{
+    if (!path)
+    {
+        return -1;
+    }
+
+    FILE *fp = fopen(path, "r");
+    if (!fp)
+    {
+        return -1;
+    }
+
+    sort_algorithm_t table[SORT_CALIBRATE_SIZE_CLASSES][SORT_CALIBRATE_COUNT_CLASSES];
+    bool filled[SORT_CALIBRATE_SIZE_CLASSES][SORT_CALIBRATE_COUNT_CLASSES] = { { false } };
+    size_t filled_count = 0;
+    char line[128];
+    bool ok = fgets(line, sizeof(line), fp) != NULL &&
+              strncmp(line, CALIBRATE_FILE_MAGIC, strlen(CALIBRATE_FILE_MAGIC)) == 0;
+
+    while (ok && fgets(line, sizeof(line), fp))
+    {
+        size_t size, count;
+        char name[32];
+
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+        if (sscanf(line, "%zu %zu %31s", &size, &count, name) != 3)
+        {
+            ok = false;
+            break;
+        }
+
+        // 档位必须与当前版本完全一致
+        size_t s = calibrate_class(calibrate_sizes, SORT_CALIBRATE_SIZE_CLASSES, size);
+        size_t c = calibrate_class(calibrate_counts, SORT_CALIBRATE_COUNT_CLASSES, count);
+        sort_algorithm_t algorithm;
+        if (calibrate_sizes[s] != size || calibrate_counts[c] != count ||
+            filled[s][c] || !calibrate_algorithm_parse(name, &algorithm))
+        {
+            ok = false;
+            break;
+        }
+        table[s][c] = algorithm;
+        filled[s][c] = true;
+        filled_count++;
+    }
+    fclose(fp);
+
+    if (!ok || filled_count != SORT_CALIBRATE_SIZE_CLASSES * SORT_CALIBRATE_COUNT_CLASSES)
+    {
+        return -1;
+    }
+
+    memcpy(g_calibration_table, table, sizeof(table));
+    calibrate_install();
+    return 0;
+}
+
+int sort_calibrate_cached(const char *path)
+{
+    if (sort_calibration_load(path) == 0)
+    {
+        return 0;
+    }
+    if (sort_calibrate() != 0)
+    {
+        return -1;
+    }
+    // 保存失败不影响本次使用校准结果
+    sort_calibration_save(path);
+    return 0;
+}
@@ -0,0 +1,40 @@
+#ifndef __SORT_CALIBRATE_H__
+#define __SORT_CALIBRATE_H__
+
+#include <stddef.h>
+#include "sort.h"
+
+// SORT_AUTO 算法选择的自动校准
+//
+// 在本机上对插入、快速、归并、堆排序做微基准测试，按元素大小和元素个数分档，
+// 每档在随机、有序、逆序、近似有序、大量重复五种输入上计时，取总时间最短的算法，
+// 生成校准表并通过 set_algorithm_selector 安装。
+// 校准表可以保存到文件，之后的运行直接加载，跳过校准。
+//
+// 校准和加载会修改全局选择器，不要与其他线程中的 sort() 并发调用。
+
+// 元素大小分档（字节数上限，超过最后一档按最后一档处理）
+#define SORT_CALIBRATE_SIZE_CLASSES 5
+// 元素个数分档（个数上限，超过最后一档按最后一档处理）
+#define SORT_CALIBRATE_COUNT_CLASSES 10
+
+// 运行校准并安装校准后的选择器，成功返回 0，内存不足返回 -1
+// 耗时一到两秒，最大只测到 65536 个元素
+extern int sort_calibrate(void);
+
+// 把当前校准表保存到文件，尚未校准返回 -1
+extern int sort_calibration_save(const char *path);
+
+// 从文件加载校准表并安装选择器，文件不存在或格式不符返回 -1
+extern int sort_calibration_load(const char *path);
+
+// 优先从 path 加载；加载失败时运行校准并保存到 path
+extern int sort_calibrate_cached(const char *path);
+
+// 查询校准表，尚未校准时返回 SORT_AUTO
+extern sort_algorithm_t sort_calibrated_algorithm(size_t num, size_t size);
+
+// 丢弃校准结果，恢复默认选择器
+extern void sort_calibration_reset(void);
+
+#endif /* __SORT_CALIBRATE_H__ */
@@ -0,0 +1,311 @@
+#ifndef __SORT_DEFINE_H__
+#define __SORT_DEFINE_H__
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * 类型特化的排序生成宏（纯头文件）
+ *
+ * sort() 通过比较函数指针和按字节大小拷贝来处理任意类型，每次比较都是一次间接调用，
+ * 编译器无法内联和向量化。SORT_DEFINE 为具体类型生成一组单态的排序函数，
+ * 比较表达式直接内联在循环中，元素按值赋值而不是 memcpy。
+ *
+ * 用法：
+ *   SORT_DEFINE(name, type, less_expr)
+ *
+ *   name      生成函数的前缀
+ *   type      元素类型
+ *   less_expr 以两个元素 a、b（类型为 type）表示 a < b 的表达式，必须是严格弱序
+ *
+ * 生成的函数（均为 static inline）：
+ *   void name_sort(type *base, size_t num);            // pdqsort，不稳定，O(n log n)
+ *   int  name_merge_sort(type *base, size_t num);      // 归并排序，稳定，成功返回 0，内存不足返回 -1
+ *   void name_heap_sort(type *base, size_t num);       // 堆排序，不稳定，不分配内存
+ *   void name_insertion_sort(type *base, size_t num);  // 插入排序，稳定，适合很短的数组
+ *
+ * 示例：
+ *   SORT_DEFINE(i64, int64_t, a < b)
+ *   SORT_DEFINE(dbl_desc, double, a > b)
+ *   SORT_DEFINE(record, struct record, a.key < b.key || (a.key == b.key && a.id < b.id))
+ *
+ *   i64_sort(array, count);
+ */
+
+// 小于该长度的区间使用插入排序
+#define SORT_DEFINE_INSERTION_THRESHOLD 24
+// 大于该长度的区间使用 ninther 选主元
+#define SORT_DEFINE_NINTHER_THRESHOLD 128
+// 部分插入排序最多移动的元素个数
+#define SORT_DEFINE_PARTIAL_LIMIT 8
+
+#define SORT_DEFINE(name, type, less_expr)                                              \
+                                                                                        \
+static inline bool name##_less(type a, type b)                                          \
+{                                                                                       \
+    return (less_expr);                                                                 \
+}                                                                                       \
+                                                                                        \
+static inline void name##_swap(type *x, type *y)                                        \
+{                                                                                       \
+    type t = *x;                                                                        \
+    *x = *y;                                                                            \
+    *y = t;                                                                             \
+}                                                                                       \
+                                                                                        \
+/* 插入排序 [begin, end) */                                                             \
+static inline void name##_insertion_sort_range(type *begin, type *end)                  \
+{                                                                                       \
+    if (begin == end) return;                                                           \
+    for (type *cur = begin + 1; cur != end; cur++) {                                    \
+        if (name##_less(*cur, cur[-1])) {                                               \
+            type tmp = *cur;                                                            \
+            type *sift = cur;                                                           \
+            do {                                                                        \
+                *sift = sift[-1];                                                       \
+                sift--;                                                                 \
+            } while (sift != begin && name##_less(tmp, sift[-1]));                      \
+            *sift = tmp;                                                                \
+        }                                                                               \
+    }                                                                                   \
+}                                                                                       \
+                                                                                        \
+/* 无边界检查的插入排序，要求 begin[-1] 不大于区间内任何元素 */                          \
+static inline void name##_unguarded_insertion_sort(type *begin, type *end)              \
+{                                                                                       \
+    if (begin == end) return;                                                           \
+    for (type *cur = begin + 1; cur != end; cur++) {                                    \
+        if (name##_less(*cur, cur[-1])) {                                               \
+            type tmp = *cur;                                                            \
+            type *sift = cur;                                                           \
+            do {                                                                        \
+                *sift = sift[-1];                                                       \
+                sift--;                                                                 \
+            } while (name##_less(tmp, sift[-1]));                                       \
+            *sift = tmp;                                                                \
+        }                                                                               \
+    }                                                                                   \
+}                                                                                       \
+                                                                                        \
+/* 移动次数超过上限时放弃，返回 false */                                                 \
+static inline bool name##_partial_insertion_sort(type *begin, type *end)                \
+{                                                                                       \
+    size_t limit = 0;                                                                   \
+    if (begin == end) return true;                                                      \
+    for (type *cur = begin + 1; cur != end; cur++) {                                    \
+        if (name##_less(*cur, cur[-1])) {                                               \
+            type tmp = *cur;                                                            \
+            type *sift = cur;                                                           \
+            do {                                                                        \
+                *sift = sift[-1];                                                       \
+                sift--;                                                                 \
+            } while (sift != begin && name##_less(tmp, sift[-1]));                      \
+            *sift = tmp;                                                                \
+            limit += (size_t)(cur - sift);                                              \
+        }                                                                               \
+        if (limit > SORT_DEFINE_PARTIAL_LIMIT) return false;                            \
+    }                                                                                   \
+    return true;                                                                        \
+}                                                                                       \
+                                                                                        \
+static inline void name##_sort3(type *x, type *y, type *z)                              \
+{                                                                                       \
+    if (name##_less(*y, *x)) name##_swap(x, y);                                         \
+    if (name##_less(*z, *y)) name##_swap(y, z);                                         \
+    if (name##_less(*y, *x)) name##_swap(x, y);                                         \
+}                                                                                       \
+                                                                                        \
+/* 堆排序：空穴下沉，每层只做一次赋值 */                                                 \
+static inline void name##_sift_down(type *base, size_t num, size_t i)                   \
+{                                                                                       \
+    type value = base[i];                                                               \
+    for (;;) {                                                                          \
+        size_t child = 2 * i + 1;                                                       \
+        if (child >= num) break;                                                        \
+        if (child + 1 < num && name##_less(base[child], base[child + 1])) child++;      \
+        if (!name##_less(value, base[child])) break;                                    \
+        base[i] = base[child];                                                          \
+        i = child;                                                                      \
+    }                                                                                   \
+    base[i] = value;                                                                    \
+}                                                                                       \
+                                                                                        \
+static inline void name##_heap_sort(type *base, size_t num)                             \
+{                                                                                       \
+    if (!base || num < 2) return;                                                       \
+    for (size_t i = num / 2; i > 0; i--) {                                              \
+        name##_sift_down(base, num, i - 1);                                             \
+    }                                                                                   \
+    for (size_t i = num - 1; i > 0; i--) {                                              \
+        name##_swap(&base[0], &base[i]);                                                \
+        name##_sift_down(base, i, 0);                                                   \
+    }                                                                                   \
+}                                                                                       \
+                                                                                        \
+/* 左边 < 主元，右边 >= 主元，主元为 *begin */                                           \
+static inline type *name##_partition_right(type *begin, type *end, bool *already)       \
+{                                                                                       \
+    type pivot = *begin;                                                                \
+    type *first = begin;                                                                \
+    type *last = end;                                                                   \
+    while (name##_less(*++first, pivot));                                               \
+    if (first - 1 == begin) {                                                           \
+        while (first < last && !name##_less(*--last, pivot));                           \
+    } else {                                                                            \
+        while (!name##_less(*--last, pivot));                                           \
+    }                                                                                   \
+    *already = first >= last;                                                           \
+    while (first < last) {                                                              \
+        name##_swap(first, last);                                                       \
+        while (name##_less(*++first, pivot));                                           \
+        while (!name##_less(*--last, pivot));                                           \
+    }                                                                                   \
+    type *pivot_pos = first - 1;                                                        \
+    *begin = *pivot_pos;                                                                \
+    *pivot_pos = pivot;                                                                 \
+    return pivot_pos;                                                                   \
+}                                                                                       \
+                                                                                        \
+/* 左边 <= 主元，右边 > 主元，用于把与主元相等的重复键一次归位 */                        \
+static inline type *name##_partition_left(type *begin, type *end)                       \
+{                                                                                       \
+    type pivot = *begin;                                                                \
+    type *first = begin;                                                                \
+    type *last = end;                                                                   \
+    while (name##_less(pivot, *--last));                                                \
+    if (last + 1 == end) {                                                              \
+        while (first < last && !name##_less(pivot, *++first));                          \
+    } else {                                                                            \
+        while (!name##_less(pivot, *++first));                                          \
+    }                                                                                   \
+    while (first < last) {                                                              \
+        name##_swap(first, last);                                                       \
+        while (name##_less(pivot, *--last));                                            \
+        while (!name##_less(pivot, *++first));                                          \
+    }                                                                                   \
+    *begin = *last;                                                                     \
+    *last = pivot;                                                                      \
+    return last;                                                                        \
+}                                                                                       \
+                                                                                        \
+static inline void name##_break_patterns(type *begin, type *end, size_t len)            \
+{                                                                                       \
+    size_t q = len / 4;                                                                 \
+    name##_swap(begin, begin + q);                                                      \
+    name##_swap(end - 1, end - q);                                                      \
+    if (len > SORT_DEFINE_NINTHER_THRESHOLD) {                                          \
+        name##_swap(begin + 1, begin + (q + 1));                                        \
+        name##_swap(begin + 2, begin + (q + 2));                                        \
+        name##_swap(end - 2, end - (q + 1));                                            \
+        name##_swap(end - 3, end - (q + 2));                                            \
+    }                                                                                   \
+}                                                                                       \
+                                                                                        \
+/* pdqsort 主循环，算法同 sort.c 中的 quick_sort */                                      \
+static void name##_pdq_loop(type *begin, type *end, int bad_allowed, bool leftmost)     \
+{                                                                                       \
+    for (;;) {                                                                          \
+        size_t len = (size_t)(end - begin);                                             \
+        if (len < SORT_DEFINE_INSERTION_THRESHOLD) {                                    \
+            if (leftmost) name##_insertion_sort_range(begin, end);                      \
+            else name##_unguarded_insertion_sort(begin, end);                           \
+            return;                                                                     \
+        }                                                                               \
+                                                                                        \
+        size_t half = len / 2;                                                          \
+        if (len > SORT_DEFINE_NINTHER_THRESHOLD) {                                      \
+            name##_sort3(begin, begin + half, end - 1);                                 \
+            name##_sort3(begin + 1, begin + (half - 1), end - 2);                       \
+            name##_sort3(begin + 2, begin + (half + 1), end - 3);                       \
+            name##_sort3(begin + (half - 1), begin + half, begin + (half + 1));         \
+            name##_swap(begin, begin + half);                                           \
+        } else {                                                                        \
+            name##_sort3(begin + half, begin, end - 1);                                 \
+        }                                                                               \
+                                                                                        \
+        if (!leftmost && !name##_less(begin[-1], *begin)) {                             \
+            begin = name##_partition_left(begin, end) + 1;                              \
+            continue;                                                                   \
+        }                                                                               \
+                                                                                        \
+        bool already;                                                                   \
+        type *pivot_pos = name##_partition_right(begin, end, &already);                 \
+        size_t left_len = (size_t)(pivot_pos - begin);                                  \
+        size_t right_len = (size_t)(end - (pivot_pos + 1));                             \
+                                                                                        \
+        if (left_len < len / 8 || right_len < len / 8) {                                \
+            if (--bad_allowed == 0) {                                                   \
+                name##_heap_sort(begin, len);                                           \
+                return;                                                                 \
+            }                                                                           \
+            if (left_len >= SORT_DEFINE_INSERTION_THRESHOLD)                            \
+                name##_break_patterns(begin, pivot_pos, left_len);                      \
+            if (right_len >= SORT_DEFINE_INSERTION_THRESHOLD)                           \
+                name##_break_patterns(pivot_pos + 1, end, right_len);                   \
+        } else if (already &&                                                           \
+                   name##_partial_insertion_sort(begin, pivot_pos) &&                   \
+                   name##_partial_insertion_sort(pivot_pos + 1, end)) {                 \
+            return;                                                                     \
+        }                                                                               \
+                                                                                        \
+        if (left_len < right_len) {                                                     \
+            name##_pdq_loop(begin, pivot_pos, bad_allowed, leftmost);                   \
+            begin = pivot_pos + 1;                                                      \
+            leftmost = false;                                                           \
+        } else {                                                                        \
+            name##_pdq_loop(pivot_pos + 1, end, bad_allowed, false);                    \
+            end = pivot_pos;                                                            \
+        }                                                                               \
+    }                                                                                   \
+}                                                                                       \
+                                                                                        \
+static inline void name##_sort(type *base, size_t num)                                  \
+{                                                                                       \
+    if (!base || num < 2) return;                                                       \
+    int bad_allowed = 0;                                                                \
+    for (size_t n = num; n > 1; n >>= 1) bad_allowed++;                                 \
+    name##_pdq_loop(base, base + num, bad_allowed, true);                               \
+}                                                                                       \
+                                                                                        \
+static inline void name##_insertion_sort(type *base, size_t num)                        \
+{                                                                                       \
+    if (!base || num < 2) return;                                                       \
+    name##_insertion_sort_range(base, base + num);                                      \
+}                                                                                       \
+                                                                                        \
+/* 归并排序：buf 至少能容纳 num / 2 个元素，只把左半部分拷出再合并 */                    \
+static void name##_merge_rec(type *base, size_t num, type *buf)                         \
+{                                                                                       \
+    if (num <= SORT_DEFINE_INSERTION_THRESHOLD) {                                       \
+        name##_insertion_sort_range(base, base + num);                                  \
+        return;                                                                         \
+    }                                                                                   \
+    size_t mid = num / 2;                                                               \
+    name##_merge_rec(base, mid, buf);                                                   \
+    name##_merge_rec(base + mid, num - mid, buf);                                       \
+    /* 两半已经整体有序，无需合并 */                                                     \
+    if (!name##_less(base[mid], base[mid - 1])) return;                                 \
+                                                                                        \
+    memcpy(buf, base, mid * sizeof(type));                                              \
+    size_t i = 0, j = mid, k = 0;                                                       \
+    while (i < mid && j < num) {                                                        \
+        /* 相等时取左边元素，保证稳定 */                                                 \
+        if (name##_less(base[j], buf[i])) base[k++] = base[j++];                        \
+        else base[k++] = buf[i++];                                                      \
+    }                                                                                   \
+    while (i < mid) base[k++] = buf[i++];                                               \
+}                                                                                       \
+                                                                                        \
+static inline int name##_merge_sort(type *base, size_t num)                             \
+{                                                                                       \
+    if (!base || num < 2) return 0;                                                     \
+    type *buf = (type *)malloc((num / 2 + 1) * sizeof(type));                           \
+    if (!buf) return -1;                                                                \
+    name##_merge_rec(base, num, buf);                                                   \
+    free(buf);                                                                          \
+    return 0;                                                                           \
+}
+
+#endif /* __SORT_DEFINE_H__ */
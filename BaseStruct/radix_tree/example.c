@@ -274,10 +274,10 @@ static void test_stress()
     printf("[stress] insert %d: %.3fs, search %d: %.3fs, delete %d: %.3fs, left=%zu\n",
            N, t_insert, Q, t_search, Q, t_delete, left);
 
-    // 清理
+    // 清理（先销毁树，叶子还在树中时不能释放）
+    radix_destroy(&t);
     for (int i = 0; i < N; ++i) { if (items[i]) { free(items[i]->key); free(items[i]); } }
     free(items);
-    radix_destroy(&t);
 }
 
 // ============================================================================
@@ -449,6 +449,13 @@ int radix_erase(radix_root_t *tree, struct radix_leaf *leaf)
 static void destroy_recursive(radix_root_t *tree, struct radix_node *n)
 {
 	if (!n) return;
+	// 整数键模式的子节点挂在槽位数组中，叶子层（shift 为 0）的槽位是用户条目
+	if (n->is_fixed_mode && n->shift > 0) {
+		for (unsigned long i = 0; i < RADIX_TREE_MAP_SIZE; i++) {
+			if (radix_tree_is_internal_node(n->slots[i]))
+				destroy_recursive(tree, entry_to_node(n->slots[i]));
+		}
+	}
 	for (struct radix_node *ch = n->first_child; ch; ) {
 		struct radix_node *next = ch->next_sibling;
 		destroy_recursive(tree, ch);
@@ -471,6 +478,7 @@ void radix_destroy(radix_root_t *tree)
 	if (!tree || !tree->root) return;
 	destroy_recursive(tree, tree->root);
 	tree->root = NULL;
+	tree->height = 0;
 }
 
 // 找到以 n 为根的最小叶子（字典序）
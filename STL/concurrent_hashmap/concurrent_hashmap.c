@@ -0,0 +1,714 @@
+#include "concurrent_hashmap.h"
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#define CONCURRENT_HASHMAP_DEFAULT_CAPACITY 16
+#define CONCURRENT_HASHMAP_DEFAULT_LOAD_FACTOR 0.75f
+#define CONCURRENT_HASHMAP_RESIZE_FACTOR 2
+#define CONCURRENT_HASHMAP_MIN_CAPACITY 8
+#define CONCURRENT_HASHMAP_MAX_SHARDS 4096
+#define CONCURRENT_HASHMAP_SHARDS_PER_CPU 4
+#define CONCURRENT_HASHMAP_READ_RETRIES 8        // 无锁读取失败多少次后退化为持锁读取
+#define CONCURRENT_HASHMAP_MAX_DEPTH 128         // 红黑树高度上限，超过说明读到了正在旋转的树
+#define CONCURRENT_HASHMAP_RECLAIM_THRESHOLD 64  // 分片待释放对象达到该数量时尝试回收
+
+/*
+ * 并发约定
+ *
+ * 写者持有分片锁，修改前后各递增一次 seq；读者不加锁，读取前后比较 seq，
+ * 相同且为偶数说明期间没有写入。红黑树代码用宽松原子写修改子节点指针和根指针，
+ * 新节点用释放语义接入树中；读者用获取语义的原子加载读取这些指针，读到的要么是旧值
+ * 要么是新值，并且经由新指针看到的节点内容已经写好。
+ *
+ * 读者可能在写者修改期间访问到已摘除的节点，所以被摘除的对象不能立即释放：
+ * 读者进入临界区时登记当前全局纪元，所有活跃读者都看到当前纪元后全局纪元才能前进，
+ * 在纪元 e 摘除的对象等全局纪元到达 e + 2 时释放。
+ */
+
+//-----------------------------
+// 线程读者槽位（进程内所有映射共用同一套线程编号）
+//-----------------------------
+
+static unsigned char g_thread_slots[CONCURRENT_HASHMAP_MAX_THREADS];
+static pthread_once_t g_thread_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_thread_key;
+static __thread int tls_thread_slot = -1;   // -1 未分配，-2 槽位已用尽
+
+// 线程退出时归还槽位
+static void thread_slot_release(void *arg) {
+    size_t slot = (size_t)(uintptr_t)arg - 1;
+    __atomic_store_n(&g_thread_slots[slot], 0, __ATOMIC_RELEASE);
+}
+
+static void thread_slot_key_init(void) {
+    pthread_key_create(&g_thread_key, thread_slot_release);
+}
+
+// 获取当前线程的读者槽位，槽位用尽返回 -1
+static int thread_slot(void) {
+    if (tls_thread_slot >= 0) {
+        return tls_thread_slot;
+    }
+    if (tls_thread_slot == -2) {
+        return -1;
+    }
+
+    pthread_once(&g_thread_once, thread_slot_key_init);
+    for (int i = 0; i < CONCURRENT_HASHMAP_MAX_THREADS; i++) {
+        unsigned char expected = 0;
+        if (__atomic_compare_exchange_n(&g_thread_slots[i], &expected, 1, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            pthread_setspecific(g_thread_key, (void *)(uintptr_t)(i + 1));
+            tls_thread_slot = i;
+            return i;
+        }
+    }
+
+    tls_thread_slot = -2;
+    return -1;
+}
+
+// 自旋等待提示
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+//-----------------------------
+// 纪元回收
+//-----------------------------
+
+// 进入读临界区，返回读者槽位，-1 表示没有槽位只能持锁读取
+static int reader_enter(const concurrent_hashmap_t *map) {
+    int slot = thread_slot();
+    if (slot < 0) {
+        return -1;
+    }
+
+    unsigned long epoch = __atomic_load_n(&map->epoch, __ATOMIC_ACQUIRE);
+    // 登记必须先于之后对共享数据的读取，使用全序存储
+    __atomic_store_n(&map->readers[slot].state, (epoch << 1) | 1, __ATOMIC_SEQ_CST);
+    return slot;
+}
+
+// 离开读临界区
+static void reader_exit(const concurrent_hashmap_t *map, int slot) {
+    __atomic_store_n(&map->readers[slot].state, 0, __ATOMIC_RELEASE);
+}
+
+// 所有活跃读者都已看到当前纪元时推进全局纪元
+static unsigned long try_advance_epoch(concurrent_hashmap_t *map) {
+    unsigned long epoch = __atomic_load_n(&map->epoch, __ATOMIC_SEQ_CST);
+
+    for (int i = 0; i < CONCURRENT_HASHMAP_MAX_THREADS; i++) {
+        unsigned long state = __atomic_load_n(&map->readers[i].state, __ATOMIC_SEQ_CST);
+        if ((state & 1) && (state >> 1) != epoch) {
+            return epoch;
+        }
+    }
+
+    __atomic_compare_exchange_n(&map->epoch, &epoch, epoch + 1, false,
+                                __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return __atomic_load_n(&map->epoch, __ATOMIC_SEQ_CST);
+}
+
+// 释放分片中已经安全的待释放对象（调用者持有分片锁）
+static void shard_reclaim(concurrent_hashmap_t *map, concurrent_hashmap_shard_t *shard) {
+    unsigned long epoch = try_advance_epoch(map);
+    size_t kept = 0;
+
+    for (size_t i = 0; i < shard->retired_count; i++) {
+        concurrent_hashmap_retired_t *r = &shard->retired[i];
+        if (r->epoch + 2 <= epoch) {
+            r->release(r->ptr, map);
+        } else {
+            shard->retired[kept++] = *r;
+        }
+    }
+    shard->retired_count = kept;
+}
+
+// 登记待释放对象（调用者持有分片锁）
+// 列表扩容失败时先尝试回收，仍然没有空间就等待读者离开后直接释放
+static void shard_retire(concurrent_hashmap_t *map, concurrent_hashmap_shard_t *shard,
+                         void *ptr, void (*release)(void *ptr, concurrent_hashmap_t *map)) {
+    if (shard->retired_count == shard->retired_capacity) {
+        size_t new_capacity = shard->retired_capacity ? shard->retired_capacity * 2
+                                                      : CONCURRENT_HASHMAP_RECLAIM_THRESHOLD;
+        concurrent_hashmap_retired_t *list = (concurrent_hashmap_retired_t *)realloc(
+            shard->retired, new_capacity * sizeof(concurrent_hashmap_retired_t));
+        if (list) {
+            shard->retired = list;
+            shard->retired_capacity = new_capacity;
+        } else {
+            unsigned long target = __atomic_load_n(&map->epoch, __ATOMIC_SEQ_CST) + 2;
+            while (try_advance_epoch(map) < target) {
+                cpu_relax();
+            }
+            shard_reclaim(map, shard);
+            if (shard->retired_count == shard->retired_capacity) {
+                release(ptr, map);
+                return;
+            }
+        }
+    }
+
+    concurrent_hashmap_retired_t *r = &shard->retired[shard->retired_count++];
+    r->ptr = ptr;
+    r->release = release;
+    r->epoch = __atomic_load_n(&map->epoch, __ATOMIC_SEQ_CST);
+
+    if (shard->retired_count >= CONCURRENT_HASHMAP_RECLAIM_THRESHOLD &&
+        shard->retired_count % CONCURRENT_HASHMAP_RECLAIM_THRESHOLD == 0) {
+        shard_reclaim(map, shard);
+    }
+}
+
+//-----------------------------
+// 顺序计数
+//-----------------------------
+
+// 写者开始修改（调用者持有分片锁）
+static inline void shard_write_begin(concurrent_hashmap_shard_t *shard) {
+    __atomic_store_n(&shard->seq, shard->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+// 写者结束修改
+static inline void shard_write_end(concurrent_hashmap_shard_t *shard) {
+    __atomic_store_n(&shard->seq, shard->seq + 1, __ATOMIC_RELEASE);
+}
+
+// 读者开始读取
+static inline unsigned long shard_read_begin(const concurrent_hashmap_shard_t *shard) {
+    return __atomic_load_n(&shard->seq, __ATOMIC_ACQUIRE);
+}
+
+// 读者结束读取，返回 true 表示期间有写入需要重试
+static inline bool shard_read_retry(const concurrent_hashmap_shard_t *shard, unsigned long seq) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&shard->seq, __ATOMIC_RELAXED) != seq;
+}
+
+//-----------------------------
+// 节点与桶数组
+//-----------------------------
+
+// 对用户哈希值做一次混合，高位用于选分片，低位用于选桶
+static inline unsigned int hash_mix(unsigned int h) {
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
+// 哈希值所在的分片
+static inline concurrent_hashmap_shard_t *shard_for(const concurrent_hashmap_t *map, unsigned int hash) {
+    return &map->shards[(uint64_t)hash >> map->shard_shift];
+}
+
+// 比较查找键与节点，先比较哈希值再比较键内容
+static inline int entry_compare(const concurrent_hashmap_t *map, unsigned int hash,
+                                const void *key, size_t key_size,
+                                const hashmap_entry_t *entry) {
+    if (hash != entry->hash) {
+        return hash < entry->hash ? -1 : 1;
+    }
+    return map->key_compare_fn(key, key_size, entry->key, entry->key_size);
+}
+
+// 红黑树节点比较函数（写者插入时使用）
+static int rb_node_compare(const struct rb_node *a, const struct rb_node *b, void *arg) {
+    const concurrent_hashmap_t *map = (const concurrent_hashmap_t *)arg;
+    const hashmap_entry_t *entry_a = rb_entry(a, hashmap_entry_t, rb_node);
+    const hashmap_entry_t *entry_b = rb_entry(b, hashmap_entry_t, rb_node);
+    return entry_compare(map, entry_a->hash, entry_a->key, entry_a->key_size, entry_b);
+}
+
+// 释放节点、键和值
+static void entry_release(void *ptr, concurrent_hashmap_t *map) {
+    hashmap_entry_t *entry = (hashmap_entry_t *)ptr;
+    free(entry->key);
+    free(entry->value);
+    free(entry);
+}
+
+// 释放被替换的节点和旧值（键已转交给新节点）
+static void entry_release_value(void *ptr, concurrent_hashmap_t *map) {
+    hashmap_entry_t *entry = (hashmap_entry_t *)ptr;
+    free(entry->value);
+    free(entry);
+}
+
+// 只释放桶数组（节点已迁移）
+static void table_release(void *ptr, concurrent_hashmap_t *map) {
+    free(ptr);
+}
+
+// 释放桶数组及其中所有节点
+static void table_release_all(void *ptr, concurrent_hashmap_t *map) {
+    concurrent_hashmap_table_t *table = (concurrent_hashmap_table_t *)ptr;
+    for (size_t i = 0; i < table->capacity; i++) {
+        hashmap_entry_t *pos, *n;
+        rbtree_postorder_for_each_entry_safe(pos, n, &table->buckets[i].root, rb_node) {
+            entry_release(pos, map);
+        }
+    }
+    free(table);
+}
+
+// 分配桶数组，桶在第一次插入前才初始化
+static concurrent_hashmap_table_t *table_alloc(size_t capacity) {
+    concurrent_hashmap_table_t *table = (concurrent_hashmap_table_t *)calloc(
+        1, sizeof(concurrent_hashmap_table_t) + capacity * sizeof(rb_root_t));
+    if (table) {
+        table->capacity = capacity;
+    }
+    return table;
+}
+
+// 插入前初始化桶
+static inline rb_root_t *bucket_prepare(concurrent_hashmap_t *map, rb_root_t *bucket) {
+    if (!bucket->compare) {
+        rb_init(bucket, rb_node_compare, map, NULL, NULL);
+    }
+    return bucket;
+}
+
+// 无锁查找：ok 为 false 表示树深度异常（读到了正在修改的树），需要重试
+static hashmap_entry_t *table_lookup(const concurrent_hashmap_t *map,
+                                     const concurrent_hashmap_table_t *table,
+                                     const void *key, size_t key_size,
+                                     unsigned int hash, bool *ok) {
+    const rb_root_t *bucket = &table->buckets[hash % table->capacity];
+    struct rb_node *node = __atomic_load_n(&bucket->root.rb_node, __ATOMIC_ACQUIRE);
+
+    *ok = true;
+    for (int depth = 0; node; depth++) {
+        if (depth > CONCURRENT_HASHMAP_MAX_DEPTH) {
+            *ok = false;
+            return NULL;
+        }
+
+        hashmap_entry_t *entry = rb_entry(node, hashmap_entry_t, rb_node);
+        int result = entry_compare(map, hash, key, key_size, entry);
+        if (result < 0) {
+            node = __atomic_load_n(&node->rb_left, __ATOMIC_ACQUIRE);
+        } else if (result > 0) {
+            node = __atomic_load_n(&node->rb_right, __ATOMIC_ACQUIRE);
+        } else {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+// 持锁查找
+static hashmap_entry_t *shard_find_locked(concurrent_hashmap_shard_t *shard,
+                                          const void *key, size_t key_size,
+                                          unsigned int hash, rb_root_t **bucket_out) {
+    rb_root_t *bucket = &shard->table->buckets[hash % shard->table->capacity];
+    hashmap_entry_t temp = {
+        .hash = hash,
+        .key = (void *)key,
+        .key_size = key_size
+    };
+
+    if (bucket_out) {
+        *bucket_out = bucket;
+    }
+
+    // 未初始化的桶一定为空
+    if (!bucket->compare) {
+        return NULL;
+    }
+
+    struct rb_node *node = rb_search(bucket, &temp.rb_node);
+    return node ? rb_entry(node, hashmap_entry_t, rb_node) : NULL;
+}
+
+// 分片重新哈希（调用者持有分片锁并处于写入区间内）
+static hashmap_status_t shard_rehash(concurrent_hashmap_t *map, concurrent_hashmap_shard_t *shard,
+                                     size_t new_capacity) {
+    concurrent_hashmap_table_t *old_table = shard->table;
+    concurrent_hashmap_table_t *new_table = table_alloc(new_capacity);
+    if (!new_table) {
+        return HASHMAP_NOMEM;
+    }
+
+    for (size_t i = 0; i < old_table->capacity; i++) {
+        hashmap_entry_t *pos, *n;
+        rbtree_postorder_for_each_entry_safe(pos, n, &old_table->buckets[i].root, rb_node) {
+            rb_root_t *bucket = &new_table->buckets[pos->hash % new_capacity];
+            rb_insert(bucket_prepare(map, bucket), &pos->rb_node);
+        }
+    }
+
+    // 发布新桶数组，旧桶数组等读者离开后释放
+    __atomic_store_n(&shard->table, new_table, __ATOMIC_RELEASE);
+    shard_retire(map, shard, old_table, table_release);
+
+    return HASHMAP_OK;
+}
+
+// 复制一段内存
+static void *dup_bytes(const void *data, size_t size) {
+    void *copy = malloc(size ? size : 1);
+    if (copy && size) {
+        memcpy(copy, data, size);
+    }
+    return copy;
+}
+
+//-----------------------------
+// 公共接口
+//-----------------------------
+
+// 创建并发哈希映射
+concurrent_hashmap_t* concurrent_hashmap_create(size_t shard_count, size_t initial_capacity,
+                                                float load_factor,
+                                                hashmap_hash_fn hash_fn,
+                                                hashmap_key_compare_fn key_compare_fn) {
+    // 参数验证
+    if (shard_count == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        shard_count = (size_t)(cpus > 0 ? cpus : 1) * CONCURRENT_HASHMAP_SHARDS_PER_CPU;
+    }
+    if (shard_count > CONCURRENT_HASHMAP_MAX_SHARDS) {
+        shard_count = CONCURRENT_HASHMAP_MAX_SHARDS;
+    }
+    if (initial_capacity < CONCURRENT_HASHMAP_MIN_CAPACITY) {
+        initial_capacity = CONCURRENT_HASHMAP_MIN_CAPACITY;
+    }
+    if (load_factor <= 0.0f || load_factor > 1.0f) {
+        load_factor = CONCURRENT_HASHMAP_DEFAULT_LOAD_FACTOR;
+    }
+
+    // 分片数量取 2 的幂，用哈希值最高的 log2(shard_count) 位选择分片
+    unsigned int shard_bits = 0;
+    while (((size_t)1 << shard_bits) < shard_count) {
+        shard_bits++;
+    }
+    shard_count = (size_t)1 << shard_bits;
+
+    concurrent_hashmap_t *map = (concurrent_hashmap_t *)malloc(sizeof(concurrent_hashmap_t));
+    if (!map) {
+        return NULL;
+    }
+
+    map->shards = (concurrent_hashmap_shard_t *)aligned_alloc(
+        CONCURRENT_HASHMAP_CACHELINE, shard_count * sizeof(concurrent_hashmap_shard_t));
+    map->readers = (concurrent_hashmap_reader_t *)aligned_alloc(
+        CONCURRENT_HASHMAP_CACHELINE, CONCURRENT_HASHMAP_MAX_THREADS * sizeof(concurrent_hashmap_reader_t));
+    if (!map->shards || !map->readers) {
+        free(map->shards);
+        free(map->readers);
+        free(map);
+        return NULL;
+    }
+    memset(map->readers, 0, CONCURRENT_HASHMAP_MAX_THREADS * sizeof(concurrent_hashmap_reader_t));
+
+    // 初始化分片
+    for (size_t i = 0; i < shard_count; i++) {
+        concurrent_hashmap_shard_t *shard = &map->shards[i];
+        memset(shard, 0, sizeof(*shard));
+        shard->table = table_alloc(initial_capacity);
+        if (!shard->table) {
+            for (size_t j = 0; j < i; j++) {
+                pthread_mutex_destroy(&map->shards[j].lock);
+                free(map->shards[j].table);
+            }
+            free(map->shards);
+            free(map->readers);
+            free(map);
+            return NULL;
+        }
+        pthread_mutex_init(&shard->lock, NULL);
+    }
+
+    // 初始化属性
+    map->shard_count = shard_count;
+    map->shard_shift = 32 - shard_bits;
+    map->load_factor = load_factor;
+    map->epoch = 1;
+    map->hash_fn = hash_fn ? hash_fn : hashmap_hash_string;
+    map->key_compare_fn = key_compare_fn ? key_compare_fn : hashmap_compare_string;
+
+    return map;
+}
+
+// 销毁并发哈希映射
+void concurrent_hashmap_destroy(concurrent_hashmap_t *map) {
+    if (!map) {
+        return;
+    }
+
+    for (size_t i = 0; i < map->shard_count; i++) {
+        concurrent_hashmap_shard_t *shard = &map->shards[i];
+
+        // 没有读者了，待释放对象可以直接释放
+        for (size_t j = 0; j < shard->retired_count; j++) {
+            shard->retired[j].release(shard->retired[j].ptr, map);
+        }
+        free(shard->retired);
+
+        table_release_all(shard->table, map);
+        pthread_mutex_destroy(&shard->lock);
+    }
+
+    free(map->shards);
+    free(map->readers);
+    free(map);
+}
+
+// 清空并发哈希映射
+void concurrent_hashmap_clear(concurrent_hashmap_t *map) {
+    if (!map) {
+        return;
+    }
+
+    for (size_t i = 0; i < map->shard_count; i++) {
+        concurrent_hashmap_shard_t *shard = &map->shards[i];
+
+        pthread_mutex_lock(&shard->lock);
+        concurrent_hashmap_table_t *table = table_alloc(shard->table->capacity);
+        if (table) {
+            // 整体替换为空桶数组，旧桶数组连同节点延迟释放
+            concurrent_hashmap_table_t *old_table = shard->table;
+            shard_write_begin(shard);
+            __atomic_store_n(&shard->table, table, __ATOMIC_RELEASE);
+            __atomic_store_n(&shard->size, 0, __ATOMIC_RELAXED);
+            shard_write_end(shard);
+            shard_retire(map, shard, old_table, table_release_all);
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
+
+// 获取键值对数量
+size_t concurrent_hashmap_size(const concurrent_hashmap_t *map) {
+    if (!map) {
+        return 0;
+    }
+
+    size_t size = 0;
+    for (size_t i = 0; i < map->shard_count; i++) {
+        size += __atomic_load_n(&map->shards[i].size, __ATOMIC_RELAXED);
+    }
+    return size;
+}
+
+// 插入键值对
+hashmap_status_t concurrent_hashmap_put(concurrent_hashmap_t *map, const void *key, size_t key_size,
+                                        const void *value, size_t value_size) {
+    if (!map || !key) {
+        return HASHMAP_ERR;
+    }
+
+    unsigned int hash = hash_mix(map->hash_fn(key, key_size));
+    concurrent_hashmap_shard_t *shard = shard_for(map, hash);
+
+    // 在锁外完成节点和值的分配与复制，缩短临界区
+    hashmap_entry_t *entry = (hashmap_entry_t *)malloc(sizeof(hashmap_entry_t));
+    void *new_value = dup_bytes(value, value_size);
+    if (!entry || !new_value) {
+        free(entry);
+        free(new_value);
+        return HASHMAP_NOMEM;
+    }
+    entry->hash = hash;
+    entry->value = new_value;
+    entry->value_size = value_size;
+
+    pthread_mutex_lock(&shard->lock);
+
+    rb_root_t *bucket;
+    hashmap_entry_t *existing = shard_find_locked(shard, key, key_size, hash, &bucket);
+    if (existing) {
+        // 节点发布后不再修改，用新节点整体替换，键转交给新节点
+        // 子节点指针先于发布写好，rb_replace 以释放语义接入新节点，读者经由新节点总能走到有效的子树
+        entry->key = existing->key;
+        entry->key_size = existing->key_size;
+        entry->rb_node = existing->rb_node;
+
+        shard_write_begin(shard);
+        rb_replace(bucket, &existing->rb_node, &entry->rb_node);
+        shard_write_end(shard);
+
+        shard_retire(map, shard, existing, entry_release_value);
+        pthread_mutex_unlock(&shard->lock);
+        return HASHMAP_OK;
+    }
+
+    entry->key = dup_bytes(key, key_size);
+    if (!entry->key) {
+        pthread_mutex_unlock(&shard->lock);
+        free(new_value);
+        free(entry);
+        return HASHMAP_NOMEM;
+    }
+    entry->key_size = key_size;
+
+    shard_write_begin(shard);
+
+    // 检查是否需要扩容
+    hashmap_status_t status = HASHMAP_OK;
+    if ((float)(shard->size + 1) / shard->table->capacity > map->load_factor) {
+        status = shard_rehash(map, shard, shard->table->capacity * CONCURRENT_HASHMAP_RESIZE_FACTOR);
+        bucket = &shard->table->buckets[hash % shard->table->capacity];
+    }
+
+    // 扩容失败时仍可插入当前桶数组，只是负载偏高
+    bucket_prepare(map, bucket);
+    rb_insert(bucket, &entry->rb_node);
+    __atomic_store_n(&shard->size, shard->size + 1, __ATOMIC_RELAXED);
+
+    shard_write_end(shard);
+    pthread_mutex_unlock(&shard->lock);
+
+    return status == HASHMAP_NOMEM ? HASHMAP_OK : status;
+}
+
+// 无锁读取，失败次数过多或没有读者槽位时持锁读取
+static hashmap_status_t shard_read(const concurrent_hashmap_t *map, const void *key, size_t key_size,
+                                   void *value, size_t value_size, size_t *actual_size) {
+    unsigned int hash = hash_mix(map->hash_fn(key, key_size));
+    concurrent_hashmap_shard_t *shard = shard_for(map, hash);
+
+    int slot = reader_enter(map);
+    if (slot >= 0) {
+        for (int attempt = 0; attempt < CONCURRENT_HASHMAP_READ_RETRIES; attempt++) {
+            unsigned long seq = shard_read_begin(shard);
+            if (seq & 1) {
+                cpu_relax();
+                continue;
+            }
+
+            const concurrent_hashmap_table_t *table = __atomic_load_n(&shard->table, __ATOMIC_ACQUIRE);
+            bool ok;
+            hashmap_entry_t *entry = table_lookup(map, table, key, key_size, hash, &ok);
+            if (!ok) {
+                continue;
+            }
+
+            // 节点不会被原地修改，复制出来的值对应某一个完整的版本
+            size_t entry_value_size = 0;
+            if (entry) {
+                entry_value_size = entry->value_size;
+                if (value) {
+                    size_t copy_size = (value_size < entry_value_size) ? value_size : entry_value_size;
+                    memcpy(value, entry->value, copy_size);
+                }
+            }
+
+            if (shard_read_retry(shard, seq)) {
+                continue;
+            }
+
+            reader_exit(map, slot);
+            if (!entry) {
+                return HASHMAP_NOT_FOUND;
+            }
+            if (actual_size) {
+                *actual_size = entry_value_size;
+            }
+            return HASHMAP_OK;
+        }
+        reader_exit(map, slot);
+    }
+
+    // 持锁读取
+    pthread_mutex_lock(&shard->lock);
+    hashmap_entry_t *entry = shard_find_locked(shard, key, key_size, hash, NULL);
+    if (entry) {
+        if (actual_size) {
+            *actual_size = entry->value_size;
+        }
+        if (value) {
+            size_t copy_size = (value_size < entry->value_size) ? value_size : entry->value_size;
+            memcpy(value, entry->value, copy_size);
+        }
+    }
+    pthread_mutex_unlock(&shard->lock);
+
+    return entry ? HASHMAP_OK : HASHMAP_NOT_FOUND;
+}
+
+// 获取键对应的值
+hashmap_status_t concurrent_hashmap_get(const concurrent_hashmap_t *map, const void *key, size_t key_size,
+                                        void *value, size_t value_size, size_t *actual_size) {
+    if (!map || !key) {
+        return HASHMAP_ERR;
+    }
+
+    return shard_read(map, key, key_size, value, value_size, actual_size);
+}
+
+// 移除键值对
+hashmap_status_t concurrent_hashmap_remove(concurrent_hashmap_t *map, const void *key, size_t key_size) {
+    if (!map || !key) {
+        return HASHMAP_ERR;
+    }
+
+    unsigned int hash = hash_mix(map->hash_fn(key, key_size));
+    concurrent_hashmap_shard_t *shard = shard_for(map, hash);
+
+    pthread_mutex_lock(&shard->lock);
+
+    rb_root_t *bucket;
+    hashmap_entry_t *entry = shard_find_locked(shard, key, key_size, hash, &bucket);
+    if (!entry) {
+        pthread_mutex_unlock(&shard->lock);
+        return HASHMAP_NOT_FOUND;
+    }
+
+    shard_write_begin(shard);
+    rb_erase(bucket, &entry->rb_node);
+    __atomic_store_n(&shard->size, shard->size - 1, __ATOMIC_RELAXED);
+    shard_write_end(shard);
+
+    // 读者可能仍持有该节点，延迟释放
+    shard_retire(map, shard, entry, entry_release);
+
+    pthread_mutex_unlock(&shard->lock);
+    return HASHMAP_OK;
+}
+
+// 检查键是否存在
+bool concurrent_hashmap_contains(const concurrent_hashmap_t *map, const void *key, size_t key_size) {
+    if (!map || !key) {
+        return false;
+    }
+
+    return shard_read(map, key, key_size, NULL, 0, NULL) == HASHMAP_OK;
+}
+
+// 遍历并发哈希映射
+void concurrent_hashmap_foreach(const concurrent_hashmap_t *map, hashmap_foreach_fn fn, void *user_data) {
+    if (!map || !fn) {
+        return;
+    }
+
+    for (size_t i = 0; i < map->shard_count; i++) {
+        concurrent_hashmap_shard_t *shard = &map->shards[i];
+
+        pthread_mutex_lock(&shard->lock);
+        concurrent_hashmap_table_t *table = shard->table;
+        for (size_t j = 0; j < table->capacity; j++) {
+            struct rb_node *node;
+            for (node = rb_first(&table->buckets[j].root); node; node = rb_next(node)) {
+                hashmap_entry_t *entry = rb_entry(node, hashmap_entry_t, rb_node);
+                if (!fn(entry->key, entry->key_size, entry->value, entry->value_size, user_data)) {
+                    pthread_mutex_unlock(&shard->lock);
+                    return; // 中断遍历
+                }
+            }
+        }
+        pthread_mutex_unlock(&shard->lock);
+    }
+}
@@ -0,0 +1,167 @@
+#ifndef __CONCURRENT_HASHMAP_H__
+#define __CONCURRENT_HASHMAP_H__
+
+#include "hashmap.h"
+#include <pthread.h>
+
+/*
+ * 分片并发哈希表，基于 hashmap 的节点结构、哈希函数和红黑树桶
+ *
+ * 主要特性：
+ * 1. 按哈希值高位把键分配到 N 个分片，每个分片独立加锁，写操作只锁一个分片
+ * 2. 读操作不加任何锁：分片写入时递增顺序计数（seqlock），读者发现计数变化就重试
+ * 3. 节点发布后不再原地修改，更新值时整体替换节点；被摘除的节点、旧值和旧桶数组
+ *    通过纪元（epoch）回收延迟释放，保证无锁读者访问的内存始终有效
+ * 4. 线程数超过 CONCURRENT_HASHMAP_MAX_THREADS 或读者反复重试时退化为持锁读取
+ *
+ * 接口语义与 hashmap 的 put/get/remove/contains/foreach 保持一致。
+ */
+
+// 同时持有读者记录的最大线程数
+#define CONCURRENT_HASHMAP_MAX_THREADS 256
+
+// 缓存行大小，分片和读者记录按缓存行对齐，避免伪共享
+#define CONCURRENT_HASHMAP_CACHELINE 64
+
+/**
+ * 分片桶数组，扩容时整体替换
+ */
+typedef struct concurrent_hashmap_table {
+    size_t capacity;          // 桶数量
+    rb_root_t buckets[];      // 桶数组（红黑树）
+} concurrent_hashmap_table_t;
+
+struct concurrent_hashmap;
+
+/**
+ * 延迟释放记录
+ */
+typedef struct concurrent_hashmap_retired {
+    void *ptr;                // 待释放对象
+    void (*release)(void *ptr, struct concurrent_hashmap *map); // 释放函数
+    unsigned long epoch;      // 摘除时的全局纪元
+} concurrent_hashmap_retired_t;
+
+/**
+ * 分片结构
+ */
+typedef struct concurrent_hashmap_shard {
+    pthread_mutex_t lock;                 // 写锁
+    unsigned long seq;                    // 顺序计数，奇数表示正在写入
+    concurrent_hashmap_table_t *table;    // 当前桶数组
+    size_t size;                          // 分片内键值对数量
+
+    concurrent_hashmap_retired_t *retired; // 待释放对象列表（受写锁保护）
+    size_t retired_count;                  // 待释放对象数量
+    size_t retired_capacity;               // 列表容量
+} __attribute__((aligned(CONCURRENT_HASHMAP_CACHELINE))) concurrent_hashmap_shard_t;
+
+/**
+ * 读者纪元记录，每个线程一条
+ */
+typedef struct concurrent_hashmap_reader {
+    unsigned long state;      // 0 表示不在读临界区，否则为 (纪元 << 1) | 1
+} __attribute__((aligned(CONCURRENT_HASHMAP_CACHELINE))) concurrent_hashmap_reader_t;
+
+/**
+ * 并发哈希映射结构
+ */
+typedef struct concurrent_hashmap {
+    size_t shard_count;       // 分片数量（2 的幂）
+    unsigned int shard_shift; // 哈希值右移位数，得到分片下标
+    float load_factor;        // 分片负载因子
+
+    concurrent_hashmap_shard_t *shards;     // 分片数组
+    concurrent_hashmap_reader_t *readers;   // 读者纪元记录数组
+    unsigned long epoch;                    // 全局纪元
+
+    hashmap_hash_fn hash_fn;  // 哈希函数
+    hashmap_key_compare_fn key_compare_fn; // 键比较函数
+} concurrent_hashmap_t;
+
+/**
+ * 创建并发哈希映射
+ * @param shard_count 分片数量（向上取整到 2 的幂，0 表示按 CPU 数量自动选择）
+ * @param initial_capacity 每个分片的初始桶数量
+ * @param load_factor 负载因子，超过此值分片将重新哈希
+ * @param hash_fn 哈希函数
+ * @param key_compare_fn 键比较函数
+ * @return 并发哈希映射对象，失败返回NULL
+ */
+concurrent_hashmap_t* concurrent_hashmap_create(size_t shard_count, size_t initial_capacity,
+                                                float load_factor,
+                                                hashmap_hash_fn hash_fn,
+                                                hashmap_key_compare_fn key_compare_fn);
+
+/**
+ * 销毁并发哈希映射（调用时不能有其他线程仍在访问）
+ * @param map 并发哈希映射对象
+ */
+void concurrent_hashmap_destroy(concurrent_hashmap_t *map);
+
+/**
+ * 清空并发哈希映射
+ * @param map 并发哈希映射对象
+ */
+void concurrent_hashmap_clear(concurrent_hashmap_t *map);
+
+/**
+ * 获取键值对数量（并发写入时为近似值）
+ * @param map 并发哈希映射对象
+ * @return 键值对数量
+ */
+size_t concurrent_hashmap_size(const concurrent_hashmap_t *map);
+
+/**
+ * 插入键值对，键已存在时替换值
+ * @param map 并发哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @param value 值
+ * @param value_size 值的大小
+ * @return 状态码
+ */
+hashmap_status_t concurrent_hashmap_put(concurrent_hashmap_t *map, const void *key, size_t key_size,
+                                        const void *value, size_t value_size);
+
+/**
+ * 获取键对应的值（无锁读取）
+ * @param map 并发哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @param value 用于存储值的缓冲区
+ * @param value_size 缓冲区大小
+ * @param actual_size 实际值的大小（可为NULL）
+ * @return 状态码
+ */
+hashmap_status_t concurrent_hashmap_get(const concurrent_hashmap_t *map, const void *key, size_t key_size,
+                                        void *value, size_t value_size, size_t *actual_size);
+
+/**
+ * 移除键值对
+ * @param map 并发哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @return 状态码
+ */
+hashmap_status_t concurrent_hashmap_remove(concurrent_hashmap_t *map, const void *key, size_t key_size);
+
+/**
+ * 检查键是否存在（无锁读取）
+ * @param map 并发哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @return true表示存在，false表示不存在
+ */
+bool concurrent_hashmap_contains(const concurrent_hashmap_t *map, const void *key, size_t key_size);
+
+/**
+ * 遍历并发哈希映射
+ * 逐个分片持锁遍历，回调中不能修改同一个映射
+ * @param map 并发哈希映射对象
+ * @param fn 回调函数
+ * @param user_data 用户数据
+ */
+void concurrent_hashmap_foreach(const concurrent_hashmap_t *map, hashmap_foreach_fn fn, void *user_data);
+
+#endif /* __CONCURRENT_HASHMAP_H__ */
@@ -0,0 +1,196 @@
+#include "concurrent_hashmap.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define THREAD_COUNT 4
+#define KEYS_PER_THREAD 50000
+#define READ_ROUNDS 4
+
+// 用于遍历的回调函数
+bool print_entry(const void *key, size_t key_size,
+                void *value, size_t value_size,
+                void *user_data) {
+    printf("键: %s, 值: %d\n", (const char *)key, *(int *)value);
+    return 1;
+}
+
+// 统计遍历到的键值对
+bool count_entry(const void *key, size_t key_size,
+                void *value, size_t value_size,
+                void *user_data) {
+    (*(size_t *)user_data)++;
+    return 1;
+}
+
+typedef struct {
+    concurrent_hashmap_t *map;
+    int id;
+    int errors;
+} worker_arg_t;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// 写线程：插入自己的键区间，然后更新并删除其中一半
+static void *writer_thread(void *arg) {
+    worker_arg_t *w = (worker_arg_t *)arg;
+    int base = w->id * KEYS_PER_THREAD;
+
+    for (int i = base; i < base + KEYS_PER_THREAD; i++) {
+        int value = i;
+        if (concurrent_hashmap_put(w->map, &i, sizeof(int), &value, sizeof(int)) != HASHMAP_OK) {
+            w->errors++;
+        }
+    }
+    for (int i = base; i < base + KEYS_PER_THREAD; i++) {
+        if (i % 2 == 0) {
+            concurrent_hashmap_remove(w->map, &i, sizeof(int));
+        } else {
+            int value = i * 2;
+            concurrent_hashmap_put(w->map, &i, sizeof(int), &value, sizeof(int));
+        }
+    }
+    return NULL;
+}
+
+// 读线程：与写线程并发读取，读到的值必须是某个写入过的完整版本
+static void *reader_thread(void *arg) {
+    worker_arg_t *w = (worker_arg_t *)arg;
+    int total = THREAD_COUNT * KEYS_PER_THREAD;
+
+    for (int round = 0; round < READ_ROUNDS; round++) {
+        for (int i = 0; i < total; i++) {
+            int value;
+            if (concurrent_hashmap_get(w->map, &i, sizeof(int), &value, sizeof(int), NULL) == HASHMAP_OK) {
+                if (value != i && value != i * 2) {
+                    w->errors++;
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+// 多线程读写测试，结束后校验最终内容
+static int concurrent_test(void) {
+    concurrent_hashmap_t *map = concurrent_hashmap_create(0, 16, 0.75f,
+                                                          hashmap_hash_data, hashmap_compare_data);
+    if (!map) {
+        return 1;
+    }
+
+    pthread_t writers[THREAD_COUNT], readers[THREAD_COUNT];
+    worker_arg_t writer_args[THREAD_COUNT], reader_args[THREAD_COUNT];
+
+    double start = now_seconds();
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        writer_args[i] = (worker_arg_t){ map, i, 0 };
+        reader_args[i] = (worker_arg_t){ map, i, 0 };
+        pthread_create(&writers[i], NULL, writer_thread, &writer_args[i]);
+        pthread_create(&readers[i], NULL, reader_thread, &reader_args[i]);
+    }
+
+    int errors = 0;
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(writers[i], NULL);
+        pthread_join(readers[i], NULL);
+        errors += writer_args[i].errors + reader_args[i].errors;
+    }
+    double elapsed = now_seconds() - start;
+
+    // 偶数键已删除，奇数键的值被更新为两倍
+    int total = THREAD_COUNT * KEYS_PER_THREAD;
+    for (int i = 0; i < total; i++) {
+        int value = -1;
+        hashmap_status_t status = concurrent_hashmap_get(map, &i, sizeof(int), &value, sizeof(int), NULL);
+        if (i % 2 == 0 && status != HASHMAP_NOT_FOUND) {
+            errors++;
+        }
+        if (i % 2 == 1 && (status != HASHMAP_OK || value != i * 2)) {
+            errors++;
+        }
+    }
+
+    size_t counted = 0;
+    concurrent_hashmap_foreach(map, count_entry, &counted);
+    if (counted != (size_t)total / 2 || concurrent_hashmap_size(map) != (size_t)total / 2) {
+        errors++;
+    }
+
+    printf("分片: %zu, %d 写线程 + %d 读线程, 耗时: %.3f 秒, 大小: %zu, 错误数: %d\n",
+           map->shard_count, THREAD_COUNT, THREAD_COUNT, elapsed,
+           concurrent_hashmap_size(map), errors);
+    concurrent_hashmap_destroy(map);
+    return errors != 0;
+}
+
+int main() {
+    // 创建并发哈希映射，分片数量按 CPU 数量自动选择
+    concurrent_hashmap_t *map = concurrent_hashmap_create(0, 16, 0.75f, NULL, NULL);
+    if (!map) {
+        printf("创建并发哈希映射失败\n");
+        return 1;
+    }
+
+    // 插入一些键值对
+    const char *keys[] = {"apple", "banana", "cherry", "date", "elderberry"};
+    int values[] = {10, 20, 30, 40, 50};
+
+    printf("插入键值对...\n");
+    for (int i = 0; i < 5; i++) {
+        if (concurrent_hashmap_put(map, keys[i], strlen(keys[i]) + 1, &values[i], sizeof(int)) != HASHMAP_OK) {
+            printf("插入键 '%s' 失败\n", keys[i]);
+        }
+    }
+
+    // 查询键值对
+    printf("\n查询键值对...\n");
+    for (int i = 0; i < 5; i++) {
+        int value;
+        if (concurrent_hashmap_get(map, keys[i], strlen(keys[i]) + 1, &value, sizeof(int), NULL) == HASHMAP_OK) {
+            printf("键 '%s' 的值为: %d\n", keys[i], value);
+        } else {
+            printf("找不到键 '%s'\n", keys[i]);
+        }
+    }
+
+    // 修改值
+    printf("\n修改键值...\n");
+    int new_value = 100;
+    concurrent_hashmap_put(map, "banana", strlen("banana") + 1, &new_value, sizeof(int));
+
+    int value;
+    concurrent_hashmap_get(map, "banana", strlen("banana") + 1, &value, sizeof(int), NULL);
+    printf("修改后 'banana' 的值为: %d\n", value);
+
+    // 遍历并发哈希映射
+    printf("\n遍历并发哈希映射...\n");
+    concurrent_hashmap_foreach(map, print_entry, NULL);
+
+    // 检查键是否存在
+    printf("\n检查键是否存在...\n");
+    printf("'apple' 存在: %s\n", concurrent_hashmap_contains(map, "apple", strlen("apple") + 1) ? "是" : "否");
+    printf("'grape' 存在: %s\n", concurrent_hashmap_contains(map, "grape", strlen("grape") + 1) ? "是" : "否");
+
+    // 删除键值对
+    printf("\n删除键值对...\n");
+    concurrent_hashmap_remove(map, "cherry", strlen("cherry") + 1);
+    printf("删除后 'cherry' 存在: %s\n", concurrent_hashmap_contains(map, "cherry", strlen("cherry") + 1) ? "是" : "否");
+
+    // 清空并发哈希映射
+    printf("\n清空并发哈希映射...\n");
+    concurrent_hashmap_clear(map);
+    printf("并发哈希映射大小: %zu\n", concurrent_hashmap_size(map));
+
+    // 销毁并发哈希映射
+    concurrent_hashmap_destroy(map);
+    printf("\n并发哈希映射已销毁\n");
+
+    // 多线程并发读写测试
+    printf("\n多线程读写测试...\n");
+    return concurrent_test();
+}
@@ -0,0 +1,386 @@
+#ifndef __HASHMAP_H__
+#define __HASHMAP_H__
+
+#include "rb_tree.h"
+#include <stdlib.h>
+
+/**
+ * 哈希映射状态码
+ */
+typedef enum {
+    HASHMAP_OK = 0,            // 操作成功
+    HASHMAP_ERR = -1,          // 一般错误
+    HASHMAP_DUPLICATE = -2,    // 键已存在
+    HASHMAP_NOT_FOUND = -3,    // 键不存在
+    HASHMAP_NOMEM = -4,        // 内存分配失败
+} hashmap_status_t;
+
+/**
+ * 重新哈希模式
+ */
+typedef enum {
+    HASHMAP_REHASH_BLOCKING = 0,    // 扩容时一次性迁移所有节点（默认）
+    HASHMAP_REHASH_INCREMENTAL,     // 渐进式迁移：新旧桶数组并存，每次写操作迁移少量桶
+} hashmap_rehash_mode_t;
+
+/**
+ * 内存分配模式
+ */
+typedef enum {
+    HASHMAP_ALLOC_MALLOC = 0,       // 节点、键、值分别通过 malloc 和 key_dup/value_dup 分配（默认）
+    HASHMAP_ALLOC_SLAB,             // 从映射自有的分级 slab 页中分配，小键值与节点内联在同一块中
+} hashmap_alloc_mode_t;
+
+// slab 尺寸级别数量（16 字节递增，最大 HASHMAP_SLAB_MAX_BLOCK 字节）
+#define HASHMAP_SLAB_CLASS_COUNT 13
+
+// slab 单块最大尺寸，更大的键值单独分配并挂在映射上统一释放
+#define HASHMAP_SLAB_MAX_BLOCK 512
+
+// slab 页大小
+#define HASHMAP_SLAB_PAGE_SIZE (64 * 1024)
+
+/**
+ * slab 分配器状态
+ */
+typedef struct hashmap_slab {
+    void *free_lists[HASHMAP_SLAB_CLASS_COUNT]; // 各尺寸级别的空闲块链表
+    char *cursor;             // 当前页中尚未切分部分的起点
+    char *limit;              // 当前页末尾
+    void *pages;              // 已分配的页链表
+    void *large;              // 超过最大块尺寸的单独分配链表（双向）
+    size_t page_count;        // 页数量
+    size_t foreign_count;     // 通过 put_owned 接管、需要逐个释放的缓冲区数量
+} hashmap_slab_t;
+
+/**
+ * 哈希表节点结构
+ */
+typedef struct hashmap_entry {
+    struct rb_node rb_node;   // 红黑树节点
+    unsigned int hash;        // 键的哈希值
+    unsigned int flags;       // 节点、键、值的内存来源（slab 模式使用）
+    void *key;                // 键
+    void *value;              // 值
+    size_t key_size;          // 键大小
+    size_t value_size;        // 值大小
+} hashmap_entry_t;
+
+/**
+ * 哈希函数类型定义
+ */
+typedef unsigned int (*hashmap_hash_fn)(const void *key, size_t key_size);
+
+/**
+ * 键比较函数类型定义
+ */
+typedef int (*hashmap_key_compare_fn)(const void *key1, size_t key1_size, 
+                                     const void *key2, size_t key2_size);
+
+/**
+ * 哈希映射结构
+ */
+typedef struct hashmap {
+    size_t size;              // 键值对数量
+    size_t capacity;          // 桶数组容量
+    float load_factor;        // 负载因子
+    rb_root_t *buckets;       // 桶数组（红黑树）
+    
+    // 渐进式重新哈希状态，rehash_buckets 非空表示正在迁移
+    hashmap_rehash_mode_t rehash_mode; // 重新哈希模式
+    rb_root_t *rehash_buckets;         // 迁移目标桶数组
+    size_t rehash_capacity;            // 迁移目标桶数组容量
+    size_t rehash_index;               // 下一个待迁移的旧桶下标
+    
+    hashmap_hash_fn hash_fn;  // 哈希函数
+    hashmap_key_compare_fn key_compare_fn; // 键比较函数
+    
+    hashmap_alloc_mode_t alloc_mode;   // 内存分配模式
+    hashmap_slab_t *slab;              // slab 分配器，malloc 模式下为 NULL
+    
+    // 内存操作函数
+    void* (*key_dup)(const void *key, size_t size);
+    void* (*value_dup)(const void *value, size_t size);
+    void (*key_free)(void *key);
+    void (*value_free)(void *value);
+} hashmap_t;
+
+/**
+ * 遍历回调函数类型
+ */
+typedef bool (*hashmap_foreach_fn)(const void *key, size_t key_size,
+                                  void *value, size_t value_size,
+                                  void *user_data);
+
+/**
+ * 创建哈希映射
+ * @param initial_capacity 初始桶数量
+ * @param load_factor 负载因子，超过此值将重新哈希
+ * @param hash_fn 哈希函数
+ * @param key_compare_fn 键比较函数
+ * @return 哈希映射对象，失败返回NULL
+ */
+hashmap_t* hashmap_create(size_t initial_capacity, float load_factor,
+                         hashmap_hash_fn hash_fn,
+                         hashmap_key_compare_fn key_compare_fn);
+
+/**
+ * 销毁哈希映射
+ * @param map 哈希映射对象
+ */
+void hashmap_destroy(hashmap_t *map);
+
+/**
+ * 清空哈希映射
+ * @param map 哈希映射对象
+ */
+void hashmap_clear(hashmap_t *map);
+
+/**
+ * 获取哈希映射中键值对数量
+ * @param map 哈希映射对象
+ * @return 键值对数量
+ */
+size_t hashmap_size(const hashmap_t *map);
+
+/**
+ * 插入键值对
+ * @param map 哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @param value 值
+ * @param value_size 值的大小
+ * @return 状态码
+ */
+hashmap_status_t hashmap_put(hashmap_t *map, const void *key, size_t key_size,
+                            const void *value, size_t value_size);
+
+/**
+ * 插入键值对并接管键和值的所有权，不调用 key_dup/value_dup
+ * 键和值必须能被 key_free/value_free 释放（默认为 free）；
+ * 键已存在时保留原有的键，传入的键立即用 key_free 释放，旧值用 value_free 释放。
+ * 返回错误时所有权仍归调用者。
+ * @param map 哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @param value 值
+ * @param value_size 值的大小
+ * @return 状态码
+ */
+hashmap_status_t hashmap_put_owned(hashmap_t *map, void *key, size_t key_size,
+                                  void *value, size_t value_size);
+
+/**
+ * 为键预留一块 value_size 字节的值缓冲区，由调用者原地填充，省去一次值复制
+ * 键不存在时复制键并分配缓冲区，malloc 模式下缓冲区由 malloc 分配（自定义 value_free
+ * 需与 free 兼容），slab 模式下从 slab 分配；
+ * 键已存在且大小相同时返回原有缓冲区，大小不同时替换为新缓冲区。
+ * 缓冲区内容未初始化，有效期同 hashmap_get_ref。
+ * @param map 哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @param value_size 值的大小
+ * @param value 输出值缓冲区指针
+ * @return 状态码
+ */
+hashmap_status_t hashmap_emplace(hashmap_t *map, const void *key, size_t key_size,
+                                size_t value_size, void **value);
+
+/**
+ * 获取键对应的值
+ * @param map 哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @param value 用于存储值的缓冲区
+ * @param value_size 缓冲区大小
+ * @param actual_size 实际值的大小（可为NULL）
+ * @return 状态码
+ */
+hashmap_status_t hashmap_get(const hashmap_t *map, const void *key, size_t key_size,
+                           void *value, size_t value_size, size_t *actual_size);
+
+/**
+ * 获取键对应值的指针，不复制值
+ * 值存放在独立分配的缓冲区中，重新哈希不会移动它；指针在该键被更新、移除
+ * 或映射被清空、销毁之前一直有效
+ * @param map 哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @param value 输出映射内部保存的值指针
+ * @param value_size 输出值的大小（可为NULL）
+ * @return 状态码
+ */
+hashmap_status_t hashmap_get_ref(const hashmap_t *map, const void *key, size_t key_size,
+                               void **value, size_t *value_size);
+
+/**
+ * 移除键值对
+ * @param map 哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @return 状态码
+ */
+hashmap_status_t hashmap_remove(hashmap_t *map, const void *key, size_t key_size);
+
+/**
+ * 检查键是否存在
+ * @param map 哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @return true表示存在，false表示不存在
+ */
+bool hashmap_contains(const hashmap_t *map, const void *key, size_t key_size);
+
+/**
+ * 批量获取键对应的值
+ * 先计算一组键的哈希值并预取所有目标桶，再逐个查找，多个键的访存延迟相互重叠，
+ * 映射远大于末级缓存时比逐个调用 hashmap_get 吞吐更高
+ * @param map 哈希映射对象
+ * @param keys 键数组
+ * @param key_sizes 键大小数组
+ * @param count 键数量
+ * @param values 值缓冲区数组（可为NULL，元素也可为NULL，表示不复制值）
+ * @param value_sizes 值缓冲区大小数组（values 为NULL时可为NULL）
+ * @param actual_sizes 输出实际值大小数组（可为NULL）
+ * @param statuses 输出每个键的状态码数组（可为NULL），空键为 HASHMAP_ERR
+ * @return 找到的键数量
+ */
+size_t hashmap_get_batch(const hashmap_t *map, const void *const *keys, const size_t *key_sizes,
+                         size_t count, void *const *values, const size_t *value_sizes,
+                         size_t *actual_sizes, hashmap_status_t *statuses);
+
+/**
+ * 批量插入键值对，预取方式同 hashmap_get_batch
+ * 遇到错误（包括空键）立即返回，之前的键值对已经插入
+ * @param map 哈希映射对象
+ * @param keys 键数组
+ * @param key_sizes 键大小数组
+ * @param values 值数组
+ * @param value_sizes 值大小数组
+ * @param count 键值对数量
+ * @return 状态码
+ */
+hashmap_status_t hashmap_put_batch(hashmap_t *map, const void *const *keys, const size_t *key_sizes,
+                                   const void *const *values, const size_t *value_sizes,
+                                   size_t count);
+
+/**
+ * 批量检查键是否存在，预取方式同 hashmap_get_batch
+ * @param map 哈希映射对象
+ * @param keys 键数组
+ * @param key_sizes 键大小数组
+ * @param count 键数量
+ * @param results 输出每个键是否存在（可为NULL），空键为 false
+ * @return 存在的键数量
+ */
+size_t hashmap_contains_batch(const hashmap_t *map, const void *const *keys, const size_t *key_sizes,
+                              size_t count, bool *results);
+
+/**
+ * 遍历哈希映射
+ * @param map 哈希映射对象
+ * @param fn 回调函数
+ * @param user_data 用户数据
+ */
+void hashmap_foreach(const hashmap_t *map, hashmap_foreach_fn fn, void *user_data);
+
+/**
+ * 重新设置哈希映射容量
+ * @param map 哈希映射对象
+ * @param new_capacity 新容量
+ * @return 状态码
+ */
+hashmap_status_t hashmap_resize(hashmap_t *map, size_t new_capacity);
+
+/**
+ * 设置重新哈希模式
+ * 渐进式模式下扩容只分配新桶数组，之后每次 put/remove 迁移少量旧桶，
+ * 查询根据迁移进度只查找键所在的那一张表；get/contains 为只读操作，不参与迁移。
+ * 从渐进式切换回阻塞式时会先完成正在进行的迁移。
+ * @param map 哈希映射对象
+ * @param mode 重新哈希模式
+ * @return 状态码
+ */
+hashmap_status_t hashmap_set_rehash_mode(hashmap_t *map, hashmap_rehash_mode_t mode);
+
+/**
+ * 是否正在进行渐进式重新哈希
+ * @param map 哈希映射对象
+ * @return true表示正在迁移
+ */
+bool hashmap_is_rehashing(const hashmap_t *map);
+
+/**
+ * 主动推进渐进式重新哈希，适合在空闲时或读多写少的场景下调用
+ * @param map 哈希映射对象
+ * @param buckets 本次最多迁移的非空旧桶数量
+ * @return true表示迁移仍未完成
+ */
+bool hashmap_rehash_step(hashmap_t *map, size_t buckets);
+
+/**
+ * 设置内存分配模式，只能在映射为空时切换
+ * slab 模式下节点、键、值从映射自有的分级 slab 页中分配，节点与不超过
+ * HASHMAP_SLAB_MAX_BLOCK 的键值内联在同一块中，一次插入只做一次块分配；
+ * 清空和销毁按页整体释放，不再逐个释放节点。该模式不调用 key_dup/value_dup，
+ * key_free/value_free 只用于通过 hashmap_put_owned 接管的缓冲区。
+ * @param map 哈希映射对象
+ * @param mode 内存分配模式
+ * @return 状态码，映射非空时返回 HASHMAP_ERR
+ */
+hashmap_status_t hashmap_set_alloc_mode(hashmap_t *map, hashmap_alloc_mode_t mode);
+
+/**
+ * 设置自定义内存操作函数
+ * @param map 哈希映射对象
+ * @param key_dup 键复制函数
+ * @param value_dup 值复制函数
+ * @param key_free 键释放函数
+ * @param value_free 值释放函数
+ */
+void hashmap_set_memory_functions(hashmap_t *map,
+                                 void* (*key_dup)(const void *key, size_t size),
+                                 void* (*value_dup)(const void *value, size_t size),
+                                 void (*key_free)(void *key),
+                                 void (*value_free)(void *value));
+
+/**
+ * 默认字符串哈希函数（wyhash，按 '\0' 结尾的字符串内容计算）
+ * 种子在进程启动时随机生成，同一进程内结果稳定，不同进程之间不同
+ * @param key 键
+ * @param key_size 键的大小
+ * @return 哈希值
+ */
+unsigned int hashmap_hash_string(const void *key, size_t key_size);
+
+/**
+ * 默认数据哈希函数（wyhash，种子同上）
+ * @param key 键
+ * @param key_size 键的大小
+ * @return 哈希值
+ */
+unsigned int hashmap_hash_data(const void *key, size_t key_size);
+
+/**
+ * 默认字符串比较函数
+ * @param key1 第一个键
+ * @param key1_size 第一个键的大小
+ * @param key2 第二个键
+ * @param key2_size 第二个键的大小
+ * @return 比较结果
+ */
+int hashmap_compare_string(const void *key1, size_t key1_size, 
+                          const void *key2, size_t key2_size);
+
+/**
+ * 默认数据比较函数
+ * @param key1 第一个键
+ * @param key1_size 第一个键的大小
+ * @param key2 第二个键
+ * @param key2_size 第二个键的大小
+ * @return 比较结果
+ */
+int hashmap_compare_data(const void *key1, size_t key1_size, 
+                        const void *key2, size_t key2_size);
+
+#endif /* __HASHMAP_H__ */
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "flat_hashmap.h"
+#include <stdio.h>
+#include <string.h>
+
+#define KEY_MAX 32
+
+// 用于遍历的回调函数
+bool print_entry(const void *key, size_t key_size,
+                void *value, size_t value_size,
+                void *user_data) {
+    printf("键: %s, 值: %d\n", (const char *)key, *(int *)value);
+    return 1;
+}
+
+// 大量整数键插入、删除后校验结果
+static int stress_test(flat_hashmap_probe_t probe) {
+    const int count = 100000;
+    flat_hashmap_set_default_probe(probe);
+    flat_hashmap_t *map = flat_hashmap_create(sizeof(int), sizeof(int), 0, 0.0f,
+                                              flat_hashmap_hash_data, flat_hashmap_compare_data);
+    if (!map) {
+        return 1;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int value = i * 2;
+        if (flat_hashmap_put(map, &i, sizeof(int), &value, sizeof(int)) != FLAT_HASHMAP_OK) {
+            flat_hashmap_destroy(map);
+            return 1;
+        }
+    }
+
+    // 删除偶数键，制造删除标记
+    for (int i = 0; i < count; i += 2) {
+        flat_hashmap_remove(map, &i, sizeof(int));
+    }
+
+    int errors = 0;
+    for (int i = 0; i < count; i++) {
+        int value = -1;
+        flat_hashmap_status_t status = flat_hashmap_get(map, &i, sizeof(int), &value, sizeof(int), NULL);
+        if (i % 2 == 0 && status != FLAT_HASHMAP_NOT_FOUND) {
+            errors++;
+        }
+        if (i % 2 == 1 && (status != FLAT_HASHMAP_OK || value != i * 2)) {
+            errors++;
+        }
+    }
+
+    // 重新插入偶数键，复用删除标记
+    for (int i = 0; i < count; i += 2) {
+        int value = i * 2;
+        flat_hashmap_put(map, &i, sizeof(int), &value, sizeof(int));
+    }
+    if (flat_hashmap_size(map) != (size_t)count) {
+        errors++;
+    }
+
+    printf("%-6s 容量: %zu, 大小: %zu, 错误数: %d\n", flat_hashmap_probe_name(flat_hashmap_get_probe(map)),
+           map->capacity, flat_hashmap_size(map), errors);
+    flat_hashmap_destroy(map);
+    return errors != 0;
+}
+
+// 很小的负载因子：最小容量下也必须能扩容，不能卡在原地重建
+static int low_load_factor_test(void) {
+    const int count = 100;
+    flat_hashmap_t *map = flat_hashmap_create(sizeof(int), sizeof(int), 8, 0.02f,
+                                              flat_hashmap_hash_data, flat_hashmap_compare_data);
+    if (!map) {
+        return 1;
+    }
+
+    int errors = 0;
+    for (int i = 0; i < count; i++) {
+        if (flat_hashmap_put(map, &i, sizeof(int), &i, sizeof(int)) != FLAT_HASHMAP_OK) {
+            errors++;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        int value = -1;
+        if (flat_hashmap_get(map, &i, sizeof(int), &value, sizeof(int), NULL) != FLAT_HASHMAP_OK ||
+            value != i) {
+            errors++;
+        }
+    }
+    if (flat_hashmap_size(map) != (size_t)count) {
+        errors++;
+    }
+
+    printf("负载因子 0.02 容量: %zu, 大小: %zu, 错误数: %d\n",
+           map->capacity, flat_hashmap_size(map), errors);
+    flat_hashmap_destroy(map);
+    return errors != 0;
+}
+
+int main() {
+    // 创建扁平哈希映射，键为不超过 KEY_MAX 字节的字符串，值为 int
+    flat_hashmap_t *map = flat_hashmap_create(KEY_MAX, sizeof(int), 16, 0.875f,
+                                              flat_hashmap_hash_string, flat_hashmap_compare_string);
+    if (!map) {
+        printf("创建扁平哈希映射失败\n");
+        return 1;
+    }
+    printf("探测方式: %s\n", flat_hashmap_probe_name(flat_hashmap_get_probe(map)));
+
+    // 插入一些键值对
+    const char *keys[] = {"apple", "banana", "cherry", "date", "elderberry"};
+    int values[] = {10, 20, 30, 40, 50};
+
+    printf("插入键值对...\n");
+    for (int i = 0; i < 5; i++) {
+        if (flat_hashmap_put(map, keys[i], strlen(keys[i]) + 1, &values[i], sizeof(int)) != FLAT_HASHMAP_OK) {
+            printf("插入键 '%s' 失败\n", keys[i]);
+        }
+    }
+
+    // 查询键值对
+    printf("\n查询键值对...\n");
+    for (int i = 0; i < 5; i++) {
+        int value;
+        if (flat_hashmap_get(map, keys[i], strlen(keys[i]) + 1, &value, sizeof(int), NULL) == FLAT_HASHMAP_OK) {
+            printf("键 '%s' 的值为: %d\n", keys[i], value);
+        } else {
+            printf("找不到键 '%s'\n", keys[i]);
+        }
+    }
+
+    // 修改值
+    printf("\n修改键值...\n");
+    int new_value = 100;
+    flat_hashmap_put(map, "banana", strlen("banana") + 1, &new_value, sizeof(int));
+
+    int value;
+    flat_hashmap_get(map, "banana", strlen("banana") + 1, &value, sizeof(int), NULL);
+    printf("修改后 'banana' 的值为: %d\n", value);
+
+    // 超过最大尺寸的键会被拒绝
+    const char *long_key = "this-key-is-definitely-longer-than-32-bytes";
+    printf("插入超长键: %s\n",
+           flat_hashmap_put(map, long_key, strlen(long_key) + 1, &value, sizeof(int)) == FLAT_HASHMAP_ERR ? "拒绝" : "成功");
+
+    // 遍历扁平哈希映射
+    printf("\n遍历扁平哈希映射...\n");
+    flat_hashmap_foreach(map, print_entry, NULL);
+
+    // 检查键是否存在
+    printf("\n检查键是否存在...\n");
+    printf("'apple' 存在: %s\n", flat_hashmap_contains(map, "apple", strlen("apple") + 1) ? "是" : "否");
+    printf("'grape' 存在: %s\n", flat_hashmap_contains(map, "grape", strlen("grape") + 1) ? "是" : "否");
+
+    // 删除键值对
+    printf("\n删除键值对...\n");
+    flat_hashmap_remove(map, "cherry", strlen("cherry") + 1);
+    printf("删除后 'cherry' 存在: %s\n", flat_hashmap_contains(map, "cherry", strlen("cherry") + 1) ? "是" : "否");
+
+    // 再次遍历
+    printf("\n删除后遍历...\n");
+    flat_hashmap_foreach(map, print_entry, NULL);
+
+    // 清空扁平哈希映射
+    printf("\n清空扁平哈希映射...\n");
+    flat_hashmap_clear(map);
+    printf("扁平哈希映射大小: %zu\n", flat_hashmap_size(map));
+
+    // 销毁扁平哈希映射
+    flat_hashmap_destroy(map);
+    printf("\n扁平哈希映射已销毁\n");
+
+    // 大量数据测试，分别使用每种探测方式（不支持的指令集会自动降级）
+    printf("\n大量插入删除测试...\n");
+    int failed = 0;
+    failed |= stress_test(FLAT_HASHMAP_PROBE_SCALAR);
+    failed |= stress_test(FLAT_HASHMAP_PROBE_SSE2);
+    failed |= stress_test(FLAT_HASHMAP_PROBE_AVX2);
+    flat_hashmap_set_default_probe(FLAT_HASHMAP_PROBE_AUTO);
+    failed |= low_load_factor_test();
+    return failed;
+}
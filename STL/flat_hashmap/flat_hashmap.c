@@ -0,0 +1,675 @@
+#include "flat_hashmap.h"
+#include "wyhash.h"
+#include <string.h>
+#include <stdio.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FLAT_HASHMAP_HAVE_X86 1
+#endif
+
+#define FLAT_HASHMAP_DEFAULT_LOAD_FACTOR 0.875f
+#define FLAT_HASHMAP_MAX_LOAD_FACTOR 0.875f
+#define FLAT_HASHMAP_MIN_CAPACITY FLAT_HASHMAP_MAX_PROBE_WIDTH
+#define FLAT_HASHMAP_RESIZE_FACTOR 2
+#define FLAT_HASHMAP_SLOT_ALIGN 8
+
+// 槽位头部，后面依次跟随键和值的内联存储
+typedef struct flat_hashmap_slot {
+    uint32_t key_size;        // 键的实际大小
+    uint32_t value_size;      // 值的实际大小
+} flat_hashmap_slot_t;
+
+// 向上对齐
+static inline size_t align_up(size_t n, size_t align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+// 向上取整到 2 的幂
+static size_t next_pow2(size_t n) {
+    size_t cap = FLAT_HASHMAP_MIN_CAPACITY;
+    while (cap < n) {
+        cap <<= 1;
+    }
+    return cap;
+}
+
+// 指定容量下可以占用的槽位数量，至少保留一个空槽保证探测能够终止
+// 负载因子很小时向下取整可能得到 0，至少允许占用一个槽位，否则表永远无法扩容
+static size_t capacity_to_growth(size_t capacity, float load_factor) {
+    size_t growth = (size_t)((double)capacity * load_factor);
+    if (growth >= capacity) {
+        growth = capacity - 1;
+    }
+    if (growth == 0) {
+        growth = 1;
+    }
+    return growth;
+}
+
+// 对用户哈希值做一次 64 位混合，避免低位分布差或只有 32 位有效的哈希函数导致探测聚集
+static inline uint64_t hash_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// 探测起点使用低 7 位以上的 57 位，容量超过 2^32 时仍能覆盖整张表
+static inline size_t hash_h1(uint64_t hash) {
+    return (size_t)(hash >> 7);
+}
+
+// 控制字节标签使用低 7 位
+static inline uint8_t hash_h2(uint64_t hash) {
+    return (uint8_t)(hash & 0x7f);
+}
+
+// 控制字节是否为占用状态
+static inline bool ctrl_is_full(uint8_t c) {
+    return (c & 0x80) == 0;
+}
+
+// 获取槽位指针
+static inline flat_hashmap_slot_t *slot_at(const flat_hashmap_t *map, size_t index) {
+    return (flat_hashmap_slot_t *)(map->slots + index * map->slot_size);
+}
+
+// 获取槽位中的键
+static inline void *slot_key(flat_hashmap_slot_t *slot) {
+    return (uint8_t *)slot + sizeof(flat_hashmap_slot_t);
+}
+
+// 获取槽位中的值
+static inline void *slot_value(const flat_hashmap_t *map, flat_hashmap_slot_t *slot) {
+    return (uint8_t *)slot + map->value_offset;
+}
+
+// 设置控制字节，头部 MAX_PROBE_WIDTH 个字节同时写入尾部镜像区
+static inline void set_ctrl(flat_hashmap_t *map, size_t index, uint8_t c) {
+    map->ctrl[index] = c;
+    if (index < FLAT_HASHMAP_MAX_PROBE_WIDTH) {
+        map->ctrl[map->capacity + index] = c;
+    }
+}
+
+//-----------------------------
+// 控制组匹配（返回位掩码，第 i 位对应窗口内第 i 个槽位）
+//-----------------------------
+
+// 标量：匹配标签等于 h2 的槽位
+static inline uint32_t group_match_scalar(const uint8_t *group, uint8_t h2) {
+    uint32_t mask = 0;
+    for (int i = 0; i < FLAT_HASHMAP_GROUP_WIDTH; i++) {
+        mask |= (uint32_t)(group[i] == h2) << i;
+    }
+    return mask;
+}
+
+// 标量：匹配空槽位
+static inline uint32_t group_match_empty_scalar(const uint8_t *group) {
+    uint32_t mask = 0;
+    for (int i = 0; i < FLAT_HASHMAP_GROUP_WIDTH; i++) {
+        mask |= (uint32_t)(group[i] == FLAT_HASHMAP_CTRL_EMPTY) << i;
+    }
+    return mask;
+}
+
+// 标量：匹配空槽位或已删除槽位
+static inline uint32_t group_match_empty_or_deleted_scalar(const uint8_t *group) {
+    uint32_t mask = 0;
+    for (int i = 0; i < FLAT_HASHMAP_GROUP_WIDTH; i++) {
+        mask |= (uint32_t)!ctrl_is_full(group[i]) << i;
+    }
+    return mask;
+}
+
+#ifdef FLAT_HASHMAP_HAVE_X86
+// SSE2：一次比较 16 个控制字节
+__attribute__((target("sse2")))
+static inline uint32_t group_match_sse2(const uint8_t *group, uint8_t h2) {
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)h2)));
+}
+
+__attribute__((target("sse2")))
+static inline uint32_t group_match_empty_sse2(const uint8_t *group) {
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)FLAT_HASHMAP_CTRL_EMPTY)));
+}
+
+// 空和已删除的最高位都为 1，直接取符号位
+__attribute__((target("sse2")))
+static inline uint32_t group_match_empty_or_deleted_sse2(const uint8_t *group) {
+    __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(ctrl);
+}
+
+// AVX2：一次比较 32 个控制字节（相邻两个控制组）
+__attribute__((target("avx2")))
+static inline uint32_t group_match_avx2(const uint8_t *group, uint8_t h2) {
+    __m256i ctrl = _mm256_loadu_si256((const __m256i *)group);
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8((char)h2)));
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t group_match_empty_avx2(const uint8_t *group) {
+    __m256i ctrl = _mm256_loadu_si256((const __m256i *)group);
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8((char)FLAT_HASHMAP_CTRL_EMPTY)));
+}
+
+__attribute__((target("avx2")))
+static inline uint32_t group_match_empty_or_deleted_avx2(const uint8_t *group) {
+    __m256i ctrl = _mm256_loadu_si256((const __m256i *)group);
+    return (uint32_t)_mm256_movemask_epi8(ctrl);
+}
+#endif
+
+// 之后创建的映射默认使用的探测方式
+static flat_hashmap_probe_t g_default_probe = FLAT_HASHMAP_PROBE_AUTO;
+
+// 探测方式名称
+static const char *flat_hashmap_probe_names[] = {
+    "Auto",
+    "Scalar",
+    "SSE2",
+    "AVX2"
+};
+
+// 按 CPU 支持情况确定探测方式，不支持时逐级降级
+static flat_hashmap_probe_t resolve_probe(flat_hashmap_probe_t probe) {
+#ifdef FLAT_HASHMAP_HAVE_X86
+    __builtin_cpu_init();
+    bool has_avx2 = __builtin_cpu_supports("avx2");
+    bool has_sse2 = __builtin_cpu_supports("sse2");
+
+    if (probe == FLAT_HASHMAP_PROBE_AUTO || probe == FLAT_HASHMAP_PROBE_AVX2) {
+        if (has_avx2) {
+            return FLAT_HASHMAP_PROBE_AVX2;
+        }
+        probe = FLAT_HASHMAP_PROBE_SSE2;
+    }
+    if (probe == FLAT_HASHMAP_PROBE_SSE2 && has_sse2) {
+        return FLAT_HASHMAP_PROBE_SSE2;
+    }
+#endif
+    return FLAT_HASHMAP_PROBE_SCALAR;
+}
+
+// 探测方式对应的窗口宽度
+static size_t probe_width_of(flat_hashmap_probe_t probe) {
+    return probe == FLAT_HASHMAP_PROBE_AVX2 ? FLAT_HASHMAP_MAX_PROBE_WIDTH : FLAT_HASHMAP_GROUP_WIDTH;
+}
+
+// 设置默认探测方式
+void flat_hashmap_set_default_probe(flat_hashmap_probe_t probe) {
+    g_default_probe = probe;
+}
+
+// 获取映射实际使用的探测方式
+flat_hashmap_probe_t flat_hashmap_get_probe(const flat_hashmap_t *map) {
+    return map ? map->probe : FLAT_HASHMAP_PROBE_AUTO;
+}
+
+// 获取探测方式名称
+const char *flat_hashmap_probe_name(flat_hashmap_probe_t probe) {
+    if (probe >= FLAT_HASHMAP_PROBE_AUTO && probe <= FLAT_HASHMAP_PROBE_AVX2) {
+        return flat_hashmap_probe_names[probe];
+    }
+    return "Unknown";
+}
+
+// 进程级哈希种子，启动时随机生成，抵御针对固定哈希函数构造碰撞键的哈希洪水攻击
+static uint64_t flat_hashmap_hash_seed;
+
+__attribute__((constructor))
+static void flat_hashmap_hash_seed_init(void) {
+    flat_hashmap_hash_seed = wyhash_seed_random();
+}
+
+// 字符串哈希函数 - 带种子的 64 位 wyhash
+uint64_t flat_hashmap_hash_string(const void *key, size_t key_size) {
+    return wyhash(key, strlen((const char *)key), flat_hashmap_hash_seed);
+}
+
+// 数据哈希函数 - 带种子的 64 位 wyhash
+uint64_t flat_hashmap_hash_data(const void *key, size_t key_size) {
+    return wyhash(key, key_size, flat_hashmap_hash_seed);
+}
+
+// 字符串比较函数
+int flat_hashmap_compare_string(const void *key1, size_t key1_size,
+                                const void *key2, size_t key2_size) {
+    return strcmp((const char *)key1, (const char *)key2);
+}
+
+// 数据比较函数
+int flat_hashmap_compare_data(const void *key1, size_t key1_size,
+                              const void *key2, size_t key2_size) {
+    if (key1_size != key2_size) {
+        return key1_size < key2_size ? -1 : 1;
+    }
+    return memcmp(key1, key2, key1_size);
+}
+
+// 分配控制字节和槽位数组
+static flat_hashmap_status_t alloc_table(flat_hashmap_t *map, size_t capacity,
+                                         uint8_t **ctrl_out, uint8_t **slots_out) {
+    uint8_t *ctrl = (uint8_t *)malloc(capacity + FLAT_HASHMAP_MAX_PROBE_WIDTH);
+    if (!ctrl) {
+        return FLAT_HASHMAP_NOMEM;
+    }
+
+    uint8_t *slots = (uint8_t *)malloc(capacity * map->slot_size);
+    if (!slots) {
+        free(ctrl);
+        return FLAT_HASHMAP_NOMEM;
+    }
+
+    memset(ctrl, FLAT_HASHMAP_CTRL_EMPTY, capacity + FLAT_HASHMAP_MAX_PROBE_WIDTH);
+    *ctrl_out = ctrl;
+    *slots_out = slots;
+    return FLAT_HASHMAP_OK;
+}
+
+// 创建扁平哈希映射
+flat_hashmap_t* flat_hashmap_create(size_t max_key_size, size_t max_value_size,
+                                    size_t initial_capacity, float load_factor,
+                                    flat_hashmap_hash_fn hash_fn,
+                                    flat_hashmap_key_compare_fn key_compare_fn) {
+    // 参数验证
+    if (max_key_size == 0 || max_key_size > UINT32_MAX || max_value_size > UINT32_MAX) {
+        return NULL;
+    }
+    if (load_factor <= 0.0f || load_factor > FLAT_HASHMAP_MAX_LOAD_FACTOR) {
+        load_factor = FLAT_HASHMAP_DEFAULT_LOAD_FACTOR;
+    }
+
+    // 分配映射结构
+    flat_hashmap_t *map = (flat_hashmap_t*)malloc(sizeof(flat_hashmap_t));
+    if (!map) {
+        return NULL;
+    }
+
+    // 计算槽位布局：头部 | 键 | 值
+    map->max_key_size = max_key_size;
+    map->max_value_size = max_value_size;
+    map->value_offset = align_up(sizeof(flat_hashmap_slot_t) + max_key_size, FLAT_HASHMAP_SLOT_ALIGN);
+    map->slot_size = align_up(map->value_offset + max_value_size, FLAT_HASHMAP_SLOT_ALIGN);
+
+    // 探测方式决定窗口宽度，创建后不再改变
+    map->probe = resolve_probe(g_default_probe);
+    map->probe_width = probe_width_of(map->probe);
+
+    // 分配控制字节和槽位
+    size_t capacity = next_pow2(initial_capacity);
+    if (alloc_table(map, capacity, &map->ctrl, &map->slots) != FLAT_HASHMAP_OK) {
+        free(map);
+        return NULL;
+    }
+
+    // 初始化属性
+    map->size = 0;
+    map->capacity = capacity;
+    map->load_factor = load_factor;
+    map->growth_left = capacity_to_growth(capacity, load_factor);
+    map->hash_fn = hash_fn ? hash_fn : flat_hashmap_hash_string;
+    map->key_compare_fn = key_compare_fn ? key_compare_fn : flat_hashmap_compare_string;
+
+    return map;
+}
+
+// 销毁扁平哈希映射
+void flat_hashmap_destroy(flat_hashmap_t *map) {
+    if (!map) {
+        return;
+    }
+
+    free(map->ctrl);
+    free(map->slots);
+    free(map);
+}
+
+// 清空扁平哈希映射
+void flat_hashmap_clear(flat_hashmap_t *map) {
+    if (!map) {
+        return;
+    }
+
+    // 键值内联存储，只需重置控制字节
+    memset(map->ctrl, FLAT_HASHMAP_CTRL_EMPTY, map->capacity + FLAT_HASHMAP_MAX_PROBE_WIDTH);
+    map->size = 0;
+    map->growth_left = capacity_to_growth(map->capacity, map->load_factor);
+}
+
+// 获取键值对数量
+size_t flat_hashmap_size(const flat_hashmap_t *map) {
+    return map ? map->size : 0;
+}
+
+/*
+ * 生成某一种探测方式的查找函数，组匹配函数与探测循环放在同一个目标指令集下，
+ * 保证向量比较能够内联进循环
+ *
+ * find_index: 查找键所在的槽位，找不到返回 SIZE_MAX
+ * find_first_non_full: 查找第一个可插入的槽位（空槽位或已删除槽位）
+ */
+#define FLAT_HASHMAP_DEFINE_PROBE(suffix, attr, width)                                  \
+attr static size_t find_index_##suffix(const flat_hashmap_t *map,                      \
+                                       const void *key, size_t key_size,               \
+                                       uint64_t hash) {                                \
+    size_t mask = map->capacity - 1;                                                   \
+    size_t pos = hash_h1(hash) & mask;                                                 \
+    size_t step = 0;                                                                   \
+    uint8_t h2 = hash_h2(hash);                                                        \
+                                                                                       \
+    for (;;) {                                                                         \
+        const uint8_t *group = map->ctrl + pos;                                        \
+                                                                                       \
+        /* 先按标签过滤，标签命中后再比较键内容 */                                     \
+        uint32_t match = group_match_##suffix(group, h2);                              \
+        while (match) {                                                                \
+            size_t index = (pos + __builtin_ctz(match)) & mask;                        \
+            flat_hashmap_slot_t *slot = slot_at(map, index);                           \
+            if (map->key_compare_fn(slot_key(slot), slot->key_size, key, key_size) == 0) { \
+                return index;                                                          \
+            }                                                                          \
+            match &= match - 1;                                                        \
+        }                                                                              \
+                                                                                       \
+        /* 窗口内有空槽位说明键不存在 */                                               \
+        if (group_match_empty_##suffix(group)) {                                       \
+            return SIZE_MAX;                                                           \
+        }                                                                              \
+                                                                                       \
+        /* 三角探测，按窗口宽度跳跃，容量为 2 的幂时可以覆盖所有窗口 */                \
+        step += (width);                                                               \
+        pos = (pos + step) & mask;                                                     \
+    }                                                                                  \
+}                                                                                      \
+                                                                                       \
+attr static size_t find_first_non_full_##suffix(const flat_hashmap_t *map,             \
+                                                uint64_t hash) {                       \
+    size_t mask = map->capacity - 1;                                                   \
+    size_t pos = hash_h1(hash) & mask;                                                 \
+    size_t step = 0;                                                                   \
+                                                                                       \
+    for (;;) {                                                                         \
+        uint32_t match = group_match_empty_or_deleted_##suffix(map->ctrl + pos);       \
+        if (match) {                                                                   \
+            return (pos + __builtin_ctz(match)) & mask;                                \
+        }                                                                              \
+        step += (width);                                                               \
+        pos = (pos + step) & mask;                                                     \
+    }                                                                                  \
+}
+
+FLAT_HASHMAP_DEFINE_PROBE(scalar, , FLAT_HASHMAP_GROUP_WIDTH)
+#ifdef FLAT_HASHMAP_HAVE_X86
+FLAT_HASHMAP_DEFINE_PROBE(sse2, __attribute__((target("sse2"))), FLAT_HASHMAP_GROUP_WIDTH)
+FLAT_HASHMAP_DEFINE_PROBE(avx2, __attribute__((target("avx2"))), FLAT_HASHMAP_MAX_PROBE_WIDTH)
+#endif
+
+// 按映射的探测方式分发查找
+static inline size_t flat_hashmap_find_index(const flat_hashmap_t *map,
+                                             const void *key, size_t key_size,
+                                             uint64_t hash) {
+    switch (map->probe) {
+#ifdef FLAT_HASHMAP_HAVE_X86
+        case FLAT_HASHMAP_PROBE_AVX2:
+            return find_index_avx2(map, key, key_size, hash);
+        case FLAT_HASHMAP_PROBE_SSE2:
+            return find_index_sse2(map, key, key_size, hash);
+#endif
+        default:
+            return find_index_scalar(map, key, key_size, hash);
+    }
+}
+
+// 按映射的探测方式分发空槽位查找
+static inline size_t find_first_non_full(const flat_hashmap_t *map, uint64_t hash) {
+    switch (map->probe) {
+#ifdef FLAT_HASHMAP_HAVE_X86
+        case FLAT_HASHMAP_PROBE_AVX2:
+            return find_first_non_full_avx2(map, hash);
+        case FLAT_HASHMAP_PROBE_SSE2:
+            return find_first_non_full_sse2(map, hash);
+#endif
+        default:
+            return find_first_non_full_scalar(map, hash);
+    }
+}
+
+// 按映射的探测方式匹配一个窗口内的空槽位
+static uint32_t window_match_empty(const flat_hashmap_t *map, const uint8_t *window) {
+    switch (map->probe) {
+#ifdef FLAT_HASHMAP_HAVE_X86
+        case FLAT_HASHMAP_PROBE_AVX2:
+            return group_match_empty_avx2(window);
+        case FLAT_HASHMAP_PROBE_SSE2:
+            return group_match_empty_sse2(window);
+#endif
+        default:
+            return group_match_empty_scalar(window);
+    }
+}
+
+// 执行重新哈希，同时清理所有已删除标记
+static flat_hashmap_status_t flat_hashmap_rehash(flat_hashmap_t *map, size_t new_capacity) {
+    uint8_t *old_ctrl = map->ctrl;
+    uint8_t *old_slots = map->slots;
+    size_t old_capacity = map->capacity;
+
+    // 分配新表
+    uint8_t *new_ctrl, *new_slots;
+    flat_hashmap_status_t status = alloc_table(map, new_capacity, &new_ctrl, &new_slots);
+    if (status != FLAT_HASHMAP_OK) {
+        return status;
+    }
+
+    map->ctrl = new_ctrl;
+    map->slots = new_slots;
+    map->capacity = new_capacity;
+
+    // 将所有占用槽位搬到新表
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (!ctrl_is_full(old_ctrl[i])) {
+            continue;
+        }
+
+        flat_hashmap_slot_t *old_slot = (flat_hashmap_slot_t *)(old_slots + i * map->slot_size);
+        uint64_t hash = hash_mix(map->hash_fn(slot_key(old_slot), old_slot->key_size));
+        size_t index = find_first_non_full(map, hash);
+
+        set_ctrl(map, index, hash_h2(hash));
+        memcpy(slot_at(map, index), old_slot, map->slot_size);
+    }
+
+    map->growth_left = capacity_to_growth(new_capacity, map->load_factor) - map->size;
+
+    free(old_ctrl);
+    free(old_slots);
+
+    return FLAT_HASHMAP_OK;
+}
+
+// 空槽位用尽时扩容；删除标记较多时原地重建即可
+static flat_hashmap_status_t rehash_and_grow(flat_hashmap_t *map) {
+    size_t growth = capacity_to_growth(map->capacity, map->load_factor);
+    if (map->size <= growth / 2) {
+        return flat_hashmap_rehash(map, map->capacity);
+    }
+
+    // 扩容后必须还有空余的占用名额，负载因子很小时一次翻倍可能不够
+    size_t capacity = map->capacity * FLAT_HASHMAP_RESIZE_FACTOR;
+    while (capacity_to_growth(capacity, map->load_factor) <= map->size) {
+        capacity <<= 1;
+    }
+    return flat_hashmap_rehash(map, capacity);
+}
+
+// 写入槽位内容
+static void write_slot(flat_hashmap_t *map, flat_hashmap_slot_t *slot,
+                       const void *key, size_t key_size,
+                       const void *value, size_t value_size) {
+    slot->key_size = (uint32_t)key_size;
+    memcpy(slot_key(slot), key, key_size);
+    slot->value_size = (uint32_t)value_size;
+    if (value_size) {
+        memcpy(slot_value(map, slot), value, value_size);
+    }
+}
+
+// 插入键值对
+flat_hashmap_status_t flat_hashmap_put(flat_hashmap_t *map, const void *key, size_t key_size,
+                                       const void *value, size_t value_size) {
+    if (!map || !key || (!value && value_size)) {
+        return FLAT_HASHMAP_ERR;
+    }
+    if (key_size > map->max_key_size || value_size > map->max_value_size) {
+        return FLAT_HASHMAP_ERR;
+    }
+
+    // 计算哈希值
+    uint64_t hash = hash_mix(map->hash_fn(key, key_size));
+
+    // 更新现有值
+    size_t index = flat_hashmap_find_index(map, key, key_size, hash);
+    if (index != SIZE_MAX) {
+        flat_hashmap_slot_t *slot = slot_at(map, index);
+        slot->value_size = (uint32_t)value_size;
+        if (value_size) {
+            memcpy(slot_value(map, slot), value, value_size);
+        }
+        return FLAT_HASHMAP_OK;
+    }
+
+    // 复用已删除槽位不消耗空槽；占用空槽且已无余量时先扩容
+    index = find_first_non_full(map, hash);
+    if (map->growth_left == 0 && map->ctrl[index] == FLAT_HASHMAP_CTRL_EMPTY) {
+        flat_hashmap_status_t status = rehash_and_grow(map);
+        if (status != FLAT_HASHMAP_OK) {
+            return status;
+        }
+        index = find_first_non_full(map, hash);
+    }
+
+    if (map->ctrl[index] == FLAT_HASHMAP_CTRL_EMPTY) {
+        map->growth_left--;
+    }
+
+    set_ctrl(map, index, hash_h2(hash));
+    write_slot(map, slot_at(map, index), key, key_size, value, value_size);
+    map->size++;
+
+    return FLAT_HASHMAP_OK;
+}
+
+// 获取键对应的值
+flat_hashmap_status_t flat_hashmap_get(const flat_hashmap_t *map, const void *key, size_t key_size,
+                                       void *value, size_t value_size, size_t *actual_size) {
+    if (!map || !key) {
+        return FLAT_HASHMAP_ERR;
+    }
+
+    uint64_t hash = hash_mix(map->hash_fn(key, key_size));
+    size_t index = flat_hashmap_find_index(map, key, key_size, hash);
+    if (index == SIZE_MAX) {
+        return FLAT_HASHMAP_NOT_FOUND;
+    }
+
+    flat_hashmap_slot_t *slot = slot_at(map, index);
+
+    // 返回实际值大小
+    if (actual_size) {
+        *actual_size = slot->value_size;
+    }
+
+    // 复制值
+    if (value) {
+        size_t copy_size = (value_size < slot->value_size) ? value_size : slot->value_size;
+        memcpy(value, slot_value(map, slot), copy_size);
+    }
+
+    return FLAT_HASHMAP_OK;
+}
+
+// 移除键值对
+flat_hashmap_status_t flat_hashmap_remove(flat_hashmap_t *map, const void *key, size_t key_size) {
+    if (!map || !key) {
+        return FLAT_HASHMAP_ERR;
+    }
+
+    uint64_t hash = hash_mix(map->hash_fn(key, key_size));
+    size_t index = flat_hashmap_find_index(map, key, key_size, hash);
+    if (index == SIZE_MAX) {
+        return FLAT_HASHMAP_NOT_FOUND;
+    }
+
+    // 如果包含该槽位的任意连续 probe_width 个槽位从未全部占满，
+    // 就不会有探测越过它，可以直接标记为空，否则留下删除标记
+    size_t width = map->probe_width;
+    size_t mask = map->capacity - 1;
+    size_t index_before = (index - width) & mask;
+    uint32_t empty_after = window_match_empty(map, map->ctrl + index);
+    uint32_t empty_before = window_match_empty(map, map->ctrl + index_before);
+    bool was_never_full = empty_after && empty_before &&
+        (size_t)(__builtin_ctz(empty_after) +
+                 __builtin_clz(empty_before) - (32 - width)) < width;
+
+    if (was_never_full) {
+        set_ctrl(map, index, FLAT_HASHMAP_CTRL_EMPTY);
+        map->growth_left++;
+    } else {
+        set_ctrl(map, index, FLAT_HASHMAP_CTRL_DELETED);
+    }
+    map->size--;
+
+    return FLAT_HASHMAP_OK;
+}
+
+// 检查键是否存在
+bool flat_hashmap_contains(const flat_hashmap_t *map, const void *key, size_t key_size) {
+    if (!map || !key) {
+        return false;
+    }
+
+    uint64_t hash = hash_mix(map->hash_fn(key, key_size));
+    return flat_hashmap_find_index(map, key, key_size, hash) != SIZE_MAX;
+}
+
+// 遍历扁平哈希映射
+void flat_hashmap_foreach(const flat_hashmap_t *map, flat_hashmap_foreach_fn fn, void *user_data) {
+    if (!map || !fn) {
+        return;
+    }
+
+    // 顺序扫描控制字节数组
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (!ctrl_is_full(map->ctrl[i])) {
+            continue;
+        }
+
+        flat_hashmap_slot_t *slot = slot_at(map, i);
+        if (!fn(slot_key(slot), slot->key_size, slot_value(map, slot), slot->value_size, user_data)) {
+            return; // 中断遍历
+        }
+    }
+}
+
+// 重新设置槽位容量
+flat_hashmap_status_t flat_hashmap_resize(flat_hashmap_t *map, size_t new_capacity) {
+    if (!map) {
+        return FLAT_HASHMAP_ERR;
+    }
+
+    // 新容量必须能容纳现有键值对
+    size_t capacity = next_pow2(new_capacity);
+    while (capacity_to_growth(capacity, map->load_factor) < map->size) {
+        capacity <<= 1;
+    }
+
+    return flat_hashmap_rehash(map, capacity);
+}
@@ -0,0 +1,250 @@
+#ifndef __FLAT_HASHMAP_H__
+#define __FLAT_HASHMAP_H__
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * 开放寻址扁平哈希表（Swiss Table 风格）
+ *
+ * 主要特性：
+ * 1. 键值内联存储在连续的槽位数组中，没有逐项 malloc，查找不需要追指针
+ * 2. 每个槽位对应一个控制字节：空 / 已删除 / 哈希值低 7 位标签
+ * 3. 按 FLAT_HASHMAP_GROUP_WIDTH 个控制字节为一组探测，组内先比较标签再比较键
+ *    支持 SSE2/AVX2 时一条向量比较即可扫描整组，创建时通过 CPUID 选择探测方式
+ * 4. 接口语义与 STL/hashmap 的 put/get/remove/contains/foreach 保持一致
+ *
+ * 键和值按创建时给定的最大尺寸内联存储，超过最大尺寸的键值会被拒绝。
+ * 扩容会移动槽位，通过 foreach 拿到的值指针在下一次插入后可能失效。
+ */
+
+/**
+ * 扁平哈希映射状态码
+ */
+typedef enum {
+    FLAT_HASHMAP_OK = 0,            // 操作成功
+    FLAT_HASHMAP_ERR = -1,          // 一般错误（参数错误或键值超过最大尺寸）
+    FLAT_HASHMAP_DUPLICATE = -2,    // 键已存在
+    FLAT_HASHMAP_NOT_FOUND = -3,    // 键不存在
+    FLAT_HASHMAP_NOMEM = -4,        // 内存分配失败
+} flat_hashmap_status_t;
+
+// 控制组宽度（一次探测扫描的控制字节数）
+#define FLAT_HASHMAP_GROUP_WIDTH 16
+
+// 最大探测宽度（AVX2 一次扫描两个控制组），控制字节尾部镜像区的大小
+#define FLAT_HASHMAP_MAX_PROBE_WIDTH 32
+
+/**
+ * 控制组探测方式
+ */
+typedef enum {
+    FLAT_HASHMAP_PROBE_AUTO = 0,    // 根据 CPUID 自动选择
+    FLAT_HASHMAP_PROBE_SCALAR,      // 标量逐字节比较
+    FLAT_HASHMAP_PROBE_SSE2,        // SSE2 一次比较 16 个控制字节
+    FLAT_HASHMAP_PROBE_AVX2,        // AVX2 一次比较 32 个控制字节
+} flat_hashmap_probe_t;
+
+// 控制字节取值：最高位为 1 表示空或已删除，最高位为 0 表示占用（低 7 位为哈希标签）
+#define FLAT_HASHMAP_CTRL_EMPTY   ((uint8_t)0x80)
+#define FLAT_HASHMAP_CTRL_DELETED ((uint8_t)0xFE)
+
+/**
+ * 哈希函数类型定义
+ * 返回 64 位哈希值：低 7 位作为控制字节标签，其余位决定探测起点，
+ * 槽位数超过 2^25 时 32 位哈希值无法均匀覆盖整张表
+ */
+typedef uint64_t (*flat_hashmap_hash_fn)(const void *key, size_t key_size);
+
+/**
+ * 键比较函数类型定义
+ */
+typedef int (*flat_hashmap_key_compare_fn)(const void *key1, size_t key1_size,
+                                          const void *key2, size_t key2_size);
+
+/**
+ * 遍历回调函数类型
+ */
+typedef bool (*flat_hashmap_foreach_fn)(const void *key, size_t key_size,
+                                       void *value, size_t value_size,
+                                       void *user_data);
+
+/**
+ * 扁平哈希映射结构
+ */
+typedef struct flat_hashmap {
+    size_t size;              // 键值对数量
+    size_t capacity;          // 槽位数量（2 的幂）
+    size_t growth_left;       // 触发扩容前还能占用的空槽数量
+    float load_factor;        // 负载因子
+
+    size_t max_key_size;      // 键的最大尺寸
+    size_t max_value_size;    // 值的最大尺寸
+    size_t value_offset;      // 槽位内值的偏移
+    size_t slot_size;         // 单个槽位大小
+
+    flat_hashmap_probe_t probe;   // 探测方式（创建时确定）
+    size_t probe_width;           // 每步探测扫描的控制字节数
+
+    uint8_t *ctrl;            // 控制字节数组（capacity + MAX_PROBE_WIDTH，尾部镜像头部）
+    uint8_t *slots;           // 槽位数组（键值内联存储）
+
+    flat_hashmap_hash_fn hash_fn;                 // 哈希函数
+    flat_hashmap_key_compare_fn key_compare_fn;   // 键比较函数
+} flat_hashmap_t;
+
+/**
+ * 创建扁平哈希映射
+ * @param max_key_size 键的最大尺寸
+ * @param max_value_size 值的最大尺寸
+ * @param initial_capacity 初始槽位数量（向上取整到 2 的幂）
+ * @param load_factor 负载因子，超过此值将扩容（最大 0.875）
+ * @param hash_fn 哈希函数
+ * @param key_compare_fn 键比较函数
+ * @return 扁平哈希映射对象，失败返回NULL
+ */
+flat_hashmap_t* flat_hashmap_create(size_t max_key_size, size_t max_value_size,
+                                    size_t initial_capacity, float load_factor,
+                                    flat_hashmap_hash_fn hash_fn,
+                                    flat_hashmap_key_compare_fn key_compare_fn);
+
+/**
+ * 销毁扁平哈希映射
+ * @param map 扁平哈希映射对象
+ */
+void flat_hashmap_destroy(flat_hashmap_t *map);
+
+/**
+ * 清空扁平哈希映射（保留容量）
+ * @param map 扁平哈希映射对象
+ */
+void flat_hashmap_clear(flat_hashmap_t *map);
+
+/**
+ * 获取键值对数量
+ * @param map 扁平哈希映射对象
+ * @return 键值对数量
+ */
+size_t flat_hashmap_size(const flat_hashmap_t *map);
+
+/**
+ * 插入键值对，键已存在时覆盖值
+ * @param map 扁平哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小（不超过 max_key_size）
+ * @param value 值
+ * @param value_size 值的大小（不超过 max_value_size）
+ * @return 状态码
+ */
+flat_hashmap_status_t flat_hashmap_put(flat_hashmap_t *map, const void *key, size_t key_size,
+                                       const void *value, size_t value_size);
+
+/**
+ * 获取键对应的值
+ * @param map 扁平哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @param value 用于存储值的缓冲区
+ * @param value_size 缓冲区大小
+ * @param actual_size 实际值的大小（可为NULL）
+ * @return 状态码
+ */
+flat_hashmap_status_t flat_hashmap_get(const flat_hashmap_t *map, const void *key, size_t key_size,
+                                       void *value, size_t value_size, size_t *actual_size);
+
+/**
+ * 移除键值对
+ * @param map 扁平哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @return 状态码
+ */
+flat_hashmap_status_t flat_hashmap_remove(flat_hashmap_t *map, const void *key, size_t key_size);
+
+/**
+ * 检查键是否存在
+ * @param map 扁平哈希映射对象
+ * @param key 键
+ * @param key_size 键的大小
+ * @return true表示存在，false表示不存在
+ */
+bool flat_hashmap_contains(const flat_hashmap_t *map, const void *key, size_t key_size);
+
+/**
+ * 遍历扁平哈希映射
+ * @param map 扁平哈希映射对象
+ * @param fn 回调函数，返回false中断遍历（回调中不能插入或删除）
+ * @param user_data 用户数据
+ */
+void flat_hashmap_foreach(const flat_hashmap_t *map, flat_hashmap_foreach_fn fn, void *user_data);
+
+/**
+ * 重新设置槽位容量
+ * @param map 扁平哈希映射对象
+ * @param new_capacity 新容量（向上取整到 2 的幂，且能容纳现有键值对）
+ * @return 状态码
+ */
+flat_hashmap_status_t flat_hashmap_resize(flat_hashmap_t *map, size_t new_capacity);
+
+/**
+ * 设置之后创建的映射使用的探测方式
+ * 指定的指令集不可用时自动降级（AVX2 -> SSE2 -> 标量）
+ * @param probe 探测方式，FLAT_HASHMAP_PROBE_AUTO 为根据 CPUID 选择
+ */
+void flat_hashmap_set_default_probe(flat_hashmap_probe_t probe);
+
+/**
+ * 获取映射实际使用的探测方式
+ * @param map 扁平哈希映射对象
+ * @return 探测方式
+ */
+flat_hashmap_probe_t flat_hashmap_get_probe(const flat_hashmap_t *map);
+
+/**
+ * 获取探测方式名称
+ * @param probe 探测方式
+ * @return 名称字符串
+ */
+const char *flat_hashmap_probe_name(flat_hashmap_probe_t probe);
+
+/**
+ * 默认字符串哈希函数（wyhash，按 '\0' 结尾的字符串内容计算）
+ * 种子在进程启动时随机生成，同一进程内结果稳定，不同进程之间不同
+ * @param key 键
+ * @param key_size 键的大小
+ * @return 哈希值
+ */
+uint64_t flat_hashmap_hash_string(const void *key, size_t key_size);
+
+/**
+ * 默认数据哈希函数（wyhash，种子同上）
+ * @param key 键
+ * @param key_size 键的大小
+ * @return 哈希值
+ */
+uint64_t flat_hashmap_hash_data(const void *key, size_t key_size);
+
+/**
+ * 默认字符串比较函数
+ * @param key1 第一个键
+ * @param key1_size 第一个键的大小
+ * @param key2 第二个键
+ * @param key2_size 第二个键的大小
+ * @return 比较结果
+ */
+int flat_hashmap_compare_string(const void *key1, size_t key1_size,
+                                const void *key2, size_t key2_size);
+
+/**
+ * 默认数据比较函数
+ * @param key1 第一个键
+ * @param key1_size 第一个键的大小
+ * @param key2 第二个键
+ * @param key2_size 第二个键的大小
+ * @return 比较结果
+ */
+int flat_hashmap_compare_data(const void *key1, size_t key1_size,
+                              const void *key2, size_t key2_size);
+
+#endif /* __FLAT_HASHMAP_H__ */
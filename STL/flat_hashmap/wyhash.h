@@ -0,0 +1,48 @@
+#ifndef WYHASH_H
+#define WYHASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * wyhash 64 位哈希（final4 版本的构造）
+ *
+ * 每步处理 48 字节（三路并行的 64x64->128 位乘法混合），
+ * 16 字节以内的短键只需要两次乘法，适合做哈希表的键哈希。
+ * 带种子的版本可以抵御针对固定哈希函数构造碰撞键的哈希洪水攻击。
+ * 不是密码学哈希，不能用于签名或完整性校验。
+ */
+
+/**
+ * 计算 64 位哈希值
+ * @param key 输入数据指针
+ * @param len 输入数据长度
+ * @param seed 种子
+ * @return 64 位哈希值
+ */
+uint64_t wyhash(const void *key, size_t len, uint64_t seed);
+
+/**
+ * 计算 32 位哈希值（64 位结果高低两半异或折叠）
+ * @param key 输入数据指针
+ * @param len 输入数据长度
+ * @param seed 种子
+ * @return 32 位哈希值
+ */
+uint32_t wyhash32(const void *key, size_t len, uint64_t seed);
+
+/**
+ * 计算 64 位整数的哈希值，等价于对其 8 字节小端表示调用 wyhash
+ * @param value 整数
+ * @param seed 种子
+ * @return 64 位哈希值
+ */
+uint64_t wyhash_u64(uint64_t value, uint64_t seed);
+
+/**
+ * 从系统熵源生成随机种子（不可用时退化为时间和地址混合）
+ * @return 种子
+ */
+uint64_t wyhash_seed_random(void);
+
+#endif // WYHASH_H
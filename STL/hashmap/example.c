@@ -1,6 +1,7 @@
 #include "hashmap.h"
 #include <stdio.h>
 #include <string.h>
+#include <time.h>
 
 // 用于遍历的回调函数
 bool print_entry(const void *key, size_t key_size,
@@ -10,6 +11,251 @@ bool print_entry(const void *key, size_t key_size,
     return 1;
 }
 
+// 获取单调时钟（纳秒）
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// 比较两种重新哈希模式下单次 put 的最大停顿，并校验数据完整性
+static int rehash_mode_test(hashmap_rehash_mode_t mode) {
+    const int count = 1000000;
+    hashmap_t *map = hashmap_create(16, 0.75f, hashmap_hash_data, hashmap_compare_data);
+    if (!map) {
+        return 1;
+    }
+    hashmap_set_rehash_mode(map, mode);
+
+    long long max_put = 0;
+    for (int i = 0; i < count; i++) {
+        long long start = now_ns();
+        hashmap_put(map, &i, sizeof(int), &i, sizeof(int));
+        long long cost = now_ns() - start;
+        if (cost > max_put) {
+            max_put = cost;
+        }
+    }
+
+    // 迁移期间删除和查询都要能找到尚未迁移的旧桶中的键
+    int errors = 0;
+    for (int i = 0; i < count; i += 3) {
+        if (hashmap_remove(map, &i, sizeof(int)) != HASHMAP_OK) {
+            errors++;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        bool expected = (i % 3) != 0;
+        if (hashmap_contains(map, &i, sizeof(int)) != expected) {
+            errors++;
+        }
+    }
+
+    printf("%s: 最大单次 put 耗时 %.3f ms, 迁移中: %s, 大小: %zu, 错误数: %d\n",
+           mode == HASHMAP_REHASH_BLOCKING ? "阻塞式" : "渐进式",
+           max_put / 1e6, hashmap_is_rehashing(map) ? "是" : "否",
+           hashmap_size(map), errors);
+
+    hashmap_destroy(map);
+    return errors != 0;
+}
+
+// 比较两种内存分配模式下插入和清空的耗时，并校验数据完整性
+static int alloc_mode_test(hashmap_alloc_mode_t mode) {
+    const int count = 1000000;
+    hashmap_t *map = hashmap_create(count * 2, 0.75f, hashmap_hash_data, hashmap_compare_data);
+    if (!map || hashmap_set_alloc_mode(map, mode) != HASHMAP_OK) {
+        hashmap_destroy(map);
+        return 1;
+    }
+
+    int errors = 0;
+    long long start = now_ns();
+    for (int i = 0; i < count; i++) {
+        hashmap_put(map, &i, sizeof(int), &i, sizeof(int));
+    }
+    long long put_cost = now_ns() - start;
+
+    // 大值、更新和接管的缓冲区混合在一起
+    char big[1024];
+    memset(big, 'x', sizeof(big));
+    for (int i = 0; i < count; i += 1000) {
+        hashmap_put(map, &i, sizeof(int), big, sizeof(big));
+    }
+    for (int i = 1; i < count; i += 1000) {
+        int *key = malloc(sizeof(int));
+        int *value = malloc(sizeof(int));
+        *key = i;
+        *value = -i;
+        if (hashmap_put_owned(map, key, sizeof(int), value, sizeof(int)) != HASHMAP_OK) {
+            free(key);
+            free(value);
+        }
+    }
+    for (int i = 2; i < count; i += 1000) {
+        void *slot;
+        if (hashmap_emplace(map, &i, sizeof(int), sizeof(big), &slot) == HASHMAP_OK) {
+            memcpy(slot, big, sizeof(big));
+        }
+    }
+    for (int i = 3; i < count; i += 1000) {
+        hashmap_remove(map, &i, sizeof(int));
+    }
+
+    for (int i = 0; i < count; i++) {
+        void *ref;
+        size_t size;
+        hashmap_status_t status = hashmap_get_ref(map, &i, sizeof(int), &ref, &size);
+        switch (i % 1000) {
+        case 0:
+        case 2:
+            errors += status != HASHMAP_OK || size != sizeof(big) || memcmp(ref, big, sizeof(big)) != 0;
+            break;
+        case 1:
+            errors += status != HASHMAP_OK || *(int *)ref != -i;
+            break;
+        case 3:
+            errors += status != HASHMAP_NOT_FOUND;
+            break;
+        default:
+            errors += status != HASHMAP_OK || *(int *)ref != i;
+            break;
+        }
+    }
+
+    start = now_ns();
+    hashmap_clear(map);
+    long long clear_cost = now_ns() - start;
+
+    // 清空后映射仍可继续使用
+    for (int i = 0; i < 1000; i++) {
+        hashmap_put(map, &i, sizeof(int), &i, sizeof(int));
+    }
+    errors += hashmap_size(map) != 1000;
+
+    printf("%s: 插入 %.1f ms, 清空 %.1f ms, 错误数: %d\n",
+           mode == HASHMAP_ALLOC_MALLOC ? "malloc" : "slab",
+           put_cost / 1e6, clear_cost / 1e6, errors);
+
+    hashmap_destroy(map);
+    return errors != 0;
+}
+
+// 比较逐个查询与批量查询的耗时，并校验批量接口的结果
+static int batch_test(void) {
+    const int count = 2000000;
+    const int lookups = 2000000;
+    enum { BATCH = 64 };
+    hashmap_t *map = hashmap_create(count, 0.75f, hashmap_hash_data, hashmap_compare_data);
+    if (!map) {
+        return 1;
+    }
+
+    // 批量插入偶数键
+    int keys[BATCH], values[BATCH];
+    const void *key_ptrs[BATCH], *value_ptrs[BATCH];
+    size_t key_sizes[BATCH], value_sizes[BATCH];
+    for (int i = 0; i < BATCH; i++) {
+        key_ptrs[i] = &keys[i];
+        value_ptrs[i] = &values[i];
+        key_sizes[i] = sizeof(int);
+        value_sizes[i] = sizeof(int);
+    }
+    for (int base = 0; base < count; base += BATCH) {
+        for (int i = 0; i < BATCH; i++) {
+            keys[i] = (base + i) * 2;
+            values[i] = base + i;
+        }
+        if (hashmap_put_batch(map, key_ptrs, key_sizes, value_ptrs, value_sizes, BATCH) != HASHMAP_OK) {
+            hashmap_destroy(map);
+            return 1;
+        }
+    }
+
+    // 随机键，一半命中
+    int *queries = malloc(sizeof(int) * lookups);
+    unsigned int seed = 12345;
+    for (int i = 0; i < lookups; i++) {
+        seed = seed * 1103515245u + 12345u;
+        queries[i] = (int)((seed >> 1) % (unsigned int)(count * 2));
+    }
+
+    long long start = now_ns();
+    long long sum_single = 0;
+    for (int i = 0; i < lookups; i++) {
+        int value;
+        if (hashmap_get(map, &queries[i], sizeof(int), &value, sizeof(int), NULL) == HASHMAP_OK) {
+            sum_single += value;
+        }
+    }
+    long long single_cost = now_ns() - start;
+
+    int results[BATCH];
+    void *result_ptrs[BATCH];
+    size_t result_sizes[BATCH];
+    hashmap_status_t statuses[BATCH];
+    for (int i = 0; i < BATCH; i++) {
+        result_ptrs[i] = &results[i];
+        result_sizes[i] = sizeof(int);
+    }
+
+    int errors = 0;
+    long long sum_batch = 0;
+    start = now_ns();
+    for (int base = 0; base < lookups; base += BATCH) {
+        const void *batch_keys[BATCH];
+        for (int i = 0; i < BATCH; i++) {
+            batch_keys[i] = &queries[base + i];
+        }
+        hashmap_get_batch(map, batch_keys, key_sizes, BATCH, result_ptrs, result_sizes, NULL, statuses);
+        for (int i = 0; i < BATCH; i++) {
+            if (statuses[i] == HASHMAP_OK) {
+                sum_batch += results[i];
+            }
+            if ((statuses[i] == HASHMAP_OK) != (queries[base + i] % 2 == 0)) {
+                errors++;
+            }
+        }
+    }
+    long long batch_cost = now_ns() - start;
+
+    // 批量存在性检查
+    const void *batch_keys[BATCH];
+    bool exists[BATCH];
+    for (int i = 0; i < BATCH; i++) {
+        batch_keys[i] = &queries[i];
+    }
+    size_t found = hashmap_contains_batch(map, batch_keys, key_sizes, BATCH, exists);
+    size_t expected = 0;
+    for (int i = 0; i < BATCH; i++) {
+        expected += queries[i] % 2 == 0;
+        errors += exists[i] != (queries[i] % 2 == 0);
+    }
+    errors += found != expected;
+    errors += sum_single != sum_batch;
+
+    // 空键不参与哈希，查询报告错误或不存在，插入在空键处停止
+    batch_keys[3] = NULL;
+    hashmap_get_batch(map, batch_keys, key_sizes, BATCH, result_ptrs, result_sizes, NULL, statuses);
+    errors += statuses[3] != HASHMAP_ERR;
+    hashmap_contains_batch(map, batch_keys, key_sizes, BATCH, exists);
+    errors += exists[3];
+    size_t before = hashmap_size(map);
+    for (int i = 0; i < BATCH; i++) {
+        keys[i] = i * 2 + 1;
+    }
+    key_ptrs[5] = NULL;
+    errors += hashmap_put_batch(map, key_ptrs, key_sizes, value_ptrs, value_sizes, BATCH) != HASHMAP_ERR;
+    errors += hashmap_size(map) != before + 5;
+
+    printf("逐个查询: %.1f ms, 批量查询: %.1f ms, 错误数: %d\n",
+           single_cost / 1e6, batch_cost / 1e6, errors);
+
+    free(queries);
+    hashmap_destroy(map);
+    return errors != 0;
+}
+
 int main() {
     // 创建哈希映射
     hashmap_t *map = hashmap_create(16, 0.75f, hashmap_hash_string, hashmap_compare_string);
@@ -67,6 +313,32 @@ int main() {
     printf("\n删除后遍历...\n");
     hashmap_foreach(map, print_entry, NULL);
     
+    // 零拷贝接口
+    printf("\n零拷贝接口...\n");
+    char *owned_key = strdup("fig");
+    int *owned_value = malloc(sizeof(int));
+    *owned_value = 60;
+    if (hashmap_put_owned(map, owned_key, strlen(owned_key) + 1, owned_value, sizeof(int)) != HASHMAP_OK) {
+        free(owned_key);
+        free(owned_value);
+    }
+    
+    void *slot;
+    if (hashmap_emplace(map, "grape", strlen("grape") + 1, sizeof(int), &slot) == HASHMAP_OK) {
+        *(int *)slot = 70; // 直接写入映射内部的缓冲区
+    }
+    
+    void *ref;
+    size_t ref_size;
+    if (hashmap_get_ref(map, "fig", strlen("fig") + 1, &ref, &ref_size) == HASHMAP_OK) {
+        printf("'fig' 的值为: %d (指针与传入的缓冲区相同: %s)\n", *(int *)ref, ref == owned_value ? "是" : "否");
+    }
+    if (hashmap_get_ref(map, "grape", strlen("grape") + 1, &ref, NULL) == HASHMAP_OK) {
+        (*(int *)ref)++; // 原地修改
+    }
+    hashmap_get(map, "grape", strlen("grape") + 1, &value, sizeof(int), NULL);
+    printf("原地修改后 'grape' 的值为: %d\n", value);
+    
     // 清空哈希映射
     printf("\n清空哈希映射...\n");
     hashmap_clear(map);
@@ -76,5 +348,20 @@ int main() {
     hashmap_destroy(map);
     printf("\n哈希映射已销毁\n");
     
-    return 0;
+    // 重新哈希模式对比
+    printf("\n重新哈希模式对比 (1000000 个整数键)...\n");
+    int failed = 0;
+    failed |= rehash_mode_test(HASHMAP_REHASH_BLOCKING);
+    failed |= rehash_mode_test(HASHMAP_REHASH_INCREMENTAL);
+    
+    // 内存分配模式对比
+    printf("\n内存分配模式对比 (1000000 个整数键)...\n");
+    failed |= alloc_mode_test(HASHMAP_ALLOC_MALLOC);
+    failed |= alloc_mode_test(HASHMAP_ALLOC_SLAB);
+    
+    // 批量接口
+    printf("\n批量查询对比 (2000000 个键, 每批 64 个)...\n");
+    failed |= batch_test();
+    
+    return failed;
 }
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "hashmap.h"
+#include "wyhash.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
@@ -7,6 +8,21 @@
 #define HASHMAP_DEFAULT_LOAD_FACTOR 0.75f
 #define HASHMAP_RESIZE_FACTOR 2
 #define HASHMAP_MIN_CAPACITY 8
+#define HASHMAP_REHASH_STEP_BUCKETS 4   // 渐进式模式下每次写操作迁移的非空旧桶数量
+#define HASHMAP_REHASH_EMPTY_VISITS 10  // 每迁移一个非空桶最多顺带跳过的空桶数量
+#define HASHMAP_BATCH_WINDOW 16         // 批量操作每组预取的键数量
+
+// 节点内存来源标记（hashmap_entry_t.flags）
+// 键或值既不内联也不来自 slab 时由 key_free/value_free 释放
+#define HASHMAP_ENTRY_SLAB          0x01    // 节点块来自 slab，尺寸级别保存在高位
+#define HASHMAP_ENTRY_KEY_INLINE    0x02    // 键内联在节点块中
+#define HASHMAP_ENTRY_VALUE_INLINE  0x04    // 值内联在节点块中
+#define HASHMAP_ENTRY_KEY_SLAB      0x08    // 键单独从 slab 分配
+#define HASHMAP_ENTRY_VALUE_SLAB    0x10    // 值单独从 slab 分配
+#define HASHMAP_ENTRY_CLASS_SHIFT   8
+
+#define HASHMAP_SLAB_ALIGN 16
+#define HASHMAP_SLAB_ALIGN_UP(n) (((n) + HASHMAP_SLAB_ALIGN - 1) & ~(size_t)(HASHMAP_SLAB_ALIGN - 1))
 
 // 红黑树节点比较函数
 static int rb_node_compare(const struct rb_node *a, const struct rb_node *b, void *arg) {
@@ -16,7 +32,7 @@ static int rb_node_compare(const struct rb_node *a, const struct rb_node *b, voi
     
     // 先比较哈希值
     if (entry_a->hash != entry_b->hash) {
-        return entry_a->hash - entry_b->hash;
+        return entry_a->hash < entry_b->hash ? -1 : 1;
     }
     
     // 哈希值相同，再比较键内容
@@ -24,23 +40,6 @@ static int rb_node_compare(const struct rb_node *a, const struct rb_node *b, voi
                               entry_b->key, entry_b->key_size);
 }
 
-// 红黑树节点析构函数
-static void rb_node_destructor(struct rb_node *node, void *arg) {
-    hashmap_t *map = (hashmap_t*)arg;
-    hashmap_entry_t *entry = rb_entry(node, hashmap_entry_t, rb_node);
-    
-    // 释放键和值
-    if (map->key_free) {
-        map->key_free(entry->key);
-    }
-    if (map->value_free) {
-        map->value_free(entry->value);
-    }
-    
-    // 释放节点
-    free(entry);
-}
-
 // 默认键复制函数
 static void* default_key_dup(const void *key, size_t size) {
     void *new_key = malloc(size);
@@ -69,29 +68,375 @@ static void default_value_free(void *value) {
     free(value);
 }
 
-// 字符串哈希函数 - DJB2算法
-unsigned int hashmap_hash_string(const void *key, size_t key_size) {
-    const unsigned char *str = (const unsigned char *)key;
-    unsigned int hash = 5381;
-    int c;
+//-----------------------------
+// slab 分配器
+//-----------------------------
+
+// slab 页头，页按链表串起来，清空时整体释放
+typedef struct hashmap_slab_page {
+    struct hashmap_slab_page *next;
+} hashmap_slab_page_t;
+
+// 超过最大块尺寸的单独分配，双向链表便于单个释放
+typedef struct hashmap_slab_large {
+    struct hashmap_slab_large *prev;
+    struct hashmap_slab_large *next;
+} hashmap_slab_large_t;
+
+// 空闲块链表节点
+typedef struct hashmap_slab_free {
+    struct hashmap_slab_free *next;
+} hashmap_slab_free_t;
+
+#define HASHMAP_SLAB_PAGE_HEADER HASHMAP_SLAB_ALIGN_UP(sizeof(hashmap_slab_page_t))
+#define HASHMAP_SLAB_LARGE_HEADER HASHMAP_SLAB_ALIGN_UP(sizeof(hashmap_slab_large_t))
+
+// 各尺寸级别的块大小
+static const size_t slab_class_size[HASHMAP_SLAB_CLASS_COUNT] = {
+    16, 32, 48, 64, 80, 96, 128, 160, 192, 256, 320, 384, 512
+};
+
+// 尺寸对应的级别（size 不超过 HASHMAP_SLAB_MAX_BLOCK）
+static inline unsigned int slab_class_of(size_t size) {
+    if (size <= 96) {
+        return size ? (unsigned int)((size - 1) >> 4) : 0;
+    }
+    unsigned int cls = 6;
+    while (slab_class_size[cls] < size) {
+        cls++;
+    }
+    return cls;
+}
+
+// 从指定级别分配一块：优先复用空闲块，其次从当前页切分，页用完再申请新页
+static void* slab_alloc_class(hashmap_slab_t *slab, unsigned int cls) {
+    hashmap_slab_free_t *block = (hashmap_slab_free_t*)slab->free_lists[cls];
+    if (block) {
+        slab->free_lists[cls] = block->next;
+        return block;
+    }
     
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+    size_t size = slab_class_size[cls];
+    if ((size_t)(slab->limit - slab->cursor) < size) {
+        hashmap_slab_page_t *page = (hashmap_slab_page_t*)malloc(HASHMAP_SLAB_PAGE_SIZE);
+        if (!page) {
+            return NULL;
+        }
+        page->next = (hashmap_slab_page_t*)slab->pages;
+        slab->pages = page;
+        slab->page_count++;
+        slab->cursor = (char*)page + HASHMAP_SLAB_PAGE_HEADER;
+        slab->limit = (char*)page + HASHMAP_SLAB_PAGE_SIZE;
     }
     
-    return hash;
+    void *ptr = slab->cursor;
+    slab->cursor += size;
+    return ptr;
 }
 
-// 数据哈希函数
-unsigned int hashmap_hash_data(const void *key, size_t key_size) {
-    const unsigned char *data = (const unsigned char *)key;
-    unsigned int hash = 5381;
+// 归还一块到指定级别的空闲链表
+static inline void slab_free_class(hashmap_slab_t *slab, void *ptr, unsigned int cls) {
+    hashmap_slab_free_t *block = (hashmap_slab_free_t*)ptr;
+    block->next = (hashmap_slab_free_t*)slab->free_lists[cls];
+    slab->free_lists[cls] = block;
+}
+
+// 按尺寸分配，超过最大块尺寸时单独 malloc 并挂到大块链表
+static void* slab_alloc(hashmap_slab_t *slab, size_t size) {
+    if (size <= HASHMAP_SLAB_MAX_BLOCK) {
+        return slab_alloc_class(slab, slab_class_of(size));
+    }
+    
+    hashmap_slab_large_t *large = (hashmap_slab_large_t*)malloc(HASHMAP_SLAB_LARGE_HEADER + size);
+    if (!large) {
+        return NULL;
+    }
+    large->prev = NULL;
+    large->next = (hashmap_slab_large_t*)slab->large;
+    if (large->next) {
+        large->next->prev = large;
+    }
+    slab->large = large;
+    return (char*)large + HASHMAP_SLAB_LARGE_HEADER;
+}
+
+// 按尺寸释放
+static void slab_free(hashmap_slab_t *slab, void *ptr, size_t size) {
+    if (size <= HASHMAP_SLAB_MAX_BLOCK) {
+        slab_free_class(slab, ptr, slab_class_of(size));
+        return;
+    }
+    
+    hashmap_slab_large_t *large = (hashmap_slab_large_t*)((char*)ptr - HASHMAP_SLAB_LARGE_HEADER);
+    if (large->prev) {
+        large->prev->next = large->next;
+    } else {
+        slab->large = large->next;
+    }
+    if (large->next) {
+        large->next->prev = large->prev;
+    }
+    free(large);
+}
+
+// 释放全部页和大块，复杂度与页数成正比
+static void slab_release_all(hashmap_slab_t *slab) {
+    hashmap_slab_page_t *page = (hashmap_slab_page_t*)slab->pages;
+    while (page) {
+        hashmap_slab_page_t *next = page->next;
+        free(page);
+        page = next;
+    }
+    
+    hashmap_slab_large_t *large = (hashmap_slab_large_t*)slab->large;
+    while (large) {
+        hashmap_slab_large_t *next = large->next;
+        free(large);
+        large = next;
+    }
+    
+    // 调用前接管的缓冲区已经逐个释放
+    memset(slab, 0, sizeof(*slab));
+}
+
+//-----------------------------
+// 节点分配与释放
+//-----------------------------
+
+// 释放节点的键
+static void hashmap_entry_free_key(hashmap_t *map, hashmap_entry_t *entry) {
+    if (entry->flags & HASHMAP_ENTRY_KEY_INLINE) {
+        return;
+    }
+    if (entry->flags & HASHMAP_ENTRY_KEY_SLAB) {
+        slab_free(map->slab, entry->key, entry->key_size);
+        return;
+    }
+    
+    if (map->key_free) {
+        map->key_free(entry->key);
+    }
+    if (map->slab) {
+        map->slab->foreign_count--;
+    }
+}
+
+// 释放节点的值
+static void hashmap_entry_free_value(hashmap_t *map, hashmap_entry_t *entry) {
+    if (entry->flags & HASHMAP_ENTRY_VALUE_INLINE) {
+        return;
+    }
+    if (entry->flags & HASHMAP_ENTRY_VALUE_SLAB) {
+        slab_free(map->slab, entry->value, entry->value_size);
+        return;
+    }
+    
+    if (map->value_free) {
+        map->value_free(entry->value);
+    }
+    if (map->slab) {
+        map->slab->foreign_count--;
+    }
+}
+
+// 释放节点、键和值
+static void hashmap_entry_free(hashmap_t *map, hashmap_entry_t *entry) {
+    hashmap_entry_free_key(map, entry);
+    hashmap_entry_free_value(map, entry);
+    
+    if (entry->flags & HASHMAP_ENTRY_SLAB) {
+        slab_free_class(map->slab, entry, entry->flags >> HASHMAP_ENTRY_CLASS_SHIFT);
+    } else {
+        free(entry);
+    }
+}
+
+// 创建节点并复制键和值，value 为 NULL 时只分配值缓冲区
+// slab 模式下键值尽量与节点内联在同一块中
+static hashmap_entry_t* hashmap_entry_new(hashmap_t *map, unsigned int hash,
+                                          const void *key, size_t key_size,
+                                          const void *value, size_t value_size) {
+    hashmap_entry_t *entry;
+    
+    if (map->slab) {
+        size_t key_span = HASHMAP_SLAB_ALIGN_UP(key_size);
+        bool key_inline = sizeof(hashmap_entry_t) + key_span <= HASHMAP_SLAB_MAX_BLOCK;
+        bool value_inline = key_inline &&
+                            sizeof(hashmap_entry_t) + key_span + value_size <= HASHMAP_SLAB_MAX_BLOCK;
+        size_t block = sizeof(hashmap_entry_t) + (key_inline ? key_span : 0)
+                                               + (value_inline ? value_size : 0);
+        unsigned int cls = slab_class_of(block);
+        
+        entry = (hashmap_entry_t*)slab_alloc_class(map->slab, cls);
+        if (!entry) {
+            return NULL;
+        }
+        entry->flags = HASHMAP_ENTRY_SLAB | (cls << HASHMAP_ENTRY_CLASS_SHIFT);
+        
+        if (key_inline) {
+            entry->key = (char*)(entry + 1);
+            entry->flags |= HASHMAP_ENTRY_KEY_INLINE;
+        } else {
+            entry->key = slab_alloc(map->slab, key_size);
+            entry->flags |= HASHMAP_ENTRY_KEY_SLAB;
+        }
+        if (value_inline) {
+            entry->value = (char*)(entry + 1) + key_span;
+            entry->flags |= HASHMAP_ENTRY_VALUE_INLINE;
+        } else {
+            entry->value = slab_alloc(map->slab, value_size);
+            entry->flags |= HASHMAP_ENTRY_VALUE_SLAB;
+        }
+        
+        if (!entry->key || !entry->value) {
+            if (entry->key && !key_inline) {
+                slab_free(map->slab, entry->key, key_size);
+            }
+            if (entry->value && !value_inline) {
+                slab_free(map->slab, entry->value, value_size);
+            }
+            slab_free_class(map->slab, entry, cls);
+            return NULL;
+        }
+        
+        memcpy(entry->key, key, key_size);
+        if (value) {
+            memcpy(entry->value, value, value_size);
+        }
+    } else {
+        entry = (hashmap_entry_t*)malloc(sizeof(hashmap_entry_t));
+        if (!entry) {
+            return NULL;
+        }
+        entry->flags = 0;
+        
+        // 复制键和值
+        entry->key = map->key_dup(key, key_size);
+        if (!entry->key) {
+            free(entry);
+            return NULL;
+        }
+        
+        entry->value = value ? map->value_dup(value, value_size) : malloc(value_size ? value_size : 1);
+        if (!entry->value) {
+            map->key_free(entry->key);
+            free(entry);
+            return NULL;
+        }
+    }
+    
+    // 设置节点属性
+    entry->hash = hash;
+    entry->key_size = key_size;
+    entry->value_size = value_size;
+    return entry;
+}
+
+// 创建节点并直接接管键和值
+static hashmap_entry_t* hashmap_entry_new_owned(hashmap_t *map, unsigned int hash,
+                                                void *key, size_t key_size,
+                                                void *value, size_t value_size) {
+    hashmap_entry_t *entry;
+    
+    if (map->slab) {
+        unsigned int cls = slab_class_of(sizeof(hashmap_entry_t));
+        entry = (hashmap_entry_t*)slab_alloc_class(map->slab, cls);
+        if (!entry) {
+            return NULL;
+        }
+        entry->flags = HASHMAP_ENTRY_SLAB | (cls << HASHMAP_ENTRY_CLASS_SHIFT);
+        map->slab->foreign_count += 2;
+    } else {
+        entry = (hashmap_entry_t*)malloc(sizeof(hashmap_entry_t));
+        if (!entry) {
+            return NULL;
+        }
+        entry->flags = 0;
+    }
     
-    for (size_t i = 0; i < key_size; i++) {
-        hash = ((hash << 5) + hash) + data[i];
+    entry->hash = hash;
+    entry->key = key;
+    entry->key_size = key_size;
+    entry->value = value;
+    entry->value_size = value_size;
+    return entry;
+}
+
+// 替换节点的值，value 为 NULL 时只分配不复制
+// 映射自有的值缓冲区大小不变时原地覆盖
+static hashmap_status_t hashmap_entry_set_value(hashmap_t *map, hashmap_entry_t *entry,
+                                                const void *value, size_t value_size) {
+    if ((entry->flags & (HASHMAP_ENTRY_VALUE_INLINE | HASHMAP_ENTRY_VALUE_SLAB)) &&
+        entry->value_size == value_size) {
+        if (value) {
+            memcpy(entry->value, value, value_size);
+        }
+        return HASHMAP_OK;
     }
     
-    return hash;
+    void *new_value;
+    if (map->slab) {
+        new_value = slab_alloc(map->slab, value_size);
+        if (new_value && value) {
+            memcpy(new_value, value, value_size);
+        }
+    } else {
+        new_value = value ? map->value_dup(value, value_size) : malloc(value_size ? value_size : 1);
+    }
+    if (!new_value) {
+        return HASHMAP_NOMEM;
+    }
+    
+    // 释放旧值
+    hashmap_entry_free_value(map, entry);
+    
+    entry->value = new_value;
+    entry->value_size = value_size;
+    entry->flags &= ~(HASHMAP_ENTRY_VALUE_INLINE | HASHMAP_ENTRY_VALUE_SLAB);
+    if (map->slab) {
+        entry->flags |= HASHMAP_ENTRY_VALUE_SLAB;
+    }
+    return HASHMAP_OK;
+}
+
+// 红黑树节点析构函数
+static void rb_node_destructor(struct rb_node *node, void *arg) {
+    hashmap_entry_free((hashmap_t*)arg, rb_entry(node, hashmap_entry_t, rb_node));
+}
+
+// 清空桶数组中的所有节点
+// slab 模式下节点随页整体释放，只需释放通过 put_owned 接管的缓冲区
+static void hashmap_release_buckets(hashmap_t *map, rb_root_t *buckets, size_t capacity) {
+    for (size_t i = 0; i < capacity; i++) {
+        if (!map->slab) {
+            rb_destroy(&buckets[i]);
+        } else if (map->slab->foreign_count) {
+            hashmap_entry_t *pos, *n;
+            rbtree_postorder_for_each_entry_safe(pos, n, &buckets[i].root, rb_node) {
+                hashmap_entry_free_key(map, pos);
+                hashmap_entry_free_value(map, pos);
+            }
+        }
+        buckets[i].root = RB_ROOT;
+    }
+}
+
+// 进程级哈希种子，启动时随机生成，抵御针对固定哈希函数构造碰撞键的哈希洪水攻击
+static uint64_t hashmap_hash_seed;
+
+__attribute__((constructor))
+static void hashmap_hash_seed_init(void) {
+    hashmap_hash_seed = wyhash_seed_random();
+}
+
+// 字符串哈希函数 - 带种子的 wyhash，折叠为 32 位
+unsigned int hashmap_hash_string(const void *key, size_t key_size) {
+    return wyhash32(key, strlen((const char *)key), hashmap_hash_seed);
+}
+
+// 数据哈希函数 - 带种子的 wyhash，折叠为 32 位
+unsigned int hashmap_hash_data(const void *key, size_t key_size) {
+    return wyhash32(key, key_size, hashmap_hash_seed);
 }
 
 // 字符串比较函数
@@ -109,6 +454,21 @@ int hashmap_compare_data(const void *key1, size_t key1_size,
     return memcmp(key1, key2, key1_size);
 }
 
+// 分配桶数组
+// calloc 得到的空根可以直接查找和销毁，桶在第一次插入前才初始化，
+// 这样开始一次渐进式迁移不需要先触碰整个新桶数组
+static rb_root_t* hashmap_alloc_buckets(size_t capacity) {
+    return (rb_root_t*)calloc(capacity, sizeof(rb_root_t));
+}
+
+// 插入前初始化桶
+static inline rb_root_t* hashmap_bucket_prepare(hashmap_t *map, rb_root_t *bucket) {
+    if (!bucket->compare) {
+        rb_init(bucket, rb_node_compare, map, rb_node_destructor, map);
+    }
+    return bucket;
+}
+
 // 创建哈希映射
 hashmap_t* hashmap_create(size_t initial_capacity, float load_factor,
                          hashmap_hash_fn hash_fn,
@@ -128,7 +488,7 @@ hashmap_t* hashmap_create(size_t initial_capacity, float load_factor,
     }
     
     // 分配桶数组
-    map->buckets = (rb_root_t*)calloc(initial_capacity, sizeof(rb_root_t));
+    map->buckets = hashmap_alloc_buckets(initial_capacity);
     if (!map->buckets) {
         free(map);
         return NULL;
@@ -141,17 +501,22 @@ hashmap_t* hashmap_create(size_t initial_capacity, float load_factor,
     map->hash_fn = hash_fn ? hash_fn : hashmap_hash_string;
     map->key_compare_fn = key_compare_fn ? key_compare_fn : hashmap_compare_string;
     
+    // 默认阻塞式重新哈希
+    map->rehash_mode = HASHMAP_REHASH_BLOCKING;
+    map->rehash_buckets = NULL;
+    map->rehash_capacity = 0;
+    map->rehash_index = 0;
+    
+    // 默认逐项 malloc
+    map->alloc_mode = HASHMAP_ALLOC_MALLOC;
+    map->slab = NULL;
+    
     // 设置默认的内存操作函数
     map->key_dup = default_key_dup;
     map->value_dup = default_value_dup;
     map->key_free = default_key_free;
     map->value_free = default_value_free;
     
-    // 初始化桶
-    for (size_t i = 0; i < initial_capacity; i++) {
-        rb_init(&map->buckets[i], rb_node_compare, map, rb_node_destructor, map);
-    }
-    
     return map;
 }
 
@@ -161,12 +526,18 @@ void hashmap_destroy(hashmap_t *map) {
         return;
     }
     
-    // 清除所有桶
-    for (size_t i = 0; i < map->capacity; i++) {
-        rb_destroy(&map->buckets[i]);
+    // 清除所有桶（包括迁移中的新桶数组）
+    hashmap_release_buckets(map, map->buckets, map->capacity);
+    if (map->rehash_buckets) {
+        hashmap_release_buckets(map, map->rehash_buckets, map->rehash_capacity);
+    }
+    if (map->slab) {
+        slab_release_all(map->slab);
+        free(map->slab);
     }
     
     // 释放桶数组和映射结构
+    free(map->rehash_buckets);
     free(map->buckets);
     free(map);
 }
@@ -178,9 +549,20 @@ void hashmap_clear(hashmap_t *map) {
     }
     
     // 清除所有桶
-    for (size_t i = 0; i < map->capacity; i++) {
-        rb_destroy(&map->buckets[i]);
-        rb_init(&map->buckets[i], rb_node_compare, map, rb_node_destructor, map);
+    hashmap_release_buckets(map, map->buckets, map->capacity);
+    
+    // 正在迁移时直接丢弃新桶数组，旧桶数组已全部清空
+    if (map->rehash_buckets) {
+        hashmap_release_buckets(map, map->rehash_buckets, map->rehash_capacity);
+        free(map->rehash_buckets);
+        map->rehash_buckets = NULL;
+        map->rehash_capacity = 0;
+        map->rehash_index = 0;
+    }
+    
+    // slab 模式按页整体释放
+    if (map->slab) {
+        slab_release_all(map->slab);
     }
     
     map->size = 0;
@@ -191,6 +573,35 @@ size_t hashmap_size(const hashmap_t *map) {
     return map ? map->size : 0;
 }
 
+// 哈希值所在的桶：迁移期间旧桶下标小于 rehash_index 的已迁移到新桶数组
+static rb_root_t* hashmap_bucket_for(const hashmap_t *map, unsigned int hash) {
+    size_t index = hash % map->capacity;
+    if (map->rehash_buckets && index < map->rehash_index) {
+        return &map->rehash_buckets[hash % map->rehash_capacity];
+    }
+    return &map->buckets[index];
+}
+
+// 按已计算的哈希值查找键对应的节点
+static hashmap_entry_t* hashmap_find_hashed(const hashmap_t *map, 
+                                          const void *key, size_t key_size,
+                                          unsigned int hash) {
+    // 创建一个临时节点用于查找
+    hashmap_entry_t temp = {
+        .hash = hash,
+        .key = (void*)key,
+        .key_size = key_size
+    };
+    
+    // 在键所在桶的红黑树中查找
+    struct rb_node *node = rb_search(hashmap_bucket_for(map, hash), &temp.rb_node);
+    if (!node) {
+        return NULL;
+    }
+    
+    return rb_entry(node, hashmap_entry_t, rb_node);
+}
+
 // 查找键对应的节点
 static hashmap_entry_t* hashmap_find_entry(const hashmap_t *map, 
                                          const void *key, size_t key_size,
@@ -201,23 +612,56 @@ static hashmap_entry_t* hashmap_find_entry(const hashmap_t *map,
         *hash_out = hash;
     }
     
-    // 确定桶索引
-    size_t index = hash % map->capacity;
+    return hashmap_find_hashed(map, key, key_size, hash);
+}
+
+// 将一个旧桶中的节点全部搬到新桶数组
+static void hashmap_migrate_bucket(hashmap_t *map, rb_root_t *bucket) {
+    hashmap_entry_t *pos, *n;
     
-    // 创建一个临时节点用于查找
-    hashmap_entry_t temp = {
-        .hash = hash,
-        .key = (void*)key,
-        .key_size = key_size
-    };
+    // 后序遍历摘取节点，旧树随后整体丢弃，不需要逐个删除再平衡
+    rbtree_postorder_for_each_entry_safe(pos, n, &bucket->root, rb_node) {
+        rb_root_t *target = &map->rehash_buckets[pos->hash % map->rehash_capacity];
+        rb_insert(hashmap_bucket_prepare(map, target), &pos->rb_node);
+    }
+    bucket->root = RB_ROOT;
+}
+
+// 迁移最多 buckets 个非空旧桶，全部迁移后用新桶数组替换旧桶数组
+// 返回 true 表示迁移仍未完成
+static bool hashmap_rehash_migrate(hashmap_t *map, size_t buckets) {
+    size_t empty_visits = (buckets > SIZE_MAX / HASHMAP_REHASH_EMPTY_VISITS)
+                          ? SIZE_MAX : buckets * HASHMAP_REHASH_EMPTY_VISITS;
     
-    // 在红黑树中查找
-    struct rb_node *node = rb_search(&map->buckets[index], &temp.rb_node);
-    if (!node) {
-        return NULL;
+    while (buckets > 0 && map->rehash_index < map->capacity) {
+        rb_root_t *bucket = &map->buckets[map->rehash_index];
+        map->rehash_index++;
+        
+        if (rb_empty(bucket)) {
+            // 限制单次跳过的空桶数量，保证每次操作的停顿有上界
+            if (--empty_visits == 0) {
+                break;
+            }
+            continue;
+        }
+        
+        hashmap_migrate_bucket(map, bucket);
+        buckets--;
     }
     
-    return rb_entry(node, hashmap_entry_t, rb_node);
+    if (map->rehash_index < map->capacity) {
+        return true;
+    }
+    
+    // 迁移完成，释放旧桶数组
+    free(map->buckets);
+    map->buckets = map->rehash_buckets;
+    map->capacity = map->rehash_capacity;
+    map->rehash_buckets = NULL;
+    map->rehash_capacity = 0;
+    map->rehash_index = 0;
+    
+    return false;
 }
 
 // 执行重新哈希
@@ -227,46 +671,72 @@ static hashmap_status_t hashmap_rehash(hashmap_t *map, size_t new_capacity) {
         new_capacity = HASHMAP_MIN_CAPACITY;
     }
     
+    // 先完成正在进行的迁移
+    if (map->rehash_buckets) {
+        hashmap_rehash_migrate(map, SIZE_MAX);
+    }
+    
     // 分配新桶
-    rb_root_t *new_buckets = (rb_root_t*)calloc(new_capacity, sizeof(rb_root_t));
-    if (!new_buckets) {
+    map->rehash_buckets = hashmap_alloc_buckets(new_capacity);
+    if (!map->rehash_buckets) {
         return HASHMAP_NOMEM;
     }
+    map->rehash_capacity = new_capacity;
+    map->rehash_index = 0;
     
-    // 初始化新桶
-    for (size_t i = 0; i < new_capacity; i++) {
-        rb_init(&new_buckets[i], rb_node_compare, map, rb_node_destructor, map);
+    // 阻塞模式立即迁移全部节点，渐进模式由后续操作分摊
+    if (map->rehash_mode == HASHMAP_REHASH_BLOCKING) {
+        hashmap_rehash_migrate(map, SIZE_MAX);
     }
     
-    // 遍历旧桶，重新哈希所有项
-    for (size_t i = 0; i < map->capacity; i++) {
-        struct rb_node *node = rb_first(&map->buckets[i].root);
-        while (node) {
-            // 保存下一个节点
-            struct rb_node *next = rb_next(node);
-            
-            // 重新计算桶索引
-            hashmap_entry_t *entry = rb_entry(node, hashmap_entry_t, rb_node);
-            size_t new_index = entry->hash % new_capacity;
-            
-            // 从旧桶中删除
-            rb_erase(&map->buckets[i], node);
-            
-            // 插入到新桶
-            rb_insert(&new_buckets[new_index], node);
-            
-            // 继续下一个节点
-            node = next;
-        }
+    return HASHMAP_OK;
+}
+
+// 写操作前的准备：推进渐进式迁移，并在需要时扩容
+static hashmap_status_t hashmap_prepare_insert(hashmap_t *map) {
+    // 渐进式迁移一小步
+    if (map->rehash_buckets) {
+        hashmap_rehash_migrate(map, HASHMAP_REHASH_STEP_BUCKETS);
     }
     
-    // 释放旧桶数组
-    free(map->buckets);
+    // 检查是否需要扩容（迁移期间按目标容量计算）
+    size_t capacity = map->rehash_buckets ? map->rehash_capacity : map->capacity;
+    if ((float)(map->size + 1) / capacity > map->load_factor) {
+        return hashmap_rehash(map, capacity * HASHMAP_RESIZE_FACTOR);
+    }
     
-    // 更新映射属性
-    map->buckets = new_buckets;
-    map->capacity = new_capacity;
+    return HASHMAP_OK;
+}
+
+// 把节点插入键所在的桶（调用者已确认键不存在）
+static void hashmap_link_entry(hashmap_t *map, hashmap_entry_t *entry) {
+    rb_root_t *bucket = hashmap_bucket_prepare(map, hashmap_bucket_for(map, entry->hash));
+    rb_insert(bucket, &entry->rb_node);
+    map->size++;
+}
+
+// 按已计算的哈希值插入键值对
+static hashmap_status_t hashmap_put_hashed(hashmap_t *map, unsigned int hash,
+                                           const void *key, size_t key_size,
+                                           const void *value, size_t value_size) {
+    hashmap_status_t status = hashmap_prepare_insert(map);
+    if (status != HASHMAP_OK) {
+        return status;
+    }
+    
+    hashmap_entry_t *existing = hashmap_find_hashed(map, key, key_size, hash);
+    if (existing) {
+        // 更新现有值
+        return hashmap_entry_set_value(map, existing, value, value_size);
+    }
+    
+    // 创建新节点，复制键和值
+    hashmap_entry_t *entry = hashmap_entry_new(map, hash, key, key_size, value, value_size);
+    if (!entry) {
+        return HASHMAP_NOMEM;
+    }
     
+    hashmap_link_entry(map, entry);
     return HASHMAP_OK;
 }
 
@@ -277,74 +747,100 @@ hashmap_status_t hashmap_put(hashmap_t *map, const void *key, size_t key_size,
         return HASHMAP_ERR;
     }
     
-    // 检查是否需要扩容
-    if ((float)(map->size + 1) / map->capacity > map->load_factor) {
-        hashmap_status_t status = hashmap_rehash(map, map->capacity * HASHMAP_RESIZE_FACTOR);
-        if (status != HASHMAP_OK) {
-            return status;
-        }
+    return hashmap_put_hashed(map, map->hash_fn(key, key_size), key, key_size, value, value_size);
+}
+
+// 插入键值对并接管键和值的所有权（不复制）
+hashmap_status_t hashmap_put_owned(hashmap_t *map, void *key, size_t key_size,
+                                  void *value, size_t value_size) {
+    if (!map || !key) {
+        return HASHMAP_ERR;
+    }
+    
+    hashmap_status_t status = hashmap_prepare_insert(map);
+    if (status != HASHMAP_OK) {
+        return status;
     }
     
-    // 计算哈希值
     unsigned int hash;
     hashmap_entry_t *existing = hashmap_find_entry(map, key, key_size, &hash);
     
     if (existing) {
-        // 更新现有值
-        void *new_value = map->value_dup(value, value_size);
-        if (!new_value) {
-            return HASHMAP_NOMEM;
-        }
-        
-        // 释放旧值
-        if (map->value_free) {
-            map->value_free(existing->value);
-        }
-        
-        existing->value = new_value;
+        // 保留已有的键，传入的键已经转交给映射，直接释放
+        hashmap_entry_free_value(map, existing);
+        existing->value = value;
         existing->value_size = value_size;
-        
-        return HASHMAP_OK;
-    } else {
-        // 创建新节点
-        hashmap_entry_t *entry = (hashmap_entry_t*)malloc(sizeof(hashmap_entry_t));
-        if (!entry) {
-            return HASHMAP_NOMEM;
+        existing->flags &= ~(HASHMAP_ENTRY_VALUE_INLINE | HASHMAP_ENTRY_VALUE_SLAB);
+        if (map->slab) {
+            map->slab->foreign_count++;
         }
-        
-        // 复制键和值
-        entry->key = map->key_dup(key, key_size);
-        if (!entry->key) {
-            free(entry);
-            return HASHMAP_NOMEM;
+        if (map->key_free) {
+            map->key_free(key);
         }
         
-        entry->value = map->value_dup(value, value_size);
-        if (!entry->value) {
-            map->key_free(entry->key);
-            free(entry);
-            return HASHMAP_NOMEM;
-        }
-        
-        // 设置节点属性
-        entry->hash = hash;
-        entry->key_size = key_size;
-        entry->value_size = value_size;
-        
-        // 确定桶索引
-        size_t index = hash % map->capacity;
-        
-        // 插入红黑树
-        if (rb_insert(&map->buckets[index], &entry->rb_node) != 0) {
-            map->key_free(entry->key);
-            map->value_free(entry->value);
-            free(entry);
-            return HASHMAP_ERR;
+        return HASHMAP_OK;
+    }
+    
+    hashmap_entry_t *entry = hashmap_entry_new_owned(map, hash, key, key_size, value, value_size);
+    if (!entry) {
+        return HASHMAP_NOMEM;
+    }
+    
+    hashmap_link_entry(map, entry);
+    return HASHMAP_OK;
+}
+
+// 为键预留值缓冲区，由调用者原地填充
+hashmap_status_t hashmap_emplace(hashmap_t *map, const void *key, size_t key_size,
+                                size_t value_size, void **value) {
+    if (!map || !key || !value) {
+        return HASHMAP_ERR;
+    }
+    
+    hashmap_status_t status = hashmap_prepare_insert(map);
+    if (status != HASHMAP_OK) {
+        return status;
+    }
+    
+    unsigned int hash;
+    hashmap_entry_t *existing = hashmap_find_entry(map, key, key_size, &hash);
+    
+    if (existing) {
+        // 大小相同时直接复用原有缓冲区
+        if (existing->value_size != value_size) {
+            status = hashmap_entry_set_value(map, existing, NULL, value_size);
+            if (status != HASHMAP_OK) {
+                return status;
+            }
         }
         
-        map->size++;
+        *value = existing->value;
         return HASHMAP_OK;
     }
+    
+    hashmap_entry_t *entry = hashmap_entry_new(map, hash, key, key_size, NULL, value_size);
+    if (!entry) {
+        return HASHMAP_NOMEM;
+    }
+    
+    hashmap_link_entry(map, entry);
+    *value = entry->value;
+    return HASHMAP_OK;
+}
+
+// 把节点的值复制到调用者缓冲区
+static void hashmap_copy_value(const hashmap_entry_t *entry, void *value, size_t value_size,
+                               size_t *actual_size) {
+    // 返回实际值大小
+    if (actual_size) {
+        *actual_size = entry->value_size;
+    }
+    
+    // 复制值
+    if (value) {
+        size_t copy_size = (value_size < entry->value_size) ? value_size : entry->value_size;
+        memcpy(value, entry->value, copy_size);
+    }
 }
 
 // 获取键对应的值
@@ -359,15 +855,25 @@ hashmap_status_t hashmap_get(const hashmap_t *map, const void *key, size_t key_s
         return HASHMAP_NOT_FOUND;
     }
     
-    // 返回实际值大小
-    if (actual_size) {
-        *actual_size = entry->value_size;
+    hashmap_copy_value(entry, value, value_size, actual_size);
+    return HASHMAP_OK;
+}
+
+// 获取键对应值的指针（不复制）
+hashmap_status_t hashmap_get_ref(const hashmap_t *map, const void *key, size_t key_size,
+                               void **value, size_t *value_size) {
+    if (!map || !key || !value) {
+        return HASHMAP_ERR;
     }
     
-    // 复制值
-    if (value) {
-        size_t copy_size = (value_size < entry->value_size) ? value_size : entry->value_size;
-        memcpy(value, entry->value, copy_size);
+    hashmap_entry_t *entry = hashmap_find_entry(map, key, key_size, NULL);
+    if (!entry) {
+        return HASHMAP_NOT_FOUND;
+    }
+    
+    *value = entry->value;
+    if (value_size) {
+        *value_size = entry->value_size;
     }
     
     return HASHMAP_OK;
@@ -379,9 +885,14 @@ hashmap_status_t hashmap_remove(hashmap_t *map, const void *key, size_t key_size
         return HASHMAP_ERR;
     }
     
+    // 渐进式迁移一小步
+    if (map->rehash_buckets) {
+        hashmap_rehash_migrate(map, HASHMAP_REHASH_STEP_BUCKETS);
+    }
+    
     // 计算哈希值
     unsigned int hash = map->hash_fn(key, key_size);
-    size_t index = hash % map->capacity;
+    rb_root_t *bucket = hashmap_bucket_for(map, hash);
     
     // 创建临时节点用于查找
     hashmap_entry_t temp = {
@@ -391,13 +902,14 @@ hashmap_status_t hashmap_remove(hashmap_t *map, const void *key, size_t key_size
     };
     
     // 在红黑树中查找
-    struct rb_node *node = rb_search(&map->buckets[index], &temp.rb_node);
+    struct rb_node *node = rb_search(bucket, &temp.rb_node);
     if (!node) {
         return HASHMAP_NOT_FOUND;
     }
     
-    // 从红黑树中删除
-    rb_erase(&map->buckets[index], node);
+    // 从红黑树中删除，并释放节点、键和值
+    rb_erase(bucket, node);
+    rb_node_destructor(node, map);
     map->size--;
     
     return HASHMAP_OK;
@@ -412,25 +924,162 @@ bool hashmap_contains(const hashmap_t *map, const void *key, size_t key_size) {
     return hashmap_find_entry(map, key, key_size, NULL) != NULL;
 }
 
-// 遍历哈希映射
-void hashmap_foreach(const hashmap_t *map, hashmap_foreach_fn fn, void *user_data) {
-    if (!map || !fn) {
-        return;
+// 计算一组键的哈希值并预取它们所在的桶和树根节点
+// 先把整组的访存请求都发出去，后续逐个查找时访存延迟已经相互重叠
+// 空键不计算哈希（哈希函数不接受 NULL），由调用者按错误处理
+static void hashmap_batch_prefetch(const hashmap_t *map, const void *const *keys,
+                                   const size_t *key_sizes, size_t count,
+                                   unsigned int *hashes) {
+    for (size_t i = 0; i < count; i++) {
+        if (!keys[i]) {
+            hashes[i] = 0;
+            continue;
+        }
+        hashes[i] = map->hash_fn(keys[i], key_sizes[i]);
+        __builtin_prefetch(hashmap_bucket_for(map, hashes[i]), 0, 1);
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!keys[i]) {
+            continue;
+        }
+        struct rb_node *root = hashmap_bucket_for(map, hashes[i])->root.rb_node;
+        if (root) {
+            __builtin_prefetch(root, 0, 1);
+        }
+    }
+}
+
+// 批量获取键对应的值
+size_t hashmap_get_batch(const hashmap_t *map, const void *const *keys, const size_t *key_sizes,
+                         size_t count, void *const *values, const size_t *value_sizes,
+                         size_t *actual_sizes, hashmap_status_t *statuses) {
+    if (!map || !keys || !key_sizes) {
+        return 0;
+    }
+    
+    unsigned int hashes[HASHMAP_BATCH_WINDOW];
+    size_t found = 0;
+    
+    for (size_t base = 0; base < count; base += HASHMAP_BATCH_WINDOW) {
+        size_t n = count - base < HASHMAP_BATCH_WINDOW ? count - base : HASHMAP_BATCH_WINDOW;
+        hashmap_batch_prefetch(map, keys + base, key_sizes + base, n, hashes);
+        
+        for (size_t i = 0; i < n; i++) {
+            size_t k = base + i;
+            if (!keys[k]) {
+                if (statuses) {
+                    statuses[k] = HASHMAP_ERR;
+                }
+                continue;
+            }
+            hashmap_entry_t *entry = hashmap_find_hashed(map, keys[k], key_sizes[k], hashes[i]);
+            if (statuses) {
+                statuses[k] = entry ? HASHMAP_OK : HASHMAP_NOT_FOUND;
+            }
+            if (!entry) {
+                continue;
+            }
+            
+            hashmap_copy_value(entry, values ? values[k] : NULL,
+                               value_sizes ? value_sizes[k] : 0,
+                               actual_sizes ? &actual_sizes[k] : NULL);
+            found++;
+        }
+    }
+    
+    return found;
+}
+
+// 批量检查键是否存在
+size_t hashmap_contains_batch(const hashmap_t *map, const void *const *keys, const size_t *key_sizes,
+                              size_t count, bool *results) {
+    if (!map || !keys || !key_sizes) {
+        return 0;
+    }
+    
+    unsigned int hashes[HASHMAP_BATCH_WINDOW];
+    size_t found = 0;
+    
+    for (size_t base = 0; base < count; base += HASHMAP_BATCH_WINDOW) {
+        size_t n = count - base < HASHMAP_BATCH_WINDOW ? count - base : HASHMAP_BATCH_WINDOW;
+        hashmap_batch_prefetch(map, keys + base, key_sizes + base, n, hashes);
+        
+        for (size_t i = 0; i < n; i++) {
+            size_t k = base + i;
+            bool exists = keys[k] && hashmap_find_hashed(map, keys[k], key_sizes[k], hashes[i]) != NULL;
+            if (results) {
+                results[k] = exists;
+            }
+            found += exists;
+        }
+    }
+    
+    return found;
+}
+
+// 批量插入键值对
+hashmap_status_t hashmap_put_batch(hashmap_t *map, const void *const *keys, const size_t *key_sizes,
+                                   const void *const *values, const size_t *value_sizes,
+                                   size_t count) {
+    if (!map || !keys || !key_sizes || !values || !value_sizes) {
+        return HASHMAP_ERR;
     }
     
-    // 遍历所有桶
-    for (size_t i = 0; i < map->capacity; i++) {
-        struct rb_node *node = rb_first(&map->buckets[i].root);
+    unsigned int hashes[HASHMAP_BATCH_WINDOW];
+    
+    for (size_t base = 0; base < count; base += HASHMAP_BATCH_WINDOW) {
+        size_t n = count - base < HASHMAP_BATCH_WINDOW ? count - base : HASHMAP_BATCH_WINDOW;
+        
+        // 组内扩容会让预取的桶失效，插入时按哈希值重新定位，预取只是提示
+        hashmap_batch_prefetch(map, keys + base, key_sizes + base, n, hashes);
+        
+        for (size_t i = 0; i < n; i++) {
+            size_t k = base + i;
+            if (!keys[k]) {
+                return HASHMAP_ERR;
+            }
+            hashmap_status_t status = hashmap_put_hashed(map, hashes[i], keys[k], key_sizes[k],
+                                                         values[k], value_sizes[k]);
+            if (status != HASHMAP_OK) {
+                return status;
+            }
+        }
+    }
+    
+    return HASHMAP_OK;
+}
+
+// 遍历一个桶数组，回调要求中断时返回 false
+static bool hashmap_foreach_buckets(const rb_root_t *buckets, size_t capacity,
+                                    hashmap_foreach_fn fn, void *user_data) {
+    for (size_t i = 0; i < capacity; i++) {
+        struct rb_node *node = rb_first(&buckets[i].root);
         while (node) {
             hashmap_entry_t *entry = rb_entry(node, hashmap_entry_t, rb_node);
             node = rb_next(node); // 先保存下一个节点，因为回调可能导致当前节点被删除
             
             // 调用回调函数
             if (!fn(entry->key, entry->key_size, entry->value, entry->value_size, user_data)) {
-                return; // 中断遍历
+                return false; // 中断遍历
             }
         }
     }
+    return true;
+}
+
+// 遍历哈希映射
+void hashmap_foreach(const hashmap_t *map, hashmap_foreach_fn fn, void *user_data) {
+    if (!map || !fn) {
+        return;
+    }
+    
+    // 遍历所有桶，迁移期间已迁移的旧桶为空，剩余节点在新桶数组中
+    if (!hashmap_foreach_buckets(map->buckets, map->capacity, fn, user_data)) {
+        return;
+    }
+    if (map->rehash_buckets) {
+        hashmap_foreach_buckets(map->rehash_buckets, map->rehash_capacity, fn, user_data);
+    }
 }
 
 // 重新设置哈希映射容量
@@ -442,6 +1091,61 @@ hashmap_status_t hashmap_resize(hashmap_t *map, size_t new_capacity) {
     return hashmap_rehash(map, new_capacity);
 }
 
+// 设置重新哈希模式
+hashmap_status_t hashmap_set_rehash_mode(hashmap_t *map, hashmap_rehash_mode_t mode) {
+    if (!map || (mode != HASHMAP_REHASH_BLOCKING && mode != HASHMAP_REHASH_INCREMENTAL)) {
+        return HASHMAP_ERR;
+    }
+    
+    // 切回阻塞模式时完成正在进行的迁移
+    if (mode == HASHMAP_REHASH_BLOCKING && map->rehash_buckets) {
+        hashmap_rehash_migrate(map, SIZE_MAX);
+    }
+    
+    map->rehash_mode = mode;
+    return HASHMAP_OK;
+}
+
+// 是否正在进行渐进式重新哈希
+bool hashmap_is_rehashing(const hashmap_t *map) {
+    return map && map->rehash_buckets != NULL;
+}
+
+// 主动推进渐进式重新哈希
+bool hashmap_rehash_step(hashmap_t *map, size_t buckets) {
+    if (!map || !map->rehash_buckets) {
+        return false;
+    }
+    
+    return hashmap_rehash_migrate(map, buckets);
+}
+
+// 设置内存分配模式
+hashmap_status_t hashmap_set_alloc_mode(hashmap_t *map, hashmap_alloc_mode_t mode) {
+    if (!map || (mode != HASHMAP_ALLOC_MALLOC && mode != HASHMAP_ALLOC_SLAB)) {
+        return HASHMAP_ERR;
+    }
+    
+    // 已有节点的内存来源不能改变
+    if (map->size != 0) {
+        return HASHMAP_ERR;
+    }
+    
+    if (mode == HASHMAP_ALLOC_SLAB && !map->slab) {
+        map->slab = (hashmap_slab_t*)calloc(1, sizeof(hashmap_slab_t));
+        if (!map->slab) {
+            return HASHMAP_NOMEM;
+        }
+    } else if (mode == HASHMAP_ALLOC_MALLOC && map->slab) {
+        slab_release_all(map->slab);
+        free(map->slab);
+        map->slab = NULL;
+    }
+    
+    map->alloc_mode = mode;
+    return HASHMAP_OK;
+}
+
 // 设置自定义内存操作函数
 void hashmap_set_memory_functions(hashmap_t *map,
                                  void* (*key_dup)(const void *key, size_t size),
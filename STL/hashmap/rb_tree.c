@@ -21,16 +21,17 @@
  * 红黑树辅助函数
  */
 
+/* 替换父节点（或根）指向 old 的链接，new_node 可能是刚初始化好的新节点，用释放语义发布 */
 static inline void __rb_change_child(struct rb_node *old, struct rb_node *new_node,
                                     struct rb_node *parent, struct rb_root *root)
 {
     if (parent) {
         if (parent->rb_left == old)
-            parent->rb_left = new_node;
+            RB_PUBLISH(parent->rb_left, new_node);
         else
-            parent->rb_right = new_node;
+            RB_PUBLISH(parent->rb_right, new_node);
     } else {
-        root->rb_node = new_node;
+        RB_PUBLISH(root->rb_node, new_node);
     }
 }
 
@@ -77,8 +78,8 @@ void rb_insert_color(struct rb_node *node, struct rb_root *root)
             if (node == parent->rb_right) {
                 /* 情况4：当前节点是父节点的右子节点 */
                 tmp = node->rb_left;
-                parent->rb_right = tmp;
-                node->rb_left = parent;
+                RB_WRITE_ONCE(parent->rb_right, tmp);
+                RB_WRITE_ONCE(node->rb_left, parent);
                 if (tmp)
                     rb_set_parent_color(tmp, parent, RB_BLACK);
                 rb_set_parent_color(parent, node, RB_RED);
@@ -86,8 +87,8 @@ void rb_insert_color(struct rb_node *node, struct rb_root *root)
             }
 
             /* 情况5：当前节点是父节点的左子节点 */
-            gparent->rb_left = parent->rb_right;
-            parent->rb_right = gparent;
+            RB_WRITE_ONCE(gparent->rb_left, parent->rb_right);
+            RB_WRITE_ONCE(parent->rb_right, gparent);
             if (gparent->rb_left)
                 rb_set_parent_color(gparent->rb_left, gparent, RB_BLACK);
             __rb_rotate_set_parents(gparent, parent, root, RB_RED);
@@ -107,8 +108,8 @@ void rb_insert_color(struct rb_node *node, struct rb_root *root)
             if (node == parent->rb_left) {
                 /* 情况4的镜像 */
                 tmp = node->rb_right;
-                parent->rb_left = tmp;
-                node->rb_right = parent;
+                RB_WRITE_ONCE(parent->rb_left, tmp);
+                RB_WRITE_ONCE(node->rb_right, parent);
                 if (tmp)
                     rb_set_parent_color(tmp, parent, RB_BLACK);
                 rb_set_parent_color(parent, node, RB_RED);
@@ -116,8 +117,8 @@ void rb_insert_color(struct rb_node *node, struct rb_root *root)
             }
 
             /* 情况5的镜像 */
-            gparent->rb_right = parent->rb_left;
-            parent->rb_left = gparent;
+            RB_WRITE_ONCE(gparent->rb_right, parent->rb_left);
+            RB_WRITE_ONCE(parent->rb_left, gparent);
             if (gparent->rb_right)
                 rb_set_parent_color(gparent->rb_right, gparent, RB_BLACK);
             __rb_rotate_set_parents(gparent, parent, root, RB_RED);
@@ -140,8 +141,8 @@ static void ____rb_erase_color(struct rb_node *parent, struct rb_root *root,
             if (rb_is_red(sibling)) {
                 /* 情况1：兄弟节点是红色 */
                 tmp1 = sibling->rb_left;
-                parent->rb_right = tmp1;
-                sibling->rb_left = parent;
+                RB_WRITE_ONCE(parent->rb_right, tmp1);
+                RB_WRITE_ONCE(sibling->rb_left, parent);
                 if (tmp1)
                     rb_set_parent_color(tmp1, parent, RB_BLACK);
                 __rb_rotate_set_parents(parent, sibling, root, RB_RED);
@@ -168,9 +169,9 @@ static void ____rb_erase_color(struct rb_node *parent, struct rb_root *root,
                 }
                 /* 情况3：兄弟节点的左子节点是红色，右子节点是黑色 */
                 tmp1 = tmp2->rb_right;
-                sibling->rb_left = tmp1;
-                tmp2->rb_right = sibling;
-                parent->rb_right = tmp2;
+                RB_WRITE_ONCE(sibling->rb_left, tmp1);
+                RB_WRITE_ONCE(tmp2->rb_right, sibling);
+                RB_WRITE_ONCE(parent->rb_right, tmp2);
                 if (tmp1)
                     rb_set_parent_color(tmp1, sibling, RB_BLACK);
                 if (augment_rotate)
@@ -180,8 +181,8 @@ static void ____rb_erase_color(struct rb_node *parent, struct rb_root *root,
             }
             /* 情况4：兄弟节点的右子节点是红色 */
             tmp2 = sibling->rb_left;
-            parent->rb_right = tmp2;
-            sibling->rb_left = parent;
+            RB_WRITE_ONCE(parent->rb_right, tmp2);
+            RB_WRITE_ONCE(sibling->rb_left, parent);
             rb_set_parent_color(tmp1, sibling, RB_BLACK);
             if (tmp2)
                 rb_set_parent(tmp2, parent);
@@ -194,8 +195,8 @@ static void ____rb_erase_color(struct rb_node *parent, struct rb_root *root,
             if (rb_is_red(sibling)) {
                 /* 情况1的镜像 */
                 tmp1 = sibling->rb_right;
-                parent->rb_left = tmp1;
-                sibling->rb_right = parent;
+                RB_WRITE_ONCE(parent->rb_left, tmp1);
+                RB_WRITE_ONCE(sibling->rb_right, parent);
                 if (tmp1)
                     rb_set_parent_color(tmp1, parent, RB_BLACK);
                 __rb_rotate_set_parents(parent, sibling, root, RB_RED);
@@ -222,9 +223,9 @@ static void ____rb_erase_color(struct rb_node *parent, struct rb_root *root,
                 }
                 /* 情况3的镜像 */
                 tmp1 = tmp2->rb_left;
-                sibling->rb_right = tmp1;
-                tmp2->rb_left = sibling;
-                parent->rb_left = tmp2;
+                RB_WRITE_ONCE(sibling->rb_right, tmp1);
+                RB_WRITE_ONCE(tmp2->rb_left, sibling);
+                RB_WRITE_ONCE(parent->rb_left, tmp2);
                 if (tmp1)
                     rb_set_parent_color(tmp1, sibling, RB_BLACK);
                 if (augment_rotate)
@@ -234,8 +235,8 @@ static void ____rb_erase_color(struct rb_node *parent, struct rb_root *root,
             }
             /* 情况4的镜像 */
             tmp2 = sibling->rb_right;
-            parent->rb_left = tmp2;
-            sibling->rb_right = parent;
+            RB_WRITE_ONCE(parent->rb_left, tmp2);
+            RB_WRITE_ONCE(sibling->rb_right, parent);
             rb_set_parent_color(tmp1, sibling, RB_BLACK);
             if (tmp2)
                 rb_set_parent(tmp2, parent);
@@ -264,7 +265,7 @@ static struct rb_node *__rb_erase_augmented(struct rb_node *node, struct rb_root
             child->__rb_parent_color = pc;
             rebalance = NULL;
         } else
-            rebalance = __builtin_expect(pc & 1, 1) ? NULL : parent;
+            rebalance = rb_is_black(node) ? parent : NULL;  /* 删除黑色叶子节点才需要修复 */
         tmp = parent;
     } else if (!child) {
         /* 情况2：节点只有一个左子节点 */
@@ -291,8 +292,8 @@ static struct rb_node *__rb_erase_augmented(struct rb_node *node, struct rb_root
                 tmp = tmp->rb_left;
             } while (tmp);
             child2 = successor->rb_right;
-            parent->rb_left = child2;
-            successor->rb_right = child;
+            RB_WRITE_ONCE(parent->rb_left, child2);
+            RB_WRITE_ONCE(successor->rb_right, child);
             rb_set_parent(child, successor);
             if (augment_rotate) {
                 augment_rotate(node, successor);
@@ -301,7 +302,7 @@ static struct rb_node *__rb_erase_augmented(struct rb_node *node, struct rb_root
         }
 
         tmp = node->rb_left;
-        successor->rb_left = tmp;
+        RB_WRITE_ONCE(successor->rb_left, tmp);
         rb_set_parent(tmp, successor);
 
         pc = node->__rb_parent_color;
@@ -315,7 +316,7 @@ static struct rb_node *__rb_erase_augmented(struct rb_node *node, struct rb_root
         } else {
             unsigned long pc2 = successor->__rb_parent_color;
             successor->__rb_parent_color = pc;
-            rebalance = __builtin_expect(pc2 & 1, 1) ? NULL : parent;
+            rebalance = (pc2 & RB_BLACK) ? parent : NULL;   /* 后继节点为黑色才需要修复 */
         }
         tmp = successor;
     }
@@ -333,7 +334,6 @@ void __rb_erase(struct rb_node *node, struct rb_root *root)
         ____rb_erase_color(rebalance, root, NULL);
 }
 
-
 /*
  * 查找函数实现
  */
@@ -481,7 +481,7 @@ void rb_init(rb_root_t *tree,
              void (*node_destructor)(struct rb_node *node, void *arg),
              void *destructor_arg) 
 {
-    tree->root.rb_node = NULL;
+    RB_WRITE_ONCE(tree->root.rb_node, NULL);
     tree->compare = compare;
     tree->compare_arg = compare_arg;
     tree->node_destructor = node_destructor;
@@ -559,7 +559,7 @@ static void rb_destroy_recursive(rb_root_t *tree, struct rb_node *node)
 void rb_clear(rb_root_t *tree)
 {
     rb_destroy_recursive(tree, tree->root.rb_node);
-    tree->root.rb_node = NULL;
+    RB_WRITE_ONCE(tree->root.rb_node, NULL);
 }
 
 void rb_destroy(rb_root_t *tree)
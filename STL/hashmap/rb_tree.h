@@ -32,6 +32,17 @@
  * 4. 自平衡红黑树，保证 O(log n) 时间复杂度
  */
 
+/*
+ * 子节点指针和根指针的写入
+ * 无锁读者（如 concurrent_hashmap）在写者旋转期间用原子加载读取这些指针，
+ * 普通写入在 C11 中构成数据竞争，编译器可以撕裂、合并或重排它们。
+ * 与内核 latched rbtree 一样，写者改用宽松原子写（WRITE_ONCE），
+ * 把新节点接入树中时用释放语义（rcu_assign_pointer），读者看到指针时节点内容已经写好。
+ * 两者在 x86 上都是普通 mov，单线程使用没有额外开销。
+ */
+#define RB_WRITE_ONCE(x, val) __atomic_store_n(&(x), (val), __ATOMIC_RELAXED)
+#define RB_PUBLISH(x, val)    __atomic_store_n(&(x), (val), __ATOMIC_RELEASE)
+
 // 红黑树节点颜色常量
 #define RB_RED      0
 #define RB_BLACK    1
@@ -231,9 +242,11 @@ static inline void rb_link_node(struct rb_node *node, struct rb_node *parent,
                                struct rb_node **rb_link)
 {
     node->__rb_parent_color = (unsigned long)parent;
-    node->rb_left = node->rb_right = NULL;
+    // 节点可能是从另一棵树搬来的（如扩容时），旧树上的读者仍可能读到它的子节点指针
+    RB_WRITE_ONCE(node->rb_left, NULL);
+    RB_WRITE_ONCE(node->rb_right, NULL);
     
-    *rb_link = node;
+    RB_PUBLISH(*rb_link, node);
 }
 
 #endif // __RB_TREE_H__
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "wyhash.h"
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/random.h>
+
+// 默认密钥（奇数且每个字节汉明重量为 4）
+static const uint64_t wyhash_secret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+    0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL
+};
+
+#define WYHASH_LIKELY(x)   __builtin_expect(!!(x), 1)
+#define WYHASH_UNLIKELY(x) __builtin_expect(!!(x), 0)
+
+// 64x64 -> 128 位乘法，低半部分写回 a，高半部分写回 b
+static inline void wyhash_mum(uint64_t *a, uint64_t *b) {
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+}
+
+// 乘法混合：128 位乘积的高低两半异或
+static inline uint64_t wyhash_mix(uint64_t a, uint64_t b) {
+    wyhash_mum(&a, &b);
+    return a ^ b;
+}
+
+// 按小端读取 8 字节
+static inline uint64_t wyhash_read8(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+// 按小端读取 4 字节
+static inline uint64_t wyhash_read4(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap32(v);
+#endif
+    return v;
+}
+
+// 读取 1~3 字节（首、中、尾各一个字节）
+static inline uint64_t wyhash_read3(const uint8_t *p, size_t k) {
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+// 计算 64 位哈希值
+uint64_t wyhash(const void *key, size_t len, uint64_t seed) {
+    const uint8_t *p = (const uint8_t *)key;
+    uint64_t a, b;
+
+    seed ^= wyhash_mix(seed ^ wyhash_secret[0], wyhash_secret[1]);
+
+    if (WYHASH_LIKELY(len <= 16)) {
+        if (WYHASH_LIKELY(len >= 4)) {
+            // 4~16 字节：首尾各取两个可能重叠的 4 字节
+            a = (wyhash_read4(p) << 32) | wyhash_read4(p + ((len >> 3) << 2));
+            b = (wyhash_read4(p + len - 4) << 32) | wyhash_read4(p + len - 4 - ((len >> 3) << 2));
+        } else if (WYHASH_LIKELY(len > 0)) {
+            a = wyhash_read3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (WYHASH_UNLIKELY(i >= 48)) {
+            // 三条互不依赖的乘法链并行处理 48 字节
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wyhash_mix(wyhash_read8(p) ^ wyhash_secret[1], wyhash_read8(p + 8) ^ seed);
+                see1 = wyhash_mix(wyhash_read8(p + 16) ^ wyhash_secret[2], wyhash_read8(p + 24) ^ see1);
+                see2 = wyhash_mix(wyhash_read8(p + 32) ^ wyhash_secret[3], wyhash_read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (WYHASH_LIKELY(i >= 48));
+            seed ^= see1 ^ see2;
+        }
+        while (WYHASH_UNLIKELY(i > 16)) {
+            seed = wyhash_mix(wyhash_read8(p) ^ wyhash_secret[1], wyhash_read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        // 最后 16 字节（可能与已处理部分重叠）
+        a = wyhash_read8(p + i - 16);
+        b = wyhash_read8(p + i - 8);
+    }
+
+    a ^= wyhash_secret[1];
+    b ^= seed;
+    wyhash_mum(&a, &b);
+    return wyhash_mix(a ^ wyhash_secret[0] ^ len, b ^ wyhash_secret[1]);
+}
+
+// 计算 32 位哈希值
+uint32_t wyhash32(const void *key, size_t len, uint64_t seed) {
+    uint64_t h = wyhash(key, len, seed);
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+// 计算 64 位整数的哈希值（wyhash 8 字节分支的展开）
+uint64_t wyhash_u64(uint64_t value, uint64_t seed) {
+    uint64_t lo = value & 0xffffffffULL;
+    uint64_t hi = value >> 32;
+    uint64_t a = (lo << 32) | hi;
+    uint64_t b = (hi << 32) | lo;
+
+    seed ^= wyhash_mix(seed ^ wyhash_secret[0], wyhash_secret[1]);
+    a ^= wyhash_secret[1];
+    b ^= seed;
+    wyhash_mum(&a, &b);
+    return wyhash_mix(a ^ wyhash_secret[0] ^ 8, b ^ wyhash_secret[1]);
+}
+
+// 从系统熵源生成随机种子
+uint64_t wyhash_seed_random(void) {
+    uint64_t seed;
+    if (getrandom(&seed, sizeof(seed), GRND_NONBLOCK) == (ssize_t)sizeof(seed)) {
+        return seed;
+    }
+
+    // 熵源不可用：混合时间、进程号和栈地址
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    seed = wyhash_mix((uint64_t)ts.tv_sec ^ wyhash_secret[0], (uint64_t)ts.tv_nsec ^ wyhash_secret[1]);
+    seed = wyhash_mix(seed ^ (uint64_t)getpid(), (uint64_t)(uintptr_t)&ts ^ wyhash_secret[2]);
+    return seed;
+}
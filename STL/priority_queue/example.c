@@ -161,11 +161,12 @@ void heap_allocation_example()
         pq_push(heap, value);
     }
     
-    // 出队并检查内存释放
-    printf("\n出队元素 (自动释放内存):\n");
-    while (!pq_is_empty(heap)) {
-        void *element;
-        pq_pop(heap); // 会自动调用析构函数释放内存
+    // 出队不调用析构函数，取出的元素由调用者释放
+    printf("\n出队元素 (手动释放内存):\n");
+    void *element;
+    while (pq_peek(heap, &element) == PQ_SUCCESS) {
+        pq_pop(heap);
+        heap_data_destructor(element);
     }
     
     // 销毁堆
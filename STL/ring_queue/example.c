@@ -60,10 +60,11 @@ void basic_operations_demo()
         printf("队首元素: %d\n", *(int*)element);
     }
     
-    // 使用会调用析构函数的出队方法
-    printf("\n使用 dequeue 出队剩余元素 (自动调用析构函数):\n");
-    while (!ring_queue_is_empty(queue)) {
-        ring_queue_dequeue(queue);  // element将被置为NULL
+    // 出队不调用析构函数，取出的元素由调用者释放
+    printf("\n使用 dequeue 出队剩余元素 (手动释放):\n");
+    while (ring_queue_peek(queue, &element) == RING_QUEUE_SUCCESS) {
+        ring_queue_dequeue(queue);
+        int_destructor(element);
     }
     
     // 尝试从空队列出队
@@ -103,10 +104,13 @@ void auto_destructor_demo()
         printf("\n队首元素: %s (未出队)\n", (char*)element);
     }
     
-    // 出队部分元素 - 调用析构函数
-    printf("\n出队部分元素 (自动调用析构函数):\n");
+    // 出队部分元素 - 出队不调用析构函数，手动释放
+    printf("\n出队部分元素 (手动释放):\n");
     for (int i = 0; i < 2; i++) {
-        ring_queue_dequeue(queue);  // element被析构后置为NULL
+        if (ring_queue_peek(queue, &element) == RING_QUEUE_SUCCESS) {
+            ring_queue_dequeue(queue);
+            string_destructor(element);
+        }
     }
     
     // 剩余元素通过清空函数自动析构
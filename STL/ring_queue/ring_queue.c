@@ -93,23 +93,21 @@ void ring_queue_clear(ring_queue_t *queue)
         return;
     }
     
-    // 如果有析构函数，则对每个元素调用它
+    // 如果有析构函数，则对每个元素调用它（出队不调用析构函数，这里需要直接遍历）
     if (queue->element_destructor) {
-        while (!ring_queue_is_empty(queue)) {
-            if (ring_queue_dequeue(queue) == RING_QUEUE_ERROR) {
-#ifdef DEBUG
-                perror("[ring_queue_clear] Failed to dequeue element.");
-#endif
-                break;
-            }
+        size_t index = queue->head;
+        for (size_t i = 0; i < queue->size; i++) {
+            queue->element_destructor(queue->buffer[index]);
+            queue->buffer[index] = NULL;
+            index = (index + 1) % queue->capacity;
         }
-    } else {
-        // 没有析构函数，直接重置队列状态
-        queue->head = 0;
-        queue->tail = 0;
-        queue->size = 0;
-        queue->is_full = 0;
     }
+
+    // 重置队列状态
+    queue->head = 0;
+    queue->tail = 0;
+    queue->size = 0;
+    queue->is_full = 0;
 }
 
 // 入队操作
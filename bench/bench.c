@@ -0,0 +1,507 @@
+#define _GNU_SOURCE
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <malloc.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#define BENCH_ZIPF_THETA 0.99
+#define BENCH_SORT_MAX_ROUNDS 100
+
+//-----------------------------
+// 随机数与键分布
+//-----------------------------
+
+// splitmix64：种子扩展和键打散
+static inline uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// [0, 1) 均匀浮点数
+static inline double random_unit(uint64_t *state) {
+    return (splitmix64(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Zipf 分布生成器（Gray 等人的方法，YCSB 同款）
+typedef struct {
+    uint64_t n;
+    double theta;
+    double alpha;
+    double zetan;
+    double eta;
+} zipf_t;
+
+static double zeta(uint64_t n, double theta) {
+    double sum = 0;
+    for (uint64_t i = 1; i <= n; i++) {
+        sum += 1.0 / pow((double)i, theta);
+    }
+    return sum;
+}
+
+static void zipf_init(zipf_t *z, uint64_t n, double theta) {
+    double zeta2 = zeta(2, theta);
+    z->n = n;
+    z->theta = theta;
+    z->alpha = 1.0 / (1.0 - theta);
+    z->zetan = zeta(n, theta);
+    z->eta = (1.0 - pow(2.0 / (double)n, 1.0 - theta)) / (1.0 - zeta2 / z->zetan);
+}
+
+// 生成排名（0 最热）
+static uint64_t zipf_next(const zipf_t *z, uint64_t *state) {
+    double u = random_unit(state);
+    double uz = u * z->zetan;
+    if (uz < 1.0) {
+        return 0;
+    }
+    if (uz < 1.0 + pow(0.5, z->theta)) {
+        return 1;
+    }
+    uint64_t rank = (uint64_t)((double)z->n * pow(z->eta * u - z->eta + 1.0, z->alpha));
+    return rank < z->n ? rank : z->n - 1;
+}
+
+// 把排名打散到整个键空间，热点键不集中在键空间开头
+static inline uint64_t scramble(uint64_t rank, uint64_t n) {
+    uint64_t state = rank;
+    return splitmix64(&state) % n;
+}
+
+// 按分布生成 count 个 [0, n) 内的键
+static void generate_keys(uint64_t *keys, size_t count, uint64_t n, bench_dist_t dist, uint64_t seed) {
+    uint64_t state = seed;
+
+    switch (dist) {
+    case BENCH_DIST_UNIFORM:
+        for (size_t i = 0; i < count; i++) {
+            keys[i] = splitmix64(&state) % n;
+        }
+        break;
+    case BENCH_DIST_ZIPF: {
+        zipf_t z;
+        zipf_init(&z, n, BENCH_ZIPF_THETA);
+        for (size_t i = 0; i < count; i++) {
+            keys[i] = scramble(zipf_next(&z, &state), n);
+        }
+        break;
+    }
+    case BENCH_DIST_SEQ:
+    default: {
+        uint64_t start = splitmix64(&state) % n;
+        for (size_t i = 0; i < count; i++) {
+            keys[i] = (start + i) % n;
+        }
+        break;
+    }
+    }
+}
+
+// 0..n-1 的随机排列
+static void generate_permutation(uint64_t *keys, size_t n, uint64_t seed) {
+    uint64_t state = seed;
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = i;
+    }
+    for (size_t i = n; i > 1; i--) {
+        size_t j = splitmix64(&state) % i;
+        uint64_t tmp = keys[i - 1];
+        keys[i - 1] = keys[j];
+        keys[j] = tmp;
+    }
+}
+
+static const char *const dist_names[BENCH_DIST_COUNT] = { "uniform", "zipf", "seq" };
+
+// 获取键分布名称
+const char *bench_dist_name(bench_dist_t dist) {
+    return dist < BENCH_DIST_COUNT ? dist_names[dist] : "unknown";
+}
+
+// 按名称查找键分布
+bool bench_dist_parse(const char *name, bench_dist_t *dist) {
+    for (int i = 0; i < BENCH_DIST_COUNT; i++) {
+        if (strcmp(name, dist_names[i]) == 0) {
+            *dist = (bench_dist_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+//-----------------------------
+// 计时、内存与硬件计数器
+//-----------------------------
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 测量一次计时调用本身的开销，采样延迟时扣除
+static uint64_t timer_overhead(void) {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t a = now_ns();
+        uint64_t b = now_ns();
+        if (b - a < best) {
+            best = b - a;
+        }
+    }
+    return best;
+}
+
+// 当前堆上已分配的字节数（含 mmap 分配的大块）
+static size_t heap_in_use(void) {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+// 打开缓存未命中计数器，不可用（无权限或虚拟机）时返回 -1
+static int perf_open_cache_misses(void) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void perf_start(int fd) {
+    if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+// 停止计数并返回计数值，不可用返回 -1
+static double perf_stop(int fd) {
+    if (fd < 0) {
+        return -1;
+    }
+    uint64_t count = 0;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &count, sizeof(count)) != (ssize_t)sizeof(count)) {
+        return -1;
+    }
+    return (double)count;
+}
+
+//-----------------------------
+// 统计
+//-----------------------------
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// 从延迟样本计算分位数
+static void fill_percentiles(bench_result_t *r, uint64_t *samples, size_t count) {
+    if (count == 0) {
+        r->p50_ns = r->p90_ns = r->p99_ns = r->p999_ns = r->max_ns = 0;
+        return;
+    }
+    qsort(samples, count, sizeof(uint64_t), compare_u64);
+    r->p50_ns = (double)samples[(count - 1) * 50 / 100];
+    r->p90_ns = (double)samples[(count - 1) * 90 / 100];
+    r->p99_ns = (double)samples[(count - 1) * 99 / 100];
+    r->p999_ns = (double)samples[(count - 1) * 999 / 1000];
+    r->max_ns = (double)samples[count - 1];
+}
+
+static void result_init(bench_result_t *r, const bench_target_t *target, bench_dist_t dist,
+                        const char *phase, size_t size, size_t ops, double seconds) {
+    memset(r, 0, sizeof(*r));
+    r->target = target->name;
+    r->workload = bench_dist_name(dist);
+    r->phase = phase;
+    r->size = size;
+    r->ops = ops;
+    r->seconds = seconds;
+    r->ops_per_sec = seconds > 0 ? (double)ops / seconds : 0;
+    r->bytes_per_element = -1;
+    r->cache_misses_per_op = -1;
+}
+
+//-----------------------------
+// 运行
+//-----------------------------
+
+// 键值容器与队列：加载阶段 + 混合阶段
+static size_t run_container(const bench_target_t *target, bench_dist_t dist, size_t size,
+                            const bench_config_t *config, bench_result_t *results) {
+    size_t ops = config->ops;
+    unsigned int sample = config->sample ? config->sample : 1;
+    uint64_t *order = malloc(size * sizeof(uint64_t));
+    uint64_t *keys = malloc(ops * sizeof(uint64_t));
+    uint8_t *is_read = malloc(ops);
+    uint64_t *samples = malloc((ops / sample + 1) * sizeof(uint64_t));
+    if (!order || !keys || !is_read || !samples) {
+        free(order);
+        free(keys);
+        free(is_read);
+        free(samples);
+        return 0;
+    }
+
+    // 负载在计时前全部生成好
+    uint64_t state = config->seed;
+    generate_permutation(order, size, splitmix64(&state));
+    generate_keys(keys, ops, size, dist, splitmix64(&state));
+    for (size_t i = 0; i < ops; i++) {
+        is_read[i] = random_unit(&state) < config->read_ratio;
+    }
+
+    uint64_t overhead = timer_overhead();
+    int perf_fd = perf_open_cache_misses();
+
+    // 加载阶段
+    size_t heap_before = heap_in_use();
+    void *ctx = target->create(size);
+    if (!ctx) {
+        free(order);
+        free(keys);
+        free(is_read);
+        free(samples);
+        if (perf_fd >= 0) {
+            close(perf_fd);
+        }
+        return 0;
+    }
+
+    size_t sampled = 0;
+    perf_start(perf_fd);
+    uint64_t start = now_ns();
+    for (size_t i = 0; i < size; i++) {
+        if (i % sample == 0) {
+            uint64_t t0 = now_ns();
+            target->insert(ctx, order[i]);
+            uint64_t t1 = now_ns();
+            samples[sampled++] = t1 - t0 > overhead ? t1 - t0 - overhead : 0;
+        } else {
+            target->insert(ctx, order[i]);
+        }
+    }
+    uint64_t elapsed = now_ns() - start;
+    double misses = perf_stop(perf_fd);
+    size_t heap_after = heap_in_use();
+
+    bench_result_t *load = &results[0];
+    result_init(load, target, dist, "load", size, size, elapsed / 1e9);
+    fill_percentiles(load, samples, sampled);
+    if (heap_after > heap_before && size > 0) {
+        load->bytes_per_element = (double)(heap_after - heap_before) / (double)size;
+    }
+    if (misses >= 0) {
+        load->cache_misses_per_op = misses / (double)size;
+    }
+
+    // 混合阶段：写操作交替删除和插入，容器大小保持在 size 附近
+    // 队列的删除为出队、插入为入队，队列长度同样保持不变
+    size_t writes = 0;
+    volatile size_t hits = 0;
+    sampled = 0;
+    perf_start(perf_fd);
+    start = now_ns();
+    for (size_t i = 0; i < ops; i++) {
+        uint64_t t0 = 0;
+        bool timed = (i % sample == 0);
+        if (timed) {
+            t0 = now_ns();
+        }
+
+        if (is_read[i]) {
+            hits += target->lookup(ctx, keys[i]);
+        } else if (writes++ & 1) {
+            hits += target->insert(ctx, keys[i]);
+        } else {
+            hits += target->remove(ctx, keys[i]);
+        }
+
+        if (timed) {
+            uint64_t t1 = now_ns();
+            samples[sampled++] = t1 - t0 > overhead ? t1 - t0 - overhead : 0;
+        }
+    }
+    elapsed = now_ns() - start;
+    misses = perf_stop(perf_fd);
+
+    bench_result_t *mixed = &results[1];
+    result_init(mixed, target, dist, "mixed", size, ops, elapsed / 1e9);
+    fill_percentiles(mixed, samples, sampled);
+    mixed->bytes_per_element = load->bytes_per_element;
+    if (misses >= 0) {
+        mixed->cache_misses_per_op = misses / (double)ops;
+    }
+
+    target->destroy(ctx);
+    if (perf_fd >= 0) {
+        close(perf_fd);
+    }
+    free(order);
+    free(keys);
+    free(is_read);
+    free(samples);
+    return 2;
+}
+
+// 排序：每轮复制原始数据后排序一次，延迟分位数按轮统计
+static size_t run_sort(const bench_target_t *target, bench_dist_t dist, size_t size,
+                       const bench_config_t *config, bench_result_t *results) {
+    size_t rounds = size ? config->ops / size : 0;
+    if (rounds < 1) {
+        rounds = 1;
+    }
+    if (rounds > BENCH_SORT_MAX_ROUNDS) {
+        rounds = BENCH_SORT_MAX_ROUNDS;
+    }
+
+    uint64_t *source = malloc(size * sizeof(uint64_t));
+    uint64_t *data = malloc(size * sizeof(uint64_t));
+    uint64_t *samples = malloc(rounds * sizeof(uint64_t));
+    if (!source || !data || !samples) {
+        free(source);
+        free(data);
+        free(samples);
+        return 0;
+    }
+
+    // 均匀分布为随机 64 位值，Zipf 分布重复值多，顺序分布为已排序数据
+    uint64_t state = config->seed;
+    if (dist == BENCH_DIST_UNIFORM) {
+        for (size_t i = 0; i < size; i++) {
+            source[i] = splitmix64(&state);
+        }
+    } else if (dist == BENCH_DIST_ZIPF) {
+        generate_keys(source, size, size, dist, splitmix64(&state));
+    } else {
+        for (size_t i = 0; i < size; i++) {
+            source[i] = i;
+        }
+    }
+
+    int perf_fd = perf_open_cache_misses();
+    uint64_t total = 0;
+    double misses = 0;
+
+    for (size_t r = 0; r < rounds; r++) {
+        memcpy(data, source, size * sizeof(uint64_t));
+        perf_start(perf_fd);
+        uint64_t start = now_ns();
+        target->sort(data, size);
+        samples[r] = now_ns() - start;
+        double m = perf_stop(perf_fd);
+        misses = (m < 0 || misses < 0) ? -1 : misses + m;
+        total += samples[r];
+
+        // 校验结果有序
+        for (size_t i = 1; i < size; i++) {
+            if (data[i - 1] > data[i]) {
+                fprintf(stderr, "%s: 排序结果错误\n", target->name);
+                break;
+            }
+        }
+    }
+
+    bench_result_t *res = &results[0];
+    result_init(res, target, dist, "sort", size, size * rounds, total / 1e9);
+    fill_percentiles(res, samples, rounds);
+    res->bytes_per_element = sizeof(uint64_t);
+    if (misses >= 0 && size > 0) {
+        res->cache_misses_per_op = misses / (double)(size * rounds);
+    }
+
+    if (perf_fd >= 0) {
+        close(perf_fd);
+    }
+    free(source);
+    free(data);
+    free(samples);
+    return 1;
+}
+
+// 运行一个目标在一种负载下的全部阶段
+size_t bench_run(const bench_target_t *target, bench_dist_t dist, size_t size,
+                 const bench_config_t *config, bench_result_t *results) {
+    if (!target || !config || !results || size == 0) {
+        return 0;
+    }
+    if (target->kind == BENCH_KIND_SORT) {
+        return run_sort(target, dist, size, config, results);
+    }
+    return run_container(target, dist, size, config, results);
+}
+
+//-----------------------------
+// 输出
+//-----------------------------
+
+// 不可用的数值在 CSV 中留空，在 JSON 中输出 null
+static void print_optional(bench_format_t format, double value) {
+    if (value >= 0) {
+        printf("%.3f", value);
+    } else if (format == BENCH_FORMAT_JSON) {
+        printf("null");
+    }
+}
+
+// 输出结果表头
+void bench_print_header(bench_format_t format) {
+    if (format == BENCH_FORMAT_JSON) {
+        printf("[\n");
+    } else {
+        printf("target,workload,size,phase,ops,seconds,ops_per_sec,"
+               "p50_ns,p90_ns,p99_ns,p999_ns,max_ns,bytes_per_element,cache_misses_per_op\n");
+    }
+}
+
+// 输出一条结果
+void bench_print_result(bench_format_t format, const bench_result_t *r, bool first) {
+    if (format == BENCH_FORMAT_JSON) {
+        printf("%s  {\"target\": \"%s\", \"workload\": \"%s\", \"size\": %zu, \"phase\": \"%s\", "
+               "\"ops\": %zu, \"seconds\": %.6f, \"ops_per_sec\": %.1f, "
+               "\"p50_ns\": %.0f, \"p90_ns\": %.0f, \"p99_ns\": %.0f, \"p999_ns\": %.0f, \"max_ns\": %.0f, "
+               "\"bytes_per_element\": ",
+               first ? "" : ",\n", r->target, r->workload, r->size, r->phase,
+               r->ops, r->seconds, r->ops_per_sec,
+               r->p50_ns, r->p90_ns, r->p99_ns, r->p999_ns, r->max_ns);
+        print_optional(format, r->bytes_per_element);
+        printf(", \"cache_misses_per_op\": ");
+        print_optional(format, r->cache_misses_per_op);
+        printf("}");
+    } else {
+        printf("%s,%s,%zu,%s,%zu,%.6f,%.1f,%.0f,%.0f,%.0f,%.0f,%.0f,",
+               r->target, r->workload, r->size, r->phase, r->ops, r->seconds, r->ops_per_sec,
+               r->p50_ns, r->p90_ns, r->p99_ns, r->p999_ns, r->max_ns);
+        print_optional(format, r->bytes_per_element);
+        printf(",");
+        print_optional(format, r->cache_misses_per_op);
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+// 输出结尾
+void bench_print_footer(bench_format_t format) {
+    if (format == BENCH_FORMAT_JSON) {
+        printf("\n]\n");
+    }
+}
@@ -0,0 +1,153 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * 性能测试框架
+ *
+ * 每个被测容器实现一个 bench_target_t 适配器，驱动程序按统一的负载运行：
+ * 1. 加载阶段：按随机排列插入 size 个键（键为 0..size-1）
+ * 2. 混合阶段：按 read_ratio 混合读写，读为查找，写交替为删除和插入，容器大小基本不变
+ * 排序类目标每轮对 size 个元素排序一次。
+ *
+ * 负载的键分布：
+ *   uniform  均匀分布
+ *   zipf     Zipf 分布（theta = 0.99，热点键打散到整个键空间）
+ *   seq      顺序访问
+ */
+
+/**
+ * 目标类型
+ */
+typedef enum {
+    BENCH_KIND_MAP = 0,     // 键值容器：insert/lookup/remove
+    BENCH_KIND_QUEUE,       // 队列：insert 为入队，remove 为出队，lookup 为查看队首
+    BENCH_KIND_SORT,        // 排序：sort
+} bench_kind_t;
+
+/**
+ * 键分布
+ */
+typedef enum {
+    BENCH_DIST_UNIFORM = 0,
+    BENCH_DIST_ZIPF,
+    BENCH_DIST_SEQ,
+    BENCH_DIST_COUNT
+} bench_dist_t;
+
+/**
+ * 被测目标适配器
+ */
+typedef struct bench_target {
+    const char *name;       // 目标名称
+    bench_kind_t kind;      // 目标类型
+
+    // 创建容器，size 为预期元素数量；返回 NULL 表示失败
+    void *(*create)(size_t size);
+    // 销毁容器及其中的所有元素
+    void (*destroy)(void *ctx);
+
+    // 容器操作，返回 true 表示命中或成功
+    bool (*insert)(void *ctx, uint64_t key);
+    bool (*lookup)(void *ctx, uint64_t key);
+    bool (*remove)(void *ctx, uint64_t key);
+
+    // 排序（仅 BENCH_KIND_SORT）
+    void (*sort)(uint64_t *data, size_t count);
+} bench_target_t;
+
+/**
+ * 运行配置
+ */
+typedef struct bench_config {
+    size_t ops;             // 混合阶段操作数（排序为总排序元素数）
+    double read_ratio;      // 读操作比例
+    uint64_t seed;          // 随机种子（相同种子生成相同负载）
+    unsigned int sample;    // 每隔多少个操作采样一次延迟
+} bench_config_t;
+
+/**
+ * 单个阶段的测试结果
+ */
+typedef struct bench_result {
+    const char *target;     // 目标名称
+    const char *workload;   // 键分布名称
+    const char *phase;      // 阶段：load / mixed / sort
+    size_t size;            // 元素数量
+    size_t ops;             // 操作数
+    double seconds;         // 总耗时
+    double ops_per_sec;     // 吞吐
+    double p50_ns;          // 延迟分位数（纳秒）
+    double p90_ns;
+    double p99_ns;
+    double p999_ns;
+    double max_ns;
+    double bytes_per_element;   // 每元素堆内存，负数表示不可用
+    double cache_misses_per_op; // 每操作缓存未命中次数，负数表示不可用
+} bench_result_t;
+
+/**
+ * 结果输出格式
+ */
+typedef enum {
+    BENCH_FORMAT_CSV = 0,
+    BENCH_FORMAT_JSON,
+} bench_format_t;
+
+/**
+ * 获取键分布名称
+ * @param dist 键分布
+ * @return 名称字符串
+ */
+const char *bench_dist_name(bench_dist_t dist);
+
+/**
+ * 按名称查找键分布
+ * @param name 名称
+ * @param dist 输出键分布
+ * @return true表示找到
+ */
+bool bench_dist_parse(const char *name, bench_dist_t *dist);
+
+/**
+ * 运行一个目标在一种负载下的全部阶段
+ * @param target 目标适配器
+ * @param dist 键分布
+ * @param size 元素数量
+ * @param config 运行配置
+ * @param results 输出结果数组（至少 2 个元素）
+ * @return 结果数量，失败返回 0
+ */
+size_t bench_run(const bench_target_t *target, bench_dist_t dist, size_t size,
+                 const bench_config_t *config, bench_result_t *results);
+
+/**
+ * 输出结果表头（JSON 为数组开始）
+ * @param format 输出格式
+ */
+void bench_print_header(bench_format_t format);
+
+/**
+ * 输出一条结果
+ * @param format 输出格式
+ * @param result 结果
+ * @param first 是否为第一条（JSON 用于处理逗号）
+ */
+void bench_print_result(bench_format_t format, const bench_result_t *result, bool first);
+
+/**
+ * 输出结尾（JSON 为数组结束）
+ * @param format 输出格式
+ */
+void bench_print_footer(bench_format_t format);
+
+/**
+ * 所有已注册的目标
+ */
+extern const bench_target_t *const bench_targets[];
+extern const size_t bench_target_count;
+
+#endif /* __BENCH_H__ */
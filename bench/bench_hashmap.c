@@ -0,0 +1,118 @@
+#include <stddef.h>
+#include "bench.h"
+#include "../STL/hashmap/hashmap.h"
+#include "../STL/flat_hashmap/flat_hashmap.h"
+#include "../STL/concurrent_hashmap/concurrent_hashmap.h"
+
+// 键和值都是 8 字节整数，值等于键
+
+//-----------------------------
+// 哈希映射（默认 malloc 分配）
+//-----------------------------
+
+static void *hashmap_bench_create(size_t size) {
+    (void)size;
+    return hashmap_create(16, 0.75f, hashmap_hash_data, hashmap_compare_data);
+}
+
+// slab 分配模式
+static void *hashmap_slab_bench_create(size_t size) {
+    hashmap_t *map = hashmap_bench_create(size);
+    if (map && hashmap_set_alloc_mode(map, HASHMAP_ALLOC_SLAB) != HASHMAP_OK) {
+        hashmap_destroy(map);
+        return NULL;
+    }
+    return map;
+}
+
+static void hashmap_bench_destroy(void *ctx) {
+    hashmap_destroy(ctx);
+}
+
+static bool hashmap_bench_insert(void *ctx, uint64_t key) {
+    return hashmap_put(ctx, &key, sizeof(key), &key, sizeof(key)) == HASHMAP_OK;
+}
+
+static bool hashmap_bench_lookup(void *ctx, uint64_t key) {
+    uint64_t value;
+    return hashmap_get(ctx, &key, sizeof(key), &value, sizeof(value), NULL) == HASHMAP_OK;
+}
+
+static bool hashmap_bench_remove(void *ctx, uint64_t key) {
+    return hashmap_remove(ctx, &key, sizeof(key)) == HASHMAP_OK;
+}
+
+const bench_target_t bench_hashmap = {
+    "hashmap", BENCH_KIND_MAP, hashmap_bench_create, hashmap_bench_destroy,
+    hashmap_bench_insert, hashmap_bench_lookup, hashmap_bench_remove, NULL
+};
+
+const bench_target_t bench_hashmap_slab = {
+    "hashmap_slab", BENCH_KIND_MAP, hashmap_slab_bench_create, hashmap_bench_destroy,
+    hashmap_bench_insert, hashmap_bench_lookup, hashmap_bench_remove, NULL
+};
+
+//-----------------------------
+// 扁平哈希映射
+//-----------------------------
+
+static void *flat_hashmap_bench_create(size_t size) {
+    (void)size;
+    return flat_hashmap_create(sizeof(uint64_t), sizeof(uint64_t), 16, 0.875f,
+                               flat_hashmap_hash_data, flat_hashmap_compare_data);
+}
+
+static void flat_hashmap_bench_destroy(void *ctx) {
+    flat_hashmap_destroy(ctx);
+}
+
+static bool flat_hashmap_bench_insert(void *ctx, uint64_t key) {
+    return flat_hashmap_put(ctx, &key, sizeof(key), &key, sizeof(key)) == FLAT_HASHMAP_OK;
+}
+
+static bool flat_hashmap_bench_lookup(void *ctx, uint64_t key) {
+    uint64_t value;
+    return flat_hashmap_get(ctx, &key, sizeof(key), &value, sizeof(value), NULL) == FLAT_HASHMAP_OK;
+}
+
+static bool flat_hashmap_bench_remove(void *ctx, uint64_t key) {
+    return flat_hashmap_remove(ctx, &key, sizeof(key)) == FLAT_HASHMAP_OK;
+}
+
+const bench_target_t bench_flat_hashmap = {
+    "flat_hashmap", BENCH_KIND_MAP, flat_hashmap_bench_create, flat_hashmap_bench_destroy,
+    flat_hashmap_bench_insert, flat_hashmap_bench_lookup, flat_hashmap_bench_remove, NULL
+};
+
+//-----------------------------
+// 并发哈希映射（单线程驱动，衡量分片与读者纪元的额外开销）
+//-----------------------------
+
+static void *concurrent_hashmap_bench_create(size_t size) {
+    (void)size;
+    return concurrent_hashmap_create(0, 16, 0.75f, hashmap_hash_data, hashmap_compare_data);
+}
+
+static void concurrent_hashmap_bench_destroy(void *ctx) {
+    concurrent_hashmap_destroy(ctx);
+}
+
+static bool concurrent_hashmap_bench_insert(void *ctx, uint64_t key) {
+    return concurrent_hashmap_put(ctx, &key, sizeof(key), &key, sizeof(key)) == HASHMAP_OK;
+}
+
+static bool concurrent_hashmap_bench_lookup(void *ctx, uint64_t key) {
+    uint64_t value;
+    return concurrent_hashmap_get(ctx, &key, sizeof(key), &value, sizeof(value), NULL) == HASHMAP_OK;
+}
+
+static bool concurrent_hashmap_bench_remove(void *ctx, uint64_t key) {
+    return concurrent_hashmap_remove(ctx, &key, sizeof(key)) == HASHMAP_OK;
+}
+
+const bench_target_t bench_concurrent_hashmap = {
+    "concurrent_hashmap", BENCH_KIND_MAP,
+    concurrent_hashmap_bench_create, concurrent_hashmap_bench_destroy,
+    concurrent_hashmap_bench_insert, concurrent_hashmap_bench_lookup,
+    concurrent_hashmap_bench_remove, NULL
+};
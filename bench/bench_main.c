@@ -0,0 +1,251 @@
+/*
+ * 容器与排序性能测试
+ *
+ * 编译（在仓库根目录）：
+ *   gcc -O2 -pthread -o cstl_bench bench/bench.c bench/bench_main.c \
+ *       bench/bench_hashmap.c bench/bench_tree.c bench/bench_queue.c bench/bench_sort.c \
+ *       STL/hashmap/hashmap.c STL/hashmap/wyhash.c BaseStruct/rb_tree/rb_tree.c \
+ *       STL/flat_hashmap/flat_hashmap.c STL/concurrent_hashmap/concurrent_hashmap.c \
+ *       BaseStruct/avl_tree/avl_tree.c BaseStruct/splay_tree/splay_tree.c \
+ *       BaseStruct/b_tree/b_tree.c BaseStruct/radix_tree/radix_tree.c \
+ *       BaseStruct/lru_list/lru_list.c BaseStruct/lru_list/list.c BaseStruct/lru_list/hlist.c \
+ *       STL/priority_queue/priority_queue.c STL/ring_queue/ring_queue.c \
+ *       Algorithm/sort/sort.c -lm
+ *
+ * 用法：
+ *   cstl_bench [-t 目标,...] [-w uniform,zipf,seq] [-n 1K,1M,...] [-o 操作数]
+ *              [-r 读比例] [-f csv|json] [-s 种子] [-p 采样间隔] [-l]
+ *
+ * 示例：
+ *   cstl_bench -t hashmap,flat_hashmap -w zipf -n 1M -f json > result.json
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bench.h"
+
+extern const bench_target_t bench_hashmap;
+extern const bench_target_t bench_hashmap_slab;
+extern const bench_target_t bench_flat_hashmap;
+extern const bench_target_t bench_concurrent_hashmap;
+extern const bench_target_t bench_rb_tree;
+extern const bench_target_t bench_avl_tree;
+extern const bench_target_t bench_splay_tree;
+extern const bench_target_t bench_b_tree;
+extern const bench_target_t bench_radix_tree;
+extern const bench_target_t bench_lru_list;
+extern const bench_target_t bench_priority_queue;
+extern const bench_target_t bench_ring_queue;
+extern const bench_target_t bench_sort_auto;
+extern const bench_target_t bench_sort_quick;
+extern const bench_target_t bench_sort_merge;
+extern const bench_target_t bench_sort_heap;
+extern const bench_target_t bench_sort_parallel;
+extern const bench_target_t bench_sort_radix;
+extern const bench_target_t bench_sort_define;
+extern const bench_target_t bench_sort_define_merge;
+extern const bench_target_t bench_sort_define_heap;
+extern const bench_target_t bench_qsort;
+
+const bench_target_t *const bench_targets[] = {
+    &bench_hashmap,
+    &bench_hashmap_slab,
+    &bench_flat_hashmap,
+    &bench_concurrent_hashmap,
+    &bench_rb_tree,
+    &bench_avl_tree,
+    &bench_splay_tree,
+    &bench_b_tree,
+    &bench_radix_tree,
+    &bench_lru_list,
+    &bench_priority_queue,
+    &bench_ring_queue,
+    &bench_sort_auto,
+    &bench_sort_quick,
+    &bench_sort_merge,
+    &bench_sort_heap,
+    &bench_sort_parallel,
+    &bench_sort_radix,
+    &bench_sort_define,
+    &bench_sort_define_merge,
+    &bench_sort_define_heap,
+    &bench_qsort,
+};
+const size_t bench_target_count = sizeof(bench_targets) / sizeof(bench_targets[0]);
+
+#define MAX_SIZES 16
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "用法: %s [选项]\n"
+            "  -t 目标,...     要测试的目标（默认全部，-l 查看列表）\n"
+            "  -w 分布,...     键分布: uniform,zipf,seq（默认全部）\n"
+            "  -n 大小,...     元素数量，支持 K/M 后缀（默认 1K,100K,1M）\n"
+            "  -o 操作数       混合阶段操作数（默认 1000000）\n"
+            "  -r 读比例       混合阶段读操作比例（默认 0.9）\n"
+            "  -f csv|json     输出格式（默认 csv）\n"
+            "  -s 种子         随机种子（默认 42）\n"
+            "  -p 间隔         每隔多少个操作采样一次延迟（默认 16）\n"
+            "  -l              列出所有目标\n",
+            prog);
+}
+
+// 解析带 K/M 后缀的数量
+static bool parse_count(const char *s, size_t *out) {
+    char *end;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (end == s) {
+        return false;
+    }
+    if (*end == 'K' || *end == 'k') {
+        v *= 1000ULL;
+        end++;
+    } else if (*end == 'M' || *end == 'm') {
+        v *= 1000000ULL;
+        end++;
+    }
+    if (*end != '\0' || v == 0) {
+        return false;
+    }
+    *out = (size_t)v;
+    return true;
+}
+
+static const bench_target_t *find_target(const char *name) {
+    for (size_t i = 0; i < bench_target_count; i++) {
+        if (strcmp(bench_targets[i]->name, name) == 0) {
+            return bench_targets[i];
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    bench_config_t config = { .ops = 1000000, .read_ratio = 0.9, .seed = 42, .sample = 16 };
+    bench_format_t format = BENCH_FORMAT_CSV;
+    bool selected[sizeof(bench_targets) / sizeof(bench_targets[0])] = { false };
+    bool any_target = false;
+    bool dists[BENCH_DIST_COUNT] = { false };
+    bool any_dist = false;
+    size_t sizes[MAX_SIZES] = { 1000, 100000, 1000000 };
+    size_t size_count = 3;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:w:n:o:r:f:s:p:lh")) != -1) {
+        char *list, *tok, *save;
+        switch (opt) {
+        case 't':
+            list = strdup(optarg);
+            for (tok = strtok_r(list, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+                const bench_target_t *t = find_target(tok);
+                if (!t) {
+                    fprintf(stderr, "未知目标: %s\n", tok);
+                    free(list);
+                    return 1;
+                }
+                for (size_t i = 0; i < bench_target_count; i++) {
+                    if (bench_targets[i] == t) {
+                        selected[i] = true;
+                    }
+                }
+                any_target = true;
+            }
+            free(list);
+            break;
+        case 'w':
+            list = strdup(optarg);
+            for (tok = strtok_r(list, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+                bench_dist_t dist;
+                if (!bench_dist_parse(tok, &dist)) {
+                    fprintf(stderr, "未知分布: %s\n", tok);
+                    free(list);
+                    return 1;
+                }
+                dists[dist] = true;
+                any_dist = true;
+            }
+            free(list);
+            break;
+        case 'n':
+            size_count = 0;
+            list = strdup(optarg);
+            for (tok = strtok_r(list, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+                if (size_count == MAX_SIZES || !parse_count(tok, &sizes[size_count])) {
+                    fprintf(stderr, "无效大小: %s\n", tok);
+                    free(list);
+                    return 1;
+                }
+                size_count++;
+            }
+            free(list);
+            break;
+        case 'o':
+            if (!parse_count(optarg, &config.ops)) {
+                fprintf(stderr, "无效操作数: %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 'r':
+            config.read_ratio = atof(optarg);
+            if (config.read_ratio < 0 || config.read_ratio > 1) {
+                fprintf(stderr, "读比例必须在 0~1 之间\n");
+                return 1;
+            }
+            break;
+        case 'f':
+            if (strcmp(optarg, "json") == 0) {
+                format = BENCH_FORMAT_JSON;
+            } else if (strcmp(optarg, "csv") == 0) {
+                format = BENCH_FORMAT_CSV;
+            } else {
+                fprintf(stderr, "未知格式: %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 's':
+            config.seed = strtoull(optarg, NULL, 0);
+            break;
+        case 'p':
+            config.sample = (unsigned int)atoi(optarg);
+            if (config.sample == 0) {
+                config.sample = 1;
+            }
+            break;
+        case 'l':
+            for (size_t i = 0; i < bench_target_count; i++) {
+                printf("%s\n", bench_targets[i]->name);
+            }
+            return 0;
+        default:
+            usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    bench_print_header(format);
+    bool first = true;
+    for (size_t i = 0; i < bench_target_count; i++) {
+        if (any_target && !selected[i]) {
+            continue;
+        }
+        for (int d = 0; d < BENCH_DIST_COUNT; d++) {
+            if (any_dist && !dists[d]) {
+                continue;
+            }
+            for (size_t s = 0; s < size_count; s++) {
+                bench_result_t results[2];
+                size_t n = bench_run(bench_targets[i], (bench_dist_t)d, sizes[s], &config, results);
+                if (n == 0) {
+                    fprintf(stderr, "%s: 运行失败（大小 %zu）\n", bench_targets[i]->name, sizes[s]);
+                }
+                for (size_t r = 0; r < n; r++) {
+                    bench_print_result(format, &results[r], first);
+                    first = false;
+                }
+            }
+        }
+    }
+    bench_print_footer(format);
+    return 0;
+}
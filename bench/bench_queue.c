@@ -0,0 +1,150 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "../BaseStruct/lru_list/lru_list.h"
+#include "../STL/priority_queue/priority_queue.h"
+#include "../STL/ring_queue/ring_queue.h"
+
+//-----------------------------
+// LRU链表：节点按键预先分配，键 k 固定使用第 k 个节点
+//-----------------------------
+
+typedef struct {
+    struct lru_node node;
+    uint64_t key;
+} lru_bench_item_t;
+
+typedef struct {
+    lru_list_t *lru;
+    lru_bench_item_t *items;
+    size_t size;
+} lru_bench_t;
+
+static unsigned int lru_bench_hash(const void *key, void *arg) {
+    uint64_t k = *(const uint64_t *)key;
+    (void)arg;
+    return (unsigned int)((k * 0x9e3779b97f4a7c15ULL) >> 32);
+}
+
+static int lru_bench_compare(const void *key, const void *node, void *arg) {
+    const lru_bench_item_t *item = container_of(node, lru_bench_item_t, node);
+    (void)arg;
+    return *(const uint64_t *)key != item->key;
+}
+
+static void *lru_bench_create(size_t size) {
+    lru_bench_t *b = malloc(sizeof(lru_bench_t));
+    if (!b) {
+        return NULL;
+    }
+    b->size = size;
+    b->items = malloc(size * sizeof(lru_bench_item_t));
+    b->lru = lru_create(0, (unsigned int)size, lru_bench_hash, lru_bench_compare, NULL);
+    if (!b->items || !b->lru) {
+        free(b->items);
+        lru_destroy(b->lru);
+        free(b);
+        return NULL;
+    }
+    for (size_t i = 0; i < size; i++) {
+        b->items[i].key = i;
+    }
+    return b;
+}
+
+static void lru_bench_destroy(void *ctx) {
+    lru_bench_t *b = ctx;
+    lru_destroy(b->lru);
+    free(b->items);
+    free(b);
+}
+
+static bool lru_bench_insert(void *ctx, uint64_t key) {
+    lru_bench_t *b = ctx;
+    return lru_put(b->lru, &b->items[key].node, &key) == 0;
+}
+
+static bool lru_bench_lookup(void *ctx, uint64_t key) {
+    lru_bench_t *b = ctx;
+    return lru_get(b->lru, &key) != NULL;
+}
+
+static bool lru_bench_remove(void *ctx, uint64_t key) {
+    lru_bench_t *b = ctx;
+    return lru_remove(b->lru, &key) == 0;
+}
+
+const bench_target_t bench_lru_list = {
+    "lru_list", BENCH_KIND_MAP, lru_bench_create, lru_bench_destroy,
+    lru_bench_insert, lru_bench_lookup, lru_bench_remove, NULL
+};
+
+//-----------------------------
+// 优先队列（最小堆），元素为编码在指针里的整数
+//-----------------------------
+
+static int pq_bench_compare(const void *a, const void *b, void *arg) {
+    uintptr_t x = (uintptr_t)a, y = (uintptr_t)b;
+    (void)arg;
+    return (x > y) - (x < y);
+}
+
+static void *pq_bench_create(size_t size) {
+    return pq_create(size, PQ_MIN_HEAP, pq_bench_compare, NULL, NULL);
+}
+
+static void pq_bench_destroy(void *ctx) {
+    pq_destroy(ctx);
+}
+
+static bool pq_bench_push(void *ctx, uint64_t key) {
+    return pq_push(ctx, (void *)(uintptr_t)key) == PQ_SUCCESS;
+}
+
+static bool pq_bench_peek(void *ctx, uint64_t key) {
+    void *top;
+    (void)key;
+    return pq_peek(ctx, &top) == PQ_SUCCESS;
+}
+
+static bool pq_bench_pop(void *ctx, uint64_t key) {
+    (void)key;
+    return pq_pop(ctx) == PQ_SUCCESS;
+}
+
+const bench_target_t bench_priority_queue = {
+    "priority_queue", BENCH_KIND_QUEUE, pq_bench_create, pq_bench_destroy,
+    pq_bench_push, pq_bench_peek, pq_bench_pop, NULL
+};
+
+//-----------------------------
+// 环形队列
+//-----------------------------
+
+static void *ring_queue_bench_create(size_t size) {
+    return ring_queue_create(size + 1, NULL);
+}
+
+static void ring_queue_bench_destroy(void *ctx) {
+    ring_queue_destroy(ctx);
+}
+
+static bool ring_queue_bench_enqueue(void *ctx, uint64_t key) {
+    return ring_queue_enqueue(ctx, (void *)(uintptr_t)key) == RING_QUEUE_SUCCESS;
+}
+
+static bool ring_queue_bench_peek(void *ctx, uint64_t key) {
+    void *front;
+    (void)key;
+    return ring_queue_peek(ctx, &front) == RING_QUEUE_SUCCESS;
+}
+
+static bool ring_queue_bench_dequeue(void *ctx, uint64_t key) {
+    (void)key;
+    return ring_queue_dequeue(ctx) == RING_QUEUE_SUCCESS;
+}
+
+const bench_target_t bench_ring_queue = {
+    "ring_queue", BENCH_KIND_QUEUE, ring_queue_bench_create, ring_queue_bench_destroy,
+    ring_queue_bench_enqueue, ring_queue_bench_peek, ring_queue_bench_dequeue, NULL
+};
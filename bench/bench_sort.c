@@ -0,0 +1,73 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "../Algorithm/sort/sort.h"
+#include "../Algorithm/sort/sort_define.h"
+
+SORT_DEFINE(bench_u64, uint64_t, a < b)
+
+static int sort_bench_compare(const void *a, const void *b, void *context) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    (void)context;
+    return (x > y) - (x < y);
+}
+
+static int qsort_bench_compare(const void *a, const void *b) {
+    return sort_bench_compare(a, b, NULL);
+}
+
+static void sort_auto_bench(uint64_t *data, size_t count) {
+    sort(data, count, sizeof(uint64_t), sort_bench_compare, NULL, SORT_AUTO);
+}
+
+static void sort_quick_bench(uint64_t *data, size_t count) {
+    quick_sort(data, count, sizeof(uint64_t), sort_bench_compare, NULL);
+}
+
+static void sort_merge_bench(uint64_t *data, size_t count) {
+    merge_sort(data, count, sizeof(uint64_t), sort_bench_compare, NULL);
+}
+
+static void sort_heap_bench(uint64_t *data, size_t count) {
+    heap_sort(data, count, sizeof(uint64_t), sort_bench_compare, NULL);
+}
+
+static void sort_parallel_bench(uint64_t *data, size_t count) {
+    sort_parallel(data, count, sizeof(uint64_t), sort_bench_compare, NULL, 0);
+}
+
+static void sort_radix_bench(uint64_t *data, size_t count) {
+    radix_sort_u64(data, count);
+}
+
+// SORT_DEFINE 生成的类型特化版本
+static void sort_define_bench(uint64_t *data, size_t count) {
+    bench_u64_sort(data, count);
+}
+
+static void sort_define_merge_bench(uint64_t *data, size_t count) {
+    bench_u64_merge_sort(data, count);
+}
+
+static void sort_define_heap_bench(uint64_t *data, size_t count) {
+    bench_u64_heap_sort(data, count);
+}
+
+// libc qsort 作为基准
+static void qsort_bench(uint64_t *data, size_t count) {
+    qsort(data, count, sizeof(uint64_t), qsort_bench_compare);
+}
+
+#define SORT_TARGET(var, name, fn) \
+    const bench_target_t var = { name, BENCH_KIND_SORT, NULL, NULL, NULL, NULL, NULL, fn }
+
+SORT_TARGET(bench_sort_auto, "sort_auto", sort_auto_bench);
+SORT_TARGET(bench_sort_quick, "sort_quick", sort_quick_bench);
+SORT_TARGET(bench_sort_merge, "sort_merge", sort_merge_bench);
+SORT_TARGET(bench_sort_heap, "sort_heap", sort_heap_bench);
+SORT_TARGET(bench_sort_parallel, "sort_parallel", sort_parallel_bench);
+SORT_TARGET(bench_sort_radix, "sort_radix", sort_radix_bench);
+SORT_TARGET(bench_sort_define, "sort_define", sort_define_bench);
+SORT_TARGET(bench_sort_define_merge, "sort_define_merge", sort_define_merge_bench);
+SORT_TARGET(bench_sort_define_heap, "sort_define_heap", sort_define_heap_bench);
+SORT_TARGET(bench_qsort, "qsort", qsort_bench);
@@ -0,0 +1,266 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include "bench.h"
+#include "../BaseStruct/rb_tree/rb_tree.h"
+#include "../BaseStruct/avl_tree/avl_tree.h"
+#include "../BaseStruct/splay_tree/splay_tree.h"
+#include "../BaseStruct/b_tree/b_tree.h"
+#include "../BaseStruct/radix_tree/radix_tree.h"
+
+// 侵入式树的元素：节点内嵌在用户结构中，每个元素单独分配
+#define DEFINE_TREE_ITEM(prefix, node_type)                                     \
+    typedef struct {                                                            \
+        struct node_type node;                                                  \
+        uint64_t key;                                                           \
+    } prefix##_item_t;                                                          \
+                                                                                \
+    static int prefix##_compare(const struct node_type *a,                      \
+                                const struct node_type *b, void *arg) {         \
+        uint64_t x = container_of(a, prefix##_item_t, node)->key;               \
+        uint64_t y = container_of(b, prefix##_item_t, node)->key;               \
+        (void)arg;                                                              \
+        return (x > y) - (x < y);                                               \
+    }                                                                           \
+                                                                                \
+    static void prefix##_free(struct node_type *node, void *arg) {              \
+        (void)arg;                                                              \
+        free(container_of(node, prefix##_item_t, node));                        \
+    }
+
+//-----------------------------
+// 红黑树
+//-----------------------------
+
+DEFINE_TREE_ITEM(rb, rb_node)
+
+static void *rb_bench_create(size_t size) {
+    rb_root_t *tree = malloc(sizeof(rb_root_t));
+    (void)size;
+    if (tree) {
+        rb_init(tree, rb_compare, NULL, rb_free, NULL);
+    }
+    return tree;
+}
+
+static void rb_bench_destroy(void *ctx) {
+    rb_destroy(ctx);
+    free(ctx);
+}
+
+static bool rb_bench_insert(void *ctx, uint64_t key) {
+    rb_item_t *item = malloc(sizeof(rb_item_t));
+    if (!item) {
+        return false;
+    }
+    item->key = key;
+    if (rb_insert(ctx, &item->node) != 0) {
+        free(item);
+        return false;
+    }
+    return true;
+}
+
+static bool rb_bench_lookup(void *ctx, uint64_t key) {
+    rb_item_t probe = { .key = key };
+    return rb_search(ctx, &probe.node) != NULL;
+}
+
+static bool rb_bench_remove(void *ctx, uint64_t key) {
+    rb_item_t probe = { .key = key };
+    struct rb_node *node = rb_search(ctx, &probe.node);
+    if (!node) {
+        return false;
+    }
+    rb_erase(ctx, node);
+    rb_free(node, NULL);
+    return true;
+}
+
+const bench_target_t bench_rb_tree = {
+    "rb_tree", BENCH_KIND_MAP, rb_bench_create, rb_bench_destroy,
+    rb_bench_insert, rb_bench_lookup, rb_bench_remove, NULL
+};
+
+//-----------------------------
+// AVL树
+//-----------------------------
+
+DEFINE_TREE_ITEM(avl, avl_node)
+
+static void *avl_bench_create(size_t size) {
+    avl_root_t *tree = malloc(sizeof(avl_root_t));
+    (void)size;
+    if (tree) {
+        avl_init(tree, avl_compare, NULL, avl_free, NULL);
+    }
+    return tree;
+}
+
+static void avl_bench_destroy(void *ctx) {
+    avl_destroy(ctx);
+    free(ctx);
+}
+
+static bool avl_bench_insert(void *ctx, uint64_t key) {
+    avl_item_t *item = malloc(sizeof(avl_item_t));
+    if (!item) {
+        return false;
+    }
+    item->key = key;
+    if (avl_insert(ctx, &item->node) != 0) {
+        free(item);
+        return false;
+    }
+    return true;
+}
+
+static bool avl_bench_lookup(void *ctx, uint64_t key) {
+    avl_item_t probe = { .key = key };
+    return avl_search(ctx, &probe.node) != NULL;
+}
+
+static bool avl_bench_remove(void *ctx, uint64_t key) {
+    avl_item_t probe = { .key = key };
+    struct avl_node *node = avl_search(ctx, &probe.node);
+    if (!node) {
+        return false;
+    }
+    avl_erase(ctx, node);
+    avl_free(node, NULL);
+    return true;
+}
+
+const bench_target_t bench_avl_tree = {
+    "avl_tree", BENCH_KIND_MAP, avl_bench_create, avl_bench_destroy,
+    avl_bench_insert, avl_bench_lookup, avl_bench_remove, NULL
+};
+
+//-----------------------------
+// 伸展树
+//-----------------------------
+
+DEFINE_TREE_ITEM(splay, splay_node)
+
+static void *splay_bench_create(size_t size) {
+    splay_root_t *tree = malloc(sizeof(splay_root_t));
+    (void)size;
+    if (tree) {
+        splay_init(tree, splay_compare, NULL, splay_free, NULL);
+    }
+    return tree;
+}
+
+static void splay_bench_destroy(void *ctx) {
+    splay_destroy(ctx);
+    free(ctx);
+}
+
+static bool splay_bench_insert(void *ctx, uint64_t key) {
+    splay_item_t *item = malloc(sizeof(splay_item_t));
+    if (!item) {
+        return false;
+    }
+    item->key = key;
+    if (splay_insert(ctx, &item->node) != 0) {
+        free(item);
+        return false;
+    }
+    return true;
+}
+
+static bool splay_bench_lookup(void *ctx, uint64_t key) {
+    splay_item_t probe = { .key = key };
+    return splay_search(ctx, &probe.node) != NULL;
+}
+
+static bool splay_bench_remove(void *ctx, uint64_t key) {
+    splay_item_t probe = { .key = key };
+    struct splay_node *node = splay_search(ctx, &probe.node);
+    if (!node) {
+        return false;
+    }
+    splay_erase(ctx, node);
+    splay_free(node, NULL);
+    return true;
+}
+
+const bench_target_t bench_splay_tree = {
+    "splay_tree", BENCH_KIND_MAP, splay_bench_create, splay_bench_destroy,
+    splay_bench_insert, splay_bench_lookup, splay_bench_remove, NULL
+};
+
+//-----------------------------
+// B树：键直接编码在指针里（key + 1，避免与 NULL 冲突）
+//-----------------------------
+
+#define BTREE_KEY(key) ((void *)(uintptr_t)((key) + 1))
+
+static int btree_bench_compare(const void *a, const void *b, void *arg) {
+    uintptr_t x = (uintptr_t)a, y = (uintptr_t)b;
+    (void)arg;
+    return (x > y) - (x < y);
+}
+
+static void *btree_bench_create(size_t size) {
+    (void)size;
+    return btree_create(BTREE_DEFAULT_ORDER, btree_bench_compare, NULL, NULL, NULL);
+}
+
+static void btree_bench_destroy(void *ctx) {
+    btree_destroy(ctx);
+}
+
+static bool btree_bench_insert(void *ctx, uint64_t key) {
+    return btree_insert(ctx, BTREE_KEY(key)) == 0;
+}
+
+static bool btree_bench_lookup(void *ctx, uint64_t key) {
+    return btree_search(ctx, BTREE_KEY(key)) != NULL;
+}
+
+static bool btree_bench_remove(void *ctx, uint64_t key) {
+    return btree_delete(ctx, BTREE_KEY(key)) == 0;
+}
+
+const bench_target_t bench_b_tree = {
+    "b_tree", BENCH_KIND_MAP, btree_bench_create, btree_bench_destroy,
+    btree_bench_insert, btree_bench_lookup, btree_bench_remove, NULL
+};
+
+//-----------------------------
+// 基数树（整数键接口）
+//-----------------------------
+
+// 所有键共享同一个条目，基数树只测索引结构本身
+static uint64_t radix_bench_item;
+
+static void *radix_bench_create(size_t size) {
+    radix_root_t *tree = malloc(sizeof(radix_root_t));
+    (void)size;
+    if (tree) {
+        radix_tree_init(tree);
+    }
+    return tree;
+}
+
+static void radix_bench_destroy(void *ctx) {
+    radix_destroy(ctx);
+    free(ctx);
+}
+
+static bool radix_bench_insert(void *ctx, uint64_t key) {
+    return radix_tree_insert(ctx, (unsigned long)key, &radix_bench_item) == 0;
+}
+
+static bool radix_bench_lookup(void *ctx, uint64_t key) {
+    return radix_tree_lookup(ctx, (unsigned long)key) != NULL;
+}
+
+static bool radix_bench_remove(void *ctx, uint64_t key) {
+    return radix_tree_delete(ctx, (unsigned long)key) != NULL;
+}
+
+const bench_target_t bench_radix_tree = {
+    "radix_tree", BENCH_KIND_MAP, radix_bench_create, radix_bench_destroy,
+    radix_bench_insert, radix_bench_lookup, radix_bench_remove, NULL
+};
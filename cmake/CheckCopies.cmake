@@ -0,0 +1,54 @@
+# 检查各目录中依赖文件的副本与库中唯一编译的那一份是否一致
+#
+# 每个目录保持可以单独复制使用，所以 list.c、rb_tree.c 等依赖文件在多个目录下都有副本，
+# 但 libcstl 只编译一份。副本一旦修改走样，单独使用目录和链接库的行为就会不同。
+#
+# 检查：cmake -DSOURCE_DIR=<仓库根目录> -P cmake/CheckCopies.cmake
+# 同步：cmake -DSOURCE_DIR=<仓库根目录> -DSYNC=ON -P cmake/CheckCopies.cmake
+
+if(NOT SOURCE_DIR)
+    get_filename_component(SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+endif()
+
+# 格式："原件|副本所在目录 ..."
+set(CSTL_COPY_GROUPS
+    "BaseStruct/list/list.h|BaseStruct/lru_list STL/list STL/queue STL/stack STL/dequeue"
+    "BaseStruct/list/list.c|BaseStruct/lru_list STL/list STL/queue STL/stack STL/dequeue"
+    "BaseStruct/hlist/hlist.h|BaseStruct/lru_list STL/hlist"
+    "BaseStruct/hlist/hlist.c|BaseStruct/lru_list STL/hlist"
+    "BaseStruct/rb_tree/rb_tree.h|STL/hashmap STL/concurrent_hashmap"
+    "BaseStruct/rb_tree/rb_tree.c|STL/hashmap STL/concurrent_hashmap"
+    "Algorithm/hash/WyHash/wyhash.h|STL/hashmap STL/flat_hashmap STL/concurrent_hashmap"
+    "Algorithm/hash/WyHash/wyhash.c|STL/hashmap STL/flat_hashmap STL/concurrent_hashmap"
+    "STL/hashmap/hashmap.h|STL/concurrent_hashmap"
+    "STL/hashmap/hashmap.c|STL/concurrent_hashmap"
+)
+
+set(mismatch 0)
+foreach(group IN LISTS CSTL_COPY_GROUPS)
+    string(REPLACE "|" ";" parts "${group}")
+    list(GET parts 0 original)
+    list(GET parts 1 dirs)
+    separate_arguments(dirs)
+    get_filename_component(name "${original}" NAME)
+
+    foreach(dir IN LISTS dirs)
+        set(copy "${dir}/${name}")
+        execute_process(
+            COMMAND ${CMAKE_COMMAND} -E compare_files "${SOURCE_DIR}/${original}" "${SOURCE_DIR}/${copy}"
+            RESULT_VARIABLE differ)
+        if(differ)
+            if(SYNC)
+                message(STATUS "同步 ${copy} <- ${original}")
+                configure_file("${SOURCE_DIR}/${original}" "${SOURCE_DIR}/${copy}" COPYONLY)
+            else()
+                message(SEND_ERROR "${copy} 与 ${original} 不一致")
+                set(mismatch 1)
+            endif()
+        endif()
+    endforeach()
+endforeach()
+
+if(mismatch)
+    message(FATAL_ERROR "依赖文件副本不一致，修改原件后运行 SYNC=ON 同步")
+endif()